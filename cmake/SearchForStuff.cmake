@@ -720,6 +720,26 @@ else()
   set (HAVE_UUID TRUE)
 endif()
 
+########################################
+# Find zstd and lz4, used to compress log files
+pkg_check_modules(libzstd libzstd)
+if (libzstd_FOUND)
+  message (STATUS "Looking for libzstd - found")
+  set (HAVE_ZSTD TRUE)
+else ()
+  set (HAVE_ZSTD FALSE)
+  BUILD_WARNING ("libzstd not found - Log files will not support zstd encoding.")
+endif ()
+
+pkg_check_modules(liblz4 liblz4)
+if (liblz4_FOUND)
+  message (STATUS "Looking for liblz4 - found")
+  set (HAVE_LZ4 TRUE)
+else ()
+  set (HAVE_LZ4 FALSE)
+  BUILD_WARNING ("liblz4 not found - Log files will not support lz4 encoding.")
+endif ()
+
 ########################################
 # Find graphviz
 include (${gazebo_cmake_dir}/FindGraphviz.cmake)
@@ -15,6 +15,9 @@
  *
 */
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <thread>
 #include <mutex>
@@ -23,6 +26,8 @@
 #include <boost/make_shared.hpp>
 #include <google/protobuf/descriptor.h>
 #include <set>
+#include <unordered_map>
+#include <vector>
 #include "gazebo/transport/IOManager.hh"
 
 #include "Master.hh"
@@ -35,11 +40,24 @@ namespace gazebo
 {
   struct MasterPrivate
   {
-    /// \brief All the known publishers.
-    gazebo::Master::PubList publishers;
+    /// \brief All the known publishers, by topic.
+    std::unordered_map<std::string, gazebo::Master::PubList> publishers;
 
-    /// \brief All the known subscribers.
-    gazebo::Master::SubList subscribers;
+    /// \brief All the known subscribers, by topic.
+    std::unordered_map<std::string, gazebo::Master::SubList> subscribers;
+
+    /// \brief Topics published through each connection, by connection id.
+    std::unordered_map<unsigned int, std::set<std::string>>
+        connectionPublishers;
+
+    /// \brief Topics subscribed through each connection, by connection id.
+    std::unordered_map<unsigned int, std::set<std::string>>
+        connectionSubscribers;
+
+    /// \brief Ids of the connections which announced that they understand
+    /// the batched publisher_add_batch and publisher_del_batch messages.
+    /// Older clients only get the single-entry messages.
+    std::set<unsigned int> batchConnections;
 
     /// \brief All the known connections.
     gazebo::Master::Connection_M connections;
@@ -64,6 +82,16 @@ namespace gazebo
 
     /// \brief Mutex to protect msg bufferes.
     std::recursive_mutex msgsMutex;
+
+    /// \brief Wakes up the main loop when a message arrives.
+    std::condition_variable runCondition;
+
+    /// \brief Mutex for runCondition and runPending.
+    std::mutex runMutex;
+
+    /// \brief True if a message arrived since the last iteration of the
+    /// main loop.
+    bool runPending = false;
   };
 }
 
@@ -118,12 +146,10 @@ void Master::OnAccept(transport::ConnectionPtr _newConnection)
 
   // Send all the publishers
   msgs::Publishers publishersMsg;
-  PubList::iterator pubiter;
-  for (pubiter = this->dataPtr->publishers.begin();
-       pubiter != this->dataPtr->publishers.end(); ++pubiter)
+  for (auto const &topic : this->dataPtr->publishers)
   {
-    msgs::Publish *pub = publishersMsg.add_publisher();
-    pub->CopyFrom(pubiter->first);
+    for (auto const &pub : topic.second)
+      publishersMsg.add_publisher()->CopyFrom(pub.first);
   }
   _newConnection->EnqueueMsg(
       msgs::Package("publishers_init", publishersMsg), true);
@@ -162,8 +188,17 @@ void Master::OnRead(const unsigned int _connectionIndex,
   // Store the message if it's not empty
   if (!_data.empty())
   {
-    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->msgsMutex);
-    this->dataPtr->msgs.push_back(std::make_pair(_connectionIndex, _data));
+    {
+      std::lock_guard<std::recursive_mutex> lock(this->dataPtr->msgsMutex);
+      this->dataPtr->msgs.push_back(std::make_pair(_connectionIndex, _data));
+    }
+
+    // Process the message right away
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+      this->dataPtr->runPending = true;
+    }
+    this->dataPtr->runCondition.notify_one();
   }
   else
   {
@@ -177,11 +212,14 @@ void Master::OnRead(const unsigned int _connectionIndex,
 void Master::SendSubscribers(const std::string &_topic,
                              const std::string &_buffer)
 {
+  auto subscribers = this->dataPtr->subscribers.find(_topic);
+  if (subscribers == this->dataPtr->subscribers.end())
+    return;
+
   // Find all subscribers for this topic
   std::set<transport::ConnectionPtr> uniqueConnections;
-  for (auto const &subscriber : this->dataPtr->subscribers)
-    if (subscriber.first.topic() == _topic)
-      uniqueConnections.insert(subscriber.second);
+  for (auto const &subscriber : subscribers->second)
+    uniqueConnections.insert(subscriber.second);
 
   // Send message to all unique connections
   for (auto &conn : uniqueConnections)
@@ -226,21 +264,15 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
   }
   else if (packet.type() == "advertise")
   {
-    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
-    msgs::Publish pub;
-    pub.ParseFromString(packet.serialized_data());
-
-    Connection_M::iterator iter2;
-    for (iter2 = this->dataPtr->connections.begin();
-         iter2 != this->dataPtr->connections.end(); ++iter2)
-    {
-      iter2->second->EnqueueMsg(msgs::Package("publisher_add", pub));
-    }
-
-    this->dataPtr->publishers.push_back(std::make_pair(pub, conn));
-
-    this->SendSubscribers(pub.topic(),
-        msgs::Package("publisher_advertise", pub));
+    msgs::Publishers pubs;
+    pubs.add_publisher()->ParseFromString(packet.serialized_data());
+    this->AddPublishers(pubs, conn);
+  }
+  else if (packet.type() == "advertise_batch")
+  {
+    msgs::Publishers pubs;
+    pubs.ParseFromString(packet.serialized_data());
+    this->AddPublishers(pubs, conn);
   }
   else if (packet.type() == "unadvertise")
   {
@@ -259,18 +291,16 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     msgs::Subscribe sub;
     sub.ParseFromString(packet.serialized_data());
 
-    this->dataPtr->subscribers.push_back(std::make_pair(sub, conn));
-
-    PubList::iterator iter;
+    this->dataPtr->subscribers[sub.topic()].push_back(
+        std::make_pair(sub, conn));
+    this->dataPtr->connectionSubscribers[conn->GetId()].insert(sub.topic());
 
     // Find all publishers of the topic
-    for (iter = this->dataPtr->publishers.begin();
-        iter != this->dataPtr->publishers.end(); ++iter)
+    auto pubs = this->dataPtr->publishers.find(sub.topic());
+    if (pubs != this->dataPtr->publishers.end())
     {
-      if (iter->first.topic() == sub.topic())
-      {
-        conn->EnqueueMsg(msgs::Package("publisher_subscribe", iter->first));
-      }
+      for (auto const &pub : pubs->second)
+        conn->EnqueueMsg(msgs::Package("publisher_subscribe", pub.first));
     }
   }
   else if (packet.type() == "request")
@@ -281,12 +311,10 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
     if (req.request() == "get_publishers")
     {
       msgs::Publishers msg;
-      PubList::iterator iter;
-      for (iter = this->dataPtr->publishers.begin();
-          iter != this->dataPtr->publishers.end(); ++iter)
+      for (auto const &topic : this->dataPtr->publishers)
       {
-        msgs::Publish *pub = msg.add_publisher();
-        pub->CopyFrom(iter->first);
+        for (auto const &pub : topic.second)
+          msg.add_publisher()->CopyFrom(pub.first);
       }
       conn->EnqueueMsg(msgs::Package("publisher_list", msg), true);
     }
@@ -296,18 +324,12 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       msgs::GzString_V msg;
 
       // Add all topics that are published
-      for (PubList::iterator iter = this->dataPtr->publishers.begin();
-          iter != this->dataPtr->publishers.end(); ++iter)
-      {
-        topics.insert(iter->first.topic());
-      }
+      for (auto const &topic : this->dataPtr->publishers)
+        topics.insert(topic.first);
 
       // Add all topics that are subscribed
-      for (SubList::iterator iter = this->dataPtr->subscribers.begin();
-           iter != this->dataPtr->subscribers.end(); ++iter)
-      {
-        topics.insert(iter->first.topic());
-      }
+      for (auto const &topic : this->dataPtr->subscribers)
+        topics.insert(topic.first);
 
       // Construct the message of only unique names
       for (std::set<std::string>::iterator iter =
@@ -325,38 +347,39 @@ void Master::ProcessMessage(const unsigned int _connectionIndex,
       msgs::TopicInfo ti;
       ti.set_msg_type(pub.msg_type());
 
-      PubList::iterator piter;
-      SubList::iterator siter;
-
       // Find all publishers of the topic
-      for (piter = this->dataPtr->publishers.begin();
-          piter != this->dataPtr->publishers.end(); ++piter)
+      auto pubs = this->dataPtr->publishers.find(req.data());
+      if (pubs != this->dataPtr->publishers.end())
       {
-        if (piter->first.topic() == req.data())
-        {
-          msgs::Publish *pubPtr = ti.add_publisher();
-          pubPtr->CopyFrom(piter->first);
-        }
+        for (auto const &pub : pubs->second)
+          ti.add_publisher()->CopyFrom(pub.first);
       }
 
       // Find all subscribers of the topic
-      for (siter = this->dataPtr->subscribers.begin();
-          siter != this->dataPtr->subscribers.end(); ++siter)
+      auto subs = this->dataPtr->subscribers.find(req.data());
+      if (subs != this->dataPtr->subscribers.end())
       {
-        if (siter->first.topic() == req.data())
+        for (auto const &sub : subs->second)
         {
           // If the topic info message type has not been set or the
           // topic info message type is an empty string, then set the topic
           // info message type based on a subscriber's message type.
           if (!ti.has_msg_type() || ti.msg_type().empty())
-            ti.set_msg_type(siter->first.msg_type());
-          msgs::Subscribe *sub = ti.add_subscriber();
-          sub->CopyFrom(siter->first);
+            ti.set_msg_type(sub.first.msg_type());
+          ti.add_subscriber()->CopyFrom(sub.first);
         }
       }
 
       conn->EnqueueMsg(msgs::Package("topic_info_response", ti));
     }
+    else if (req.request() == "batch_support")
+    {
+      // Acknowledge, so that the client sends batched advertisements too.
+      std::lock_guard<std::recursive_mutex>
+          lock(this->dataPtr->connectionMutex);
+      this->dataPtr->batchConnections.insert(conn->GetId());
+      conn->EnqueueMsg(msgs::Package("batch_support", req));
+    }
     else if (req.request() == "get_topic_namespaces")
     {
       msgs::GzString_V msg;
@@ -384,7 +407,16 @@ void Master::Run()
   while (!this->dataPtr->stop)
   {
     this->RunOnce();
-    common::Time::MSleep(10);
+
+    // Sleep until a message arrives. The timeout only bounds how long
+    // closed connections stay in the list.
+    std::unique_lock<std::mutex> lock(this->dataPtr->runMutex);
+    this->dataPtr->runCondition.wait_for(lock, std::chrono::milliseconds(100),
+        [this]
+        {
+          return this->dataPtr->runPending || this->dataPtr->stop;
+        });
+    this->dataPtr->runPending = false;
   }
 }
 
@@ -450,75 +482,162 @@ void Master::RemoveConnection(Connection_M::iterator _connIter)
     }
   }
 
-  // Remove all publishers for this connection
-  bool done = false;
-  while (!done)
+  const unsigned int id = _connIter->second->GetId();
+
+  // Remove all publishers for this connection, and tell the other
+  // connections about all of them at once.
+  auto topics = this->dataPtr->connectionPublishers.find(id);
+  if (topics != this->dataPtr->connectionPublishers.end())
   {
-    done = true;
-    PubList::iterator pubIter = this->dataPtr->publishers.begin();
-    while (pubIter != this->dataPtr->publishers.end())
+    msgs::Publishers pubs;
+    for (auto const &topic : topics->second)
     {
-      if ((*pubIter).second->GetId() == _connIter->second->GetId())
+      auto list = this->dataPtr->publishers.find(topic);
+      if (list == this->dataPtr->publishers.end())
+        continue;
+
+      for (auto const &pub : list->second)
       {
-        this->RemovePublisher((*pubIter).first);
-        done = false;
-        break;
+        if (pub.second->GetId() == id)
+          pubs.add_publisher()->CopyFrom(pub.first);
       }
-      else
-        ++pubIter;
     }
+    this->RemovePublishers(pubs);
   }
 
-
-  done = false;
-  while (!done)
+  // Remove all subscribers for this connection
+  topics = this->dataPtr->connectionSubscribers.find(id);
+  if (topics != this->dataPtr->connectionSubscribers.end())
   {
-    done = true;
-
-    // Remove all subscribers for this connection
-    SubList::iterator subIter = this->dataPtr->subscribers.begin();
-    while (subIter != this->dataPtr->subscribers.end())
+    std::vector<msgs::Subscribe> subs;
+    for (auto const &topic : topics->second)
     {
-      if ((*subIter).second->GetId() == _connIter->second->GetId())
+      auto list = this->dataPtr->subscribers.find(topic);
+      if (list == this->dataPtr->subscribers.end())
+        continue;
+
+      for (auto const &sub : list->second)
       {
-        this->RemoveSubscriber((*subIter).first);
-        done = false;
-        break;
+        if (sub.second->GetId() == id)
+          subs.push_back(sub.first);
       }
-      else
-        ++subIter;
     }
+    for (auto const &sub : subs)
+      this->RemoveSubscriber(sub);
   }
 
+  this->dataPtr->connectionPublishers.erase(id);
+  this->dataPtr->connectionSubscribers.erase(id);
+  this->dataPtr->batchConnections.erase(id);
   this->dataPtr->connections.erase(_connIter);
 }
 
 /////////////////////////////////////////////////
-void Master::RemovePublisher(const msgs::Publish _pub)
+void Master::AddPublishers(const msgs::Publishers &_pubs,
+    transport::ConnectionPtr _conn)
+{
+  if (_pubs.publisher_size() == 0)
+    return;
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
+
+  // Tell all connections about the new publishers, in a single message if
+  // there are many and the connection understands batches.
+  this->SendPublishers(_pubs, "publisher_add");
+
+  for (auto const &pub : _pubs.publisher())
+  {
+    this->dataPtr->publishers[pub.topic()].push_back(
+        std::make_pair(pub, _conn));
+    this->dataPtr->connectionPublishers[_conn->GetId()].insert(pub.topic());
+
+    this->SendSubscribers(pub.topic(),
+        msgs::Package("publisher_advertise", pub));
+  }
+}
+
+/////////////////////////////////////////////////
+void Master::SendPublishers(const msgs::Publishers &_pubs,
+    const std::string &_type)
 {
+  std::string batchMsg;
+  std::vector<std::string> singleMsgs;
+
+  for (auto &conn : this->dataPtr->connections)
   {
-    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
-    Connection_M::iterator iter2;
-    for (iter2 = this->dataPtr->connections.begin();
-        iter2 != this->dataPtr->connections.end(); ++iter2)
+    if (_pubs.publisher_size() > 1 &&
+        this->dataPtr->batchConnections.count(conn.second->GetId()))
+    {
+      if (batchMsg.empty())
+        batchMsg = msgs::Package(_type + "_batch", _pubs);
+      conn.second->EnqueueMsg(batchMsg);
+    }
+    else
     {
-      iter2->second->EnqueueMsg(msgs::Package("publisher_del", _pub));
+      if (singleMsgs.empty())
+      {
+        for (auto const &pub : _pubs.publisher())
+          singleMsgs.push_back(msgs::Package(_type, pub));
+      }
+      for (auto const &msg : singleMsgs)
+        conn.second->EnqueueMsg(msg);
     }
   }
+}
+
+/////////////////////////////////////////////////
+void Master::RemovePublisher(const msgs::Publish _pub)
+{
+  msgs::Publishers pubs;
+  pubs.add_publisher()->CopyFrom(_pub);
+  this->RemovePublishers(pubs);
+}
 
-  this->SendSubscribers(_pub.topic(), msgs::Package("unadvertise", _pub));
+/////////////////////////////////////////////////
+void Master::RemovePublishers(const msgs::Publishers &_pubs)
+{
+  if (_pubs.publisher_size() == 0)
+    return;
 
-  PubList::iterator pubIter = this->dataPtr->publishers.begin();
-  while (pubIter != this->dataPtr->publishers.end())
   {
-    if (pubIter->first.topic() == _pub.topic() &&
-        pubIter->first.host() == _pub.host() &&
-        pubIter->first.port() == _pub.port())
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
+    this->SendPublishers(_pubs, "publisher_del");
+  }
+
+  for (auto const &pub : _pubs.publisher())
+  {
+    this->SendSubscribers(pub.topic(), msgs::Package("unadvertise", pub));
+
+    auto topicIter = this->dataPtr->publishers.find(pub.topic());
+    if (topicIter == this->dataPtr->publishers.end())
+      continue;
+
+    PubList &list = topicIter->second;
+    for (auto pubIter = list.begin(); pubIter != list.end();)
     {
-      pubIter = this->dataPtr->publishers.erase(pubIter);
+      if (pubIter->first.host() == pub.host() &&
+          pubIter->first.port() == pub.port())
+      {
+        const unsigned int id = pubIter->second->GetId();
+        pubIter = list.erase(pubIter);
+
+        // Drop the back reference if the connection has no other
+        // publisher of the topic
+        if (std::none_of(list.begin(), list.end(),
+              [id](const PubList::value_type &_p)
+              {
+                return _p.second->GetId() == id;
+              }))
+        {
+          this->dataPtr->connectionPublishers[id].erase(pub.topic());
+        }
+      }
+      else
+        ++pubIter;
     }
-    else
-      ++pubIter;
+
+    if (list.empty())
+      this->dataPtr->publishers.erase(topicIter);
   }
 }
 
@@ -526,34 +645,54 @@ void Master::RemovePublisher(const msgs::Publish _pub)
 void Master::RemoveSubscriber(const msgs::Subscribe _sub)
 {
   // Find all publishers of the topic, and remove the subscriptions
-  for (PubList::iterator iter = this->dataPtr->publishers.begin();
-      iter != this->dataPtr->publishers.end(); ++iter)
+  auto pubs = this->dataPtr->publishers.find(_sub.topic());
+  if (pubs != this->dataPtr->publishers.end())
   {
-    if (iter->first.topic() == _sub.topic())
-    {
-      iter->second->EnqueueMsg(msgs::Package("unsubscribe", _sub));
-    }
+    for (auto const &pub : pubs->second)
+      pub.second->EnqueueMsg(msgs::Package("unsubscribe", _sub));
   }
 
   // Remove the subscribers from our list
-  SubList::iterator subiter = this->dataPtr->subscribers.begin();
-  while (subiter != this->dataPtr->subscribers.end())
+  auto topicIter = this->dataPtr->subscribers.find(_sub.topic());
+  if (topicIter == this->dataPtr->subscribers.end())
+    return;
+
+  SubList &list = topicIter->second;
+  for (auto subIter = list.begin(); subIter != list.end();)
   {
-    if (subiter->first.topic() == _sub.topic() &&
-        subiter->first.host() == _sub.host() &&
-        subiter->first.port() == _sub.port())
+    if (subIter->first.host() == _sub.host() &&
+        subIter->first.port() == _sub.port())
     {
-      subiter = this->dataPtr->subscribers.erase(subiter);
+      const unsigned int id = subIter->second->GetId();
+      subIter = list.erase(subIter);
+
+      // Drop the back reference if the connection has no other
+      // subscriber of the topic
+      if (std::none_of(list.begin(), list.end(),
+            [id](const SubList::value_type &_s)
+            {
+              return _s.second->GetId() == id;
+            }))
+      {
+        this->dataPtr->connectionSubscribers[id].erase(_sub.topic());
+      }
     }
     else
-      ++subiter;
+      ++subIter;
   }
+
+  if (list.empty())
+    this->dataPtr->subscribers.erase(topicIter);
 }
 
 //////////////////////////////////////////////////
 void Master::Stop()
 {
-  this->dataPtr->stop = true;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->runCondition.notify_all();
 
   if (this->dataPtr->runThread)
   {
@@ -580,6 +719,8 @@ void Master::Fini()
   this->dataPtr->connections.clear();
   this->dataPtr->subscribers.clear();
   this->dataPtr->publishers.clear();
+  this->dataPtr->connectionPublishers.clear();
+  this->dataPtr->connectionSubscribers.clear();
 }
 
 //////////////////////////////////////////////////
@@ -587,18 +728,10 @@ msgs::Publish Master::GetPublisher(const std::string &_topic)
 {
   msgs::Publish msg;
 
-  PubList::iterator iter;
-
-  // Find all publishers of the topic
-  for (iter = this->dataPtr->publishers.begin();
-       iter != this->dataPtr->publishers.end(); ++iter)
-  {
-    if (iter->first.topic() == _topic)
-    {
-      msg = iter->first;
-      break;
-    }
-  }
+  // Find the first publisher of the topic
+  auto pubs = this->dataPtr->publishers.find(_topic);
+  if (pubs != this->dataPtr->publishers.end() && !pubs->second.empty())
+    msg = pubs->second.front().first;
 
   return msg;
 }
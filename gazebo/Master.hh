@@ -118,11 +118,33 @@ namespace gazebo
     /// _connIter will be incremented when removed.
     private: void RemoveConnection(Connection_M::iterator _connIter);
 
+    /// \brief Add publishers of a connection, and announce them to all
+    /// connections and to the subscribers of their topics.
+    /// \param[in] _pubs The publishers.
+    /// \param[in] _conn Connection that advertised the publishers.
+    private: void AddPublishers(const msgs::Publishers &_pubs,
+                                transport::ConnectionPtr _conn);
+
     /// \brief Remove a publisher.
     /// \param[in] _pub Publish message that contains the info necessary to
     /// remove a publisher.
     private: void RemovePublisher(const msgs::Publish _pub);
 
+    /// \brief Send publishers to all connections. Connections which
+    /// support batches get a single "<_type>_batch" message if there are
+    /// many publishers, the others get one "<_type>" message per publisher.
+    /// \param[in] _pubs The publishers.
+    /// \param[in] _type Packet type, "publisher_add" or "publisher_del".
+    private: void SendPublishers(const msgs::Publishers &_pubs,
+                                 const std::string &_type);
+
+    /// \brief Remove publishers, and announce the removal to all
+    /// connections, in a single message for the connections which support
+    /// batches.
+    /// \param[in] _pubs Publish messages that contain the info necessary
+    /// to remove the publishers.
+    private: void RemovePublishers(const msgs::Publishers &_pubs);
+
     /// \brief Remove a subscriber.
     /// \param[in] _pub Subscribe message that contains the info necessary to
     /// remove a subscriber.
@@ -165,9 +165,11 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("physics,e", po::value<std::string>(),
      "Specify a physics engine (ode|bullet|dart|simbody).")
     ("play,p", po::value<std::string>(), "Play a log file.")
+    ("play_cache", po::value<unsigned int>()->default_value(256),
+     "Memory for the states cached to seek in a played log file (MiB).")
     ("record,r", "Record state data.")
     ("record_encoding", po::value<std::string>()->default_value("zlib"),
-     "Compression encoding format for log data (zlib|bz2|txt).")
+     "Compression encoding format for log data (zlib|bz2|txt|zstd|lz4).")
     ("record_path", po::value<std::string>()->default_value(""),
      "Absolute path in which to store state data")
     ("record_period", po::value<double>()->default_value(-1),
@@ -318,6 +320,8 @@ bool Server::ParseArgs(int _argc, char **_argv)
     // Load the log file
     util::LogPlay::Instance()->Open(
         this->dataPtr->vm["play"].as<std::string>());
+    util::LogPlay::Instance()->SetKeyframeMemory(
+        this->dataPtr->vm["play_cache"].as<unsigned int>() * 1024u * 1024u);
 
     gzmsg << "\nLog playback:\n"
       << "  Log Version: "
@@ -27,6 +27,7 @@
 #include "gazebo/gazebo_config.h"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/EventProfiler.hh"
 #include "gazebo/util/system.hh"
 
 #include "ignition/common/Profiler.hh"
@@ -275,11 +276,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback0");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback();
             IGN_PROFILE_END();
           }
@@ -296,11 +299,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback1");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(_p);
             IGN_PROFILE_END();
           }
@@ -318,11 +323,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback2");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(_p1, _p2);
             IGN_PROFILE_END();
           }
@@ -341,11 +348,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback3");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(_p1, _p2, _p3);
             IGN_PROFILE_END();
           }
@@ -366,11 +375,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback4");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(_p1, _p2, _p3, _p4);
             IGN_PROFILE_END();
           }
@@ -393,11 +404,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback5");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(_p1, _p2, _p3, _p4, _p5);
             IGN_PROFILE_END();
           }
@@ -421,11 +434,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback6");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6);
             IGN_PROFILE_END();
           }
@@ -450,11 +465,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback7");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6, _p7);
             IGN_PROFILE_END();
           }
@@ -481,11 +498,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback8");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);
             IGN_PROFILE_END();
           }
@@ -514,11 +533,13 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback9");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(
                 _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9);
             IGN_PROFILE_END();
@@ -547,6 +568,7 @@ namespace gazebo
         this->Cleanup();
 
         this->SetSignaled(true);
+        const bool timed = EventProfiler::Enabled();
         for (const auto &iter: this->connections)
         {
           IGN_PROFILE("Event::Signal");
@@ -554,6 +576,7 @@ namespace gazebo
           if (iter.second->on)
           {
             IGN_PROFILE_BEGIN("callback10");
+            EventProfiler::CallScope timing(timed, iter.second->owner, this);
             iter.second->callback(
                 _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9, _p10);
             IGN_PROFILE_END();
@@ -570,8 +593,12 @@ namespace gazebo
       private: class EventConnection
       {
         /// \brief Constructor
-        public: EventConnection(const bool _on, const std::function<T> &_cb)
-                : callback(_cb)
+        /// \param[in] _on Initial on/off value.
+        /// \param[in] _cb Callback function.
+        /// \param[in] _owner Profiling owner id, see EventProfiler.
+        public: EventConnection(const bool _on, const std::function<T> &_cb,
+                    const int _owner)
+                : callback(_cb), owner(_owner)
         {
           // Windows Visual Studio 2012 does not have atomic_bool constructor,
           // so we have to set "on" using operator=
@@ -583,6 +610,9 @@ namespace gazebo
 
         /// \brief Callback function
         public: std::function<T> callback;
+
+        /// \brief Profiling owner id, -1 if the connection has no owner.
+        public: int owner;
       };
 
       /// \def EvtConnectionMap
@@ -625,7 +655,8 @@ namespace gazebo
         auto const &iter = this->connections.rbegin();
         index = iter->first + 1;
       }
-      this->connections[index].reset(new EventConnection(true, _subscriber));
+      this->connections[index].reset(new EventConnection(true, _subscriber,
+            EventProfiler::CurrentOwner()));
       return ConnectionPtr(new Connection(this, index));
     }
 
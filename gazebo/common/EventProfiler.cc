@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "gazebo/common/EventProfiler.hh"
+
+using namespace gazebo;
+using namespace event;
+
+namespace
+{
+  /// \brief Owner of a set of connections.
+  struct Owner
+  {
+    /// \brief Plugin filename.
+    std::string filename;
+
+    /// \brief Plugin name.
+    std::string name;
+
+    /// \brief Scoped name of the entity the plugin is attached to.
+    std::string scope;
+  };
+
+  /// \brief Accumulated timing of one owner on one event.
+  struct Accumulator
+  {
+    /// \brief Time accumulated during the current step.
+    double stepTime = 0;
+
+    /// \brief True if the subscriber was called during the current step.
+    bool calledThisStep = false;
+
+    /// \brief Statistics over all closed steps.
+    EventTimingStats stats;
+  };
+
+  /// \brief Key of an accumulator: owner id and event.
+  using AccumulatorKey = std::pair<int, const Event *>;
+
+  /// \brief Global profiler state.
+  struct ProfilerData
+  {
+    /// \brief True if profiling is enabled.
+    std::atomic<bool> enabled{false};
+
+    /// \brief Protects all members below.
+    std::mutex mutex;
+
+    /// \brief All owners, indexed by owner id.
+    std::vector<Owner> owners;
+
+    /// \brief Event names.
+    std::map<const Event *, std::string> eventNames;
+
+    /// \brief Timing per owner and event.
+    std::map<AccumulatorKey, Accumulator> accumulators;
+  };
+
+  /// \brief Get the global profiler state.
+  /// \return The profiler state.
+  ProfilerData &Data()
+  {
+    static ProfilerData data;
+    return data;
+  }
+
+  /// \brief Owner currently loading on this thread.
+  thread_local int g_currentOwner = -1;
+}
+
+const unsigned int EventProfiler::histogramBuckets;
+
+//////////////////////////////////////////////////
+void EventProfiler::SetEnabled(const bool _enable)
+{
+  Data().enabled = _enable;
+}
+
+//////////////////////////////////////////////////
+bool EventProfiler::Enabled()
+{
+  return Data().enabled.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void EventProfiler::SetEventName(const Event *_event,
+    const std::string &_name)
+{
+  ProfilerData &data = Data();
+  std::lock_guard<std::mutex> lock(data.mutex);
+  data.eventNames[_event] = _name;
+}
+
+//////////////////////////////////////////////////
+int EventProfiler::CurrentOwner()
+{
+  return g_currentOwner;
+}
+
+//////////////////////////////////////////////////
+void EventProfiler::Record(const int _owner, const Event *_event,
+    const double _seconds)
+{
+  ProfilerData &data = Data();
+  std::lock_guard<std::mutex> lock(data.mutex);
+  Accumulator &acc = data.accumulators[std::make_pair(_owner, _event)];
+  acc.stepTime += _seconds;
+  acc.calledThisStep = true;
+}
+
+//////////////////////////////////////////////////
+void EventProfiler::EndStep()
+{
+  ProfilerData &data = Data();
+  std::lock_guard<std::mutex> lock(data.mutex);
+  for (auto &iter : data.accumulators)
+  {
+    Accumulator &acc = iter.second;
+    if (!acc.calledThisStep)
+      continue;
+
+    EventTimingStats &stats = acc.stats;
+    if (stats.histogram.empty())
+      stats.histogram.resize(histogramBuckets, 0);
+
+    // Bucket by powers of two of microseconds
+    const double usec = acc.stepTime * 1e6;
+    unsigned int bucket = 0;
+    if (usec >= 1.0)
+    {
+      bucket = std::min(static_cast<unsigned int>(std::log2(usec)) + 1,
+          histogramBuckets - 1);
+    }
+    ++stats.histogram[bucket];
+
+    ++stats.steps;
+    stats.total += acc.stepTime;
+    stats.max = std::max(stats.max, acc.stepTime);
+
+    acc.stepTime = 0;
+    acc.calledThisStep = false;
+  }
+}
+
+//////////////////////////////////////////////////
+std::vector<EventTimingStats> EventProfiler::Stats()
+{
+  ProfilerData &data = Data();
+  std::lock_guard<std::mutex> lock(data.mutex);
+
+  std::vector<EventTimingStats> result;
+  result.reserve(data.accumulators.size());
+  for (auto const &iter : data.accumulators)
+  {
+    if (iter.second.stats.steps == 0)
+      continue;
+
+    EventTimingStats stats = iter.second.stats;
+    const int owner = iter.first.first;
+    if (owner >= 0 && static_cast<size_t>(owner) < data.owners.size())
+    {
+      stats.filename = data.owners[owner].filename;
+      stats.name = data.owners[owner].name;
+      stats.scope = data.owners[owner].scope;
+    }
+
+    auto nameIter = data.eventNames.find(iter.first.second);
+    if (nameIter != data.eventNames.end())
+      stats.event = nameIter->second;
+
+    result.push_back(stats);
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+void EventProfiler::Reset()
+{
+  ProfilerData &data = Data();
+  std::lock_guard<std::mutex> lock(data.mutex);
+  data.accumulators.clear();
+}
+
+//////////////////////////////////////////////////
+EventProfiler::OwnerScope::OwnerScope(const std::string &_filename,
+    const std::string &_name, const std::string &_scope)
+  : previous(g_currentOwner)
+{
+  ProfilerData &data = Data();
+  std::lock_guard<std::mutex> lock(data.mutex);
+
+  // Reuse the id if this owner was seen before, e.g. when a model is
+  // respawned with the same name.
+  for (size_t i = 0; i < data.owners.size(); ++i)
+  {
+    const Owner &owner = data.owners[i];
+    if (owner.filename == _filename && owner.name == _name &&
+        owner.scope == _scope)
+    {
+      g_currentOwner = static_cast<int>(i);
+      return;
+    }
+  }
+
+  data.owners.push_back({_filename, _name, _scope});
+  g_currentOwner = static_cast<int>(data.owners.size() - 1);
+}
+
+//////////////////////////////////////////////////
+EventProfiler::OwnerScope::~OwnerScope()
+{
+  g_currentOwner = this->previous;
+}
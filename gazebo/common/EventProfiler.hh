@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_EVENTPROFILER_HH_
+#define GAZEBO_COMMON_EVENTPROFILER_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace event
+  {
+    class Event;
+
+    /// \addtogroup gazebo_event Events
+    /// \{
+
+    /// \brief Timing statistics of one owner's subscriber on one event.
+    struct EventTimingStats
+    {
+      /// \brief Filename of the plugin that owns the subscriber.
+      std::string filename;
+
+      /// \brief Name of the plugin that owns the subscriber.
+      std::string name;
+
+      /// \brief Scoped name of the entity the plugin is attached to.
+      std::string scope;
+
+      /// \brief Name of the event, empty if the event was not named.
+      std::string event;
+
+      /// \brief Number of steps in which the subscriber was called.
+      uint64_t steps = 0;
+
+      /// \brief Total time spent in the subscriber, in seconds.
+      double total = 0;
+
+      /// \brief Longest time spent in the subscriber during a single step,
+      /// in seconds.
+      double max = 0;
+
+      /// \brief Histogram of per-step time. Bucket i counts steps that
+      /// took less than 2^i microseconds (and at least 2^(i-1) for i > 0).
+      /// The last bucket also counts all longer steps.
+      std::vector<uint64_t> histogram;
+    };
+
+    /// \class EventProfiler EventProfiler.hh common/common.hh
+    /// \brief Opt-in timing of event subscriber callbacks.
+    ///
+    /// Connections created while an owner is pushed with
+    /// EventProfiler::OwnerScope are tagged with that owner. When profiling
+    /// is enabled, EventT times each tagged callback and the time is
+    /// accumulated per owner and event. EndStep() folds the accumulated
+    /// time into per-step histograms. When profiling is disabled, the only
+    /// cost is one flag check per signal.
+    class GZ_COMMON_VISIBLE EventProfiler
+    {
+      /// \brief Number of histogram buckets.
+      public: static const unsigned int histogramBuckets = 20;
+
+      /// \brief Enable or disable profiling.
+      /// \param[in] _enable True to enable profiling.
+      public: static void SetEnabled(const bool _enable);
+
+      /// \brief Get whether profiling is enabled.
+      /// \return True if profiling is enabled.
+      public: static bool Enabled();
+
+      /// \brief Set a human readable name for an event.
+      /// \param[in] _event The event.
+      /// \param[in] _name Name reported in the statistics.
+      public: static void SetEventName(const Event *_event,
+                  const std::string &_name);
+
+      /// \brief Get the id of the owner that is currently loading on this
+      /// thread.
+      /// \return Owner id, or -1 if no owner is active.
+      public: static int CurrentOwner();
+
+      /// \brief Add a time measurement.
+      /// \param[in] _owner Owner id.
+      /// \param[in] _event The event that was signaled.
+      /// \param[in] _seconds Time spent in the callback.
+      public: static void Record(const int _owner, const Event *_event,
+                  const double _seconds);
+
+      /// \brief Close the current step: per-step totals are added to the
+      /// histograms and reset.
+      public: static void EndStep();
+
+      /// \brief Get the statistics accumulated since profiling was enabled.
+      /// \return Statistics per owner and event.
+      public: static std::vector<EventTimingStats> Stats();
+
+      /// \brief Clear all accumulated statistics. Owners are kept.
+      public: static void Reset();
+
+      /// \brief Tags all connections created on this thread during its
+      /// lifetime with an owner, typically a plugin being loaded.
+      public: class GZ_COMMON_VISIBLE OwnerScope
+      {
+        /// \brief Constructor
+        /// \param[in] _filename Plugin filename.
+        /// \param[in] _name Plugin name.
+        /// \param[in] _scope Scoped name of the entity the plugin is
+        /// attached to, used to tell apart instances of the same plugin.
+        public: OwnerScope(const std::string &_filename,
+                    const std::string &_name, const std::string &_scope);
+
+        /// \brief Destructor, restores the previous owner.
+        public: ~OwnerScope();
+
+        /// \brief Owner that was active before this scope.
+        private: int previous;
+      };
+
+      /// \brief Times a single callback invocation. Does nothing unless
+      /// enabled and the callback has an owner.
+      public: class CallScope
+      {
+        /// \brief Constructor
+        /// \param[in] _enabled Whether profiling is enabled.
+        /// \param[in] _owner Owner of the callback.
+        /// \param[in] _event Event being signaled.
+        public: CallScope(const bool _enabled, const int _owner,
+                    const Event *_event)
+                : owner(_enabled ? _owner : -1), event(_event)
+        {
+          if (this->owner >= 0)
+            this->start = std::chrono::steady_clock::now();
+        }
+
+        /// \brief Destructor, records the elapsed time.
+        public: ~CallScope()
+        {
+          if (this->owner >= 0)
+          {
+            EventProfiler::Record(this->owner, this->event,
+                std::chrono::duration<double>(
+                  std::chrono::steady_clock::now() - this->start).count());
+          }
+        }
+
+        /// \brief Owner of the callback, -1 if not timed.
+        private: int owner;
+
+        /// \brief Event being signaled.
+        private: const Event *event;
+
+        /// \brief Time at which the callback started.
+        private: std::chrono::steady_clock::time_point start;
+      };
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include <gazebo/common/Event.hh>
+#include <gazebo/common/EventProfiler.hh>
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class EventProfilerTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(EventProfilerTest, OwnerScope)
+{
+  EXPECT_EQ(-1, event::EventProfiler::CurrentOwner());
+  {
+    event::EventProfiler::OwnerScope outer("libouter.so", "outer", "world");
+    const int outerId = event::EventProfiler::CurrentOwner();
+    EXPECT_GE(outerId, 0);
+    {
+      event::EventProfiler::OwnerScope inner("libinner.so", "inner", "world");
+      EXPECT_NE(outerId, event::EventProfiler::CurrentOwner());
+    }
+    EXPECT_EQ(outerId, event::EventProfiler::CurrentOwner());
+
+    // Same owner gets the same id
+    event::EventProfiler::OwnerScope again("libouter.so", "outer", "world");
+    EXPECT_EQ(outerId, event::EventProfiler::CurrentOwner());
+  }
+  EXPECT_EQ(-1, event::EventProfiler::CurrentOwner());
+}
+
+/////////////////////////////////////////////////
+TEST_F(EventProfilerTest, Timing)
+{
+  event::EventT<void ()> evt;
+  event::EventProfiler::SetEventName(&evt, "testEvent");
+
+  int ownedCalls = 0;
+  int anonymousCalls = 0;
+
+  event::ConnectionPtr owned;
+  {
+    event::EventProfiler::OwnerScope scope("libslow.so", "slow", "model");
+    owned = evt.Connect([&ownedCalls]()
+        {
+          ++ownedCalls;
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        });
+  }
+  event::ConnectionPtr anonymous = evt.Connect(
+      [&anonymousCalls]() {++anonymousCalls;});
+
+  // Disabled: nothing is recorded
+  evt();
+  event::EventProfiler::EndStep();
+  EXPECT_TRUE(event::EventProfiler::Stats().empty());
+
+  event::EventProfiler::SetEnabled(true);
+  EXPECT_TRUE(event::EventProfiler::Enabled());
+
+  // Two steps, the second one signals twice
+  evt();
+  event::EventProfiler::EndStep();
+  evt();
+  evt();
+  event::EventProfiler::EndStep();
+
+  event::EventProfiler::SetEnabled(false);
+
+  EXPECT_EQ(4, ownedCalls);
+  EXPECT_EQ(4, anonymousCalls);
+
+  auto stats = event::EventProfiler::Stats();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ("libslow.so", stats[0].filename);
+  EXPECT_EQ("slow", stats[0].name);
+  EXPECT_EQ("model", stats[0].scope);
+  EXPECT_EQ("testEvent", stats[0].event);
+  EXPECT_EQ(2u, stats[0].steps);
+  EXPECT_GE(stats[0].total, 0.006);
+  EXPECT_GE(stats[0].max, 0.004);
+  ASSERT_EQ(event::EventProfiler::histogramBuckets,
+      stats[0].histogram.size());
+
+  uint64_t histogramSteps = 0;
+  for (auto const &count : stats[0].histogram)
+    histogramSteps += count;
+  EXPECT_EQ(2u, histogramSteps);
+
+  event::EventProfiler::Reset();
+  EXPECT_TRUE(event::EventProfiler::Stats().empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,409 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/MappedHeightfield.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Identifies a height field file and its format version.
+  const char fileMagic[8] = {'G', 'Z', 'H', 'F', 'L', 'D', '0', '1'};
+
+  /// \brief Heights start at a multiple of this offset in the file, so
+  /// that the mapping of the heights is page aligned.
+  const uint64_t dataAlignment = 4096;
+
+  /// \brief Fixed size header at the start of a height field file. It is
+  /// followed by the attributes, the tile minimums, the tile maximums and,
+  /// at dataOffset, the heights.
+  struct FileHeader
+  {
+    /// \brief Must be fileMagic.
+    char magic[8];
+
+    /// \brief Key given to Write.
+    uint64_t key;
+
+    /// \brief Number of vertices per side.
+    uint32_t size;
+
+    /// \brief Number of vertices per tile side.
+    uint32_t tileSize;
+
+    /// \brief Number of tiles per side.
+    uint32_t tileCount;
+
+    /// \brief Number of attributes.
+    uint32_t attributeCount;
+
+    /// \brief Offset of the heights from the start of the file.
+    uint64_t dataOffset;
+  };
+}
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \internal
+    /// \brief Private data for MappedHeightfield.
+    class MappedHeightfieldPrivate
+    {
+      /// \brief Start of the mapping.
+      public: void *mapping = nullptr;
+
+      /// \brief Length of the mapping in bytes.
+      public: size_t length = 0;
+
+      /// \brief Number of vertices per side.
+      public: unsigned int size = 0;
+
+      /// \brief Number of vertices per tile side.
+      public: unsigned int tileSize = 0;
+
+      /// \brief Number of tiles per side.
+      public: unsigned int tileCount = 0;
+
+      /// \brief Row-major heights, inside the mapping.
+      public: const float *data = nullptr;
+
+      /// \brief Minimum height of each tile, inside the mapping.
+      public: const float *tileMin = nullptr;
+
+      /// \brief Maximum height of each tile, inside the mapping.
+      public: const float *tileMax = nullptr;
+
+      /// \brief Minimum height of the grid.
+      public: float minHeight = 0;
+
+      /// \brief Maximum height of the grid.
+      public: float maxHeight = 0;
+
+      /// \brief Attributes stored with the heights.
+      public: std::vector<double> attributes;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+MappedHeightfield::MappedHeightfield()
+  : dataPtr(new MappedHeightfieldPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+MappedHeightfield::~MappedHeightfield()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool MappedHeightfield::Write(const std::string &_filename,
+    const uint64_t _key, const std::vector<float> &_heights,
+    const unsigned int _size, const unsigned int _tileSize,
+    const std::vector<double> &_attributes)
+{
+  if (_size == 0 || _tileSize == 0 ||
+      _heights.size() != static_cast<size_t>(_size) * _size)
+  {
+    gzerr << "Invalid height field size [" << _size << "] with ["
+          << _heights.size() << "] heights\n";
+    return false;
+  }
+
+  FileHeader header;
+  std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+  header.key = _key;
+  header.size = _size;
+  header.tileSize = _tileSize;
+  header.tileCount = (_size + _tileSize - 1) / _tileSize;
+  header.attributeCount = static_cast<uint32_t>(_attributes.size());
+
+  // Tile bounds
+  const size_t tiles = static_cast<size_t>(header.tileCount) *
+      header.tileCount;
+  std::vector<float> tileMin(tiles, std::numeric_limits<float>::max());
+  std::vector<float> tileMax(tiles, -std::numeric_limits<float>::max());
+  for (unsigned int y = 0; y < _size; ++y)
+  {
+    const float *row = _heights.data() + static_cast<size_t>(y) * _size;
+    const size_t tileRow = static_cast<size_t>(y / _tileSize) *
+        header.tileCount;
+    for (unsigned int x = 0; x < _size; ++x)
+    {
+      const size_t tile = tileRow + x / _tileSize;
+      tileMin[tile] = std::min(tileMin[tile], row[x]);
+      tileMax[tile] = std::max(tileMax[tile], row[x]);
+    }
+  }
+
+  const uint64_t headerEnd = sizeof(FileHeader) +
+      _attributes.size() * sizeof(double) + 2 * tiles * sizeof(float);
+  header.dataOffset = (headerEnd + dataAlignment - 1) / dataAlignment *
+      dataAlignment;
+
+  const std::string tmpFilename = _filename + ".tmp";
+  {
+    std::ofstream out(tmpFilename, std::ios::out | std::ios::binary |
+        std::ios::trunc);
+    if (!out)
+    {
+      gzerr << "Unable to write height field [" << tmpFilename << "]\n";
+      return false;
+    }
+
+    const std::vector<char> padding(header.dataOffset - headerEnd, 0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(_attributes.data()),
+        _attributes.size() * sizeof(double));
+    out.write(reinterpret_cast<const char *>(tileMin.data()),
+        tiles * sizeof(float));
+    out.write(reinterpret_cast<const char *>(tileMax.data()),
+        tiles * sizeof(float));
+    out.write(padding.data(), padding.size());
+    out.write(reinterpret_cast<const char *>(_heights.data()),
+        _heights.size() * sizeof(float));
+
+    if (!out)
+    {
+      gzerr << "Unable to write height field [" << tmpFilename << "]\n";
+      out.close();
+      std::remove(tmpFilename.c_str());
+      return false;
+    }
+  }
+
+  if (std::rename(tmpFilename.c_str(), _filename.c_str()) != 0)
+  {
+    gzerr << "Unable to rename height field [" << tmpFilename << "] to ["
+          << _filename << "]\n";
+    std::remove(tmpFilename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool MappedHeightfield::Open(const std::string &_filename,
+    const uint64_t _key)
+{
+  this->Close();
+
+#ifdef _WIN32
+  (void)_filename;
+  (void)_key;
+  return false;
+#else
+  int fd = open(_filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<uint64_t>(st.st_size) < sizeof(FileHeader))
+  {
+    close(fd);
+    return false;
+  }
+
+  const size_t length = static_cast<size_t>(st.st_size);
+  void *mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    gzerr << "Unable to map height field [" << _filename << "]: "
+          << std::strerror(errno) << "\n";
+    return false;
+  }
+
+  const char *base = static_cast<const char *>(mapping);
+  FileHeader header;
+  std::memcpy(&header, base, sizeof(header));
+
+  const uint64_t tiles = static_cast<uint64_t>(header.tileCount) *
+      header.tileCount;
+  const uint64_t headerEnd = sizeof(FileHeader) +
+      header.attributeCount * sizeof(double) + 2 * tiles * sizeof(float);
+  const uint64_t dataEnd = header.dataOffset +
+      static_cast<uint64_t>(header.size) * header.size * sizeof(float);
+
+  if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 ||
+      header.key != _key || header.size == 0 || header.tileSize == 0 ||
+      header.tileCount != (header.size + header.tileSize - 1) /
+          header.tileSize ||
+      header.dataOffset < headerEnd || header.dataOffset % dataAlignment ||
+      dataEnd > length)
+  {
+    munmap(mapping, length);
+    return false;
+  }
+
+  this->dataPtr->mapping = mapping;
+  this->dataPtr->length = length;
+  this->dataPtr->size = header.size;
+  this->dataPtr->tileSize = header.tileSize;
+  this->dataPtr->tileCount = header.tileCount;
+
+  const char *ptr = base + sizeof(FileHeader);
+  this->dataPtr->attributes.resize(header.attributeCount);
+  std::memcpy(this->dataPtr->attributes.data(), ptr,
+      header.attributeCount * sizeof(double));
+  ptr += header.attributeCount * sizeof(double);
+
+  this->dataPtr->tileMin = reinterpret_cast<const float *>(ptr);
+  this->dataPtr->tileMax = this->dataPtr->tileMin + tiles;
+  this->dataPtr->data = reinterpret_cast<const float *>(
+      base + header.dataOffset);
+
+  this->dataPtr->minHeight = *std::min_element(this->dataPtr->tileMin,
+      this->dataPtr->tileMin + tiles);
+  this->dataPtr->maxHeight = *std::max_element(this->dataPtr->tileMax,
+      this->dataPtr->tileMax + tiles);
+
+  // Collision queries read small regions of the grid; don't read ahead.
+  madvise(const_cast<char *>(base) + header.dataOffset,
+      length - header.dataOffset, MADV_RANDOM);
+
+  return true;
+#endif
+}
+
+//////////////////////////////////////////////////
+void MappedHeightfield::Close()
+{
+#ifndef _WIN32
+  if (this->dataPtr->mapping)
+    munmap(this->dataPtr->mapping, this->dataPtr->length);
+#endif
+
+  this->dataPtr->mapping = nullptr;
+  this->dataPtr->length = 0;
+  this->dataPtr->size = 0;
+  this->dataPtr->tileSize = 0;
+  this->dataPtr->tileCount = 0;
+  this->dataPtr->data = nullptr;
+  this->dataPtr->tileMin = nullptr;
+  this->dataPtr->tileMax = nullptr;
+  this->dataPtr->minHeight = 0;
+  this->dataPtr->maxHeight = 0;
+  this->dataPtr->attributes.clear();
+}
+
+//////////////////////////////////////////////////
+bool MappedHeightfield::Valid() const
+{
+  return this->dataPtr->data != nullptr;
+}
+
+//////////////////////////////////////////////////
+unsigned int MappedHeightfield::Size() const
+{
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+const float *MappedHeightfield::Data() const
+{
+  return this->dataPtr->data;
+}
+
+//////////////////////////////////////////////////
+float MappedHeightfield::Height(const unsigned int _x,
+    const unsigned int _y) const
+{
+  if (_x >= this->dataPtr->size || _y >= this->dataPtr->size)
+    return 0;
+
+  return this->dataPtr->data[static_cast<size_t>(_y) * this->dataPtr->size +
+      _x];
+}
+
+//////////////////////////////////////////////////
+unsigned int MappedHeightfield::TileSize() const
+{
+  return this->dataPtr->tileSize;
+}
+
+//////////////////////////////////////////////////
+unsigned int MappedHeightfield::TileCount() const
+{
+  return this->dataPtr->tileCount;
+}
+
+//////////////////////////////////////////////////
+float MappedHeightfield::MinHeight() const
+{
+  return this->dataPtr->minHeight;
+}
+
+//////////////////////////////////////////////////
+float MappedHeightfield::MaxHeight() const
+{
+  return this->dataPtr->maxHeight;
+}
+
+//////////////////////////////////////////////////
+bool MappedHeightfield::HeightRange(unsigned int _x0, unsigned int _y0,
+    unsigned int _x1, unsigned int _y1, float &_min, float &_max) const
+{
+  if (!this->Valid() || _x0 > _x1 || _y0 > _y1 ||
+      _x0 >= this->dataPtr->size || _y0 >= this->dataPtr->size)
+  {
+    return false;
+  }
+
+  _x1 = std::min(_x1, this->dataPtr->size - 1);
+  _y1 = std::min(_y1, this->dataPtr->size - 1);
+
+  const unsigned int tileSize = this->dataPtr->tileSize;
+  _min = std::numeric_limits<float>::max();
+  _max = -std::numeric_limits<float>::max();
+  for (unsigned int ty = _y0 / tileSize; ty <= _y1 / tileSize; ++ty)
+  {
+    const size_t row = static_cast<size_t>(ty) * this->dataPtr->tileCount;
+    for (unsigned int tx = _x0 / tileSize; tx <= _x1 / tileSize; ++tx)
+    {
+      _min = std::min(_min, this->dataPtr->tileMin[row + tx]);
+      _max = std::max(_max, this->dataPtr->tileMax[row + tx]);
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &MappedHeightfield::Attributes() const
+{
+  return this->dataPtr->attributes;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MAPPEDHEIGHTFIELD_HH_
+#define GAZEBO_COMMON_MAPPEDHEIGHTFIELD_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class MappedHeightfieldPrivate;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MappedHeightfield MappedHeightfield.hh common/common.hh
+    /// \brief A square grid of heights stored in a file and memory-mapped
+    /// read-only.
+    ///
+    /// Heights are kept in row-major order so that physics engines can
+    /// use the mapping directly as their height field. Only the pages that
+    /// are read, typically the ones below bodies in contact with the
+    /// terrain, are loaded by the operating system. The grid is also split
+    /// into square tiles whose minimum and maximum heights are stored in the
+    /// file, which gives cheap height bounds for any region.
+    ///
+    /// Memory mapping is not supported on Windows, where Open always fails.
+    class GZ_COMMON_VISIBLE MappedHeightfield
+    {
+      /// \brief Constructor
+      public: MappedHeightfield();
+
+      /// \brief Destructor
+      public: virtual ~MappedHeightfield();
+
+      /// \brief Write a height field file.
+      /// \param[in] _filename Path of the file. The file is written next to
+      /// it and renamed, so readers never see a partial file.
+      /// \param[in] _key Key identifying the source of the heights, checked
+      /// by Open.
+      /// \param[in] _heights Row-major heights, _size * _size values.
+      /// \param[in] _size Number of vertices per side.
+      /// \param[in] _tileSize Number of vertices per tile side.
+      /// \param[in] _attributes Extra values stored in the file, such as
+      /// the size of the terrain the heights were generated for.
+      /// \return True if the file was written.
+      public: static bool Write(const std::string &_filename,
+                  const uint64_t _key, const std::vector<float> &_heights,
+                  const unsigned int _size, const unsigned int _tileSize,
+                  const std::vector<double> &_attributes);
+
+      /// \brief Map a height field file.
+      /// \param[in] _filename Path of the file.
+      /// \param[in] _key Expected key, see Write.
+      /// \return False if the file does not exist, is invalid or was written
+      /// with a different key.
+      public: bool Open(const std::string &_filename, const uint64_t _key);
+
+      /// \brief Unmap the file.
+      public: void Close();
+
+      /// \brief Get whether a file is mapped.
+      /// \return True if a file is mapped.
+      public: bool Valid() const;
+
+      /// \brief Get the number of vertices per side.
+      /// \return Number of vertices per side, 0 if not mapped.
+      public: unsigned int Size() const;
+
+      /// \brief Get the row-major heights.
+      /// \return Pointer to Size() * Size() heights, null if not mapped.
+      public: const float *Data() const;
+
+      /// \brief Get the height of a vertex.
+      /// \param[in] _x Column of the vertex.
+      /// \param[in] _y Row of the vertex.
+      /// \return Height, or 0 if the vertex is out of bounds.
+      public: float Height(const unsigned int _x, const unsigned int _y) const;
+
+      /// \brief Get the number of vertices per tile side.
+      /// \return Tile size.
+      public: unsigned int TileSize() const;
+
+      /// \brief Get the number of tiles per side.
+      /// \return Number of tiles per side.
+      public: unsigned int TileCount() const;
+
+      /// \brief Get the minimum height of the whole grid.
+      /// \return Minimum height.
+      public: float MinHeight() const;
+
+      /// \brief Get the maximum height of the whole grid.
+      /// \return Maximum height.
+      public: float MaxHeight() const;
+
+      /// \brief Get bounds of the heights in a region from the tiles that
+      /// overlap it, without reading any height. The bounds are
+      /// conservative: they may be wider than the actual heights.
+      /// \param[in] _x0 First column of the region.
+      /// \param[in] _y0 First row of the region.
+      /// \param[in] _x1 Last column of the region, inclusive.
+      /// \param[in] _y1 Last row of the region, inclusive.
+      /// \param[out] _min Lower bound of the heights.
+      /// \param[out] _max Upper bound of the heights.
+      /// \return False if not mapped or the region is empty.
+      public: bool HeightRange(unsigned int _x0, unsigned int _y0,
+                  unsigned int _x1, unsigned int _y1,
+                  float &_min, float &_max) const;
+
+      /// \brief Get the extra values stored with Write.
+      /// \return Attributes.
+      public: const std::vector<double> &Attributes() const;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<MappedHeightfieldPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/MappedHeightfield.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MappedHeightfieldTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Create a temporary file name.
+  protected: virtual void SetUp()
+  {
+    gazebo::testing::AutoLogFixture::SetUp();
+    this->filename = (boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("heightfield-%%%%-%%%%")).string();
+  }
+
+  /// \brief Remove the temporary file.
+  protected: virtual void TearDown()
+  {
+    boost::filesystem::remove(this->filename);
+    gazebo::testing::AutoLogFixture::TearDown();
+  }
+
+  /// \brief Temporary file name.
+  public: std::string filename;
+};
+
+/////////////////////////////////////////////////
+TEST_F(MappedHeightfieldTest, Invalid)
+{
+  common::MappedHeightfield field;
+  EXPECT_FALSE(field.Valid());
+  EXPECT_EQ(field.Size(), 0u);
+  EXPECT_TRUE(field.Data() == nullptr);
+
+  float min, max;
+  EXPECT_FALSE(field.HeightRange(0, 0, 1, 1, min, max));
+
+  // Missing file
+  EXPECT_FALSE(field.Open(this->filename, 1));
+
+  // Wrong number of heights
+  std::vector<float> heights(10, 0);
+  EXPECT_FALSE(common::MappedHeightfield::Write(this->filename, 1, heights,
+      4, 2, {}));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MappedHeightfieldTest, WriteOpen)
+{
+  // 5x5 grid with tiles of 2x2, so the last row and column of tiles are
+  // partial. The height of a vertex is x + 10 * y.
+  const unsigned int size = 5;
+  std::vector<float> heights(size * size);
+  for (unsigned int y = 0; y < size; ++y)
+    for (unsigned int x = 0; x < size; ++x)
+      heights[y * size + x] = x + 10.0f * y;
+
+  std::vector<double> attributes = {1.5, -2.0, 3.25};
+  ASSERT_TRUE(common::MappedHeightfield::Write(this->filename, 42, heights,
+      size, 2, attributes));
+
+  common::MappedHeightfield field;
+
+  // Wrong key
+  EXPECT_FALSE(field.Open(this->filename, 41));
+  EXPECT_FALSE(field.Valid());
+
+  ASSERT_TRUE(field.Open(this->filename, 42));
+  EXPECT_TRUE(field.Valid());
+  EXPECT_EQ(field.Size(), size);
+  EXPECT_EQ(field.TileSize(), 2u);
+  EXPECT_EQ(field.TileCount(), 3u);
+  EXPECT_EQ(field.Attributes(), attributes);
+  EXPECT_FLOAT_EQ(field.MinHeight(), 0);
+  EXPECT_FLOAT_EQ(field.MaxHeight(), 44);
+
+  // The mapping holds the heights in row-major order
+  ASSERT_TRUE(field.Data() != nullptr);
+  for (unsigned int i = 0; i < heights.size(); ++i)
+    EXPECT_FLOAT_EQ(field.Data()[i], heights[i]);
+
+  EXPECT_FLOAT_EQ(field.Height(3, 2), 23);
+  EXPECT_FLOAT_EQ(field.Height(5, 0), 0);
+  EXPECT_FLOAT_EQ(field.Height(0, 5), 0);
+
+  // Bounds come from the overlapping tiles
+  float min, max;
+  EXPECT_TRUE(field.HeightRange(0, 0, 0, 0, min, max));
+  EXPECT_FLOAT_EQ(min, 0);
+  EXPECT_FLOAT_EQ(max, 11);
+
+  EXPECT_TRUE(field.HeightRange(3, 2, 4, 4, min, max));
+  EXPECT_FLOAT_EQ(min, 22);
+  EXPECT_FLOAT_EQ(max, 44);
+
+  // The region is clamped to the grid
+  EXPECT_TRUE(field.HeightRange(4, 4, 100, 100, min, max));
+  EXPECT_FLOAT_EQ(min, 44);
+  EXPECT_FLOAT_EQ(max, 44);
+
+  EXPECT_FALSE(field.HeightRange(2, 0, 1, 0, min, max));
+  EXPECT_FALSE(field.HeightRange(5, 0, 6, 0, min, max));
+
+  field.Close();
+  EXPECT_FALSE(field.Valid());
+  EXPECT_TRUE(field.Attributes().empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
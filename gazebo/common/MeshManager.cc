@@ -18,6 +18,10 @@
 #include <sys/stat.h>
 #include <string>
 #include <map>
+#include <memory>
+#include <set>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Exception.hh"
@@ -43,41 +47,50 @@ namespace common
 //////////////////////////////////////////////////
 class MeshManagerPrivate
 {
-  /// \brief 3D mesh loader for COLLADA files
-  public: ColladaLoader *colladaLoader = nullptr;
-
   /// \brief 3D mesh exporter for COLLADA files
   public: ColladaExporter *colladaExporter = nullptr;
 
-  /// \brief 3D mesh loader for STL files
-  public: STLLoader *stlLoader = nullptr;
-
-  // \brief 3D mesh loader for FBX files
-  // \todo The FBX loader needs to be implemented.
-  // public: FBXLoader *fbxLoader = nullptr;
-
   /// \brief Dictionary of meshes, indexed by name
   public: std::map<std::string, Mesh*> meshes;
 
   /// \brief supported file extensions for meshes
   public: std::vector<std::string> fileExtensions;
 
-  /// \brief Mutex to protect from loading the same mesh in different threads
-  /// at the same time.
-  public: boost::mutex mutex;
-};
+  /// \brief Mutex to protect the dictionary of meshes while meshes are
+  /// loaded from other threads, e.g. by physics::FactoryPipeline.
+  public: boost::recursive_mutex mutex;
+
+  /// \brief Names of the meshes which are being loaded.
+  public: std::set<std::string> loading;
 
-// added here for ABI compatibility
-// TODO move to header / private class when merging forward.
-static OBJLoader objLoader;
+  /// \brief Notified when a mesh has finished loading, so that threads
+  /// loading the same mesh can use it.
+  public: boost::condition_variable_any loadingCond;
+
+  /// \brief Add a loaded mesh to the dictionary and wake up the threads
+  /// waiting for it.
+  /// \param[in] _filename Name of the mesh.
+  /// \param[in] _mesh The mesh, or nullptr if loading failed.
+  public: void FinishLoad(const std::string &_filename, Mesh *_mesh)
+  {
+    {
+      boost::recursive_mutex::scoped_lock lock(this->mutex);
+      if (_mesh)
+      {
+        _mesh->SetName(_filename);
+        this->meshes.insert(std::make_pair(_filename, _mesh));
+      }
+      this->loading.erase(_filename);
+    }
+    this->loadingCond.notify_all();
+  }
+};
 
 //////////////////////////////////////////////////
 MeshManager::MeshManager()
   : dataPtr(new MeshManagerPrivate)
 {
-  this->dataPtr->colladaLoader = new ColladaLoader();
   this->dataPtr->colladaExporter = new ColladaExporter();
-  this->dataPtr->stlLoader = new STLLoader();
 
   // Create some basic shapes
   this->CreatePlane("unit_plane",
@@ -116,9 +129,7 @@ MeshManager::MeshManager()
 //////////////////////////////////////////////////
 MeshManager::~MeshManager()
 {
-  delete this->dataPtr->colladaLoader;
   delete this->dataPtr->colladaExporter;
-  delete this->dataPtr->stlLoader;
   for (auto &pairNameMesh : this->dataPtr->meshes)
   {
     delete pairNameMesh.second;
@@ -138,13 +149,18 @@ const Mesh *MeshManager::Load(const std::string &_filename)
     return nullptr;
   }
 
-  Mesh *mesh = nullptr;
+  {
+    boost::recursive_mutex::scoped_lock lock(this->dataPtr->mutex);
 
-  std::string extension;
+    // Wait for another thread that is loading the same mesh.
+    this->dataPtr->loadingCond.wait(lock, [&]
+        {
+          return this->dataPtr->loading.count(_filename) == 0;
+        });
 
-  if (this->HasMesh(_filename))
-  {
-    return this->dataPtr->meshes[_filename];
+    auto iter = this->dataPtr->meshes.find(_filename);
+    if (iter != this->dataPtr->meshes.end())
+      return iter->second;
 
     // This breaks trimesh geom. Each new trimesh should have a unique name.
     /*
@@ -157,59 +173,55 @@ const Mesh *MeshManager::Load(const std::string &_filename)
     iter->second = nullptr;
     this->dataPtr->meshes.erase(iter);
     */
+
+    this->dataPtr->loading.insert(_filename);
   }
 
+  // The mesh is parsed without holding the mutex, so that lookups of other
+  // meshes aren't blocked. Each load uses its own loader, because the
+  // loaders keep state while parsing.
+  Mesh *mesh = nullptr;
   std::string fullname = common::find_file(_filename);
 
-  if (!fullname.empty())
+  try
   {
-    extension = fullname.substr(fullname.rfind(".")+1, fullname.size());
-    std::transform(extension.begin(), extension.end(),
-        extension.begin(), ::tolower);
-    MeshLoader *loader = nullptr;
-
-    if (extension == "stl" || extension == "stlb" || extension == "stla")
-      loader = this->dataPtr->stlLoader;
-    else if (extension == "dae")
-      loader = this->dataPtr->colladaLoader;
-    else if (extension == "obj")
-      loader = &objLoader;
-    else
+    if (!fullname.empty())
     {
-      gzerr << "Unsupported mesh format for file[" << _filename << "]\n";
-      return nullptr;
-    }
-
-    try
-    {
-      // This mutex prevents two threads from loading the same mesh at the
-      // same time.
-      boost::mutex::scoped_lock lock(this->dataPtr->mutex);
-      if (!this->HasMesh(_filename))
-      {
-        if ((mesh = loader->Load(fullname)) != nullptr)
-        {
-          mesh->SetName(_filename);
-          this->dataPtr->meshes.insert(std::make_pair(_filename, mesh));
-        }
-        else
-          gzerr << "Unable to load mesh[" << fullname << "]\n";
-      }
+      std::string extension =
+        fullname.substr(fullname.rfind(".")+1, fullname.size());
+      std::transform(extension.begin(), extension.end(),
+          extension.begin(), ::tolower);
+      std::unique_ptr<MeshLoader> loader;
+
+      if (extension == "stl" || extension == "stlb" || extension == "stla")
+        loader.reset(new STLLoader());
+      else if (extension == "dae")
+        loader.reset(new ColladaLoader());
+      else if (extension == "obj")
+        loader.reset(new OBJLoader());
       else
-      {
-        mesh = this->dataPtr->meshes[_filename];
-      }
-    }
-    catch(gazebo::common::Exception &e)
-    {
-      gzerr << "Error loading mesh[" << fullname << "]\n";
-      gzerr << e << "\n";
-      gzthrow(e);
+        gzerr << "Unsupported mesh format for file[" << _filename << "]\n";
+
+      if (loader && (mesh = loader->Load(fullname)) == nullptr)
+        gzerr << "Unable to load mesh[" << fullname << "]\n";
     }
+    else
+      gzerr << "Unable to find file[" << _filename << "]\n";
+  }
+  catch(gazebo::common::Exception &e)
+  {
+    this->dataPtr->FinishLoad(_filename, nullptr);
+    gzerr << "Error loading mesh[" << fullname << "]\n";
+    gzerr << e << "\n";
+    gzthrow(e);
+  }
+  catch(...)
+  {
+    this->dataPtr->FinishLoad(_filename, nullptr);
+    throw;
   }
-  else
-    gzerr << "Unable to find file[" << _filename << "]\n";
 
+  this->dataPtr->FinishLoad(_filename, mesh);
   return mesh;
 }
 
@@ -264,6 +276,7 @@ void MeshManager::GenSphericalTexCoord(const Mesh *_mesh,
 //////////////////////////////////////////////////
 void MeshManager::AddMesh(Mesh *_mesh)
 {
+  boost::recursive_mutex::scoped_lock lock(this->dataPtr->mutex);
   if (!this->HasMesh(_mesh->GetName()))
     this->dataPtr->meshes[_mesh->GetName()] = _mesh;
 }
@@ -271,6 +284,7 @@ void MeshManager::AddMesh(Mesh *_mesh)
 //////////////////////////////////////////////////
 const Mesh *MeshManager::GetMesh(const std::string &_name) const
 {
+  boost::recursive_mutex::scoped_lock lock(this->dataPtr->mutex);
   std::map<std::string, Mesh*>::const_iterator iter;
 
   iter = this->dataPtr->meshes.find(_name);
@@ -287,6 +301,7 @@ bool MeshManager::HasMesh(const std::string &_name) const
   if (_name.empty())
     return false;
 
+  boost::recursive_mutex::scoped_lock lock(this->dataPtr->mutex);
   std::map<std::string, Mesh*>::const_iterator iter;
   iter = this->dataPtr->meshes.find(_name);
 
@@ -16,6 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "test_config.h"
 #include "gazebo/common/Mesh.hh"
@@ -266,6 +269,33 @@ TEST_F(MeshManager, CreateExtrudedPolylineInvalid)
   EXPECT_TRUE(!common::MeshManager::Instance()->HasMesh(meshName));
 }
 
+/////////////////////////////////////////////////
+TEST_F(MeshManager, LoadConcurrently)
+{
+  const std::string filename =
+      std::string(PROJECT_SOURCE_PATH) + "/test/data/box_offset.dae";
+  auto manager = common::MeshManager::Instance();
+
+  // Every thread gets the same mesh, which is only loaded once.
+  std::vector<const common::Mesh *> meshes(8, nullptr);
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < meshes.size(); ++i)
+  {
+    threads.push_back(std::thread([&, i]()
+        {
+          meshes[i] = manager->Load(filename);
+          EXPECT_TRUE(manager->HasMesh("unit_box"));
+        }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  ASSERT_NE(nullptr, meshes[0]);
+  for (auto const mesh : meshes)
+    EXPECT_EQ(meshes[0], mesh);
+  EXPECT_EQ(meshes[0], manager->GetMesh(filename));
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -14,7 +14,13 @@
  * limitations under the License.
  *
 */
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 #include <stdio.h>
 #include <gazebo/gazebo_config.h>
 
@@ -58,9 +64,57 @@ using namespace common;
 #define AV_ERROR_MAX_STRING_SIZE 64
 #endif
 
+/// \brief A frame waiting to be encoded.
+class QueuedFrame
+{
+  /// \brief RGB pixels of the frame.
+  public: std::vector<unsigned char> data;
+
+  /// \brief Width of the frame.
+  public: unsigned int width = 0;
+
+  /// \brief Height of the frame.
+  public: unsigned int height = 0;
+
+  /// \brief Time when the frame was added.
+  public: std::chrono::steady_clock::time_point added;
+};
+
 // Private data class
 class gazebo::common::VideoEncoderPrivate
 {
+#ifdef HAVE_FFMPEG
+  /// \brief Convert and encode a frame. The mutex must be locked.
+  /// \param[in] _frame RGB pixels of the frame.
+  /// \param[in] _width Width of the frame.
+  /// \param[in] _height Height of the frame.
+  /// \return True on success.
+  public: bool Encode(const unsigned char *_frame, const unsigned int _width,
+              const unsigned int _height);
+
+  /// \brief Copy a frame into a free buffer and queue it for the encoder
+  /// thread.
+  /// \param[in] _frame RGB pixels of the frame.
+  /// \param[in] _width Width of the frame.
+  /// \param[in] _height Height of the frame.
+  /// \param[in] _timestamp Timestamp of the frame.
+  /// \return True if the frame was queued.
+  public: bool Enqueue(const unsigned char *_frame, const unsigned int _width,
+              const unsigned int _height,
+              const std::chrono::steady_clock::time_point &_timestamp);
+
+  /// \brief Encoder thread loop.
+  public: void RunQueue();
+#endif
+
+  /// \brief Stop the encoder thread once all queued frames are encoded.
+  public: void StopQueue();
+
+  /// \brief Count an encoded frame.
+  /// \param[in] _added Time when the frame was added.
+  public: void RecordEncoded(
+              const std::chrono::steady_clock::time_point &_added);
+
   /// \brief Name of the file which stores the video while it is being
   ///        recorded.
   public: std::string filename;
@@ -115,6 +169,47 @@ class gazebo::common::VideoEncoderPrivate
 
   /// \brief Mutex for thread safety.
   public: std::mutex mutex;
+
+  /// \brief Maximum number of frames waiting to be encoded, zero to encode
+  /// on the caller's thread.
+  public: unsigned int queueSize = 0;
+
+  /// \brief True to drop frames when the queue is full, false to block.
+  public: bool dropWhenFull = true;
+
+  /// \brief True while the encoder thread runs.
+  public: std::atomic<bool> queueRunning{false};
+
+  /// \brief Encoder thread.
+  public: std::thread queueThread;
+
+  /// \brief Protects the queue, the buffer pool and the statistics.
+  public: mutable std::mutex queueMutex;
+
+  /// \brief Signaled when a frame is queued, a buffer is freed, or the
+  /// encoder thread has to stop.
+  public: std::condition_variable queueCondition;
+
+  /// \brief Frames waiting to be encoded, oldest first.
+  public: std::deque<std::unique_ptr<QueuedFrame>> queue;
+
+  /// \brief Free frame buffers, reused to avoid allocating per frame.
+  public: std::vector<std::unique_ptr<QueuedFrame>> pool;
+
+  /// \brief Number of frame buffers allocated for the queue.
+  public: unsigned int allocatedFrames = 0;
+
+  /// \brief True to stop the encoder thread.
+  public: bool stopQueue = false;
+
+  /// \brief Number of frames encoded since Start.
+  public: uint64_t encodedFrames = 0;
+
+  /// \brief Number of frames dropped since Start.
+  public: uint64_t droppedFrames = 0;
+
+  /// \brief Sum of the encode latencies since Start, in seconds.
+  public: double latencySum = 0;
 };
 
 /////////////////////////////////////////////////
@@ -496,7 +591,24 @@ bool VideoEncoder::Start(const std::string &_format,
     return false;
   }
 
+  unsigned int queueSize;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->queueMutex);
+    this->dataPtr->encodedFrames = 0;
+    this->dataPtr->droppedFrames = 0;
+    this->dataPtr->latencySum = 0;
+    this->dataPtr->stopQueue = false;
+    queueSize = this->dataPtr->queueSize;
+  }
+
   this->dataPtr->encoding = true;
+
+  if (queueSize > 0)
+  {
+    this->dataPtr->queueThread = std::thread(&VideoEncoderPrivate::RunQueue,
+        this->dataPtr.get());
+    this->dataPtr->queueRunning = true;
+  }
   return true;
 }
 // #else for HAVE_FFMPEG version check
@@ -538,6 +650,9 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
     const unsigned int _height,
     const std::chrono::steady_clock::time_point &_timestamp)
 {
+  if (this->dataPtr->queueRunning)
+    return this->dataPtr->Enqueue(_frame, _width, _height, _timestamp);
+
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   if (!this->dataPtr->encoding)
@@ -554,54 +669,161 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
 
   this->dataPtr->timePrev = _timestamp;
 
+  const auto added = std::chrono::steady_clock::now();
+  if (!this->dataPtr->Encode(_frame, _width, _height))
+    return false;
+
+  this->dataPtr->RecordEncoded(added);
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool VideoEncoderPrivate::Enqueue(const unsigned char *_frame,
+    const unsigned int _width, const unsigned int _height,
+    const std::chrono::steady_clock::time_point &_timestamp)
+{
+  const auto added = std::chrono::steady_clock::now();
+  std::unique_ptr<QueuedFrame> frame;
+  {
+    std::unique_lock<std::mutex> lock(this->queueMutex);
+    if (this->stopQueue)
+      return false;
+
+    // Skip frames that arrive faster than the video's fps
+    if (_timestamp - this->timePrev <
+        std::chrono::duration<double>(1.0/this->fps))
+    {
+      return false;
+    }
+    this->timePrev = _timestamp;
+
+    if (this->pool.empty() && this->allocatedFrames >= this->queueSize)
+    {
+      if (this->dropWhenFull)
+      {
+        ++this->droppedFrames;
+        return false;
+      }
+
+      this->queueCondition.wait(lock, [this]
+          {return this->stopQueue || !this->pool.empty();});
+      if (this->pool.empty())
+        return false;
+    }
+
+    if (this->pool.empty())
+    {
+      frame.reset(new QueuedFrame);
+      ++this->allocatedFrames;
+    }
+    else
+    {
+      frame = std::move(this->pool.back());
+      this->pool.pop_back();
+    }
+  }
+
+  // Copy outside the lock. The buffer keeps its capacity between frames.
+  frame->data.assign(_frame, _frame + _width * _height * 3);
+  frame->width = _width;
+  frame->height = _height;
+  frame->added = added;
+
+  {
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    this->queue.push_back(std::move(frame));
+  }
+  this->queueCondition.notify_all();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void VideoEncoderPrivate::RunQueue()
+{
+  while (true)
+  {
+    std::unique_ptr<QueuedFrame> frame;
+    {
+      std::unique_lock<std::mutex> lock(this->queueMutex);
+      this->queueCondition.wait(lock, [this]
+          {return this->stopQueue || !this->queue.empty();});
+
+      // Frames queued before stopping are still encoded
+      if (this->queue.empty())
+        return;
+
+      frame = std::move(this->queue.front());
+      this->queue.pop_front();
+    }
+
+    bool encoded;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      encoded = this->Encode(frame->data.data(), frame->width, frame->height);
+    }
+    if (encoded)
+      this->RecordEncoded(frame->added);
+
+    {
+      std::lock_guard<std::mutex> lock(this->queueMutex);
+      this->pool.push_back(std::move(frame));
+    }
+    this->queueCondition.notify_all();
+  }
+}
+
+/////////////////////////////////////////////////
+bool VideoEncoderPrivate::Encode(const unsigned char *_frame,
+    const unsigned int _width, const unsigned int _height)
+{
   // Cause the sws to be recreated on image resize
-  if (this->dataPtr->swsCtx &&
-      (this->dataPtr->inWidth != _width || this->dataPtr->inHeight != _height))
+  if (this->swsCtx &&
+      (this->inWidth != _width || this->inHeight != _height))
   {
-    sws_freeContext(this->dataPtr->swsCtx);
-    this->dataPtr->swsCtx = nullptr;
+    sws_freeContext(this->swsCtx);
+    this->swsCtx = nullptr;
 
-    if (this->dataPtr->avInFrame)
+    if (this->avInFrame)
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
-      av_free(this->dataPtr->avInFrame);
+      av_free(this->avInFrame);
 #else
-      av_frame_free(&this->dataPtr->avInFrame);
+      av_frame_free(&this->avInFrame);
 #endif
-    this->dataPtr->avInFrame = nullptr;
+    this->avInFrame = nullptr;
   }
 
-  if (!this->dataPtr->swsCtx)
+  if (!this->swsCtx)
   {
-    this->dataPtr->inWidth = _width;
-    this->dataPtr->inHeight = _height;
+    this->inWidth = _width;
+    this->inHeight = _height;
 
-    if (!this->dataPtr->avInFrame)
+    if (!this->avInFrame)
     {
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 24, 1)
-      this->dataPtr->avInFrame = new AVPicture;
-      avpicture_alloc(this->dataPtr->avInFrame,
-          AV_PIX_FMT_RGB24, this->dataPtr->inWidth,
-          this->dataPtr->inHeight);
+      this->avInFrame = new AVPicture;
+      avpicture_alloc(this->avInFrame,
+          AV_PIX_FMT_RGB24, this->inWidth,
+          this->inHeight);
 #else
-      this->dataPtr->avInFrame = av_frame_alloc();
+      this->avInFrame = av_frame_alloc();
 
-      av_image_alloc(this->dataPtr->avInFrame->data,
-          this->dataPtr->avInFrame->linesize,
-          this->dataPtr->inWidth, this->dataPtr->inHeight,
+      av_image_alloc(this->avInFrame->data,
+          this->avInFrame->linesize,
+          this->inWidth, this->inHeight,
           AV_PIX_FMT_RGB24, 1);
 #endif
     }
 
-    this->dataPtr->swsCtx = sws_getContext(
-        this->dataPtr->inWidth,
-        this->dataPtr->inHeight,
+    this->swsCtx = sws_getContext(
+        this->inWidth,
+        this->inHeight,
         AV_PIX_FMT_RGB24,
-        this->dataPtr->codecCtx->width,
-        this->dataPtr->codecCtx->height,
-        this->dataPtr->codecCtx->pix_fmt,
+        this->codecCtx->width,
+        this->codecCtx->height,
+        this->codecCtx->pix_fmt,
         SWS_BICUBIC, nullptr, nullptr, nullptr);
 
-    if (this->dataPtr->swsCtx == nullptr)
+    if (this->swsCtx == nullptr)
     {
       gzerr << "Error while calling sws_getContext\n";
       return false;
@@ -609,17 +831,17 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
   }
 
   // encode
-  memcpy(this->dataPtr->avInFrame->data[0], _frame,
-         this->dataPtr->inWidth * this->dataPtr->inHeight * 3);
+  memcpy(this->avInFrame->data[0], _frame,
+         this->inWidth * this->inHeight * 3);
 
-  sws_scale(this->dataPtr->swsCtx,
-      this->dataPtr->avInFrame->data,
-      this->dataPtr->avInFrame->linesize,
-      0, this->dataPtr->inHeight,
-      this->dataPtr->avOutFrame->data,
-      this->dataPtr->avOutFrame->linesize);
+  sws_scale(this->swsCtx,
+      this->avInFrame->data,
+      this->avInFrame->linesize,
+      0, this->inHeight,
+      this->avOutFrame->data,
+      this->avOutFrame->linesize);
 
-  this->dataPtr->avOutFrame->pts = this->dataPtr->frameCount++;
+  this->avOutFrame->pts = this->frameCount++;
 
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(57, 40, 101)
   int gotOutput = 0;
@@ -628,31 +850,31 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
   avPacket.data = nullptr;
   avPacket.size = 0;
 
-  int ret = avcodec_encode_video2(this->dataPtr->codecCtx, &avPacket,
-      this->dataPtr->avOutFrame, &gotOutput);
+  int ret = avcodec_encode_video2(this->codecCtx, &avPacket,
+      this->avOutFrame, &gotOutput);
 
   if (ret >= 0 && gotOutput == 1)
   {
-    avPacket.stream_index = this->dataPtr->videoStream->index;
+    avPacket.stream_index = this->videoStream->index;
 
     // Scale timestamp appropriately.
     if (avPacket.pts != static_cast<int64_t>(AV_NOPTS_VALUE))
     {
       avPacket.pts = av_rescale_q(avPacket.pts,
-          this->dataPtr->codecCtx->time_base,
-          this->dataPtr->videoStream->time_base);
+          this->codecCtx->time_base,
+          this->videoStream->time_base);
     }
 
     if (avPacket.dts != static_cast<int64_t>(AV_NOPTS_VALUE))
     {
       avPacket.dts = av_rescale_q(
           avPacket.dts,
-          this->dataPtr->codecCtx->time_base,
-          this->dataPtr->videoStream->time_base);
+          this->codecCtx->time_base,
+          this->videoStream->time_base);
     }
 
     // Write frame to disk
-    ret = av_interleaved_write_frame(this->dataPtr->formatCtx, &avPacket);
+    ret = av_interleaved_write_frame(this->formatCtx, &avPacket);
 
     if (ret < 0)
     {
@@ -672,38 +894,38 @@ bool VideoEncoder::AddFrame(const unsigned char *_frame,
   avPacket->data = nullptr;
   avPacket->size = 0;
 
-  int ret = avcodec_send_frame(this->dataPtr->codecCtx,
-                               this->dataPtr->avOutFrame);
+  int ret = avcodec_send_frame(this->codecCtx,
+                               this->avOutFrame);
 
   // This loop will retrieve and write available packets
   while (ret >= 0)
   {
-    ret = avcodec_receive_packet(this->dataPtr->codecCtx, avPacket);
+    ret = avcodec_receive_packet(this->codecCtx, avPacket);
 
     // Potential performance improvement: Queue the packets and write in
     // a separate thread.
     if (ret >= 0)
     {
-      avPacket->stream_index = this->dataPtr->videoStream->index;
+      avPacket->stream_index = this->videoStream->index;
 
       // Scale timestamp appropriately.
       if (avPacket->pts != static_cast<int64_t>(AV_NOPTS_VALUE))
       {
         avPacket->pts = av_rescale_q(avPacket->pts,
-            this->dataPtr->codecCtx->time_base,
-            this->dataPtr->videoStream->time_base);
+            this->codecCtx->time_base,
+            this->videoStream->time_base);
       }
 
       if (avPacket->dts != static_cast<int64_t>(AV_NOPTS_VALUE))
       {
         avPacket->dts = av_rescale_q(
             avPacket->dts,
-            this->dataPtr->codecCtx->time_base,
-            this->dataPtr->videoStream->time_base);
+            this->codecCtx->time_base,
+            this->videoStream->time_base);
       }
 
       // Write frame to disk
-      if (av_interleaved_write_frame(this->dataPtr->formatCtx, avPacket) < 0)
+      if (av_interleaved_write_frame(this->formatCtx, avPacket) < 0)
         gzerr << "Error writing frame" << std::endl;
     }
   }
@@ -729,6 +951,9 @@ bool VideoEncoder::AddFrame(const unsigned char */*_frame*/,
 /////////////////////////////////////////////////
 bool VideoEncoder::Stop()
 {
+  // Encode the queued frames before writing the trailer
+  this->dataPtr->StopQueue();
+
 #ifdef HAVE_FFMPEG
   if (this->dataPtr->encoding && this->dataPtr->formatCtx)
     av_write_trailer(this->dataPtr->formatCtx);
@@ -822,3 +1047,72 @@ void VideoEncoder::Reset()
   this->dataPtr->fps = VIDEO_ENCODER_FPS_DEFAULT;
   this->dataPtr->format = VIDEO_ENCODER_FORMAT_DEFAULT;
 }
+
+/////////////////////////////////////////////////
+void VideoEncoder::SetFrameQueue(const unsigned int _size,
+    const bool _dropWhenFull)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->queueMutex);
+  this->dataPtr->queueSize = _size;
+  this->dataPtr->dropWhenFull = _dropWhenFull;
+}
+
+/////////////////////////////////////////////////
+uint64_t VideoEncoder::EncodedFrameCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->queueMutex);
+  return this->dataPtr->encodedFrames;
+}
+
+/////////////////////////////////////////////////
+uint64_t VideoEncoder::DroppedFrameCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->queueMutex);
+  return this->dataPtr->droppedFrames;
+}
+
+/////////////////////////////////////////////////
+double VideoEncoder::EncodeLatency() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->queueMutex);
+  if (this->dataPtr->encodedFrames == 0)
+    return 0;
+  return this->dataPtr->latencySum / this->dataPtr->encodedFrames;
+}
+
+/////////////////////////////////////////////////
+void VideoEncoderPrivate::RecordEncoded(
+    const std::chrono::steady_clock::time_point &_added)
+{
+  const double latency = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - _added).count();
+
+  std::lock_guard<std::mutex> lock(this->queueMutex);
+  ++this->encodedFrames;
+  this->latencySum += latency;
+}
+
+/////////////////////////////////////////////////
+void VideoEncoderPrivate::StopQueue()
+{
+  if (!this->queueThread.joinable())
+    return;
+
+  // New frames are rejected from now on. Start clears stopQueue.
+  this->queueRunning = false;
+  {
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    this->stopQueue = true;
+  }
+  this->queueCondition.notify_all();
+  this->queueThread.join();
+
+  std::lock_guard<std::mutex> lock(this->queueMutex);
+  this->queue.clear();
+
+  gzmsg << "Video encoder: " << this->encodedFrames << " frames encoded, "
+        << this->droppedFrames << " dropped, mean latency "
+        << (this->encodedFrames > 0 ?
+            this->latencySum / this->encodedFrames * 1000.0 : 0.0)
+        << " ms\n";
+}
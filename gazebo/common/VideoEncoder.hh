@@ -18,6 +18,7 @@
 #define GAZEBO_COMMON_VIDEOENCODER_HH_
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <gazebo/util/system.hh>
@@ -119,9 +120,36 @@ namespace gazebo
       public: unsigned int BitRate() const;
 
       /// \brief Reset to default video properties and clean up allocated
-      /// memory. This will also delete any temporary files.
+      /// memory. This will also delete any temporary files. The frame queue
+      /// settings are kept.
       public: void Reset();
 
+      /// \brief Encode frames on a dedicated thread. AddFrame then only
+      /// copies the frame into a reusable buffer and queues it. Takes effect
+      /// on the next call to Start.
+      /// \param[in] _size Maximum number of frames waiting to be encoded.
+      /// Zero, the default, encodes frames in AddFrame on the caller's
+      /// thread.
+      /// \param[in] _dropWhenFull True to drop frames that are added while
+      /// the queue is full, false to block AddFrame until a frame has been
+      /// encoded.
+      public: void SetFrameQueue(const unsigned int _size,
+                  const bool _dropWhenFull = true);
+
+      /// \brief Get the number of frames encoded since Start was called.
+      /// \return Number of encoded frames.
+      public: uint64_t EncodedFrameCount() const;
+
+      /// \brief Get the number of frames dropped because the frame queue
+      /// was full, since Start was called.
+      /// \return Number of dropped frames.
+      public: uint64_t DroppedFrameCount() const;
+
+      /// \brief Get the mean time between adding a frame and the end of
+      /// its encoding, since Start was called.
+      /// \return Mean encode latency in seconds.
+      public: double EncodeLatency() const;
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<VideoEncoderPrivate> dataPtr;
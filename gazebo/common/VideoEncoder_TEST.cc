@@ -15,6 +15,9 @@
 */
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <vector>
+
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/VideoEncoder.hh"
 #include "test/util.hh"
@@ -57,6 +60,55 @@ TEST_F(VideoEncoderTest, StartStop)
 #endif
 }
 
+/////////////////////////////////////////////////
+TEST_F(VideoEncoderTest, FrameQueue)
+{
+  VideoEncoder video;
+  EXPECT_EQ(video.EncodedFrameCount(), 0u);
+  EXPECT_EQ(video.DroppedFrameCount(), 0u);
+  EXPECT_DOUBLE_EQ(video.EncodeLatency(), 0.0);
+
+#ifdef HAVE_FFMPEG
+  const unsigned int width = 320;
+  const unsigned int height = 240;
+  const unsigned int count = 20;
+  std::vector<unsigned char> frame(width * height * 3, 128);
+
+  // Space the timestamps so that no frame is skipped because of the fps
+  auto time = std::chrono::steady_clock::now();
+  const std::chrono::milliseconds period(1000 / VIDEO_ENCODER_FPS_DEFAULT + 1);
+
+  // With backpressure, every frame is encoded
+  video.SetFrameQueue(2, false);
+  EXPECT_TRUE(video.Start("mp4", "", width, height));
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    time += period;
+    EXPECT_TRUE(video.AddFrame(frame.data(), width, height, time));
+  }
+  video.Stop();
+  EXPECT_EQ(video.EncodedFrameCount(), count);
+  EXPECT_EQ(video.DroppedFrameCount(), 0u);
+  EXPECT_GT(video.EncodeLatency(), 0.0);
+
+  // When dropping, every frame is either encoded or dropped
+  video.SetFrameQueue(1, true);
+  EXPECT_TRUE(video.Start("mp4", "", width, height));
+  uint64_t queued = 0;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    time += period;
+    if (video.AddFrame(frame.data(), width, height, time))
+      ++queued;
+  }
+  video.Stop();
+  EXPECT_EQ(video.EncodedFrameCount(), queued);
+  EXPECT_EQ(video.EncodedFrameCount() + video.DroppedFrameCount(), count);
+
+  video.Reset();
+#endif
+}
+
 /////////////////////////////////////////////////
 TEST_F(VideoEncoderTest, Exists)
 {
@@ -47,10 +47,13 @@ void help()
   << "  -e [ --physics ] arg          Specify a physics engine "
   << "(ode|bullet|dart|simbody).\n"
   << "  -p [ --play ] arg             Play a log file.\n"
+  << "  --play_cache arg (=256)       Memory for the states cached to seek in "
+  << "a played\n"
+  << "                                log file (MiB).\n"
   << "  -r [ --record ]               Record state data.\n"
   << "  --record_encoding arg (=zlib) Compression encoding format for log "
   << "data \n"
-  << "                                (zlib|bz2|txt).\n"
+  << "                                (zlib|bz2|txt|zstd|lz4).\n"
   << "  --record_path arg             Absolute path in which to store "
   << "state data.\n"
   << "  --record_period arg (=-1)     Recording period (seconds).\n"
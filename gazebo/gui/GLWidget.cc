@@ -916,6 +916,8 @@ void GLWidget::ViewScene(rendering::ScenePtr _scene)
 
   // client side heightmap configuration
   _scene->SetHeightmapLOD(gazebo::gui::getINIProperty<int>("heightmap.lod", 0));
+  _scene->SetStaticBatchingEnabled(
+      gazebo::gui::getINIProperty<int>("rendering.static_batching", 0));
 
   // Update at the camera's update rate
   this->dataPtr->updateTimer->start(
@@ -20,6 +20,7 @@
 #include <ignition/math/Pose3.hh>
 #include <sdf/sdf.hh>
 #include <boost/algorithm/string.hpp>
+#include <boost/make_shared.hpp>
 
 #include "gazebo/gazebo_config.h"
 #include "gazebo/gazebo_client.hh"
@@ -342,6 +343,8 @@ void MainWindow::Init()
 
   this->dataPtr->newEntitySub = this->dataPtr->node->Subscribe("~/model/info",
       &MainWindow::OnModel, this, true);
+  this->dataPtr->newEntityBatchSub = this->dataPtr->node->Subscribe(
+      "~/model/info/batch", &MainWindow::OnModelBatch, this, true);
 
   // \todo Treating both light topics the same way, this should be improved
   this->dataPtr->lightModifySub = this->dataPtr->node->Subscribe(
@@ -377,6 +380,7 @@ void MainWindow::closeEvent(QCloseEvent * /*_event*/)
   this->dataPtr->responseSub.reset();
   this->dataPtr->guiSub.reset();
   this->dataPtr->newEntitySub.reset();
+  this->dataPtr->newEntityBatchSub.reset();
   this->dataPtr->worldModSub.reset();
   this->dataPtr->lightModifySub.reset();
   this->dataPtr->lightFactorySub.reset();
@@ -2132,6 +2136,13 @@ void MainWindow::OnModel(ConstModelPtr &_msg)
   gui::Events::modelUpdate(*_msg);
 }
 
+/////////////////////////////////////////////////
+void MainWindow::OnModelBatch(ConstModel_VPtr &_msg)
+{
+  for (auto const &model : _msg->models())
+    this->OnModel(boost::make_shared<const msgs::Model>(model));
+}
+
 /////////////////////////////////////////////////
 void MainWindow::OnLight(ConstLightPtr &_msg)
 {
@@ -83,6 +83,9 @@ namespace gazebo
       /// \brief Subscribe to model info messages.
       public: transport::SubscriberPtr newEntitySub;
 
+      /// \brief Subscribe to batches of model info messages.
+      public: transport::SubscriberPtr newEntityBatchSub;
+
       /// \brief Subscribe to world modify messages.
       public: transport::SubscriberPtr worldModSub;
 
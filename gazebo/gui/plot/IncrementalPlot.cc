@@ -15,6 +15,7 @@
  *
 */
 
+#include <algorithm>
 #include <map>
 
 #include <ignition/math/Helpers.hh>
@@ -148,9 +149,6 @@ namespace gazebo
       /// \brief The curve to draw.
       public: CurveMap curves;
 
-      /// \brief Drawing utility
-      public: QwtPlotDirectPainter *directPainter;
-
       /// \brief Pointer to the plot magnifier.
       public: PlotMagnifier *magnifier;
 
@@ -183,7 +181,6 @@ IncrementalPlot::IncrementalPlot(QWidget *_parent)
   this->setObjectName("incrementalPlot");
 
   this->dataPtr->period = 10;
-  this->dataPtr->directPainter = new QwtPlotDirectPainter(this);
 
   // panning with the left mouse button
   this->dataPtr->panner = new QwtPlotPanner(this->canvas());
@@ -353,18 +350,6 @@ void IncrementalPlot::Update()
       continue;
 
     lastPoint = curve.second->Point(pointCount-1);
-
-    if (ignition::math::isnan(lastPoint.X()) ||
-        ignition::math::isnan(lastPoint.Y()))
-    {
-      continue;
-    }
-
-    ignition::math::Vector2d minPt = curve.second->Min();
-    ignition::math::Vector2d maxPt = curve.second->Max();
-
-    this->dataPtr->directPainter->drawSeries(curve.second->Curve(),
-      pointCount - 1, pointCount - 1);
   }
 
   // get x axis lower and upper bounds
@@ -399,6 +384,12 @@ void IncrementalPlot::Update()
   this->dataPtr->prevPoint = lastPoint;
   this->setAxisScale(QwtPlot::xBottom, minX, maxX);
 
+  // Draw at most a min and a max per pixel column of the visible range
+  const unsigned int columns =
+      static_cast<unsigned int>(std::max(1, this->canvas()->width()));
+  for (auto &curve : this->dataPtr->curves)
+    curve.second->UpdateSamples(minX, maxX, columns);
+
   this->dataPtr->tracker->Update();
   this->replot();
 }
@@ -14,7 +14,13 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <map>
+#include <mutex>
+#include <vector>
+
 #include <ignition/math/Color.hh>
 
 #include "gazebo/common/Assert.hh"
@@ -45,88 +51,333 @@ namespace gazebo
           Colors[ColorGroupCount][ColorCount];
     };
 
-    /// \brief A class that manages curve data
+    /// \brief Min and max of a block of consecutive points of a curve.
+    class CurveBlock
+    {
+      /// \brief Point of the block with the smallest y value.
+      public: QPointF min;
+
+      /// \brief Point of the block with the largest y value.
+      public: QPointF max;
+
+      /// \brief X value of the first point of the block.
+      public: double firstX;
+    };
+
+    /// \brief A class that manages curve data.
+    ///
+    /// Points are kept in a ring buffer, along with levels of min/max
+    /// blocks of 4, 16, 64... consecutive points. Points may be added from
+    /// any thread. The samples drawn by qwt are picked from the level that
+    /// has a few blocks per pixel column of the visible range, so that
+    /// drawing is bounded by the plot width rather than the history length.
     class CurveData: public QwtArraySeriesData<QPointF>
     {
       public: CurveData()
               {}
 
-      /// \brief Add a point to the sample.
-      /// \return Bounding box of the sample.
+      /// \brief Get the bounding box of all the points of the curve.
+      /// \return Bounding box of the points.
       public: virtual QRectF boundingRect() const
               {
-                if (this->d_boundingRect.width() < 0.0)
-                  this->d_boundingRect = qwtBoundingRect(*this);
+                QRectF rect;
+                {
+                  std::lock_guard<std::mutex> lock(this->mutex);
+                  rect = this->bounds;
+                }
 
                 // set a minimum bounding box height
                 // this prevents plot's auto scale to zoom in on near-zero
                 // floating point noise.
                 double minHeight = 1e-3;
-                double absHeight = std::fabs(this->d_boundingRect.height());
-                if (absHeight < minHeight)
+                double absHeight = std::fabs(rect.height());
+                if (rect.width() >= 0.0 && absHeight < minHeight)
                 {
                   double halfMinHeight = minHeight * 0.5;
-                  double mid = this->d_boundingRect.top() +
-                      (absHeight * 0.5);
-                  this->d_boundingRect.setTop(mid - halfMinHeight);
-                  this->d_boundingRect.setBottom(mid + halfMinHeight);
+                  double mid = rect.top() + (absHeight * 0.5);
+                  rect.setTop(mid - halfMinHeight);
+                  rect.setBottom(mid + halfMinHeight);
                 }
 
-                return this->d_boundingRect;
+                return rect;
               }
 
-      /// \brief Add a point to the sample.
+      /// \brief Add a point to the curve.
       /// \param[in] _point Point to add.
       public: inline void Add(const QPointF &_point)
               {
-                this->d_samples += _point;
+                std::lock_guard<std::mutex> lock(this->mutex);
 
-                if (this->d_samples.size() > maxSampleSize)
+                const uint64_t index = this->count++;
+                Set(this->points, index % historySize, _point);
+
+                for (unsigned int l = 0; l < levelCount; ++l)
                 {
-                  // remove sample window
-                  // update bounding rect?
-                  this->d_samples.remove(0, windowSize);
+                  const unsigned int shift = levelShift * (l + 1);
+                  const uint64_t block = index >> shift;
+                  const size_t slot = block % (historySize >> shift);
+                  if ((index & ((uint64_t(1) << shift) - 1)) == 0)
+                  {
+                    Set(this->levels[l], slot, {_point, _point, _point.x()});
+                    continue;
+                  }
+
+                  CurveBlock &b = this->levels[l][slot];
+                  if (_point.y() < b.min.y())
+                    b.min = _point;
+                  if (_point.y() > b.max.y())
+                    b.max = _point;
                 }
 
-                if (this->d_samples.size() == 1)
+                if (index == 0)
                 {
                   // init bounding rect
-                  this->d_boundingRect.setTopLeft(_point);
-                  this->d_boundingRect.setBottomRight(_point);
+                  this->bounds.setTopLeft(_point);
+                  this->bounds.setBottomRight(_point);
                   return;
                 }
 
                 // expand bounding rect
-                if (_point.x() < this->d_boundingRect.left())
-                  this->d_boundingRect.setLeft(_point.x());
-                else if (_point.x() > this->d_boundingRect.right())
-                  this->d_boundingRect.setRight(_point.x());
-                if (_point.y() < this->d_boundingRect.top())
-                  this->d_boundingRect.setTop(_point.y());
-                else if (_point.y() > this->d_boundingRect.bottom())
-                  this->d_boundingRect.setBottom(_point.y());
+                if (_point.x() < this->bounds.left())
+                  this->bounds.setLeft(_point.x());
+                if (_point.x() > this->bounds.right())
+                  this->bounds.setRight(_point.x());
+                if (_point.y() < this->bounds.top())
+                  this->bounds.setTop(_point.y());
+                if (_point.y() > this->bounds.bottom())
+                  this->bounds.setBottom(_point.y());
               }
 
-      /// \brief Clear the sample data.
+      /// \brief Clear the curve data.
       public: void Clear()
               {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->count = 0;
+                this->points.clear();
+                this->points.shrink_to_fit();
+                for (auto &level : this->levels)
+                {
+                  level.clear();
+                  level.shrink_to_fit();
+                }
+                this->bounds = QRectF(0.0, 0.0, -1.0, -1.0);
                 this->d_samples.clear();
                 this->d_samples.squeeze();
-                this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
               }
 
-      /// \brief Get the sample data.
-      /// \return A vector of same points.
-      public: QVector<QPointF> Samples() const
+      /// \brief Get the number of points kept.
+      /// \return Number of points.
+      public: unsigned int Size() const
+              {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return static_cast<unsigned int>(this->points.size());
+              }
+
+      /// \brief Get a point.
+      /// \param[in] _index Index of the point, from the oldest point kept.
+      /// \param[out] _point The point.
+      /// \return True if the index is valid.
+      public: bool Point(const unsigned int _index, QPointF &_point) const
+              {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (_index >= this->points.size())
+                  return false;
+                _point = this->points[(this->First() + _index) % historySize];
+                return true;
+              }
+
+      /// \brief Pick the samples drawn for a range of x values: all the
+      /// points in the range if there are few of them, or else the min
+      /// and max of each pixel column. One point on each side of the range
+      /// is kept so that lines reach the borders.
+      /// \param[in] _minX Lower bound of the range.
+      /// \param[in] _maxX Upper bound of the range.
+      /// \param[in] _columns Number of pixel columns of the range.
+      public: void Decimate(const double _minX, const double _maxX,
+                  const unsigned int _columns)
+              {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->d_samples.clear();
+                if (this->points.empty() || _columns == 0 || _maxX < _minX)
+                  return;
+
+                uint64_t begin = this->LowerBound(_minX);
+                uint64_t end = this->LowerBound(std::nextafter(_maxX,
+                    std::numeric_limits<double>::max()));
+                if (begin > this->First())
+                  --begin;
+                if (end < this->count)
+                  ++end;
+
+                const uint64_t n = end - begin;
+                if (n <= 2u * _columns)
+                {
+                  for (uint64_t i = begin; i < end; ++i)
+                    this->d_samples += this->points[i % historySize];
+                  return;
+                }
+
+                // Coarsest level with at least one block per column. Level 0
+                // uses the points as blocks of one.
+                unsigned int level = 0;
+                while (level < levelCount &&
+                       (n >> (levelShift * (level + 1))) >= _columns)
+                {
+                  ++level;
+                }
+                this->Columns(begin, end, level, _minX, _maxX, _columns);
+              }
+
+      /// \brief Get the index of the first point kept.
+      /// \return Index since the first point added.
+      private: uint64_t First() const
+              {
+                return this->count - this->points.size();
+              }
+
+      /// \brief Find the first point kept whose x value is not less than
+      /// a value, assuming x values increase.
+      /// \param[in] _x The value.
+      /// \return Index since the first point added.
+      private: uint64_t LowerBound(const double _x) const
+              {
+                uint64_t low = this->First();
+                uint64_t high = this->count;
+                while (low < high)
+                {
+                  const uint64_t mid = low + (high - low) / 2;
+                  if (this->points[mid % historySize].x() < _x)
+                    low = mid + 1;
+                  else
+                    high = mid;
+                }
+                return low;
+              }
+
+      /// \brief Merge the blocks of a level into the min and max of each
+      /// pixel column, and set them as samples in x order.
+      /// \param[in] _begin Index of the first point.
+      /// \param[in] _end Index past the last point.
+      /// \param[in] _level Level of the blocks, 0 for the points.
+      /// \param[in] _minX Lower bound of the range.
+      /// \param[in] _maxX Upper bound of the range.
+      /// \param[in] _columns Number of pixel columns of the range.
+      private: void Columns(const uint64_t _begin, const uint64_t _end,
+                   const unsigned int _level, const double _minX,
+                   const double _maxX, const unsigned int _columns)
               {
-                return this->d_samples;
+                const unsigned int shift = levelShift * _level;
+                const double scale = _maxX > _minX ?
+                    _columns / (_maxX - _minX) : 0.0;
+
+                int column = std::numeric_limits<int>::min();
+                QPointF min;
+                QPointF max;
+                auto flush = [&]()
+                {
+                  if (column == std::numeric_limits<int>::min())
+                    return;
+                  if (min.x() <= max.x())
+                  {
+                    this->d_samples += min;
+                    if (max != min)
+                      this->d_samples += max;
+                  }
+                  else
+                  {
+                    this->d_samples += max;
+                    this->d_samples += min;
+                  }
+                };
+
+                auto add = [&](const CurveBlock &_block)
+                {
+                  const int blockColumn = static_cast<int>(
+                      std::floor((_block.firstX - _minX) * scale));
+                  if (blockColumn != column)
+                  {
+                    flush();
+                    column = blockColumn;
+                    min = _block.min;
+                    max = _block.max;
+                    return;
+                  }
+                  if (_block.min.y() < min.y())
+                    min = _block.min;
+                  if (_block.max.y() > max.y())
+                    max = _block.max;
+                };
+
+                uint64_t b = _begin >> shift;
+
+                // Once the ring has wrapped, the slot of a block whose first
+                // points were dropped holds the newest block, so the points
+                // kept of that block are added one by one.
+                if ((b << shift) < this->First())
+                {
+                  const uint64_t blockEnd = std::min((b + 1) << shift, _end);
+                  for (uint64_t i = _begin; i < blockEnd; ++i)
+                  {
+                    const QPointF &p = this->points[i % historySize];
+                    add({p, p, p.x()});
+                  }
+                  ++b;
+                }
+
+                for (; b <= (_end - 1) >> shift; ++b)
+                {
+                  if (_level == 0)
+                  {
+                    const QPointF &p = this->points[b % historySize];
+                    add({p, p, p.x()});
+                  }
+                  else
+                  {
+                    add(this->levels[_level - 1][b % (historySize >> shift)]);
+                  }
+                }
+                flush();
               }
 
-      /// \brief maxium sample size of this curve.
-      private: int maxSampleSize = 11000;
+      /// \brief Set an element of a ring buffer that is filled in order.
+      /// \param[in,out] _ring The ring buffer.
+      /// \param[in] _slot Index of the element.
+      /// \param[in] _value Value of the element.
+      private: template<typename T>
+               static void Set(std::vector<T> &_ring, const size_t _slot,
+                   const T &_value)
+              {
+                if (_slot == _ring.size())
+                  _ring.push_back(_value);
+                else
+                  _ring[_slot] = _value;
+              }
 
-      /// \brief Size of samples to remove when maxSampleSize is reached.
-      private: int windowSize = 1000;
+      /// \brief Number of points kept.
+      private: static const unsigned int historySize = 1u << 18;
+
+      /// \brief Log2 of the ratio between the block sizes of consecutive
+      /// levels.
+      private: static const unsigned int levelShift = 2;
+
+      /// \brief Number of levels of blocks.
+      private: static const unsigned int levelCount = 8;
+
+      /// \brief Ring buffer of points.
+      private: std::vector<QPointF> points;
+
+      /// \brief Ring buffers of blocks of each level.
+      private: std::vector<CurveBlock> levels[levelCount];
+
+      /// \brief Number of points added since the curve was cleared.
+      private: uint64_t count = 0;
+
+      /// \brief Bounding box of all the points added.
+      private: QRectF bounds = QRectF(0.0, 0.0, -1.0, -1.0);
+
+      /// \brief Protects the points, blocks and bounds, which are added to
+      /// outside the GUI thread.
+      private: mutable std::mutex mutex;
     };
 
 
@@ -342,7 +593,7 @@ void PlotCurve::SetAge(const unsigned int _age)
 /////////////////////////////////////////////////
 unsigned int PlotCurve::Size() const
 {
-  return static_cast<unsigned int>(this->dataPtr->curveData->samples().size());
+  return this->dataPtr->curveData->Size();
 }
 
 /////////////////////////////////////////////////
@@ -362,17 +613,29 @@ ignition::math::Vector2d PlotCurve::Max()
 /////////////////////////////////////////////////
 ignition::math::Vector2d PlotCurve::Point(const unsigned int _index) const
 {
-  if (_index >= static_cast<unsigned int>(
-      this->dataPtr->curveData->samples().size()))
+  QPointF pt;
+  if (!this->dataPtr->curveData->Point(_index, pt))
   {
     return ignition::math::Vector2d(ignition::math::NAN_D,
         ignition::math::NAN_D);
   }
 
-  const QPointF &pt = this->dataPtr->curveData->samples()[_index];
   return ignition::math::Vector2d(pt.x(), pt.y());
 }
 
+/////////////////////////////////////////////////
+void PlotCurve::UpdateSamples(const double _minX, const double _maxX,
+    const unsigned int _columns)
+{
+  this->dataPtr->curveData->Decimate(_minX, _maxX, _columns);
+}
+
+/////////////////////////////////////////////////
+unsigned int PlotCurve::SampleCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->curveData->size());
+}
+
 /////////////////////////////////////////////////
 QwtPlotCurve *PlotCurve::Curve()
 {
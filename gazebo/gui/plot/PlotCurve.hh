@@ -99,7 +99,9 @@ namespace gazebo
       /// \return Curve age
       public: unsigned int Age() const;
 
-      /// \brief Get the number of data points in the curve
+      /// \brief Get the number of data points in the curve. The oldest
+      /// points are dropped once the curve holds a few minutes of 1 kHz
+      /// data.
       /// \return Number of data points.
       public: unsigned int Size() const;
 
@@ -117,6 +119,20 @@ namespace gazebo
       /// returned if the index is out of bounds.
       public: ignition::math::Vector2d Point(const unsigned int _index) const;
 
+      /// \brief Update the points drawn by the curve for a range of x
+      /// values. If the range has more points than pixel columns, only the
+      /// min and max of each column are drawn, so that drawing costs the
+      /// same however long the curve is. Called from the GUI thread.
+      /// \param[in] _minX Lower bound of the range.
+      /// \param[in] _maxX Upper bound of the range.
+      /// \param[in] _columns Number of pixel columns of the range.
+      public: void UpdateSamples(const double _minX, const double _maxX,
+                  const unsigned int _columns);
+
+      /// \brief Get the number of points drawn by the curve.
+      /// \return Number of points picked by the last UpdateSamples call.
+      public: unsigned int SampleCount() const;
+
       /// \brief Return all the sample points in the curve.
       /// \return Curve sample points
       public: std::vector<ignition::math::Vector2d> Points() const;
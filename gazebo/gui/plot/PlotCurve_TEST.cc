@@ -15,6 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gazebo/gui/plot/qwt_gazebo.h"
 #include "gazebo/gui/plot/PlottingTypes.hh"
 #include "gazebo/gui/plot/PlotCurve.hh"
 #include "gazebo/gui/plot/PlotCurve_TEST.hh"
@@ -133,5 +138,87 @@ void PlotCurve_TEST::AddPoint()
   delete plotCurve;
 }
 
+/////////////////////////////////////////////////
+void PlotCurve_TEST::UpdateSamples()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty.world");
+
+  gazebo::gui::PlotCurve *plotCurve = new gazebo::gui::PlotCurve("curve01");
+  QVERIFY(plotCurve != nullptr);
+
+  // Few points are all drawn
+  for (unsigned int i = 0; i < 10; ++i)
+    plotCurve->AddPoint(ignition::math::Vector2d(i, i));
+  plotCurve->UpdateSamples(0, 10, 100);
+  QCOMPARE(plotCurve->SampleCount(), 10u);
+
+  // 100 seconds of 1 kHz data, with a spike
+  plotCurve->Clear();
+  std::vector<ignition::math::Vector2d> points;
+  const unsigned int ptSize = 100000;
+  for (unsigned int i = 0; i < ptSize; ++i)
+  {
+    const double x = i * 0.001;
+    points.push_back(ignition::math::Vector2d(x,
+        i == 54321 ? 100.0 : std::sin(x)));
+  }
+  plotCurve->AddPoints(points);
+  QCOMPARE(plotCurve->Size(), ptSize);
+
+  // At most a min and a max per column, plus a point on each side
+  const unsigned int columns = 500;
+  plotCurve->UpdateSamples(0, 100, columns);
+  QVERIFY(plotCurve->SampleCount() > columns);
+  QVERIFY(plotCurve->SampleCount() <= 2 * columns + 2);
+
+  // The spike is kept, and samples are in x order
+  double maxY = -1;
+  for (unsigned int i = 0; i < plotCurve->SampleCount(); ++i)
+  {
+    const QPointF pt = plotCurve->Curve()->sample(i);
+    maxY = std::max(maxY, pt.y());
+    if (i > 0)
+      QVERIFY(plotCurve->Curve()->sample(i - 1).x() <= pt.x());
+  }
+  QCOMPARE(maxY, 100.0);
+
+  // A zoomed in range draws its points
+  plotCurve->UpdateSamples(10, 10.1, columns);
+  QVERIFY(plotCurve->SampleCount() >= 100u);
+  QVERIFY(plotCurve->SampleCount() <= 103u);
+
+  // Once the history has wrapped, the oldest point kept starts in the
+  // middle of a block, and is a spike
+  plotCurve->Clear();
+  points.clear();
+  const unsigned int dropped = 1234;
+  const unsigned int historySize = 1u << 18;
+  for (unsigned int i = 0; i < historySize + dropped; ++i)
+  {
+    points.push_back(ignition::math::Vector2d(i * 0.001,
+        i == dropped ? 50.0 : 0.0));
+  }
+  plotCurve->AddPoints(points);
+  QCOMPARE(plotCurve->Size(), historySize);
+
+  plotCurve->UpdateSamples(0, (historySize + dropped) * 0.001, columns);
+  QVERIFY(plotCurve->SampleCount() <= 2 * columns + 2);
+  maxY = -1;
+  for (unsigned int i = 0; i < plotCurve->SampleCount(); ++i)
+  {
+    const QPointF pt = plotCurve->Curve()->sample(i);
+    QVERIFY(pt.x() >= dropped * 0.001);
+    maxY = std::max(maxY, pt.y());
+    if (i > 0)
+      QVERIFY(plotCurve->Curve()->sample(i - 1).x() <= pt.x());
+  }
+  QCOMPARE(maxY, 50.0);
+
+  delete plotCurve;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(PlotCurve_TEST)
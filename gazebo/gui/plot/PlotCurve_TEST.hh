@@ -32,5 +32,8 @@ class PlotCurve_TEST : public QTestFixture
 
   /// \brief Test adding points to the curve
   private slots: void AddPoint();
+
+  /// \brief Test that the points drawn are bounded by the plot width
+  private slots: void UpdateSamples();
 };
 #endif
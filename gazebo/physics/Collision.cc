@@ -393,6 +393,12 @@ unsigned int Collision::GetMaxContacts()
 /////////////////////////////////////////////////
 const ignition::math::Pose3d &Collision::WorldPose() const
 {
+  // Collisions of links are kept up to date by the world's transform store,
+  // which writes worldPose under World::WorldPoseMutex whenever the link
+  // moves
+  if (this->transformHandle != TransformStore::InvalidHandle)
+    return this->worldPose;
+
   // If true, compute a new world pose value.
   //
   if (this->worldPoseDirty)
@@ -194,7 +194,10 @@ namespace gazebo
 
       /// \brief Indicate that the world pose should be recalculated.
       /// The recalculation will be done when Collision::GetWorldPose is
-      /// called.
+      /// called. Collisions of links get their world pose from the world's
+      /// transform store instead, which updates it as soon as the link is
+      /// moved with notification, and otherwise during the next step, and
+      /// don't need this.
       public: void SetWorldPoseDirty();
 
       // Documentation inherited.
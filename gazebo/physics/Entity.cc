@@ -107,6 +107,27 @@ void Entity::Load(sdf::ElementPtr _sdf)
     this->initialRelativePose = this->SDFPoseRelativeToParent();
   }
 
+  // Links are roots of the world's transform store, and their collisions
+  // are children that follow them.
+  {
+    TransformStore &transforms = this->world->Transforms();
+    transforms.Remove(this->transformHandle);
+    this->transformHandle = TransformStore::InvalidHandle;
+
+    if (this->HasType(Base::LINK))
+    {
+      this->transformHandle = transforms.Add(TransformStore::InvalidHandle,
+          this->worldPose);
+    }
+    else if (this->HasType(Base::COLLISION) && this->parentEntity &&
+        this->parentEntity->transformHandle != TransformStore::InvalidHandle)
+    {
+      this->transformHandle = transforms.Add(
+          this->parentEntity->transformHandle, this->initialRelativePose,
+          &this->worldPose);
+    }
+  }
+
   if (this->parent)
   {
     this->visualMsg->set_parent_name(this->parent->GetScopedName());
@@ -338,22 +359,20 @@ void Entity::SetWorldPoseModel(
             entity->PublishPose();
         }
 
+        // Collisions follow the link through the transform store, before
+        // the physics engine reads their pose
+        entity->StoreWorldPose(_notify);
+
         if (_notify)
           entity->UpdatePhysicsPose(false);
 
-        // Tell collisions that their current world pose is dirty (needs
+        // Tell lights that their current world pose is dirty (needs
         // updating). We set a dirty flag instead of directly updating the
         // value to improve performance.
         for (Base_V::iterator iterC = (*iter)->children.begin();
              iterC != (*iter)->children.end(); ++iterC)
         {
-          if ((*iterC)->HasType(COLLISION))
-          {
-            CollisionPtr entityC =
-                boost::static_pointer_cast<Collision>(*iterC);
-            entityC->SetWorldPoseDirty();
-          }
-          else if ((*iterC)->HasType(LIGHT))
+          if ((*iterC)->HasType(LIGHT))
           {
             LightPtr entityC =
                 boost::static_pointer_cast<Light>(*iterC);
@@ -424,22 +443,21 @@ void Entity::SetWorldPoseDefault(const ignition::math::Pose3d &_pose,
   this->worldPose = _pose;
   this->worldPose.Correct();
 
+  // Collisions of links follow through the transform store, before the
+  // physics engine reads their pose
+  this->StoreWorldPose(_notify);
+
   if (_notify)
     this->UpdatePhysicsPose(true);
 
   if (this->HasType(LINK))
   {
-    // Tell collisions that their current world pose is dirty (needs
+    // Tell lights that their current world pose is dirty (needs
     // updating). We set a dirty flag instead of directly updating the
     // value to improve performance.
     for (auto &childPtr : this->children)
     {
-      if (childPtr->HasType(COLLISION))
-      {
-        CollisionPtr entityC = boost::static_pointer_cast<Collision>(childPtr);
-        entityC->SetWorldPoseDirty();
-      }
-      else if (childPtr->HasType(LIGHT))
+      if (childPtr->HasType(LIGHT))
       {
         LightPtr entityC = boost::static_pointer_cast<Light>(childPtr);
         entityC->SetWorldPoseDirty();
@@ -615,6 +633,10 @@ void Entity::Fini()
     delete this->visualMsg;
   this->visualMsg = NULL;
 
+  if (this->transformHandle != TransformStore::InvalidHandle && this->world)
+    this->world->Transforms().Remove(this->transformHandle);
+  this->transformHandle = TransformStore::InvalidHandle;
+
   this->parentEntity.reset();
 
   Base::Fini();
@@ -674,6 +696,24 @@ const ignition::math::Pose3d &Entity::DirtyPose() const
   return this->dirtyPose;
 }
 
+//////////////////////////////////////////////////
+void Entity::ApplyDirtyPose()
+{
+  (*this.*setWorldPoseFunc)(this->dirtyPose, false, false);
+}
+
+//////////////////////////////////////////////////
+void Entity::StoreWorldPose(const bool _updateChildren)
+{
+  if (this->transformHandle == TransformStore::InvalidHandle)
+    return;
+
+  TransformStore &transforms = this->world->Transforms();
+  transforms.SetWorldPose(this->transformHandle, this->worldPose);
+  if (_updateChildren)
+    transforms.UpdateDescendants(this->transformHandle);
+}
+
 //////////////////////////////////////////////////
 ignition::math::AxisAlignedBox Entity::CollisionBoundingBox() const
 {
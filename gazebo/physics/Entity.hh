@@ -33,6 +33,7 @@
 
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Base.hh"
+#include "gazebo/physics/TransformStore.hh"
 #include "gazebo/util/system.hh"
 
 namespace boost
@@ -227,6 +228,12 @@ namespace gazebo
       /// \return The dirty pose of the entity.
       public: const ignition::math::Pose3d &DirtyPose() const;
 
+      /// \brief Set the world pose to the dirty pose, without notifying
+      /// the physics engine or publishing. The caller must hold
+      /// World::WorldPoseMutex. Used by the world to apply all poses set by
+      /// the physics engine in a step under a single lock.
+      public: void ApplyDirtyPose();
+
       /// \brief This function is called when the entity's
       /// (or one of its parents) pose of the parent has changed.
       protected: virtual void OnPoseChange() = 0;
@@ -263,6 +270,14 @@ namespace gazebo
       private: void SetWorldPoseDefault(const ignition::math::Pose3d &_pose,
                    const bool _notify, const bool _publish);
 
+      /// \brief Write the world pose into the world's transform store, if
+      /// the entity has a transform. Must be called with
+      /// World::WorldPoseMutex locked.
+      /// \param[in] _updateChildren True to update the world poses of the
+      /// children right away, false to leave them to the next update of
+      /// the store.
+      private: void StoreWorldPose(const bool _updateChildren);
+
       /// \brief Called when a new pose message arrives.
       /// \param[in] _msg The message to set the pose from.
       private: void OnPoseMsg(ConstPosePtr &_msg);
@@ -317,6 +332,11 @@ namespace gazebo
       /// \brief Scale of the entity
       protected: ignition::math::Vector3d scale;
 
+      /// \brief Handle of the entity in the world's transform store. Only
+      /// links and collisions have one.
+      protected: TransformStore::Handle transformHandle =
+          TransformStore::InvalidHandle;
+
       /// \brief True if the object is static.
       private: bool isStatic;
 
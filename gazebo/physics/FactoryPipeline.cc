@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ignition/common/URI.hh"
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Exception.hh"
+#include "gazebo/common/FuelModelDatabase.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/common/ModelDatabase.hh"
+#include "gazebo/physics/FactoryPipeline.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief A factory message moving through the pipeline.
+    class FactoryJob
+    {
+      /// \brief The message, and its SDF once parsed.
+      public: FactoryPipeline::Prepared prepared;
+
+      /// \brief True when preparation is done.
+      public: bool ready = false;
+
+      /// \brief True if preparation failed.
+      public: bool failed = false;
+
+      /// \brief True if this is the last message of its batch. Messages
+      /// pushed on their own are batches of one.
+      public: bool batchEnd = true;
+    };
+
+    /// \internal
+    /// \brief Private data for FactoryPipeline.
+    class FactoryPipelinePrivate
+    {
+      /// \brief Worker thread loop.
+      public: void Run();
+
+      /// \brief Prepare a job.
+      /// \param[in] _job The job.
+      public: static void Prepare(FactoryJob &_job);
+
+      /// \brief Protects the members below.
+      public: mutable std::mutex mutex;
+
+      /// \brief Signaled when a job is queued or the pipeline stops.
+      public: std::condition_variable condition;
+
+      /// \brief All jobs that were not popped, in push order.
+      public: std::deque<std::shared_ptr<FactoryJob>> jobs;
+
+      /// \brief Jobs waiting for a worker, in push order.
+      public: std::deque<std::shared_ptr<FactoryJob>> queue;
+
+      /// \brief Worker threads.
+      public: std::vector<std::thread> workers;
+
+      /// \brief True to stop the workers.
+      public: bool stop = false;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+FactoryPipeline::FactoryPipeline(const unsigned int _workers)
+  : dataPtr(new FactoryPipelinePrivate)
+{
+  unsigned int workers = _workers;
+  if (workers == 0)
+    workers = std::max(1u, std::min(2u, std::thread::hardware_concurrency()));
+
+  for (unsigned int i = 0; i < workers; ++i)
+  {
+    this->dataPtr->workers.push_back(
+        std::thread(&FactoryPipelinePrivate::Run, this->dataPtr.get()));
+  }
+}
+
+//////////////////////////////////////////////////
+FactoryPipeline::~FactoryPipeline()
+{
+  this->Stop();
+}
+
+//////////////////////////////////////////////////
+void FactoryPipeline::Push(const msgs::Factory &_msg)
+{
+  auto job = std::make_shared<FactoryJob>();
+  job->prepared.msg = _msg;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->stop)
+      return;
+
+    this->dataPtr->jobs.push_back(job);
+    this->dataPtr->queue.push_back(job);
+  }
+  this->dataPtr->condition.notify_one();
+}
+
+//////////////////////////////////////////////////
+void FactoryPipeline::PushBatch(const msgs::Factory_V &_msgs)
+{
+  if (_msgs.factory_size() == 0)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->stop)
+      return;
+
+    for (int i = 0; i < _msgs.factory_size(); ++i)
+    {
+      auto job = std::make_shared<FactoryJob>();
+      job->prepared.msg = _msgs.factory(i);
+      job->prepared.batch = true;
+      job->batchEnd = i + 1 == _msgs.factory_size();
+
+      this->dataPtr->jobs.push_back(job);
+      this->dataPtr->queue.push_back(job);
+    }
+  }
+  this->dataPtr->condition.notify_all();
+}
+
+//////////////////////////////////////////////////
+std::list<FactoryPipeline::Prepared> FactoryPipeline::PopReady()
+{
+  std::list<Prepared> result;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // Only pop up to the end of the last batch that is fully prepared
+  size_t count = 0;
+  for (size_t i = 0; i < this->dataPtr->jobs.size() &&
+       this->dataPtr->jobs[i]->ready; ++i)
+  {
+    if (this->dataPtr->jobs[i]->batchEnd)
+      count = i + 1;
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto job = this->dataPtr->jobs.front();
+    this->dataPtr->jobs.pop_front();
+
+    if (!job->failed)
+      result.push_back(std::move(job->prepared));
+  }
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+size_t FactoryPipeline::Pending() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->jobs.size();
+}
+
+//////////////////////////////////////////////////
+void FactoryPipeline::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+    this->dataPtr->queue.clear();
+  }
+  this->dataPtr->condition.notify_all();
+
+  for (auto &worker : this->dataPtr->workers)
+  {
+    if (worker.joinable())
+      worker.join();
+  }
+  this->dataPtr->workers.clear();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->jobs.clear();
+}
+
+//////////////////////////////////////////////////
+void FactoryPipelinePrivate::Run()
+{
+  while (true)
+  {
+    std::shared_ptr<FactoryJob> job;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->condition.wait(lock, [this]
+          {return this->stop || !this->queue.empty();});
+
+      if (this->stop)
+        return;
+
+      job = this->queue.front();
+      this->queue.pop_front();
+    }
+
+    Prepare(*job);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    job->ready = true;
+  }
+}
+
+//////////////////////////////////////////////////
+void FactoryPipelinePrivate::Prepare(FactoryJob &_job)
+{
+  const msgs::Factory &msg = _job.prepared.msg;
+
+  // Clones are resolved by the world.
+  if (msg.sdf().empty() && msg.sdf_filename().empty() &&
+      msg.has_clone_model_name())
+  {
+    return;
+  }
+
+  try
+  {
+    sdf::SDFPtr sdf(new sdf::SDF);
+    sdf::initFile("root.sdf", sdf);
+    if (!FactoryPipeline::Parse(msg, sdf))
+    {
+      _job.failed = true;
+      return;
+    }
+
+    if (!msg.has_edit_name())
+      FactoryPipeline::LoadCollisionMeshes(sdf->Root());
+
+    _job.prepared.sdf = sdf;
+  }
+  catch(...)
+  {
+    gzerr << "Preparing factory message failed\n";
+    _job.failed = true;
+  }
+}
+
+//////////////////////////////////////////////////
+bool FactoryPipeline::Parse(const msgs::Factory &_msg, sdf::SDFPtr _sdf)
+{
+  if (_msg.has_sdf() && !_msg.sdf().empty())
+  {
+    // SDF Parsing happens here
+    if (!sdf::readString(_msg.sdf(), _sdf))
+    {
+      gzerr << "Unable to read sdf string[" << _msg.sdf() << "]\n";
+      return false;
+    }
+  }
+  else if (_msg.has_sdf_filename() && !_msg.sdf_filename().empty())
+  {
+    std::string filename;
+    // If http(s), look at Fuel
+    auto uri = ignition::common::URI(_msg.sdf_filename());
+    if (uri.Valid() && (uri.Scheme() == "https" || uri.Scheme() == "http"))
+    {
+      filename = common::FuelModelDatabase::Instance()->ModelFile(
+          _msg.sdf_filename());
+    }
+    // Otherwise, look at database
+    else
+    {
+      filename = common::ModelDatabase::Instance()->GetModelFile(
+          _msg.sdf_filename());
+    }
+
+    if (!sdf::readFile(filename, _sdf))
+    {
+      gzerr << "Unable to read sdf file [" << filename << "]\n";
+      return false;
+    }
+
+    common::convertToFullPaths(_sdf->Root());
+  }
+  else
+  {
+    gzerr << "Unable to load sdf from factory message."
+      << "No SDF or SDF filename specified.\n";
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void FactoryPipeline::LoadCollisionMeshes(sdf::ElementPtr _elem)
+{
+  if (!_elem)
+    return;
+
+  if (_elem->GetName() == "collision")
+  {
+    if (!_elem->HasElement("geometry"))
+      return;
+
+    sdf::ElementPtr geomElem = _elem->GetElement("geometry");
+    if (!geomElem->HasElement("mesh"))
+      return;
+
+    // Same lookup as MeshShape::Init
+    sdf::ElementPtr meshElem = geomElem->GetElement("mesh");
+    std::string uri = common::asFullPath(meshElem->Get<std::string>("uri"),
+        meshElem->FilePath());
+    std::string filename = common::find_file(uri);
+    if (filename.empty() || filename == "__default__")
+      return;
+
+    try
+    {
+      common::MeshManager::Instance()->Load(filename);
+    }
+    catch(const common::Exception &)
+    {
+      // The error is reported again when the collision is initialized.
+    }
+    return;
+  }
+
+  for (sdf::ElementPtr child = _elem->GetFirstElement(); child;
+       child = child->GetNextElement())
+  {
+    LoadCollisionMeshes(child);
+  }
+}
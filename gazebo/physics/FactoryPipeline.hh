@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_FACTORYPIPELINE_HH_
+#define GAZEBO_PHYSICS_FACTORYPIPELINE_HH_
+
+#include <list>
+#include <memory>
+#include <sdf/sdf.hh>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class FactoryPipelinePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class FactoryPipeline FactoryPipeline.hh physics/physics.hh
+    /// \brief Prepares factory messages on worker threads.
+    ///
+    /// The work of a spawn that does not depend on the world or the physics
+    /// engine runs on worker threads: parsing the SDF, resolving model URIs
+    /// through the model database or Fuel, converting paths, and loading
+    /// collision meshes into common::MeshManager. The world then only
+    /// creates the entities, in the order the messages were pushed.
+    class GZ_PHYSICS_VISIBLE FactoryPipeline
+    {
+      /// \brief A factory message ready to be committed into the world.
+      public: class Prepared
+      {
+        /// \brief The factory message.
+        public: msgs::Factory msg;
+
+        /// \brief The parsed SDF of the message. Null for messages that
+        /// clone a model, which can only be resolved by the world.
+        public: sdf::SDFPtr sdf;
+
+        /// \brief True if the message was pushed with PushBatch.
+        public: bool batch = false;
+      };
+
+      /// \brief Constructor. Starts the worker threads.
+      /// \param[in] _workers Number of worker threads, 0 to use a default
+      /// based on the number of cores.
+      public: explicit FactoryPipeline(const unsigned int _workers = 0);
+
+      /// \brief Destructor. Stops the worker threads.
+      public: virtual ~FactoryPipeline();
+
+      /// \brief Queue a factory message for preparation.
+      /// \param[in] _msg The factory message.
+      public: void Push(const msgs::Factory &_msg);
+
+      /// \brief Queue a batch of factory messages for preparation. The
+      /// messages of a batch are popped together, once all of them are
+      /// prepared.
+      /// \param[in] _msgs The factory messages.
+      public: void PushBatch(const msgs::Factory_V &_msgs);
+
+      /// \brief Take the messages whose preparation is done. Messages are
+      /// returned in the order they were pushed, so a message that is still
+      /// being prepared holds back all messages pushed after it, and a batch
+      /// is only returned as a whole. Messages that failed to be prepared
+      /// are dropped.
+      /// \return Prepared messages.
+      public: std::list<Prepared> PopReady();
+
+      /// \brief Get the number of messages pushed but not yet popped.
+      /// \return Number of pending messages.
+      public: size_t Pending() const;
+
+      /// \brief Stop the worker threads and drop all pending messages.
+      public: void Stop();
+
+      /// \brief Parse the SDF of a factory message, from its sdf string or
+      /// by resolving its sdf_filename.
+      /// \param[in] _msg The factory message.
+      /// \param[out] _sdf SDF to parse into, initialized with root.sdf.
+      /// \return False if the message has no SDF or it could not be parsed.
+      public: static bool Parse(const msgs::Factory &_msg, sdf::SDFPtr _sdf);
+
+      /// \brief Load the meshes of all collisions below an element into
+      /// common::MeshManager, so that they are found in its cache when the
+      /// collisions are initialized.
+      /// \param[in] _elem Element to search.
+      public: static void LoadCollisionMeshes(sdf::ElementPtr _elem);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<FactoryPipelinePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
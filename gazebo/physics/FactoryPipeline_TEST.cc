@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/FactoryPipeline.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class FactoryPipelineTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief SDF string of a model with a single box link.
+/// \param[in] _name Name of the model.
+/// \return SDF string.
+std::string ModelSDF(const std::string &_name)
+{
+  std::ostringstream sdfStr;
+  sdfStr << "<sdf version ='" << SDF_VERSION << "'>"
+    << "<model name='" << _name << "'>"
+    << "<link name ='link'>"
+    <<   "<collision name ='collision'>"
+    <<     "<geometry>"
+    <<       "<box><size>1.0 1.0 1.0</size></box>"
+    <<     "</geometry>"
+    <<   "</collision>"
+    << "</link>"
+    << "</model>"
+    << "</sdf>";
+  return sdfStr.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Pop prepared messages until none are pending.
+/// \param[in] _pipeline The pipeline.
+/// \return All prepared messages.
+std::list<physics::FactoryPipeline::Prepared> PopAll(
+    physics::FactoryPipeline &_pipeline)
+{
+  std::list<physics::FactoryPipeline::Prepared> result;
+  for (int i = 0; i < 500 && _pipeline.Pending() > 0; ++i)
+  {
+    result.splice(result.end(), _pipeline.PopReady());
+    common::Time::MSleep(10);
+  }
+  result.splice(result.end(), _pipeline.PopReady());
+  return result;
+}
+
+/////////////////////////////////////////////////
+TEST_F(FactoryPipelineTest, Order)
+{
+  physics::FactoryPipeline pipeline(4);
+
+  const unsigned int count = 20;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    msgs::Factory msg;
+    msg.set_sdf(ModelSDF("model_" + std::to_string(i)));
+    pipeline.Push(msg);
+  }
+
+  auto prepared = PopAll(pipeline);
+  EXPECT_EQ(pipeline.Pending(), 0u);
+  ASSERT_EQ(prepared.size(), count);
+
+  // Messages come out in the order they were pushed, with the SDF parsed.
+  unsigned int i = 0;
+  for (auto const &p : prepared)
+  {
+    ASSERT_TRUE(p.sdf != nullptr);
+    sdf::ElementPtr root = p.sdf->Root();
+    ASSERT_TRUE(root != nullptr);
+    ASSERT_TRUE(root->HasElement("model"));
+    EXPECT_EQ(root->GetElement("model")->Get<std::string>("name"),
+        "model_" + std::to_string(i));
+    EXPECT_EQ(p.msg.sdf(), ModelSDF("model_" + std::to_string(i)));
+    ++i;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(FactoryPipelineTest, InvalidAndClone)
+{
+  physics::FactoryPipeline pipeline(1);
+
+  // Invalid SDF is dropped
+  msgs::Factory invalid;
+  invalid.set_sdf("<sdf version='1.6'><model name='bad'>");
+  pipeline.Push(invalid);
+
+  // No SDF is dropped
+  msgs::Factory empty;
+  pipeline.Push(empty);
+
+  // Clones are passed on without SDF
+  msgs::Factory clone;
+  clone.set_clone_model_name("box");
+  pipeline.Push(clone);
+
+  msgs::Factory valid;
+  valid.set_sdf(ModelSDF("valid"));
+  pipeline.Push(valid);
+
+  auto prepared = PopAll(pipeline);
+  ASSERT_EQ(prepared.size(), 2u);
+  EXPECT_EQ(prepared.front().msg.clone_model_name(), "box");
+  EXPECT_TRUE(prepared.front().sdf == nullptr);
+  EXPECT_TRUE(prepared.back().sdf != nullptr);
+}
+
+/////////////////////////////////////////////////
+TEST_F(FactoryPipelineTest, Batch)
+{
+  physics::FactoryPipeline pipeline(4);
+
+  const unsigned int count = 10;
+  msgs::Factory_V msgs;
+  for (unsigned int i = 0; i < count; ++i)
+    msgs.add_factory()->set_sdf(ModelSDF("model_" + std::to_string(i)));
+
+  // An empty batch is ignored
+  pipeline.PushBatch(msgs::Factory_V());
+  EXPECT_EQ(pipeline.Pending(), 0u);
+
+  pipeline.PushBatch(msgs);
+
+  // The batch is never split
+  std::list<physics::FactoryPipeline::Prepared> prepared;
+  for (int i = 0; i < 500 && prepared.empty(); ++i)
+  {
+    prepared = pipeline.PopReady();
+    if (prepared.empty())
+      common::Time::MSleep(10);
+  }
+  ASSERT_EQ(prepared.size(), count);
+  EXPECT_EQ(pipeline.Pending(), 0u);
+
+  unsigned int i = 0;
+  for (auto const &p : prepared)
+  {
+    ASSERT_TRUE(p.sdf != nullptr);
+    EXPECT_EQ(p.msg.sdf(), ModelSDF("model_" + std::to_string(i++)));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(FactoryPipelineTest, Stop)
+{
+  physics::FactoryPipeline pipeline(1);
+  pipeline.Stop();
+
+  // Messages pushed after stopping are ignored
+  msgs::Factory msg;
+  msg.set_sdf(ModelSDF("model"));
+  pipeline.Push(msg);
+  EXPECT_EQ(pipeline.Pending(), 0u);
+  EXPECT_TRUE(pipeline.PopReady().empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
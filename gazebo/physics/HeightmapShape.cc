@@ -16,7 +16,14 @@
 */
 #include <algorithm>
 #include <cmath>
+#include <ctime>
+#include <functional>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
+#include <boost/filesystem.hpp>
 #include <ignition/math/Helpers.hh>
 #include <gazebo/gazebo_config.h>
 
@@ -25,6 +32,7 @@
 #include "gazebo/common/Image.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
+#include "gazebo/common/SystemPaths.hh"
 #include "gazebo/physics/HeightmapShape.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/transport/transport.hh"
@@ -32,6 +40,95 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Height fields with at least this many vertices per side are
+/// memory-mapped when HeightmapShape::mapHeights is set.
+static const unsigned int mappedMinVertices = 4097;
+
+/// \brief Maximum total size of the cache files of mapped height fields,
+/// in bytes. The least recently used files are removed to stay below it.
+static const uintmax_t mappedCacheMaxSize = uintmax_t(2) << 30;
+
+/// \brief Number of vertices per tile side of mapped height fields.
+static const unsigned int mappedTileSize = 256;
+
+/// \brief Indices of the attributes stored with mapped height fields.
+enum MappedAttribute
+{
+  MAPPED_SIZE_X, MAPPED_SIZE_Y, MAPPED_SIZE_Z,
+  MAPPED_SCALE_X, MAPPED_SCALE_Y, MAPPED_SCALE_Z,
+  MAPPED_GEO_REFERENCED, MAPPED_LATITUDE, MAPPED_LONGITUDE, MAPPED_ELEVATION,
+  MAPPED_ATTRIBUTE_COUNT
+};
+
+//////////////////////////////////////////////////
+/// \brief Write float heights to a mapped height field file.
+static bool WriteMappedHeights(const std::string &_filename,
+    const uint64_t _key, const std::vector<float> &_heights,
+    const unsigned int _size, const std::vector<double> &_attributes)
+{
+  return common::MappedHeightfield::Write(_filename, _key, _heights, _size,
+      mappedTileSize, _attributes);
+}
+
+//////////////////////////////////////////////////
+/// \brief Remove the least recently used cache files of mapped height
+/// fields until a new file fits in mappedCacheMaxSize.
+/// \param[in] _dir Directory of the cache files.
+/// \param[in] _size Size of the new file in bytes.
+/// \return False if the new file alone doesn't fit.
+static bool EvictMappedHeights(const boost::filesystem::path &_dir,
+    const uintmax_t _size)
+{
+  if (_size > mappedCacheMaxSize)
+    return false;
+
+  std::vector<std::pair<std::time_t, boost::filesystem::path>> files;
+  uintmax_t total = 0;
+  boost::system::error_code ec;
+  for (boost::filesystem::directory_iterator it(_dir, ec), end;
+       !ec && it != end; it.increment(ec))
+  {
+    if (it->path().extension() != ".hmap")
+      continue;
+
+    boost::system::error_code fileEc;
+    const uintmax_t fileSize = boost::filesystem::file_size(it->path(),
+        fileEc);
+    const std::time_t time = boost::filesystem::last_write_time(it->path(),
+        fileEc);
+    if (fileEc)
+      continue;
+
+    total += fileSize;
+    files.push_back(std::make_pair(time, it->path()));
+  }
+
+  // Oldest first
+  std::sort(files.begin(), files.end());
+  for (auto const &file : files)
+  {
+    if (total + _size <= mappedCacheMaxSize)
+      break;
+
+    boost::system::error_code fileEc;
+    const uintmax_t fileSize = boost::filesystem::file_size(file.second,
+        fileEc);
+    if (!fileEc && boost::filesystem::remove(file.second, fileEc))
+      total -= fileSize;
+  }
+
+  return total + _size <= mappedCacheMaxSize;
+}
+
+//////////////////////////////////////////////////
+/// \brief Double heights are not mapped.
+static bool WriteMappedHeights(const std::string &/*_filename*/,
+    const uint64_t /*_key*/, const std::vector<double> &/*_heights*/,
+    const unsigned int /*_size*/, const std::vector<double> &/*_attributes*/)
+{
+  return false;
+}
+
 
 //////////////////////////////////////////////////
 HeightmapShape::HeightmapShape(CollisionPtr _parent)
@@ -42,6 +139,8 @@ HeightmapShape::HeightmapShape(CollisionPtr _parent)
       std::is_same<HeightType, double>::value,
       "Height field needs to be double or float");
   this->vertSize = 0;
+  this->heightmapData = nullptr;
+  this->mapHeights = false;
   this->AddType(Base::HEIGHTMAP_SHAPE);
 }
 
@@ -170,12 +269,6 @@ void HeightmapShape::Load(sdf::ElementPtr _sdf)
     return;
   }
 
-  if (this->LoadTerrainFile(filename) != 0)
-  {
-    gzerr << "Heightmap data size must be square, with a size of 2^n+1\n";
-    return;
-  }
-
   this->subSampling = 2u;
   if (this->sdf->HasElement("sampling"))
   {
@@ -192,6 +285,27 @@ void HeightmapShape::Load(sdf::ElementPtr _sdf)
     }
   }
 
+  // Large height fields of engines which can map them are only cached when
+  // the geometry asks for it with <gz:cache>true</gz:cache>
+  if (this->mapHeights)
+  {
+    std::string cache;
+    if (this->sdf->HasElement("gz:cache"))
+      cache = this->sdf->GetElement("gz:cache")->Get<std::string>();
+    this->mapHeights = cache == "true" || cache == "1";
+  }
+
+  // A cached height field generated from the same file replaces loading
+  // and decoding the terrain file.
+  if (this->LoadMappedHeights(filename))
+    return;
+
+  if (this->LoadTerrainFile(filename) != 0)
+  {
+    gzerr << "Heightmap data size must be square, with a size of 2^n+1\n";
+    return;
+  }
+
   // Check if the geometry of the terrain data matches Ogre constrains
   if (this->heightmapData->GetWidth() != this->heightmapData->GetHeight() ||
       !ignition::math::isPowerOfTwo(this->heightmapData->GetWidth() - 1))
@@ -201,6 +315,128 @@ void HeightmapShape::Load(sdf::ElementPtr _sdf)
   }
 }
 
+//////////////////////////////////////////////////
+bool HeightmapShape::LoadMappedHeights(const std::string &_filename)
+{
+  if (!this->mapHeights)
+    return false;
+
+  // The key identifies the terrain file and every parameter that changes
+  // the generated heights.
+  std::ostringstream key;
+  try
+  {
+    key << _filename << ";"
+        << boost::filesystem::file_size(_filename) << ";"
+        << boost::filesystem::last_write_time(_filename) << ";";
+  }
+  catch(const boost::filesystem::filesystem_error &)
+  {
+    return false;
+  }
+  key << this->subSampling << ";" << this->flipY << ";"
+      << sizeof(HeightType) << ";";
+  if (this->sdf->HasElement("size"))
+    key << this->sdf->Get<ignition::math::Vector3d>("size");
+
+  this->mappedHeightsKey = std::hash<std::string>()(key.str());
+
+  std::ostringstream name;
+  name << std::hex << this->mappedHeightsKey << ".hmap";
+  boost::filesystem::path path =
+      common::SystemPaths::Instance()->GetLogPath();
+  path = path / "heightmap_cache" / name.str();
+  this->mappedHeightsFilename = path.string();
+
+  if (!this->mappedHeights.Open(this->mappedHeightsFilename,
+        this->mappedHeightsKey) ||
+      this->mappedHeights.Attributes().size() != MAPPED_ATTRIBUTE_COUNT)
+  {
+    this->mappedHeights.Close();
+    return false;
+  }
+
+  const std::vector<double> &attributes = this->mappedHeights.Attributes();
+  this->heightmapSize.Set(attributes[MAPPED_SIZE_X],
+      attributes[MAPPED_SIZE_Y], attributes[MAPPED_SIZE_Z]);
+
+  // Restore the geo reference of DEM terrains.
+  if (attributes[MAPPED_GEO_REFERENCED] > 0)
+  {
+    common::SphericalCoordinatesPtr sphericalCoordinates =
+        this->world->SphericalCoords();
+    if (sphericalCoordinates)
+    {
+      sphericalCoordinates->SetLatitudeReference(
+          ignition::math::Angle(attributes[MAPPED_LATITUDE]));
+      sphericalCoordinates->SetLongitudeReference(
+          ignition::math::Angle(attributes[MAPPED_LONGITUDE]));
+      sphericalCoordinates->SetElevationReference(
+          attributes[MAPPED_ELEVATION]);
+    }
+    else
+    {
+      gzerr << "Unable to get a valid SphericalCoordinates pointer\n";
+    }
+  }
+
+  // Mark the file as recently used, so that it is evicted last
+  boost::system::error_code ec;
+  boost::filesystem::last_write_time(path, std::time(nullptr), ec);
+
+  gzmsg << "Using cached heightmap [" << this->mappedHeightsFilename
+        << "]\n";
+  return true;
+}
+
+//////////////////////////////////////////////////
+void HeightmapShape::SaveMappedHeights()
+{
+  std::vector<double> attributes(MAPPED_ATTRIBUTE_COUNT, 0.0);
+  attributes[MAPPED_SIZE_X] = this->heightmapSize.X();
+  attributes[MAPPED_SIZE_Y] = this->heightmapSize.Y();
+  attributes[MAPPED_SIZE_Z] = this->heightmapSize.Z();
+  attributes[MAPPED_SCALE_X] = this->scale.X();
+  attributes[MAPPED_SCALE_Y] = this->scale.Y();
+  attributes[MAPPED_SCALE_Z] = this->scale.Z();
+
+#ifdef HAVE_GDAL
+  common::SphericalCoordinatesPtr sphericalCoordinates =
+      this->world->SphericalCoords();
+  if (dynamic_cast<common::Dem *>(this->heightmapData) &&
+      sphericalCoordinates)
+  {
+    attributes[MAPPED_GEO_REFERENCED] = 1.0;
+    attributes[MAPPED_LATITUDE] =
+        sphericalCoordinates->LatitudeReference().Radian();
+    attributes[MAPPED_LONGITUDE] =
+        sphericalCoordinates->LongitudeReference().Radian();
+    attributes[MAPPED_ELEVATION] =
+        sphericalCoordinates->GetElevationReference();
+  }
+#endif
+
+  boost::filesystem::path path(this->mappedHeightsFilename);
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(path.parent_path(), ec);
+
+  const uintmax_t size = static_cast<uintmax_t>(this->vertSize) *
+      this->vertSize * sizeof(HeightType);
+  if (!EvictMappedHeights(path.parent_path(), size) ||
+      !WriteMappedHeights(this->mappedHeightsFilename,
+        this->mappedHeightsKey, this->heights, this->vertSize, attributes) ||
+      !this->mappedHeights.Open(this->mappedHeightsFilename,
+        this->mappedHeightsKey))
+  {
+    gzwarn << "Unable to cache heightmap [" << this->mappedHeightsFilename
+           << "], heights are kept in memory\n";
+    return;
+  }
+
+  // The heights are served from the mapping from now on.
+  std::vector<HeightType>().swap(this->heights);
+}
+
 //////////////////////////////////////////////////
 int HeightmapShape::GetSubSampling() const
 {
@@ -210,6 +446,13 @@ int HeightmapShape::GetSubSampling() const
 //////////////////////////////////////////////////
 void HeightmapShape::FillHeightfield(std::vector<float>& _heights)
 {
+  if (this->mappedHeights.Valid())
+  {
+    const float *data = this->mappedHeights.Data();
+    _heights.assign(data, data + this->vertSize * this->vertSize);
+    return;
+  }
+
   this->heightmapData->FillHeightMap(this->subSampling, this->vertSize,
       this->Size(), this->scale, this->flipY, _heights);
 }
@@ -217,6 +460,13 @@ void HeightmapShape::FillHeightfield(std::vector<float>& _heights)
 //////////////////////////////////////////////////
 void HeightmapShape::FillHeightfield(std::vector<double>& _heights)
 {
+  if (this->mappedHeights.Valid())
+  {
+    const float *data = this->mappedHeights.Data();
+    _heights.assign(data, data + this->vertSize * this->vertSize);
+    return;
+  }
+
   std::vector<float> fHeights;
   this->heightmapData->FillHeightMap(this->subSampling, this->vertSize,
       this->Size(), this->scale, this->flipY, fHeights);
@@ -233,6 +483,15 @@ void HeightmapShape::Init()
       &HeightmapShape::OnRequest, this, true);
   this->responsePub = this->node->Advertise<msgs::Response>("~/response");
 
+  if (this->mappedHeights.Valid())
+  {
+    const std::vector<double> &attributes = this->mappedHeights.Attributes();
+    this->vertSize = this->mappedHeights.Size();
+    this->scale.Set(attributes[MAPPED_SCALE_X], attributes[MAPPED_SCALE_Y],
+        attributes[MAPPED_SCALE_Z]);
+    return;
+  }
+
   ignition::math::Vector3d terrainSize = this->Size();
 
   // sampling size along image width and height
@@ -258,6 +517,9 @@ void HeightmapShape::Init()
 
   // Construct the heightmap lookup table
   this->FillHeightfield(this->heights);
+
+  if (this->mapHeights && this->vertSize >= mappedMinVertices)
+    this->SaveMappedHeights();
 }
 
 //////////////////////////////////////////////////
@@ -310,7 +572,7 @@ void HeightmapShape::FillHeights(msgs::Geometry &_msg) const
     for (unsigned int x = 0; x < this->vertSize; ++x)
     {
       int index = (this->vertSize - y - 1) * this->vertSize + x;
-      _msg.mutable_heightmap()->add_heights(this->heights[index]);
+      _msg.mutable_heightmap()->add_heights(this->HeightData()[index]);
     }
   }
 }
@@ -331,15 +593,108 @@ ignition::math::Vector2i HeightmapShape::VertexCount() const
 HeightmapShape::HeightType HeightmapShape::GetHeight(int _x, int _y) const
 {
   int index =  _y * this->vertSize + _x;
-  if (_x < 0 || _y < 0 || index >= static_cast<int>(this->heights.size()))
+  if (_x < 0 || _y < 0 ||
+      index >= static_cast<int>(this->vertSize * this->vertSize))
+  {
     return 0.0;
+  }
+
+  return this->HeightData()[index];
+}
+
+/////////////////////////////////////////////////
+const HeightmapShape::HeightType *HeightmapShape::HeightData() const
+{
+  if (this->mappedHeights.Valid())
+  {
+    // Only float heights are ever mapped, see WriteMappedHeights.
+    return reinterpret_cast<const HeightType *>(this->mappedHeights.Data());
+  }
+
+  return this->heights.data();
+}
+
+/////////////////////////////////////////////////
+bool HeightmapShape::HeightRange(int _x0, int _y0, int _x1, int _y1,
+    HeightType &_min, HeightType &_max) const
+{
+  const int size = static_cast<int>(this->vertSize);
+  _x0 = std::max(_x0, 0);
+  _y0 = std::max(_y0, 0);
+  _x1 = std::min(_x1, size - 1);
+  _y1 = std::min(_y1, size - 1);
+  if (_x0 > _x1 || _y0 > _y1)
+    return false;
+
+  if (this->mappedHeights.Valid())
+  {
+    float min, max;
+    if (!this->mappedHeights.HeightRange(_x0, _y0, _x1, _y1, min, max))
+      return false;
+    _min = min;
+    _max = max;
+    return true;
+  }
 
-  return this->heights[index];
+  const HeightType *data = this->HeightData();
+  _min = std::numeric_limits<HeightType>::max();
+  _max = -std::numeric_limits<HeightType>::max();
+  for (int y = _y0; y <= _y1; ++y)
+  {
+    for (int x = _x0; x <= _x1; ++x)
+    {
+      _min = std::min(_min, data[y * size + x]);
+      _max = std::max(_max, data[y * size + x]);
+    }
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool HeightmapShape::AboveHeights(
+    const ignition::math::AxisAlignedBox &_box) const
+{
+  // Scanning in-memory heights would cost as much as the engine's own test
+  if (!this->mappedHeights.Valid() || this->vertSize < 2)
+    return false;
+
+  const ignition::math::Vector3d size = this->Size();
+  if (size.X() <= 0 || size.Y() <= 0)
+    return false;
+
+  const int last = static_cast<int>(this->vertSize) - 1;
+  const double cellX = size.X() / last;
+  const double cellY = size.Y() / last;
+
+  // Clamp before converting, the box of a plane is unbounded
+  auto index = [last](double _v)
+  {
+    return static_cast<int>(ignition::math::clamp(_v, -1.0, last + 1.0));
+  };
+  const int x0 = index(std::floor((_box.Min().X() + size.X() * 0.5) / cellX));
+  const int x1 = index(std::ceil((_box.Max().X() + size.X() * 0.5) / cellX));
+  const int y0 = index(std::floor((_box.Min().Y() + size.Y() * 0.5) / cellY));
+  const int y1 = index(std::ceil((_box.Max().Y() + size.Y() * 0.5) / cellY));
+
+  // Rows run along +y or -y depending on the engine (see flipY), so bound
+  // both the region and its mirror.
+  HeightType min, max;
+  if (!this->HeightRange(x0, y0, x1, y1, min, max))
+    return false;
+
+  HeightType mirrorMin, mirrorMax;
+  if (!this->HeightRange(x0, last - y1, x1, last - y0, mirrorMin, mirrorMax))
+    return false;
+
+  return _box.Min().Z() > std::max(max, mirrorMax);
 }
 
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 {
+  if (this->mappedHeights.Valid())
+    return this->mappedHeights.MaxHeight();
+
   HeightType max = -std::numeric_limits<HeightType>::max();
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
@@ -353,6 +708,9 @@ HeightmapShape::HeightType HeightmapShape::GetMaxHeight() const
 /////////////////////////////////////////////////
 HeightmapShape::HeightType HeightmapShape::GetMinHeight() const
 {
+  if (this->mappedHeights.Valid())
+    return this->mappedHeights.MinHeight();
+
   HeightType min = std::numeric_limits<HeightType>::max();
   for (unsigned int i = 0; i < this->heights.size(); ++i)
   {
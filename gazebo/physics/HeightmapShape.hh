@@ -17,15 +17,18 @@
 #ifndef GAZEBO_PHYSICS_HEIGHTMAPSHAPE_HH_
 #define GAZEBO_PHYSICS_HEIGHTMAPSHAPE_HH_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <ignition/transport/Node.hh>
 
+#include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Vector2.hh>
 
 #include "gazebo/common/ImageHeightmap.hh"
 #include "gazebo/common/HeightmapData.hh"
 #include "gazebo/common/Dem.hh"
+#include "gazebo/common/MappedHeightfield.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Shape.hh"
@@ -119,6 +122,30 @@ namespace gazebo
       /// \return The minimum height.
       public: HeightType GetMinHeight() const;
 
+      /// \brief Get bounds of the heights in a region of the height field.
+      /// Memory-mapped heightmaps answer from per-tile bounds without reading
+      /// any height, so the bounds may be wider than the actual heights.
+      /// \param[in] _x0 First column of the region.
+      /// \param[in] _y0 First row of the region.
+      /// \param[in] _x1 Last column of the region, inclusive.
+      /// \param[in] _y1 Last row of the region, inclusive.
+      /// \param[out] _min Lower bound of the heights in the region.
+      /// \param[out] _max Upper bound of the heights in the region.
+      /// \return False if the region does not overlap the height field.
+      public: bool HeightRange(int _x0, int _y0, int _x1, int _y1,
+                  HeightType &_min, HeightType &_max) const;
+
+      /// \brief Check whether a box lies above the terrain under it, using
+      /// the per-tile bounds of a memory-mapped heightmap. Collision engines
+      /// call this to skip a pair before reading any height.
+      /// \param[in] _box Box in the frame of the height field: x and y
+      /// centered on the field, z in the units of the heights.
+      /// \return True if the box is higher than every height under it.
+      /// False if it may touch the terrain, or if the heights are not
+      /// memory-mapped.
+      public: bool AboveHeights(
+                  const ignition::math::AxisAlignedBox &_box) const;
+
       /// \brief Get the amount of subsampling.
       /// \return Amount of subsampling.
       public: int GetSubSampling() const;
@@ -136,6 +163,16 @@ namespace gazebo
       /// \return 0 when the operation succeeds to load a file or -1 when fails.
       private: int LoadTerrainFile(const std::string &_filename);
 
+      /// \brief Map the heights from the cache if the cache is enabled and
+      /// holds a file generated from the same terrain file and parameters.
+      /// \param[in] _filename The path to the terrain file.
+      /// \return True if the heights were mapped.
+      private: bool LoadMappedHeights(const std::string &_filename);
+
+      /// \brief Write the heights to the cache and map them, releasing the
+      /// heights held in memory.
+      private: void SaveMappedHeights();
+
       /// \brief Handle request messages.
       /// \param[in] _msg The request message.
       private: void OnRequest(ConstRequestPtr &_msg);
@@ -148,9 +185,28 @@ namespace gazebo
       /// \brief Version of FillHeightfield() for double vectors.
       public: void FillHeightfield(std::vector<double>& heights);
 
+      /// \brief Get the lookup table of heights, vertSize * vertSize values in
+      /// row-major order. Use this instead of \e heights, which is empty when
+      /// the heights are memory-mapped.
+      /// \return Pointer to the heights.
+      protected: const HeightType *HeightData() const;
+
       /// \brief Lookup table of heights.
       protected: std::vector<HeightType> heights;
 
+      /// \brief True to store large height fields in a memory-mapped cache
+      /// file under the log path, so that only the regions that are used
+      /// stay in memory and later loads skip decoding the terrain file.
+      /// Physics engines that read the heights through HeightData() set
+      /// this in their constructor. Load clears it unless the heightmap
+      /// geometry has <gz:cache>true</gz:cache>. The cache files are
+      /// limited to 2 GB in total, the least recently used are removed.
+      protected: bool mapHeights;
+
+      /// \brief Memory-mapped heights, valid when mapHeights is set and the
+      /// height field is large enough.
+      protected: common::MappedHeightfield mappedHeights;
+
       /// \brief Image used to generate the heights.
       protected: common::ImageHeightmap img;
 
@@ -181,6 +237,12 @@ namespace gazebo
       /// \brief Terrain size
       private: ignition::math::Vector3d heightmapSize;
 
+      /// \brief Path of the cache file of the mapped heights.
+      private: std::string mappedHeightsFilename;
+
+      /// \brief Key of the cache file of the mapped heights.
+      private: uint64_t mappedHeightsKey = 0;
+
       #ifdef HAVE_GDAL
       /// \brief DEM used to generate the heights.
       private: common::Dem dem;
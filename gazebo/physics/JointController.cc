@@ -15,6 +15,7 @@
  *
 */
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/transport/Node.hh"
@@ -57,6 +58,13 @@ JointController::JointController(ModelPtr _model)
   {
     gzerr << "Error advertising service [" << service << "]\n";
   }
+
+  std::string batchTopic = "/" + modelName + "/joint_cmds";
+  if (!this->dataPtr->node.Subscribe(batchTopic,
+      &JointController::OnJointCommands, this))
+  {
+    gzerr << "Error subscribing to topic [" << batchTopic << "]\n";
+  }
 }
 
 /////////////////////////////////////////////////
@@ -69,11 +77,38 @@ JointController::~JointController()
 /////////////////////////////////////////////////
 void JointController::AddJoint(JointPtr _joint)
 {
-  this->dataPtr->joints[_joint->GetScopedName()] = _joint;
-  this->dataPtr->posPids[_joint->GetScopedName()].Init(
-      1, 0.1, 0.01, 1, -1, 1000, -1000);
-  this->dataPtr->velPids[_joint->GetScopedName()].Init(
-      1, 0.1, 0.01, 1, -1, 1000, -1000);
+  const std::string name = _joint->GetScopedName();
+
+  unsigned int slot;
+  auto iter = this->dataPtr->slots.find(name);
+  if (iter != this->dataPtr->slots.end())
+  {
+    slot = iter->second;
+  }
+  else if (!this->dataPtr->freeSlots.empty())
+  {
+    slot = this->dataPtr->freeSlots.back();
+    this->dataPtr->freeSlots.pop_back();
+    this->dataPtr->slots[name] = slot;
+  }
+  else
+  {
+    slot = this->dataPtr->joints.size();
+    this->dataPtr->slots[name] = slot;
+    this->dataPtr->joints.emplace_back();
+    this->dataPtr->names.emplace_back();
+    this->dataPtr->active.push_back(0);
+    this->dataPtr->posPids.emplace_back();
+    this->dataPtr->velPids.emplace_back();
+    this->dataPtr->forces.push_back(0);
+    this->dataPtr->positions.push_back(0);
+    this->dataPtr->velocities.push_back(0);
+  }
+
+  this->dataPtr->joints[slot] = _joint;
+  this->dataPtr->names[slot] = name;
+  this->dataPtr->posPids[slot].Init(1, 0.1, 0.01, 1, -1, 1000, -1000);
+  this->dataPtr->velPids[slot].Init(1, 0.1, 0.01, 1, -1, 1000, -1000);
 }
 
 /////////////////////////////////////////////////
@@ -81,9 +116,16 @@ void JointController::RemoveJoint(Joint *_joint)
 {
   if (_joint)
   {
-    this->dataPtr->joints.erase(_joint->GetScopedName());
-    this->dataPtr->posPids.erase(_joint->GetScopedName());
-    this->dataPtr->velPids.erase(_joint->GetScopedName());
+    auto iter = this->dataPtr->slots.find(_joint->GetScopedName());
+    if (iter == this->dataPtr->slots.end())
+      return;
+
+    const unsigned int slot = iter->second;
+    this->dataPtr->joints[slot].reset();
+    this->dataPtr->names[slot].clear();
+    this->dataPtr->active[slot] = 0;
+    this->dataPtr->slots.erase(iter);
+    this->dataPtr->freeSlots.push_back(slot);
   }
 }
 
@@ -91,23 +133,13 @@ void JointController::RemoveJoint(Joint *_joint)
 void JointController::Reset()
 {
   // Reset setpoints and feed-forward.
-  this->dataPtr->positions.clear();
-  this->dataPtr->velocities.clear();
-  this->dataPtr->forces.clear();
+  std::fill(this->dataPtr->active.begin(), this->dataPtr->active.end(), 0);
 
-  std::map<std::string, common::PID>::iterator iter;
+  for (auto &pid : this->dataPtr->posPids)
+    pid.Reset();
 
-  for (iter = this->dataPtr->posPids.begin();
-    iter != this->dataPtr->posPids.end(); ++iter)
-  {
-    iter->second.Reset();
-  }
-
-  for (iter = this->dataPtr->velPids.begin();
-    iter != this->dataPtr->velPids.end(); ++iter)
-  {
-    iter->second.Reset();
-  }
+  for (auto &pid : this->dataPtr->velPids)
+    pid.Reset();
 }
 
 /////////////////////////////////////////////////
@@ -123,41 +155,30 @@ void JointController::Update()
   // TODO: fix this when World::ResetTime is improved
   if (stepTime > 0)
   {
-    if (!this->dataPtr->forces.empty())
+    const size_t count = this->dataPtr->active.size();
+    for (size_t i = 0; i < count; ++i)
     {
-      std::map<std::string, double>::iterator iter;
-      for (iter = this->dataPtr->forces.begin();
-          iter != this->dataPtr->forces.end(); ++iter)
-      {
-        this->dataPtr->joints[iter->first]->SetForce(0, iter->second);
-      }
-    }
+      const uint8_t active = this->dataPtr->active[i];
+      if (!active)
+        continue;
 
-    if (!this->dataPtr->positions.empty())
-    {
-      std::map<std::string, double>::iterator iter;
+      Joint *joint = this->dataPtr->joints[i].get();
+
+      if (active & JointControllerPrivate::forceCmd)
+        joint->SetForce(0, this->dataPtr->forces[i]);
 
-      for (iter = this->dataPtr->positions.begin();
-           iter != this->dataPtr->positions.end(); ++iter)
+      if (active & JointControllerPrivate::positionCmd)
       {
-        double cmd = this->dataPtr->posPids[iter->first].Update(
-            this->dataPtr->joints[iter->first]->Position(0) -
-            iter->second, stepTime);
-        this->dataPtr->joints[iter->first]->SetForce(0, cmd);
+        double cmd = this->dataPtr->posPids[i].Update(
+            joint->Position(0) - this->dataPtr->positions[i], stepTime);
+        joint->SetForce(0, cmd);
       }
-    }
 
-    if (!this->dataPtr->velocities.empty())
-    {
-      std::map<std::string, double>::iterator iter;
-
-      for (iter = this->dataPtr->velocities.begin();
-           iter != this->dataPtr->velocities.end(); ++iter)
+      if (active & JointControllerPrivate::velocityCmd)
       {
-        double cmd = this->dataPtr->velPids[iter->first].Update(
-            this->dataPtr->joints[iter->first]->GetVelocity(0) - iter->second,
-            stepTime);
-        this->dataPtr->joints[iter->first]->SetForce(0, cmd);
+        double cmd = this->dataPtr->velPids[i].Update(
+            joint->GetVelocity(0) - this->dataPtr->velocities[i], stepTime);
+        joint->SetForce(0, cmd);
       }
     }
   }
@@ -189,199 +210,224 @@ bool JointController::OnJointCmdReq(const ignition::msgs::StringMsg &_req,
   const std::string &jointName = _req.data();
   _rep.set_name(jointName);
 
-  if (this->dataPtr->forces.find(jointName) !=
-      this->dataPtr->forces.end())
-  {
-    _rep.mutable_force_optional()->set_data(this->dataPtr->forces[jointName]);
-  }
+  const int slot = this->JointIndex(jointName);
+  if (slot < 0)
+    return true;
+
+  const uint8_t active = this->dataPtr->active[slot];
+
+  if (active & JointControllerPrivate::forceCmd)
+    _rep.mutable_force_optional()->set_data(this->dataPtr->forces[slot]);
 
-  if (this->dataPtr->positions.find(jointName) !=
-      this->dataPtr->positions.end())
+  if (active & JointControllerPrivate::positionCmd)
   {
     _rep.mutable_position()->mutable_target_optional()->set_data(
-        this->dataPtr->positions[jointName]);
+        this->dataPtr->positions[slot]);
   }
 
-  if (this->dataPtr->velocities.find(jointName) !=
-      this->dataPtr->velocities.end())
+  if (active & JointControllerPrivate::velocityCmd)
   {
     _rep.mutable_velocity()->mutable_target_optional()->set_data(
-        this->dataPtr->velocities[jointName]);
+        this->dataPtr->velocities[slot]);
   }
 
-  if (this->dataPtr->posPids.find(jointName) !=
-      this->dataPtr->posPids.end())
-  {
-    _rep.mutable_position()->mutable_p_gain_optional()->set_data(
-        this->dataPtr->posPids[jointName].GetPGain());
-    _rep.mutable_position()->mutable_d_gain_optional()->set_data(
-        this->dataPtr->posPids[jointName].GetDGain());
-    _rep.mutable_position()->mutable_i_gain_optional()->set_data(
-        this->dataPtr->posPids[jointName].GetIGain());
-  }
+  const common::PID &posPid = this->dataPtr->posPids[slot];
+  _rep.mutable_position()->mutable_p_gain_optional()->set_data(
+      posPid.GetPGain());
+  _rep.mutable_position()->mutable_d_gain_optional()->set_data(
+      posPid.GetDGain());
+  _rep.mutable_position()->mutable_i_gain_optional()->set_data(
+      posPid.GetIGain());
+
+  const common::PID &velPid = this->dataPtr->velPids[slot];
+  _rep.mutable_velocity()->mutable_p_gain_optional()->set_data(
+      velPid.GetPGain());
+  _rep.mutable_velocity()->mutable_d_gain_optional()->set_data(
+      velPid.GetDGain());
+  _rep.mutable_velocity()->mutable_i_gain_optional()->set_data(
+      velPid.GetIGain());
+
+  return true;
+}
 
-  if (this->dataPtr->velPids.find(jointName) !=
-      this->dataPtr->velPids.end())
+/////////////////////////////////////////////////
+void JointController::OnJointCommand(const ignition::msgs::JointCmd &_msg)
+{
+  const int slot = this->JointIndex(_msg.name());
+  if (slot < 0)
   {
-    _rep.mutable_velocity()->mutable_p_gain_optional()->set_data(
-        this->dataPtr->velPids[jointName].GetPGain());
-    _rep.mutable_velocity()->mutable_d_gain_optional()->set_data(
-        this->dataPtr->velPids[jointName].GetDGain());
-    _rep.mutable_velocity()->mutable_i_gain_optional()->set_data(
-        this->dataPtr->velPids[jointName].GetIGain());
+    gzerr << "Unable to find joint[" << _msg.name() << "]\n";
+    return;
   }
 
-  return true;
+  this->ApplyJointCommand(slot, _msg);
 }
 
 /////////////////////////////////////////////////
-void JointController::OnJointCommand(const ignition::msgs::JointCmd &_msg)
+void JointController::ApplyJointCommand(const int _slot,
+    const ignition::msgs::JointCmd &_msg)
 {
-  std::map<std::string, JointPtr>::iterator iter;
-  iter = this->dataPtr->joints.find(_msg.name());
-  if (iter != this->dataPtr->joints.end())
+  if (_msg.reset())
+    this->ClearCommands(_slot);
+
+  if (_msg.has_force_optional())
+    this->SetForce(_slot, _msg.force_optional().data());
+
+  if (_msg.has_position())
   {
-    if (_msg.reset())
+    if (_msg.position().has_target_optional())
     {
-      if (this->dataPtr->forces.find(_msg.name()) !=
-          this->dataPtr->forces.end())
-      {
-        this->dataPtr->forces.erase(this->dataPtr->forces.find(_msg.name()));
-      }
+      this->SetPositionTarget(_slot,
+          _msg.position().target_optional().data());
+    }
 
-      if (this->dataPtr->positions.find(_msg.name()) !=
-          this->dataPtr->positions.end())
-      {
-        this->dataPtr->positions.erase(
-            this->dataPtr->positions.find(_msg.name()));
-      }
+    common::PID &pid = this->dataPtr->posPids[_slot];
 
-      if (this->dataPtr->velocities.find(_msg.name()) !=
-          this->dataPtr->velocities.end())
-      {
-        this->dataPtr->velocities.erase(
-            this->dataPtr->velocities.find(_msg.name()));
-      }
-    }
+    if (_msg.position().has_p_gain_optional())
+      pid.SetPGain(_msg.position().p_gain_optional().data());
+
+    if (_msg.position().has_i_gain_optional())
+      pid.SetIGain(_msg.position().i_gain_optional().data());
 
-    if (_msg.has_force_optional())
-      this->dataPtr->forces[_msg.name()] = _msg.force_optional().data();
+    if (_msg.position().has_d_gain_optional())
+      pid.SetDGain(_msg.position().d_gain_optional().data());
 
-    if (_msg.has_position())
+    if (_msg.position().has_i_max_optional())
+      pid.SetIMax(_msg.position().i_max_optional().data());
+
+    if (_msg.position().has_i_min_optional())
+      pid.SetIMin(_msg.position().i_min_optional().data());
+
+    if (_msg.position().has_limit_optional())
     {
-      if (_msg.position().has_target_optional())
-      {
-        if (!this->SetPositionTarget(_msg.name(),
-            _msg.position().target_optional().data()))
-        {
-          gzerr << "Unable to set position target for joint["
-            << _msg.name() << "]. Joint is not found.\n";
-        }
-      }
+      pid.SetCmdMax(_msg.position().limit_optional().data());
+      pid.SetCmdMin(-_msg.position().limit_optional().data());
+    }
+  }
 
-      if (_msg.position().has_p_gain_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetPGain(
-            _msg.position().p_gain_optional().data());
-      }
+  if (_msg.has_velocity())
+  {
+    if (_msg.velocity().has_target_optional())
+    {
+      this->SetVelocityTarget(_slot,
+          _msg.velocity().target_optional().data());
+    }
 
-      if (_msg.position().has_i_gain_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetIGain(
-            _msg.position().i_gain_optional().data());
-      }
+    common::PID &pid = this->dataPtr->velPids[_slot];
 
-      if (_msg.position().has_d_gain_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetDGain(
-            _msg.position().d_gain_optional().data());
-      }
+    if (_msg.velocity().has_p_gain_optional())
+      pid.SetPGain(_msg.velocity().p_gain_optional().data());
 
-      if (_msg.position().has_i_max_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetIMax(
-            _msg.position().i_max_optional().data());
-      }
+    if (_msg.velocity().has_i_gain_optional())
+      pid.SetIGain(_msg.velocity().i_gain_optional().data());
 
-      if (_msg.position().has_i_min_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetIMin(
-            _msg.position().i_min_optional().data());
-      }
+    if (_msg.velocity().has_d_gain_optional())
+      pid.SetDGain(_msg.velocity().d_gain_optional().data());
 
-      if (_msg.position().has_limit_optional())
-      {
-        this->dataPtr->posPids[_msg.name()].SetCmdMax(
-            _msg.position().limit_optional().data());
-        this->dataPtr->posPids[_msg.name()].SetCmdMin(
-            -_msg.position().limit_optional().data());
-      }
-    }
+    if (_msg.velocity().has_i_max_optional())
+      pid.SetIMax(_msg.velocity().i_max_optional().data());
+
+    if (_msg.velocity().has_i_min_optional())
+      pid.SetIMin(_msg.velocity().i_min_optional().data());
 
-    if (_msg.has_velocity())
+    if (_msg.velocity().has_limit_optional())
     {
-      if (_msg.velocity().has_target_optional())
-      {
-        if (!this->SetVelocityTarget(_msg.name(),
-            _msg.velocity().target_optional().data()))
-        {
-          gzerr << "Unable to set velocity target for joint["
-            << _msg.name() << "]. Joint is not found.\n";
-        }
-      }
+      pid.SetCmdMax(_msg.velocity().limit_optional().data());
+      pid.SetCmdMin(-_msg.velocity().limit_optional().data());
+    }
+  }
+}
 
-      if (_msg.velocity().has_p_gain_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetPGain(
-            _msg.velocity().p_gain_optional().data());
-      }
+/////////////////////////////////////////////////
+/// \brief Copy a PID message into its ignition message.
+/// \param[in] _msg PID message.
+/// \param[out] _ign Ignition PID message to fill.
+static void ToIgnition(const msgs::PID &_msg, ignition::msgs::PID &_ign)
+{
+  if (_msg.has_target())
+    _ign.mutable_target_optional()->set_data(_msg.target());
 
-      if (_msg.velocity().has_i_gain_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetIGain(
-            _msg.velocity().i_gain_optional().data());
-      }
+  if (_msg.has_p_gain())
+    _ign.mutable_p_gain_optional()->set_data(_msg.p_gain());
 
-      if (_msg.velocity().has_d_gain_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetDGain(
-            _msg.velocity().d_gain_optional().data());
-      }
+  if (_msg.has_i_gain())
+    _ign.mutable_i_gain_optional()->set_data(_msg.i_gain());
 
-      if (_msg.velocity().has_i_max_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetIMax(
-            _msg.velocity().i_max_optional().data());
-      }
+  if (_msg.has_d_gain())
+    _ign.mutable_d_gain_optional()->set_data(_msg.d_gain());
 
-      if (_msg.velocity().has_i_min_optional())
-      {
-        this->dataPtr->velPids[_msg.name()].SetIMin(
-            _msg.velocity().i_min_optional().data());
-      }
+  if (_msg.has_i_max())
+    _ign.mutable_i_max_optional()->set_data(_msg.i_max());
+
+  if (_msg.has_i_min())
+    _ign.mutable_i_min_optional()->set_data(_msg.i_min());
 
-      if (_msg.velocity().has_limit_optional())
+  if (_msg.has_limit())
+    _ign.mutable_limit_optional()->set_data(_msg.limit());
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy a joint command into its ignition message, so that both
+/// message types are applied by JointController::ApplyJointCommand.
+/// \param[in] _msg Joint command.
+/// \param[out] _ign Ignition joint command to fill. It is cleared first.
+static void ToIgnition(const msgs::JointCmd &_msg,
+    ignition::msgs::JointCmd &_ign)
+{
+  _ign.Clear();
+  _ign.set_name(_msg.name());
+  _ign.set_axis(_msg.axis());
+  _ign.set_reset(_msg.reset());
+
+  if (_msg.has_force())
+    _ign.mutable_force_optional()->set_data(_msg.force());
+
+  if (_msg.has_position())
+    ToIgnition(_msg.position(), *_ign.mutable_position());
+
+  if (_msg.has_velocity())
+    ToIgnition(_msg.velocity(), *_ign.mutable_velocity());
+}
+
+/////////////////////////////////////////////////
+void JointController::OnJointCommands(const msgs::JointCmd_V &_msg)
+{
+  const int count = _msg.joint_cmd_size();
+  this->dataPtr->batchSlots.resize(count, -1);
+
+  ignition::msgs::JointCmd ignCmd;
+
+  for (int i = 0; i < count; ++i)
+  {
+    const msgs::JointCmd &cmd = _msg.joint_cmd(i);
+
+    // Reuse the slot resolved for the previous batch if the joint at this
+    // position is unchanged.
+    int &slot = this->dataPtr->batchSlots[i];
+    if (slot < 0 || !this->ValidIndex(slot) ||
+        this->dataPtr->names[slot] != cmd.name())
+    {
+      slot = this->JointIndex(cmd.name());
+      if (slot < 0)
       {
-        this->dataPtr->velPids[_msg.name()].SetCmdMax(
-            _msg.velocity().limit_optional().data());
-        this->dataPtr->velPids[_msg.name()].SetCmdMin(
-            -_msg.velocity().limit_optional().data());
+        gzerr << "Unable to find joint[" << cmd.name() << "]\n";
+        continue;
       }
     }
+
+    ToIgnition(cmd, ignCmd);
+    this->ApplyJointCommand(slot, ignCmd);
   }
-  else
-    gzerr << "Unable to find joint[" << _msg.name() << "]\n";
 }
 
 //////////////////////////////////////////////////
 void JointController::SetJointPosition(const std::string & _name,
                                        double _position, int _index)
 {
-  std::map<std::string, JointPtr>::iterator jiter =
-    this->dataPtr->joints.find(_name);
+  const int slot = this->JointIndex(_name);
 
-  if (jiter != this->dataPtr->joints.end())
-    this->SetJointPosition(jiter->second, _position, _index);
+  if (slot >= 0)
+    this->SetJointPosition(this->dataPtr->joints[slot], _position, _index);
   else
     gzwarn << "SetJointPosition [" << _name << "] not found\n";
 }
@@ -392,24 +438,25 @@ void JointController::SetJointPositions(
 {
   // go through all joints in this model and update each one
   //   for each joint update, recursively update all children
-  std::map<std::string, JointPtr>::iterator iter;
   std::map<std::string, double>::const_iterator jiter;
 
-  for (iter = this->dataPtr->joints.begin();
-      iter != this->dataPtr->joints.end(); ++iter)
+  for (auto const &joint : this->dataPtr->joints)
   {
+    if (!joint)
+      continue;
+
     // First try name without scope, i.e. joint_name
-    jiter = _jointPositions.find(iter->second->GetName());
+    jiter = _jointPositions.find(joint->GetName());
 
     if (jiter == _jointPositions.end())
     {
       // Second try name with scope, i.e. model_name::joint_name
-      jiter = _jointPositions.find(iter->second->GetScopedName());
+      jiter = _jointPositions.find(joint->GetScopedName());
       if (jiter == _jointPositions.end())
         continue;
     }
 
-    this->SetJointPosition(iter->second, jiter->second);
+    this->SetJointPosition(joint, jiter->second);
   }
 }
 
@@ -429,48 +476,80 @@ common::Time JointController::GetLastUpdateTime() const
 /////////////////////////////////////////////////
 std::map<std::string, JointPtr> JointController::GetJoints() const
 {
-  return this->dataPtr->joints;
+  std::map<std::string, JointPtr> result;
+  for (auto const &slot : this->dataPtr->slots)
+    result[slot.first] = this->dataPtr->joints[slot.second];
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, common::PID> JointController::GetPositionPIDs() const
 {
-  return this->dataPtr->posPids;
+  std::map<std::string, common::PID> result;
+  for (auto const &slot : this->dataPtr->slots)
+    result[slot.first] = this->dataPtr->posPids[slot.second];
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, common::PID> JointController::GetVelocityPIDs() const
 {
-  return this->dataPtr->velPids;
+  std::map<std::string, common::PID> result;
+  for (auto const &slot : this->dataPtr->slots)
+    result[slot.first] = this->dataPtr->velPids[slot.second];
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, double> JointController::GetForces() const
 {
-  return this->dataPtr->forces;
+  std::map<std::string, double> result;
+  for (auto const &slot : this->dataPtr->slots)
+  {
+    if (this->dataPtr->active[slot.second] & JointControllerPrivate::forceCmd)
+      result[slot.first] = this->dataPtr->forces[slot.second];
+  }
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, double> JointController::GetPositions() const
 {
-  return this->dataPtr->positions;
+  std::map<std::string, double> result;
+  for (auto const &slot : this->dataPtr->slots)
+  {
+    if (this->dataPtr->active[slot.second] &
+        JointControllerPrivate::positionCmd)
+    {
+      result[slot.first] = this->dataPtr->positions[slot.second];
+    }
+  }
+  return result;
 }
 
 /////////////////////////////////////////////////
 std::map<std::string, double> JointController::GetVelocities() const
 {
-  return this->dataPtr->velocities;
+  std::map<std::string, double> result;
+  for (auto const &slot : this->dataPtr->slots)
+  {
+    if (this->dataPtr->active[slot.second] &
+        JointControllerPrivate::velocityCmd)
+    {
+      result[slot.first] = this->dataPtr->velocities[slot.second];
+    }
+  }
+  return result;
 }
 
 //////////////////////////////////////////////////
 void JointController::SetPositionPID(const std::string &_jointName,
                                      const common::PID &_pid)
 {
-  std::map<std::string, JointPtr>::iterator iter;
-  iter = this->dataPtr->joints.find(_jointName);
+  const int slot = this->JointIndex(_jointName);
 
-  if (iter != this->dataPtr->joints.end())
-    this->dataPtr->posPids[_jointName] = _pid;
+  if (slot >= 0)
+    this->dataPtr->posPids[slot] = _pid;
   else
     gzerr << "Unable to find joint with name[" << _jointName << "]\n";
 }
@@ -479,27 +558,18 @@ void JointController::SetPositionPID(const std::string &_jointName,
 bool JointController::SetPositionTarget(const std::string &_jointName,
     const double _target)
 {
-  bool result = false;
-
-  if (this->dataPtr->posPids.find(_jointName) !=
-      this->dataPtr->posPids.end())
-  {
-    this->dataPtr->positions[_jointName] = _target;
-    result = true;
-  }
-
-  return result;
+  const int slot = this->JointIndex(_jointName);
+  return slot >= 0 && this->SetPositionTarget(slot, _target);
 }
 
 //////////////////////////////////////////////////
 void JointController::SetVelocityPID(const std::string &_jointName,
                                      const common::PID &_pid)
 {
-  std::map<std::string, JointPtr>::iterator iter;
-  iter = this->dataPtr->joints.find(_jointName);
+  const int slot = this->JointIndex(_jointName);
 
-  if (iter != this->dataPtr->joints.end())
-    this->dataPtr->velPids[_jointName] = _pid;
+  if (slot >= 0)
+    this->dataPtr->velPids[slot] = _pid;
   else
     gzerr << "Unable to find joint with name[" << _jointName << "]\n";
 }
@@ -508,30 +578,97 @@ void JointController::SetVelocityPID(const std::string &_jointName,
 bool JointController::SetVelocityTarget(const std::string &_jointName,
     const double _target)
 {
-  bool result = false;
-
-  if (this->dataPtr->velPids.find(_jointName) !=
-      this->dataPtr->velPids.end())
-  {
-    this->dataPtr->velocities[_jointName] = _target;
-    result = true;
-  }
-
-  return result;
+  const int slot = this->JointIndex(_jointName);
+  return slot >= 0 && this->SetVelocityTarget(slot, _target);
 }
 
 /////////////////////////////////////////////////
 bool JointController::SetForce(const std::string &_jointName,
     const double _force)
 {
-  bool result = false;
+  const int slot = this->JointIndex(_jointName);
+  return slot >= 0 && this->SetForce(slot, _force);
+}
 
-  if (this->dataPtr->joints.find(_jointName) !=
-      this->dataPtr->joints.end())
-  {
-    this->dataPtr->forces[_jointName] = _force;
-    result = true;
-  }
+/////////////////////////////////////////////////
+int JointController::JointIndex(const std::string &_jointName) const
+{
+  auto iter = this->dataPtr->slots.find(_jointName);
+  if (iter == this->dataPtr->slots.end())
+    return -1;
+  return static_cast<int>(iter->second);
+}
 
-  return result;
+/////////////////////////////////////////////////
+bool JointController::ValidIndex(const unsigned int _index) const
+{
+  return _index < this->dataPtr->joints.size() &&
+      this->dataPtr->joints[_index];
+}
+
+/////////////////////////////////////////////////
+bool JointController::SetPositionPID(const unsigned int _index,
+    const common::PID &_pid)
+{
+  if (!this->ValidIndex(_index))
+    return false;
+
+  this->dataPtr->posPids[_index] = _pid;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool JointController::SetPositionTarget(const unsigned int _index,
+    const double _target)
+{
+  if (!this->ValidIndex(_index))
+    return false;
+
+  this->dataPtr->positions[_index] = _target;
+  this->dataPtr->active[_index] |= JointControllerPrivate::positionCmd;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool JointController::SetVelocityPID(const unsigned int _index,
+    const common::PID &_pid)
+{
+  if (!this->ValidIndex(_index))
+    return false;
+
+  this->dataPtr->velPids[_index] = _pid;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool JointController::SetVelocityTarget(const unsigned int _index,
+    const double _target)
+{
+  if (!this->ValidIndex(_index))
+    return false;
+
+  this->dataPtr->velocities[_index] = _target;
+  this->dataPtr->active[_index] |= JointControllerPrivate::velocityCmd;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool JointController::SetForce(const unsigned int _index, const double _force)
+{
+  if (!this->ValidIndex(_index))
+    return false;
+
+  this->dataPtr->forces[_index] = _force;
+  this->dataPtr->active[_index] |= JointControllerPrivate::forceCmd;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool JointController::ClearCommands(const unsigned int _index)
+{
+  if (!this->ValidIndex(_index))
+    return false;
+
+  this->dataPtr->active[_index] = 0;
+  return true;
 }
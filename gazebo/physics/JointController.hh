@@ -116,6 +116,53 @@ namespace gazebo
       /// \return False if the joint was not found.
       public: bool SetForce(const std::string &_jointName, const double _force);
 
+      /// \brief Resolve a joint name to an index for the index based
+      /// functions below, which avoid a name lookup on every call. The index
+      /// stays valid until the joint is removed.
+      /// \param[in] _jointName Scoped name of the joint.
+      /// \return Index of the joint, or -1 if the joint was not found.
+      public: int JointIndex(const std::string &_jointName) const;
+
+      /// \brief Set the position PID values for a joint.
+      /// \param[in] _index Index of the joint, see JointIndex.
+      /// \param[in] _pid New position PID controller.
+      /// \return False if the index is not valid.
+      public: bool SetPositionPID(const unsigned int _index,
+                  const common::PID &_pid);
+
+      /// \brief Set the target position for the position PID controller.
+      /// \param[in] _index Index of the joint, see JointIndex.
+      /// \param[in] _target Position target.
+      /// \return False if the index is not valid.
+      public: bool SetPositionTarget(const unsigned int _index,
+                  const double _target);
+
+      /// \brief Set the velocity PID values for a joint.
+      /// \param[in] _index Index of the joint, see JointIndex.
+      /// \param[in] _pid New velocity PID controller.
+      /// \return False if the index is not valid.
+      public: bool SetVelocityPID(const unsigned int _index,
+                  const common::PID &_pid);
+
+      /// \brief Set the target velocity for the velocity PID controller.
+      /// \param[in] _index Index of the joint, see JointIndex.
+      /// \param[in] _target Velocity target.
+      /// \return False if the index is not valid.
+      public: bool SetVelocityTarget(const unsigned int _index,
+                  const double _target);
+
+      /// \brief Set the applied effort for a joint.
+      /// This force will persist across time steps.
+      /// \param[in] _index Index of the joint, see JointIndex.
+      /// \param[in] _force Force to apply.
+      /// \return False if the index is not valid.
+      public: bool SetForce(const unsigned int _index, const double _force);
+
+      /// \brief Clear the force, position and velocity commands of a joint.
+      /// \param[in] _index Index of the joint, see JointIndex.
+      /// \return False if the index is not valid.
+      public: bool ClearCommands(const unsigned int _index);
+
       /// \brief Get all the position PID controllers.
       /// \return A map<joint_name, PID> for all the position PID
       /// controllers.
@@ -155,6 +202,24 @@ namespace gazebo
       /// \param[in] _msg The received message.
       private: void OnJointCommand(const ignition::msgs::JointCmd &_msg);
 
+      /// \brief Apply a joint command to a controlled joint. Commands of
+      /// both msgs::JointCmd_V and ignition::msgs::JointCmd messages are
+      /// applied here, so that their fields are handled the same way.
+      /// \param[in] _slot Index of the joint.
+      /// \param[in] _msg The joint command.
+      private: void ApplyJointCommand(const int _slot,
+          const ignition::msgs::JointCmd &_msg);
+
+      /// \brief Callback when a batch of joint commands is received. All
+      /// commands in the batch are applied before the next update.
+      /// \param[in] _msg The received message.
+      private: void OnJointCommands(const msgs::JointCmd_V &_msg);
+
+      /// \brief Check that an index refers to a controlled joint.
+      /// \param[in] _index Index of the joint.
+      /// \return True if the index is valid.
+      private: bool ValidIndex(const unsigned int _index) const;
+
       /// \brief Set the positions of a Joint by name
       ///        The position is specified in native units, which means,
       ///        if you are using metric system, it's meters for SliderJoint
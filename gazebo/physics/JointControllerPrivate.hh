@@ -17,8 +17,10 @@
 #ifndef _GAZEBO_JOINTCONTROLLER_PRIVATE_HH_
 #define _GAZEBO_JOINTCONTROLLER_PRIVATE_HH_
 
+#include <cstdint>
 #include <string>
 #include <map>
+#include <vector>
 #include <ignition/transport.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -38,23 +40,55 @@ namespace gazebo
       /// \brief List of links that have been updated.
       public: Link_V updatedLinks;
 
-      /// \brief Map of joint names to the joint pointer.
-      public: std::map<std::string, JointPtr> joints;
+      /// \brief Bit set in JointControllerPrivate::active when a force
+      /// command is active.
+      public: static const uint8_t forceCmd = 1;
 
-      /// \brief Position PID controllers.
-      public: std::map<std::string, common::PID> posPids;
+      /// \brief Bit set in JointControllerPrivate::active when a position
+      /// target is active.
+      public: static const uint8_t positionCmd = 2;
 
-      /// \brief Velocity PID controllers.
-      public: std::map<std::string, common::PID> velPids;
+      /// \brief Bit set in JointControllerPrivate::active when a velocity
+      /// target is active.
+      public: static const uint8_t velocityCmd = 4;
 
-      /// \brief Forces applied to joints.
-      public: std::map<std::string, double> forces;
+      /// \brief Map of scoped joint names to joint slots. Names are only
+      /// resolved here; all other per joint state is stored in contiguous
+      /// arrays indexed by slot.
+      public: std::map<std::string, unsigned int> slots;
 
-      /// \brief Joint positions.
-      public: std::map<std::string, double> positions;
+      /// \brief Slots released by RemoveJoint, reused by AddJoint.
+      public: std::vector<unsigned int> freeSlots;
 
-      /// \brief Joint velocities.
-      public: std::map<std::string, double> velocities;
+      /// \brief Joint in each slot, null for free slots.
+      public: std::vector<JointPtr> joints;
+
+      /// \brief Scoped joint name of each slot.
+      public: std::vector<std::string> names;
+
+      /// \brief Active commands of each slot, a combination of forceCmd,
+      /// positionCmd and velocityCmd.
+      public: std::vector<uint8_t> active;
+
+      /// \brief Position PID controller of each slot.
+      public: std::vector<common::PID> posPids;
+
+      /// \brief Velocity PID controller of each slot.
+      public: std::vector<common::PID> velPids;
+
+      /// \brief Force applied to the joint in each slot.
+      public: std::vector<double> forces;
+
+      /// \brief Position target of each slot.
+      public: std::vector<double> positions;
+
+      /// \brief Velocity target of each slot.
+      public: std::vector<double> velocities;
+
+      /// \brief Slots resolved for the joint names of the last batched
+      /// command, in message order. Publishers usually send the same joints
+      /// in the same order, so names only need to be looked up once.
+      public: std::vector<int> batchSlots;
 
       /// \brief Node for communication.
       /// \deprecated See JointControllerPrivate::node.
@@ -350,6 +350,155 @@ TEST_F(JointControllerTest, JointCmd)
   EXPECT_DOUBLE_EQ(rep.velocity().d_gain_optional().data(), 9);
 }
 
+/////////////////////////////////////////////////
+TEST_F(JointControllerTest, JointIndex)
+{
+  // Create a dummy model
+  physics::ModelPtr model(new physics::Model(physics::BasePtr()));
+  EXPECT_TRUE(model != NULL);
+
+  // Create the joint controller
+  physics::JointControllerPtr jointController(
+      new physics::JointController(model));
+  EXPECT_TRUE(jointController != NULL);
+
+  physics::JointPtr joint1(new FakeJoint(model));
+  joint1->SetName("joint1");
+
+  physics::JointPtr joint2(new FakeJoint(model));
+  joint2->SetName("joint2");
+
+  jointController->AddJoint(joint1);
+  jointController->AddJoint(joint2);
+
+  int index1 = jointController->JointIndex(joint1->GetScopedName());
+  int index2 = jointController->JointIndex(joint2->GetScopedName());
+  EXPECT_GE(index1, 0);
+  EXPECT_GE(index2, 0);
+  EXPECT_NE(index1, index2);
+  EXPECT_EQ(jointController->JointIndex("my_bad_name"), -1);
+
+  // Commands set by index are visible by name
+  EXPECT_TRUE(jointController->SetPositionTarget(index1, 1.5));
+  EXPECT_TRUE(jointController->SetVelocityTarget(index2, -0.5));
+  EXPECT_TRUE(jointController->SetForce(index2, 2.0));
+  EXPECT_TRUE(jointController->SetPositionPID(index1, common::PID(4, 1, 9)));
+  EXPECT_TRUE(jointController->SetVelocityPID(index2, common::PID(3, 2, 1)));
+
+  std::map<std::string, double> positions = jointController->GetPositions();
+  EXPECT_EQ(positions.size(), 1u);
+  EXPECT_DOUBLE_EQ(positions[joint1->GetScopedName()], 1.5);
+
+  std::map<std::string, double> velocities = jointController->GetVelocities();
+  EXPECT_EQ(velocities.size(), 1u);
+  EXPECT_DOUBLE_EQ(velocities[joint2->GetScopedName()], -0.5);
+
+  std::map<std::string, double> forces = jointController->GetForces();
+  EXPECT_EQ(forces.size(), 1u);
+  EXPECT_DOUBLE_EQ(forces[joint2->GetScopedName()], 2.0);
+
+  std::map<std::string, common::PID> posPids =
+    jointController->GetPositionPIDs();
+  EXPECT_DOUBLE_EQ(posPids[joint1->GetScopedName()].GetPGain(), 4);
+  std::map<std::string, common::PID> velPids =
+    jointController->GetVelocityPIDs();
+  EXPECT_DOUBLE_EQ(velPids[joint2->GetScopedName()].GetPGain(), 3);
+
+  // Clear the commands of one joint
+  EXPECT_TRUE(jointController->ClearCommands(index2));
+  EXPECT_TRUE(jointController->GetVelocities().empty());
+  EXPECT_TRUE(jointController->GetForces().empty());
+  EXPECT_EQ(jointController->GetPositions().size(), 1u);
+
+  // Invalid indices are rejected
+  EXPECT_FALSE(jointController->SetPositionTarget(100u, 1.0));
+  EXPECT_FALSE(jointController->SetForce(100u, 1.0));
+  EXPECT_FALSE(jointController->ClearCommands(100u));
+
+  // Removing a joint invalidates its index, and the index is reused by the
+  // next joint that is added.
+  jointController->RemoveJoint(joint1.get());
+  EXPECT_EQ(jointController->JointIndex(joint1->GetScopedName()), -1);
+  EXPECT_FALSE(jointController->SetPositionTarget(index1, 1.0));
+  EXPECT_TRUE(jointController->GetPositions().empty());
+  EXPECT_EQ(jointController->GetJoints().size(), 1u);
+
+  physics::JointPtr joint3(new FakeJoint(model));
+  joint3->SetName("joint3");
+  jointController->AddJoint(joint3);
+  EXPECT_EQ(jointController->JointIndex(joint3->GetScopedName()), index1);
+  EXPECT_TRUE(jointController->GetPositions().empty());
+  EXPECT_EQ(jointController->GetJoints().size(), 2u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(JointControllerTest, JointCmdBatch)
+{
+  // Create a dummy model
+  physics::ModelPtr model(new physics::Model(physics::BasePtr()));
+  EXPECT_TRUE(model != NULL);
+
+  // Create the joint controller
+  physics::JointControllerPtr jointController(
+      new physics::JointController(model));
+  EXPECT_TRUE(jointController != NULL);
+
+  physics::JointPtr joint1(new FakeJoint(model));
+  joint1->SetName("joint1");
+
+  physics::JointPtr joint2(new FakeJoint(model));
+  joint2->SetName("joint2");
+
+  jointController->AddJoint(joint1);
+  jointController->AddJoint(joint2);
+
+  std::string modelName = model->GetScopedName();
+  if (modelName.empty())
+  {
+     modelName = model->GetName();
+  }
+  boost::replace_all(modelName, "::", "/");
+
+  ignition::transport::Node node;
+  auto pub = node.Advertise<msgs::JointCmd_V>("/" + modelName + "/joint_cmds");
+
+  msgs::JointCmd_V msg;
+  msgs::JointCmd *cmd = msg.add_joint_cmd();
+  cmd->set_name(joint1->GetScopedName());
+  cmd->mutable_position()->set_target(0.7);
+  cmd->mutable_position()->set_p_gain(5);
+  cmd = msg.add_joint_cmd();
+  cmd->set_name(joint2->GetScopedName());
+  cmd->set_force(1.1);
+  cmd->mutable_velocity()->set_target(0.2);
+
+  // Wait for the subscriber to be discovered, so that the batch is
+  // published only once.
+  for (int i = 0; i < 50 && !pub.HasConnections(); ++i)
+    common::Time::MSleep(100);
+  ASSERT_TRUE(pub.HasConnections());
+  pub.Publish(msg);
+
+  // Wait until every command type of the batch is applied
+  for (int i = 0; i < 50 && (jointController->GetPositions().empty() ||
+       jointController->GetForces().empty() ||
+       jointController->GetVelocities().empty()); ++i)
+  {
+    common::Time::MSleep(100);
+  }
+
+  std::map<std::string, double> positions = jointController->GetPositions();
+  ASSERT_EQ(positions.size(), 1u);
+  EXPECT_DOUBLE_EQ(positions[joint1->GetScopedName()], 0.7);
+  EXPECT_DOUBLE_EQ(
+      jointController->GetPositionPIDs()[joint1->GetScopedName()].GetPGain(),
+      5);
+  EXPECT_DOUBLE_EQ(
+      jointController->GetForces()[joint2->GetScopedName()], 1.1);
+  EXPECT_DOUBLE_EQ(
+      jointController->GetVelocities()[joint2->GetScopedName()], 0.2);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -20,9 +20,16 @@
 #include <string.h>
 #include <math.h>
 
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <utility>
+
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Image.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
 
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
@@ -43,6 +50,7 @@ MapShape::MapShape(CollisionPtr _parent)
   this->AddType(Base::MAP_SHAPE);
 
   this->root = new QuadNode(NULL);
+  this->mapImage = NULL;
 }
 
 //////////////////////////////////////////////////
@@ -79,16 +87,33 @@ void MapShape::Load(sdf::ElementPtr _sdf)
 
   if (!this->mapImage->Valid())
     gzthrow(std::string("Unable to open image file[") + imageFilename + "]");
-}
 
-//////////////////////////////////////////////////
-void MapShape::Init()
-{
+  // Count the occupied pixels once, so that each node of the tree counts
+  // its pixels in constant time
+  const unsigned int width = this->mapImage->GetWidth();
+  const unsigned int height = this->mapImage->GetHeight();
+  const int threshold = this->GetThreshold();
+  this->occupiedSums.assign((width + 1) * (height + 1), 0);
+  for (unsigned int y = 0; y < height; ++y)
+  {
+    unsigned int rowSum = 0;
+    for (unsigned int x = 0; x < width; ++x)
+    {
+      ignition::math::Color pixColor = this->mapImage->Pixel(x, y);
+      unsigned char v = (unsigned char)(255 *
+          ((pixColor.R() + pixColor.G() + pixColor.B()) / 3.0));
+      if (v <= threshold)
+        ++rowSum;
+      this->occupiedSums[(y + 1) * (width + 1) + x + 1] =
+          this->occupiedSums[y * (width + 1) + x + 1] + rowSum;
+    }
+  }
+
   this->root->x = 0;
   this->root->y = 0;
 
-  this->root->width = this->mapImage->GetWidth();
-  this->root->height = this->mapImage->GetHeight();
+  this->root->width = width;
+  this->root->height = height;
 
   this->BuildTree(this->root);
 
@@ -99,7 +124,22 @@ void MapShape::Init()
     this->ReduceTree(this->root);
   }
 
-  this->CreateBoxes(this->root);
+  // Collisions are added to the link here rather than in Init, which is
+  // called while the link iterates over its children.
+  std::vector<QuadNode *> nodes;
+  this->OccupiedNodes(this->root, nodes);
+  if (this->Output() == MESH)
+    this->CreateMeshes(nodes);
+  else
+    this->CreateBoxes(nodes);
+
+  this->occupiedSums.clear();
+  this->occupiedSums.shrink_to_fit();
+}
+
+//////////////////////////////////////////////////
+void MapShape::Init()
+{
 }
 
 //////////////////////////////////////////////////
@@ -159,61 +199,232 @@ int MapShape::GetGranularity() const
 }
 
 //////////////////////////////////////////////////
-void MapShape::CreateBoxes(QuadNode * /*_node*/)
+MapShape::OutputType MapShape::Output() const
 {
-  /*TODO: fix this to use SDF
-  if (node->leaf)
+  if (this->sdf->HasElement("gz:output") &&
+      this->sdf->GetElement("gz:output")->Get<std::string>() == "mesh")
   {
-    if (!node->valid || !node->occupied)
-      return;
+    return MESH;
+  }
+  return BOXES;
+}
 
-    std::ostringstream stream;
+//////////////////////////////////////////////////
+unsigned int MapShape::TileSize() const
+{
+  unsigned int tileSize = 0;
+  if (this->sdf->HasElement("gz:tile_size"))
+  {
+    std::istringstream stream(
+        this->sdf->GetElement("gz:tile_size")->Get<std::string>());
+    stream >> tileSize;
+  }
+  return tileSize;
+}
 
-    // Create the box geometry
-    CollisionPtr collision = this->GetWorld()-Physics()->CreateCollision("box", this->collisionParent->GetLink());
-    collision->SetSaveable(false);
+//////////////////////////////////////////////////
+unsigned int MapShape::CollisionCount() const
+{
+  return this->collisionCount;
+}
 
-    stream << "<gazebo:world xmlns:gazebo =\"http://playerstage.sourceforge.net/gazebo/xmlschema/#gz\" xmlns:collision =\"http://playerstage.sourceforge.net/gazebo/xmlschema/#collision\">";
+//////////////////////////////////////////////////
+void MapShape::OccupiedNodes(QuadNode *_node,
+    std::vector<QuadNode *> &_nodes) const
+{
+  if (!_node->valid)
+    return;
 
-    float x = (node->x + node->width / 2.0) * this->sdf->Get<double>("scale");
-    float y = (node->y + node->height / 2.0) * this->sdf->Get<double>("scale");
-    float z = this->sdf->Get<double>("height") / 2.0;
-    float xSize = (node->width) * this->sdf->Get<double>("scale");
-    float ySize = (node->height) * this->sdf->Get<double>("scale");
-    float zSize = this->sdf->Get<double>("height");
+  if (_node->leaf)
+  {
+    if (_node->occupied)
+      _nodes.push_back(_node);
+    return;
+  }
 
-    char collisionName[256];
-    sprintf(collisionName, "map_collision_%d", collisionCounter++);
+  for (auto child : _node->children)
+    this->OccupiedNodes(child, _nodes);
+}
 
-    stream << "<collision:box name ='" << collisionName << "'>";
-    stream << "  <xyz>" << x << " " << y << " " << z << "</xyz>";
-    stream << "  <rpy>0 0 0</rpy>";
-    stream << "  <size>" << xSize << " " << ySize << " " << zSize << "</size>";
-    stream << "  <static>true</static>";
-    stream << "  <visual>";
-    stream << "    <mesh>unit_box</mesh>";
-    stream << "    <material>" << this->materialP->GetValue() << "</material>";
-    stream << "    <size>" << xSize << " "<< ySize << " " << zSize << "</size>";
-    stream << "  </visual>";
-    stream << "</collision:box>";
-    stream << "</gazebo:world>";
+//////////////////////////////////////////////////
+void MapShape::CreateBoxes(const std::vector<QuadNode *> &_nodes)
+{
+  const double mapScale = this->Scale().X();
+  const double height = this->GetHeight();
 
-    boxConfig->LoadString(stream.str());
+  for (auto node : _nodes)
+  {
+    ignition::math::Pose3d pose(
+        (node->x + node->width / 2.0) * mapScale,
+        (node->y + node->height / 2.0) * mapScale,
+        height / 2.0, 0, 0, 0);
 
-    collision->SetStatic(true);
-    collision->Load(boxConfig->GetRootNode()->GetChild());
+    std::ostringstream geometry;
+    geometry << "<geometry><box><size>"
+             << node->width * mapScale << " " << node->height * mapScale
+             << " " << height << "</size></box></geometry>";
 
-    delete boxConfig;
+    this->CreateCollision("box", pose, geometry.str());
   }
-  else
+}
+
+//////////////////////////////////////////////////
+/// \brief Add a quad to a submesh.
+/// \param[in] _subMesh The submesh.
+/// \param[in] _corners Corners of the quad, counterclockwise seen from
+/// the outside.
+static void AddQuad(common::SubMesh *_subMesh,
+    const ignition::math::Vector3d (&_corners)[4])
+{
+  const ignition::math::Vector3d normal =
+      (_corners[1] - _corners[0]).Cross(_corners[2] - _corners[0]).Normalize();
+
+  const unsigned int first = _subMesh->GetVertexCount();
+  for (auto const &corner : _corners)
   {
-    std::deque<QuadNode*>::iterator iter;
-    for (iter = node->children.begin(); iter != node->children.end(); iter++)
+    _subMesh->AddVertex(corner);
+    _subMesh->AddNormal(normal);
+  }
+
+  _subMesh->AddIndex(first);
+  _subMesh->AddIndex(first + 1);
+  _subMesh->AddIndex(first + 2);
+  _subMesh->AddIndex(first);
+  _subMesh->AddIndex(first + 2);
+  _subMesh->AddIndex(first + 3);
+}
+
+//////////////////////////////////////////////////
+void MapShape::CreateMeshes(const std::vector<QuadNode *> &_nodes)
+{
+  const double mapScale = this->Scale().X();
+  const double height = this->GetHeight();
+  const unsigned int tileSize = this->TileSize() > 0 ? this->TileSize() :
+      std::max(this->mapImage->GetWidth(), this->mapImage->GetHeight());
+
+  // Rectangles are assigned to the tile of their first pixel
+  std::map<std::pair<unsigned int, unsigned int>,
+      std::pair<common::Mesh *, common::SubMesh *>> tiles;
+  for (auto node : _nodes)
+  {
+    auto key = std::make_pair(node->x / tileSize, node->y / tileSize);
+    auto iter = tiles.find(key);
+    if (iter == tiles.end())
+    {
+      common::Mesh *mesh = new common::Mesh();
+      common::SubMesh *subMesh = new common::SubMesh();
+      subMesh->SetPrimitiveType(common::SubMesh::TRIANGLES);
+      mesh->AddSubMesh(subMesh);
+      iter = tiles.insert(
+          std::make_pair(key, std::make_pair(mesh, subMesh))).first;
+    }
+    common::SubMesh *subMesh = iter->second.second;
+
+    const int x = node->x;
+    const int y = node->y;
+    const unsigned int w = node->width;
+    const unsigned int h = node->height;
+    const double x0 = x * mapScale;
+    const double y0 = y * mapScale;
+    const double x1 = (x + w) * mapScale;
+    const double y1 = (y + h) * mapScale;
+
+    // Top face. The bottom face lies on the ground and is left out.
+    AddQuad(subMesh, {{x0, y0, height}, {x1, y0, height},
+        {x1, y1, height}, {x0, y1, height}});
+
+    // Side faces, unless the pixels along them are all occupied, in which
+    // case they are inside the walls.
+    if (this->OccupiedCount(x, y - 1, w, 1) < w)
+    {
+      AddQuad(subMesh, {{x0, y0, 0}, {x1, y0, 0},
+          {x1, y0, height}, {x0, y0, height}});
+    }
+    if (this->OccupiedCount(x, y + h, w, 1) < w)
     {
-      this->CreateBoxes(*iter);
+      AddQuad(subMesh, {{x1, y1, 0}, {x0, y1, 0},
+          {x0, y1, height}, {x1, y1, height}});
     }
+    if (this->OccupiedCount(x - 1, y, 1, h) < h)
+    {
+      AddQuad(subMesh, {{x0, y1, 0}, {x0, y0, 0},
+          {x0, y0, height}, {x0, y1, height}});
+    }
+    if (this->OccupiedCount(x + w, y, 1, h) < h)
+    {
+      AddQuad(subMesh, {{x1, y0, 0}, {x1, y1, 0},
+          {x1, y1, height}, {x1, y0, height}});
+    }
+  }
+
+  for (auto &tile : tiles)
+  {
+    // The URI is not a path, so that the mesh shape looks it up by name
+    const std::string meshName = "map://" +
+        this->collisionParent->GetScopedName() + "/" +
+        std::to_string(collisionCounter) + "_" +
+        std::to_string(tile.first.first) + "_" +
+        std::to_string(tile.first.second);
+    tile.second.first->SetName(meshName);
+    common::MeshManager::Instance()->AddMesh(tile.second.first);
+
+    this->CreateCollision("mesh", ignition::math::Pose3d::Zero,
+        "<geometry><mesh><uri>" + meshName + "</uri></mesh></geometry>");
+  }
+}
+
+//////////////////////////////////////////////////
+void MapShape::CreateCollision(const std::string &_type,
+    const ignition::math::Pose3d &_pose, const std::string &_geometry)
+{
+  const ignition::math::Pose3d pose =
+      this->collisionParent->SDFPoseRelativeToParent() * _pose;
+
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>"
+         << "<collision name='map_collision_" << collisionCounter++ << "'>"
+         << "  <pose>" << pose << "</pose>"
+         << _geometry;
+  sdf::ElementPtr parentSDF = this->collisionParent->GetSDF();
+  if (parentSDF->HasElement("surface"))
+    stream << parentSDF->GetElement("surface")->ToString("");
+  stream << "</collision>"
+         << "</sdf>";
+
+  sdf::ElementPtr collisionSDF(new sdf::Element);
+  sdf::initFile("collision.sdf", collisionSDF);
+  if (!sdf::readString(stream.str(), collisionSDF))
+  {
+    gzerr << "Unable to create map collision" << std::endl;
+    return;
   }
-  */
+
+  LinkPtr link = this->collisionParent->GetLink();
+  CollisionPtr collision =
+      this->world->Physics()->CreateCollision(_type, link);
+  collision->SetSaveable(false);
+  collision->Load(collisionSDF);
+  ++this->collisionCount;
+}
+
+//////////////////////////////////////////////////
+unsigned int MapShape::OccupiedCount(int _x, int _y,
+    unsigned int _width, unsigned int _height) const
+{
+  const int width = this->mapImage->GetWidth();
+  const int height = this->mapImage->GetHeight();
+  const int x0 = std::max(_x, 0);
+  const int y0 = std::max(_y, 0);
+  const int x1 = std::min(_x + static_cast<int>(_width), width);
+  const int y1 = std::min(_y + static_cast<int>(_height), height);
+  if (x1 <= x0 || y1 <= y0)
+    return 0;
+
+  auto sum = [&](const int _sx, const int _sy)
+  {
+    return this->occupiedSums[_sy * (width + 1) + _sx];
+  };
+  return sum(x1, y1) - sum(x1, y0) - sum(x0, y1) + sum(x0, y0);
 }
 
 //////////////////////////////////////////////////
@@ -403,29 +614,8 @@ void MapShape::GetPixelCount(unsigned int xStart, unsigned int yStart,
                                  unsigned int &freePixels,
                                  unsigned int &occPixels)
 {
-  ignition::math::Color pixColor;
-  unsigned char v;
-  unsigned int x, y;
-
-  freePixels = occPixels = 0;
-
-  for (y = yStart; y < yStart + height; y++)
-  {
-    for (x = xStart; x < xStart + width; x++)
-    {
-      pixColor = this->mapImage->Pixel(x, y);
-
-      v = (unsigned char)(255 *
-          ((pixColor.R() + pixColor.G() + pixColor.B()) / 3.0));
-      // if (this->sdf->Get<bool>("negative"))
-        // v = 255 - v;
-
-      if (v > this->sdf->Get<int>("threshold"))
-        freePixels++;
-      else
-        occPixels++;
-    }
-  }
+  occPixels = this->OccupiedCount(xStart, yStart, width, height);
+  freePixels = width * height - occPixels;
 }
 
 //////////////////////////////////////////////////
@@ -19,6 +19,7 @@
 
 #include <deque>
 #include <string>
+#include <vector>
 
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/Shape.hh"
@@ -41,9 +42,27 @@ namespace gazebo
 
     /// \class MapShape MapShape.hh physics/physics.hh
     /// \brief Creates box extrusions based on an image.
-    /// This function is not yet complete, to be implemented.
+    ///
+    /// The occupied pixels of the image are split in a quadtree, whose
+    /// leaves are merged into rectangles. When the shape is loaded, the
+    /// rectangles are extruded into collisions added to the link of the
+    /// shape: one box collision per rectangle, or one triangle mesh
+    /// collision per tile of the image. The output is chosen with the
+    /// custom elements <gz:output> ("boxes" or "mesh") and <gz:tile_size>
+    /// (size of the square tiles in pixels, 0 for one mesh) of the <image>
+    /// element.
     class GZ_PHYSICS_VISIBLE MapShape : public Shape
     {
+      /// \brief Geometry generated from the image.
+      public: enum OutputType
+              {
+                /// \brief One box collision per rectangle.
+                BOXES,
+
+                /// \brief One triangle mesh collision per tile.
+                MESH
+              };
+
       /// \brief Constructor.
       /// \param[in] _parent Parent collision object.
       public: explicit MapShape(CollisionPtr _parent);
@@ -99,6 +118,18 @@ namespace gazebo
       /// the 3D shapes created).
       public: int GetGranularity() const;
 
+      /// \brief Get the geometry generated from the image.
+      /// \return The output type.
+      public: OutputType Output() const;
+
+      /// \brief Get the size of the tiles of the mesh output.
+      /// \return Size of the tiles in pixels, 0 for one mesh.
+      public: unsigned int TileSize() const;
+
+      /// \brief Get the number of collisions generated from the image.
+      /// \return Number of boxes or meshes.
+      public: unsigned int CollisionCount() const;
+
       /// \brief Build the quadtree.
       /// \param[in] _node Quad tree node to build.
       private: void BuildTree(QuadNode *_node);
@@ -124,12 +155,39 @@ namespace gazebo
       /// \param[in] _nodeB Second quad tree node
       private: void Merge(QuadNode *_nodeA, QuadNode *_nodeB);
 
-      /// \brief Create boxes that represents the map.
-      private: void CreateBox();
+      /// \brief Get the occupied rectangles of the reduced tree.
+      /// \param[in] _node Quad tree node to get rectangles from.
+      /// \param[out] _nodes The occupied leaves.
+      private: void OccupiedNodes(QuadNode *_node,
+                   std::vector<QuadNode *> &_nodes) const;
 
       /// \brief Create the boxes for the map
-      /// \param[in] _node Quad tree node to create boxes from.
-      private: void CreateBoxes(QuadNode *_node);
+      /// \param[in] _nodes Occupied quad tree leaves to create boxes from.
+      private: void CreateBoxes(const std::vector<QuadNode *> &_nodes);
+
+      /// \brief Create the triangle meshes for the map.
+      /// \param[in] _nodes Occupied quad tree leaves to extrude.
+      private: void CreateMeshes(const std::vector<QuadNode *> &_nodes);
+
+      /// \brief Add a collision to the link of the map.
+      /// \param[in] _type Type of the collision shape.
+      /// \param[in] _pose Pose of the collision relative to the map.
+      /// \param[in] _geometry SDF of the <geometry> element.
+      private: void CreateCollision(const std::string &_type,
+                   const ignition::math::Pose3d &_pose,
+                   const std::string &_geometry);
+
+      /// \brief Get the number of occupied pixels in an area, from the
+      /// summed area table.
+      /// \param[in] _x X pixel location of the area, may be outside the
+      /// image.
+      /// \param[in] _y Y pixel location of the area, may be outside the
+      /// image.
+      /// \param[in] _width Width of the area.
+      /// \param[in] _height Height of the area.
+      /// \return Number of occupied pixels of the area inside the image.
+      private: unsigned int OccupiedCount(int _x, int _y,
+                   unsigned int _width, unsigned int _height) const;
 
       /// \brief Image used to create the map.
       private: common::Image *mapImage;
@@ -140,6 +198,13 @@ namespace gazebo
       /// \brief True if the quad tree nodes have been merged.
       private: bool merged;
 
+      /// \brief Summed area table of the occupied pixels, with one more row
+      /// and column than the image. Only kept while the map is built.
+      private: std::vector<unsigned int> occupiedSums;
+
+      /// \brief Number of collisions generated from the image.
+      private: unsigned int collisionCount = 0;
+
       /// \brief Counter used to create unique names for each collision
       /// object.
       private: static unsigned int collisionCounter;
@@ -31,6 +31,7 @@
 #include "gazebo/common/Animation.hh"
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/EventProfiler.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/CommonIface.hh"
@@ -1128,6 +1129,10 @@ void Model::LoadPlugin(sdf::ElementPtr _sdf)
 
     ModelPtr myself = boost::static_pointer_cast<Model>(shared_from_this());
 
+    // Tag event connections made by the plugin for timing
+    event::EventProfiler::OwnerScope profilerOwner(filename, pluginName,
+        this->GetScopedName());
+
     try
     {
       plugin->Load(myself, _sdf);
@@ -131,6 +131,12 @@ namespace gazebo
       /// \sa PhysicsEngine::UpdateCollision()
       public: virtual void UpdatePhysics() {}
 
+      /// \brief Finish adding the models initialized since the last call.
+      /// Engines that defer part of adding a model, so that the work is
+      /// done once for all the models spawned in a step, complete it here.
+      /// The world calls this before loading the plugins of new models.
+      public: virtual void InitPendingModels() {}
+
       /// \brief Create a new model.
       /// \param[in] _base Boost shared pointer to a new model.
       public: virtual ModelPtr CreateModel(BasePtr _base);
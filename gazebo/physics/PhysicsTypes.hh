@@ -72,6 +72,8 @@ namespace gazebo
     class LinkState;
     class JointState;
     class TrajectoryInfo;
+    class TransformStore;
+    class TriggerManager;
 
     /// \def BasePtr
     /// \brief Boost shared pointer to a Base object
@@ -137,6 +139,10 @@ namespace gazebo
     /// \brief Shared pointer to a UserCmdManager object
     typedef std::shared_ptr<UserCmdManager> UserCmdManagerPtr;
 
+    /// \def  TriggerManagerPtr
+    /// \brief Shared pointer to a TriggerManager object
+    typedef std::shared_ptr<TriggerManager> TriggerManagerPtr;
+
     /// \def ShapePtr
     /// \brief Boost shared pointer to a Shape object
     typedef boost::shared_ptr<Shape> ShapePtr;
@@ -54,20 +54,26 @@ bool Population::PopulateAll()
 
   sdf::ElementPtr popElem = this->dataPtr->populationElem;
   bool result = true;
+  std::vector<std::string> models;
 
   // Iterate through all the population elements in the sdf.
   while (popElem)
   {
-    if (!this->PopulateOne(popElem))
+    if (!this->PopulateOne(popElem, models))
       result = false;
     popElem = popElem->GetNextElement("population");
   }
 
+  // Spawn all the populations as a single batch.
+  if (!models.empty())
+    this->dataPtr->world->InsertModelStrings(models);
+
   return result;
 }
 
 //////////////////////////////////////////////////
-bool Population::PopulateOne(const sdf::ElementPtr _population)
+bool Population::PopulateOne(const sdf::ElementPtr _population,
+    std::vector<std::string> &_models)
 {
   std::vector<ignition::math::Vector3d> objects;
   PopulationParams params;
@@ -129,7 +135,7 @@ bool Population::PopulateOne(const sdf::ElementPtr _population)
       boost::lexical_cast<std::string>(p.Z()) + " 0 0 0</pose>";
     cloneSdf.insert(last + endDelim.size(), pose);
 
-    this->dataPtr->world->InsertModelString(cloneSdf);
+    _models.push_back(cloneSdf);
   }
 
   return true;
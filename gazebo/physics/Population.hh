@@ -97,11 +97,13 @@ namespace gazebo
       /// otherwise.
       public: bool PopulateAll();
 
-      /// \brief Generate and spawn one model population into the world.
+      /// \brief Generate the models of one population.
       /// \param[in] _population SDF parameter containing the population details
-      /// \return True when the population was successfully spawned or false
+      /// \param[out] _models SDF strings of the models are appended here.
+      /// \return True when the population was successfully generated or false
       /// otherwise.
-      private: bool PopulateOne(const sdf::ElementPtr _population);
+      private: bool PopulateOne(const sdf::ElementPtr _population,
+                   std::vector<std::string> &_models);
 
       /// \brief Read a value from an SDF element. Before reading the value, it
       /// checks if the element exists and print an error message if not found.
@@ -0,0 +1,661 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/TransformStore.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+const TransformStore::Handle TransformStore::InvalidHandle =
+    std::numeric_limits<TransformStore::Handle>::max();
+
+/// \brief Index of a removed transform, or of the parent of a root.
+static const uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+/// \brief Depths with at least this many transforms are updated in
+/// parallel.
+static const size_t parallelTransforms = 4096;
+
+/// \brief Number of transforms per parallel task.
+static const size_t transformGrain = 1024;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Components of a pose, in the order they are stored.
+    enum PoseComponent {PX, PY, PZ, QW, QX, QY, QZ, POSE_COMPONENTS};
+
+    /// \internal
+    /// \brief Poses of all transforms of one depth.
+    class TransformLevel
+    {
+      /// \brief Set the relative and world poses of a transform.
+      /// \param[in] _index Index of the transform in the level.
+      /// \param[in] _relative The relative pose.
+      /// \param[in] _world The world pose.
+      public: void Set(const size_t _index,
+                  const ignition::math::Pose3d &_relative,
+                  const ignition::math::Pose3d &_world);
+
+      /// \brief Set the world pose of a transform, without marking it
+      /// dirty.
+      /// \param[in] _index Index of the transform in the level.
+      /// \param[in] _world The world pose.
+      public: void SetWorld(const size_t _index,
+                  const ignition::math::Pose3d &_world);
+
+      /// \brief Get a pose of a transform.
+      /// \param[in] _poses relative or world.
+      /// \param[in] _index Index of the transform in the level.
+      /// \return The pose.
+      public: static ignition::math::Pose3d Get(
+                  const std::vector<double> (&_poses)[POSE_COMPONENTS],
+                  const size_t _index);
+
+      /// \brief Recompute the world poses of a range of transforms.
+      /// \param[in] _parent Level of the parents, null for roots.
+      /// \param[in] _begin First index to update.
+      /// \param[in] _end One past the last index to update.
+      public: void Update(const TransformLevel *_parent, const size_t _begin,
+                  const size_t _end);
+
+      /// \brief Copy the world pose of a transform to its target, if it
+      /// has one.
+      /// \param[in] _index Index of the transform in the level.
+      public: void CopyToTarget(const size_t _index);
+
+      /// \brief Handle of each transform.
+      public: std::vector<TransformStore::Handle> handles;
+
+      /// \brief Handle of the parent of each transform.
+      public: std::vector<TransformStore::Handle> parents;
+
+      /// \brief Pose that Update keeps equal to the world pose of each
+      /// transform, or null.
+      public: std::vector<ignition::math::Pose3d *> targets;
+
+      /// \brief Index of the parent of each transform in the level above.
+      public: std::vector<uint32_t> parentIndex;
+
+      /// \brief Relative poses, one array per component.
+      public: std::vector<double> relative[POSE_COMPONENTS];
+
+      /// \brief World poses, one array per component.
+      public: std::vector<double> world[POSE_COMPONENTS];
+
+      /// \brief True for transforms whose pose was set since the last
+      /// update.
+      public: std::vector<uint8_t> dirty;
+
+      /// \brief True for transforms whose world pose changed in the last
+      /// update, read by the level below.
+      public: std::vector<uint8_t> changed;
+    };
+
+    /// \internal
+    /// \brief Where a transform is stored.
+    class TransformLocation
+    {
+      /// \brief Depth of the transform.
+      public: uint32_t level;
+
+      /// \brief Index in the level, invalidIndex once removed.
+      public: uint32_t index;
+
+      /// \brief Handles of the children of the transform.
+      public: std::vector<TransformStore::Handle> children;
+    };
+
+    /// \internal
+    /// \brief Private data for TransformStore.
+    class TransformStorePrivate
+    {
+      /// \brief Update, with the mutex locked.
+      public: void Update();
+
+      /// \brief Compute the current world pose of a transform from the
+      /// relative poses of its ancestors, even if some of them are dirty.
+      /// \param[in] _location Location of the transform.
+      /// \return The world pose.
+      public: ignition::math::Pose3d CurrentWorldPose(
+                  const TransformLocation &_location) const;
+
+      /// \brief Set the world poses of the descendants of a transform,
+      /// and copy them to their targets.
+      /// \param[in] _location Location of the transform.
+      /// \param[in] _pose Current world pose of the transform.
+      public: void Propagate(const TransformLocation &_location,
+                  const ignition::math::Pose3d &_pose);
+
+      /// \brief Get the location of a transform.
+      /// \param[in] _handle Handle of the transform.
+      /// \return The location, or null if the handle is not valid.
+      public: const TransformLocation *Find(
+                  const TransformStore::Handle _handle) const;
+
+      /// \brief Protects the members below.
+      public: mutable std::mutex mutex;
+
+      /// \brief Transforms by depth.
+      public: std::vector<TransformLevel> levels;
+
+      /// \brief Location of each transform, indexed by handle.
+      public: std::vector<TransformLocation> locations;
+
+      /// \brief Number of transforms.
+      public: size_t size = 0;
+
+      /// \brief True if a pose changed since the last update.
+      public: bool dirty = false;
+
+      /// \brief True if transforms were moved inside their level since the
+      /// last update, so parentIndex has to be recomputed.
+      public: bool indicesDirty = false;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+void TransformLevel::Set(const size_t _index,
+    const ignition::math::Pose3d &_relative,
+    const ignition::math::Pose3d &_world)
+{
+  this->relative[PX][_index] = _relative.Pos().X();
+  this->relative[PY][_index] = _relative.Pos().Y();
+  this->relative[PZ][_index] = _relative.Pos().Z();
+  this->relative[QW][_index] = _relative.Rot().W();
+  this->relative[QX][_index] = _relative.Rot().X();
+  this->relative[QY][_index] = _relative.Rot().Y();
+  this->relative[QZ][_index] = _relative.Rot().Z();
+
+  this->SetWorld(_index, _world);
+  this->dirty[_index] = 1;
+}
+
+//////////////////////////////////////////////////
+void TransformLevel::SetWorld(const size_t _index,
+    const ignition::math::Pose3d &_world)
+{
+  this->world[PX][_index] = _world.Pos().X();
+  this->world[PY][_index] = _world.Pos().Y();
+  this->world[PZ][_index] = _world.Pos().Z();
+  this->world[QW][_index] = _world.Rot().W();
+  this->world[QX][_index] = _world.Rot().X();
+  this->world[QY][_index] = _world.Rot().Y();
+  this->world[QZ][_index] = _world.Rot().Z();
+}
+
+//////////////////////////////////////////////////
+ignition::math::Pose3d TransformLevel::Get(
+    const std::vector<double> (&_poses)[POSE_COMPONENTS], const size_t _index)
+{
+  return ignition::math::Pose3d(
+      _poses[PX][_index], _poses[PY][_index], _poses[PZ][_index],
+      _poses[QW][_index], _poses[QX][_index], _poses[QY][_index],
+      _poses[QZ][_index]);
+}
+
+//////////////////////////////////////////////////
+void TransformLevel::Update(const TransformLevel *_parent,
+    const size_t _begin, const size_t _end)
+{
+  const double *rpx = this->relative[PX].data();
+  const double *rpy = this->relative[PY].data();
+  const double *rpz = this->relative[PZ].data();
+  const double *rqw = this->relative[QW].data();
+  const double *rqx = this->relative[QX].data();
+  const double *rqy = this->relative[QY].data();
+  const double *rqz = this->relative[QZ].data();
+
+  double *wpx = this->world[PX].data();
+  double *wpy = this->world[PY].data();
+  double *wpz = this->world[PZ].data();
+  double *wqw = this->world[QW].data();
+  double *wqx = this->world[QX].data();
+  double *wqy = this->world[QY].data();
+  double *wqz = this->world[QZ].data();
+
+  for (size_t i = _begin; i < _end; ++i)
+  {
+    const uint32_t p = _parent ? this->parentIndex[i] : invalidIndex;
+
+    // Roots, and children of removed transforms
+    if (p == invalidIndex)
+    {
+      this->changed[i] = this->dirty[i];
+      if (this->dirty[i])
+      {
+        wpx[i] = rpx[i];
+        wpy[i] = rpy[i];
+        wpz[i] = rpz[i];
+        wqw[i] = rqw[i];
+        wqx[i] = rqx[i];
+        wqy[i] = rqy[i];
+        wqz[i] = rqz[i];
+        this->dirty[i] = 0;
+        this->CopyToTarget(i);
+      }
+      continue;
+    }
+
+    if (!this->dirty[i] && !_parent->changed[p])
+    {
+      this->changed[i] = 0;
+      continue;
+    }
+
+    const double qw = _parent->world[QW][p];
+    const double qx = _parent->world[QX][p];
+    const double qy = _parent->world[QY][p];
+    const double qz = _parent->world[QZ][p];
+
+    // Rotate the relative position by the parent rotation:
+    // v' = v + w t + q x t, with t = 2 q x v
+    const double tx = 2.0 * (qy * rpz[i] - qz * rpy[i]);
+    const double ty = 2.0 * (qz * rpx[i] - qx * rpz[i]);
+    const double tz = 2.0 * (qx * rpy[i] - qy * rpx[i]);
+
+    wpx[i] = _parent->world[PX][p] + rpx[i] + qw * tx + (qy * tz - qz * ty);
+    wpy[i] = _parent->world[PY][p] + rpy[i] + qw * ty + (qz * tx - qx * tz);
+    wpz[i] = _parent->world[PZ][p] + rpz[i] + qw * tz + (qx * ty - qy * tx);
+
+    wqw[i] = qw * rqw[i] - qx * rqx[i] - qy * rqy[i] - qz * rqz[i];
+    wqx[i] = qw * rqx[i] + qx * rqw[i] + qy * rqz[i] - qz * rqy[i];
+    wqy[i] = qw * rqy[i] - qx * rqz[i] + qy * rqw[i] + qz * rqx[i];
+    wqz[i] = qw * rqz[i] + qx * rqy[i] - qy * rqx[i] + qz * rqw[i];
+
+    this->changed[i] = 1;
+    this->dirty[i] = 0;
+    this->CopyToTarget(i);
+  }
+}
+
+//////////////////////////////////////////////////
+void TransformLevel::CopyToTarget(const size_t _index)
+{
+  if (this->targets[_index])
+    *this->targets[_index] = Get(this->world, _index);
+}
+
+//////////////////////////////////////////////////
+const TransformLocation *TransformStorePrivate::Find(
+    const TransformStore::Handle _handle) const
+{
+  if (_handle >= this->locations.size() ||
+      this->locations[_handle].index == invalidIndex)
+  {
+    return nullptr;
+  }
+  return &this->locations[_handle];
+}
+
+//////////////////////////////////////////////////
+ignition::math::Pose3d TransformStorePrivate::CurrentWorldPose(
+    const TransformLocation &_location) const
+{
+  // Roots keep their world pose as relative pose
+  const TransformLocation *location = &_location;
+  ignition::math::Pose3d pose;
+  while (location)
+  {
+    const TransformLevel &level = this->levels[location->level];
+    pose = pose + TransformLevel::Get(level.relative, location->index);
+    location = this->Find(level.parents[location->index]);
+  }
+  return pose;
+}
+
+//////////////////////////////////////////////////
+void TransformStorePrivate::Propagate(const TransformLocation &_location,
+    const ignition::math::Pose3d &_pose)
+{
+  for (const auto child : _location.children)
+  {
+    const TransformLocation *location = this->Find(child);
+    if (!location)
+      continue;
+
+    TransformLevel &level = this->levels[location->level];
+    const ignition::math::Pose3d pose =
+        TransformLevel::Get(level.relative, location->index) + _pose;
+    level.SetWorld(location->index, pose);
+    level.CopyToTarget(location->index);
+    this->Propagate(*location, pose);
+  }
+}
+
+//////////////////////////////////////////////////
+void TransformStorePrivate::Update()
+{
+  if (!this->dirty)
+    return;
+
+  if (this->indicesDirty)
+  {
+    for (size_t l = 1; l < this->levels.size(); ++l)
+    {
+      TransformLevel &level = this->levels[l];
+      for (size_t i = 0; i < level.parents.size(); ++i)
+      {
+        const TransformLocation *parent = this->Find(level.parents[i]);
+        const uint32_t index = parent ? parent->index : invalidIndex;
+
+        // Children of removed transforms become roots
+        if (index != level.parentIndex[i])
+          level.dirty[i] = 1;
+        level.parentIndex[i] = index;
+      }
+    }
+    this->indicesDirty = false;
+  }
+
+  for (size_t l = 0; l < this->levels.size(); ++l)
+  {
+    TransformLevel &level = this->levels[l];
+    const TransformLevel *parent = l > 0 ? &this->levels[l-1] : nullptr;
+    const size_t count = level.handles.size();
+
+    if (count >= parallelTransforms)
+    {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, count, transformGrain),
+          [&](const tbb::blocked_range<size_t> &_r)
+          {
+            level.Update(parent, _r.begin(), _r.end());
+          });
+    }
+    else
+    {
+      level.Update(parent, 0, count);
+    }
+  }
+
+  this->dirty = false;
+}
+
+//////////////////////////////////////////////////
+TransformStore::TransformStore()
+  : dataPtr(new TransformStorePrivate)
+{
+}
+
+//////////////////////////////////////////////////
+TransformStore::~TransformStore()
+{
+}
+
+//////////////////////////////////////////////////
+TransformStore::Handle TransformStore::Add(const Handle _parent,
+    const ignition::math::Pose3d &_relativePose,
+    ignition::math::Pose3d *_target)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  uint32_t depth = 0;
+  uint32_t parentIndex = invalidIndex;
+  ignition::math::Pose3d worldPose = _relativePose;
+  if (_parent != InvalidHandle)
+  {
+    const TransformLocation *parent = this->dataPtr->Find(_parent);
+    if (!parent)
+    {
+      gzerr << "Unable to add a transform to missing parent[" << _parent
+            << "]\n";
+      return InvalidHandle;
+    }
+    depth = parent->level + 1;
+    parentIndex = parent->index;
+
+    // Give the target a world pose right away, so that it can be read
+    // before the next update
+    worldPose = _relativePose + this->dataPtr->CurrentWorldPose(*parent);
+  }
+
+  if (this->dataPtr->locations.size() >= InvalidHandle)
+  {
+    gzerr << "Transform store is out of handles\n";
+    return InvalidHandle;
+  }
+
+  if (this->dataPtr->levels.size() <= depth)
+    this->dataPtr->levels.resize(depth + 1);
+  TransformLevel &level = this->dataPtr->levels[depth];
+
+  const Handle handle = static_cast<Handle>(this->dataPtr->locations.size());
+  const uint32_t index = static_cast<uint32_t>(level.handles.size());
+
+  level.handles.push_back(handle);
+  level.parents.push_back(_parent);
+  level.targets.push_back(_target);
+  level.parentIndex.push_back(parentIndex);
+  for (unsigned int c = 0; c < POSE_COMPONENTS; ++c)
+  {
+    level.relative[c].push_back(0);
+    level.world[c].push_back(0);
+  }
+  level.dirty.push_back(1);
+  level.changed.push_back(0);
+  level.Set(index, _relativePose, worldPose);
+  level.CopyToTarget(index);
+
+  this->dataPtr->locations.push_back({depth, index, {}});
+  if (_parent != InvalidHandle)
+    this->dataPtr->locations[_parent].children.push_back(handle);
+  ++this->dataPtr->size;
+  this->dataPtr->dirty = true;
+
+  return handle;
+}
+
+//////////////////////////////////////////////////
+void TransformStore::Remove(const Handle _handle)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const TransformLocation *location = this->dataPtr->Find(_handle);
+  if (!location)
+    return;
+
+  TransformLevel &level = this->dataPtr->levels[location->level];
+  const uint32_t index = location->index;
+  const uint32_t last = static_cast<uint32_t>(level.handles.size() - 1);
+
+  if (this->dataPtr->Find(level.parents[index]))
+  {
+    auto &siblings = this->dataPtr->locations[level.parents[index]].children;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), _handle),
+        siblings.end());
+  }
+
+  // Move the last transform of the level into the hole
+  if (index != last)
+  {
+    level.handles[index] = level.handles[last];
+    level.parents[index] = level.parents[last];
+    level.targets[index] = level.targets[last];
+    level.parentIndex[index] = level.parentIndex[last];
+    for (unsigned int c = 0; c < POSE_COMPONENTS; ++c)
+    {
+      level.relative[c][index] = level.relative[c][last];
+      level.world[c][index] = level.world[c][last];
+    }
+    level.dirty[index] = level.dirty[last];
+    level.changed[index] = level.changed[last];
+    this->dataPtr->locations[level.handles[index]].index = index;
+  }
+
+  level.handles.pop_back();
+  level.parents.pop_back();
+  level.targets.pop_back();
+  level.parentIndex.pop_back();
+  for (unsigned int c = 0; c < POSE_COMPONENTS; ++c)
+  {
+    level.relative[c].pop_back();
+    level.world[c].pop_back();
+  }
+  level.dirty.pop_back();
+  level.changed.pop_back();
+
+  this->dataPtr->locations[_handle].index = invalidIndex;
+  this->dataPtr->locations[_handle].children.clear();
+  --this->dataPtr->size;
+  this->dataPtr->indicesDirty = true;
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+bool TransformStore::Valid(const Handle _handle) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->Find(_handle) != nullptr;
+}
+
+//////////////////////////////////////////////////
+void TransformStore::SetRelativePose(const Handle _handle,
+    const ignition::math::Pose3d &_pose)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const TransformLocation *location = this->dataPtr->Find(_handle);
+  if (!location)
+    return;
+
+  TransformLevel &level = this->dataPtr->levels[location->level];
+  level.Set(location->index, _pose,
+      TransformLevel::Get(level.world, location->index));
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+void TransformStore::SetWorldPose(const Handle _handle,
+    const ignition::math::Pose3d &_pose)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const TransformLocation *location = this->dataPtr->Find(_handle);
+  if (!location)
+    return;
+
+  TransformLevel &level = this->dataPtr->levels[location->level];
+  const uint32_t index = location->index;
+
+  ignition::math::Pose3d relative = _pose;
+  const TransformLocation *parent = this->dataPtr->Find(level.parents[index]);
+  if (parent)
+    relative = _pose - this->dataPtr->CurrentWorldPose(*parent);
+
+  level.Set(index, relative, _pose);
+  this->dataPtr->dirty = true;
+}
+
+//////////////////////////////////////////////////
+void TransformStore::UpdateDescendants(const Handle _handle)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const TransformLocation *location = this->dataPtr->Find(_handle);
+  if (!location)
+    return;
+
+  this->dataPtr->Propagate(*location,
+      this->dataPtr->CurrentWorldPose(*location));
+}
+
+//////////////////////////////////////////////////
+ignition::math::Pose3d TransformStore::RelativePose(
+    const Handle _handle) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const TransformLocation *location = this->dataPtr->Find(_handle);
+  if (!location)
+    return ignition::math::Pose3d::Zero;
+
+  return TransformLevel::Get(
+      this->dataPtr->levels[location->level].relative, location->index);
+}
+
+//////////////////////////////////////////////////
+ignition::math::Pose3d TransformStore::WorldPose(const Handle _handle)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const TransformLocation *location = this->dataPtr->Find(_handle);
+  if (!location)
+    return ignition::math::Pose3d::Zero;
+
+  this->dataPtr->Update();
+  return TransformLevel::Get(
+      this->dataPtr->levels[location->level].world, location->index);
+}
+
+//////////////////////////////////////////////////
+void TransformStore::Update()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Update();
+}
+
+//////////////////////////////////////////////////
+bool TransformStore::Dirty() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->dirty;
+}
+
+//////////////////////////////////////////////////
+size_t TransformStore::Size() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+unsigned int TransformStore::Depth() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  unsigned int depth = static_cast<unsigned int>(this->dataPtr->levels.size());
+  while (depth > 0 && this->dataPtr->levels[depth-1].handles.empty())
+    --depth;
+  return depth;
+}
+
+//////////////////////////////////////////////////
+void TransformStore::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->levels.clear();
+
+  // Keep the locations so that handles are not reused
+  for (auto &location : this->dataPtr->locations)
+  {
+    location.index = invalidIndex;
+    location.children.clear();
+  }
+  this->dataPtr->size = 0;
+  this->dataPtr->dirty = false;
+  this->dataPtr->indicesDirty = false;
+}
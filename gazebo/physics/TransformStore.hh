@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_TRANSFORMSTORE_HH_
+#define GAZEBO_PHYSICS_TRANSFORMSTORE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class TransformStorePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class TransformStore TransformStore.hh physics/physics.hh
+    /// \brief Contiguous store of the relative and world poses of a
+    /// transform hierarchy.
+    ///
+    /// Transforms are grouped by depth, and the poses of each depth are kept
+    /// in structure-of-arrays form, so parents always come before their
+    /// children. Setting a pose only marks the transform dirty. Update then
+    /// recomputes the world poses of all dirty transforms and their
+    /// descendants in one linear pass per depth, which runs in parallel for
+    /// large depths.
+    ///
+    /// The world keeps one store, in which links are roots and their
+    /// collisions are children. It updates the store during each step, and
+    /// the collisions read their world pose from their target, without
+    /// locking the store. Add, UpdateDescendants and Update write the
+    /// targets, so the world only calls them with World::WorldPoseMutex
+    /// locked, like every other write of an entity pose. All functions are
+    /// thread safe.
+    class GZ_PHYSICS_VISIBLE TransformStore
+    {
+      /// \brief Handle of a transform. Handles stay valid until the
+      /// transform is removed, and are never reused.
+      public: typedef uint32_t Handle;
+
+      /// \brief Value of a handle that refers to no transform.
+      public: static const Handle InvalidHandle;
+
+      /// \brief Constructor.
+      public: TransformStore();
+
+      /// \brief Destructor.
+      public: virtual ~TransformStore();
+
+      /// \brief Add a transform.
+      /// \param[in] _parent Handle of the parent, or InvalidHandle to add a
+      /// root.
+      /// \param[in] _relativePose Pose relative to the parent. For roots,
+      /// this is the world pose.
+      /// \param[in] _target Optional pose that Update sets to the world
+      /// pose of the transform whenever it changes. It must stay valid
+      /// until the transform is removed or the store is cleared.
+      /// \return Handle of the new transform.
+      public: Handle Add(const Handle _parent,
+                  const ignition::math::Pose3d &_relativePose,
+                  ignition::math::Pose3d *_target = nullptr);
+
+      /// \brief Remove a transform. Children of the transform stay in the
+      /// store, and become roots whose world pose is their relative pose.
+      /// \param[in] _handle Handle of the transform.
+      public: void Remove(const Handle _handle);
+
+      /// \brief Check if a handle refers to a transform in the store.
+      /// \param[in] _handle The handle.
+      /// \return True if the transform exists.
+      public: bool Valid(const Handle _handle) const;
+
+      /// \brief Set the pose of a transform relative to its parent.
+      /// \param[in] _handle Handle of the transform.
+      /// \param[in] _pose The relative pose.
+      public: void SetRelativePose(const Handle _handle,
+                  const ignition::math::Pose3d &_pose);
+
+      /// \brief Set the world pose of a transform. For transforms that have
+      /// a parent, the relative pose is computed from the current world
+      /// pose of the parent. The descendants follow on the next Update, or
+      /// right away through UpdateDescendants.
+      /// \param[in] _handle Handle of the transform.
+      /// \param[in] _pose The world pose.
+      public: void SetWorldPose(const Handle _handle,
+                  const ignition::math::Pose3d &_pose);
+
+      /// \brief Recompute the world poses of the descendants of a
+      /// transform now, and copy them to their targets, without updating
+      /// the rest of the store.
+      /// \param[in] _handle Handle of the transform.
+      public: void UpdateDescendants(const Handle _handle);
+
+      /// \brief Get the pose of a transform relative to its parent.
+      /// \param[in] _handle Handle of the transform.
+      /// \return The relative pose, identity for invalid handles.
+      public: ignition::math::Pose3d RelativePose(const Handle _handle) const;
+
+      /// \brief Get the world pose of a transform. Updates the store first
+      /// if any pose changed since the last update.
+      /// \param[in] _handle Handle of the transform.
+      /// \return The world pose, identity for invalid handles.
+      public: ignition::math::Pose3d WorldPose(const Handle _handle);
+
+      /// \brief Recompute the world poses of all transforms that changed,
+      /// and of their descendants, and copy them to their targets.
+      public: void Update();
+
+      /// \brief Check if any pose changed since the last update.
+      /// \return True if Update has work to do.
+      public: bool Dirty() const;
+
+      /// \brief Get the number of transforms.
+      /// \return Number of transforms in the store.
+      public: size_t Size() const;
+
+      /// \brief Get the number of depths in use.
+      /// \return One more than the depth of the deepest transform.
+      public: unsigned int Depth() const;
+
+      /// \brief Remove all transforms.
+      public: void Clear();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<TransformStorePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
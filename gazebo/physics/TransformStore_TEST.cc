@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/physics/TransformStore.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using TransformStore = physics::TransformStore;
+
+class TransformStoreTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Random pose with a unit quaternion.
+/// \return The pose.
+ignition::math::Pose3d RandomPose()
+{
+  return ignition::math::Pose3d(
+      ignition::math::Rand::DblUniform(-10, 10),
+      ignition::math::Rand::DblUniform(-10, 10),
+      ignition::math::Rand::DblUniform(-10, 10),
+      ignition::math::Rand::DblUniform(-IGN_PI, IGN_PI),
+      ignition::math::Rand::DblUniform(-IGN_PI, IGN_PI),
+      ignition::math::Rand::DblUniform(-IGN_PI, IGN_PI));
+}
+
+/////////////////////////////////////////////////
+/// \brief Expect two poses to be equal within a tolerance.
+/// \param[in] _a First pose.
+/// \param[in] _b Second pose.
+void ExpectPoseNear(const ignition::math::Pose3d &_a,
+    const ignition::math::Pose3d &_b)
+{
+  EXPECT_TRUE(_a.Pos().Equal(_b.Pos(), 1e-9)) << _a << " != " << _b;
+  EXPECT_TRUE(_a.Rot().Equal(_b.Rot(), 1e-9)) << _a << " != " << _b;
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransformStoreTest, Hierarchy)
+{
+  TransformStore store;
+  EXPECT_EQ(store.Size(), 0u);
+  EXPECT_EQ(store.Depth(), 0u);
+  EXPECT_FALSE(store.Valid(0));
+  EXPECT_FALSE(store.Valid(TransformStore::InvalidHandle));
+
+  const ignition::math::Pose3d rootPose(1, 2, 3, 0, 0, IGN_PI * 0.5);
+  const ignition::math::Pose3d childPose(1, 0, 0, 0, 0.3, 0);
+  const ignition::math::Pose3d grandchildPose(0, 0, 1, 0.2, 0, 0);
+
+  auto root = store.Add(TransformStore::InvalidHandle, rootPose);
+  auto child = store.Add(root, childPose);
+  auto grandchild = store.Add(child, grandchildPose);
+  EXPECT_TRUE(store.Valid(root));
+  EXPECT_TRUE(store.Valid(grandchild));
+  EXPECT_EQ(store.Size(), 3u);
+  EXPECT_EQ(store.Depth(), 3u);
+  EXPECT_TRUE(store.Dirty());
+
+  // Missing parent
+  EXPECT_EQ(store.Add(42, rootPose), TransformStore::InvalidHandle);
+
+  // World poses compose the same way as Pose3d::operator+
+  ExpectPoseNear(store.WorldPose(root), rootPose);
+  ExpectPoseNear(store.WorldPose(child), childPose + rootPose);
+  ExpectPoseNear(store.WorldPose(grandchild),
+      grandchildPose + childPose + rootPose);
+  EXPECT_FALSE(store.Dirty());
+
+  // Moving the root moves all descendants
+  const ignition::math::Pose3d newRootPose(-1, 0, 2, 0.1, 0.2, 0.3);
+  store.SetWorldPose(root, newRootPose);
+  EXPECT_TRUE(store.Dirty());
+  store.Update();
+  EXPECT_FALSE(store.Dirty());
+  ExpectPoseNear(store.WorldPose(grandchild),
+      grandchildPose + childPose + newRootPose);
+  ExpectPoseNear(store.RelativePose(grandchild), grandchildPose);
+
+  // Setting the world pose of a child keeps it attached to its parent
+  const ignition::math::Pose3d childWorld(5, 5, 5, 0, 0, 0);
+  store.SetWorldPose(child, childWorld);
+  ExpectPoseNear(store.WorldPose(child), childWorld);
+  ExpectPoseNear(store.RelativePose(child), childWorld - newRootPose);
+  ExpectPoseNear(store.WorldPose(grandchild), grandchildPose + childWorld);
+
+  store.SetWorldPose(root, rootPose);
+  ExpectPoseNear(store.WorldPose(child),
+      (childWorld - newRootPose) + rootPose);
+
+  // Relative poses
+  store.SetRelativePose(child, childPose);
+  ExpectPoseNear(store.WorldPose(grandchild),
+      grandchildPose + childPose + rootPose);
+
+  // Children of a removed transform become roots
+  store.Remove(child);
+  EXPECT_FALSE(store.Valid(child));
+  EXPECT_EQ(store.Size(), 2u);
+  ExpectPoseNear(store.WorldPose(grandchild), grandchildPose);
+  ExpectPoseNear(store.WorldPose(child), ignition::math::Pose3d::Zero);
+
+  // Handles are not reused
+  auto other = store.Add(root, childPose);
+  EXPECT_NE(other, child);
+  EXPECT_FALSE(store.Valid(child));
+
+  store.Clear();
+  EXPECT_EQ(store.Size(), 0u);
+  EXPECT_EQ(store.Depth(), 0u);
+  EXPECT_FALSE(store.Valid(root));
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransformStoreTest, UpdateDescendants)
+{
+  TransformStore store;
+
+  const ignition::math::Pose3d rootPose(1, 2, 3, 0, 0, IGN_PI * 0.5);
+  const ignition::math::Pose3d childPose(1, 0, 0, 0, 0.3, 0);
+  const ignition::math::Pose3d grandchildPose(0, 0, 1, 0.2, 0, 0);
+
+  ignition::math::Pose3d childTarget;
+  ignition::math::Pose3d grandchildTarget;
+  auto root = store.Add(TransformStore::InvalidHandle, rootPose);
+  auto child = store.Add(root, childPose, &childTarget);
+  auto grandchild = store.Add(child, grandchildPose, &grandchildTarget);
+  ExpectPoseNear(grandchildTarget, grandchildPose + childPose + rootPose);
+
+  // The targets follow right away, without a full update
+  const ignition::math::Pose3d newRootPose(-1, 0, 2, 0.1, 0.2, 0.3);
+  store.SetWorldPose(root, newRootPose);
+  store.UpdateDescendants(root);
+  ExpectPoseNear(childTarget, childPose + newRootPose);
+  ExpectPoseNear(grandchildTarget, grandchildPose + childPose + newRootPose);
+  EXPECT_TRUE(store.Dirty());
+
+  // Setting the world pose of a child uses the pose of a dirty parent
+  const ignition::math::Pose3d childWorld(5, 5, 5, 0, 0, 0);
+  store.SetWorldPose(child, childWorld);
+  ExpectPoseNear(store.RelativePose(child), childWorld - newRootPose);
+  store.UpdateDescendants(child);
+  ExpectPoseNear(grandchildTarget, grandchildPose + childWorld);
+
+  // The full update agrees
+  store.Update();
+  ExpectPoseNear(childTarget, childWorld);
+  ExpectPoseNear(grandchildTarget, grandchildPose + childWorld);
+
+  // Removed children are no longer updated
+  store.Remove(grandchild);
+  store.SetWorldPose(root, rootPose);
+  store.UpdateDescendants(root);
+  ExpectPoseNear(childTarget, (childWorld - newRootPose) + rootPose);
+  ExpectPoseNear(grandchildTarget, grandchildPose + childWorld);
+}
+
+/////////////////////////////////////////////////
+// Enough transforms to update in parallel, with removals that move
+// transforms inside their level. Collisions have targets, like in the world.
+TEST_F(TransformStoreTest, Large)
+{
+  TransformStore store;
+
+  const unsigned int linkCount = 2000;
+  const unsigned int collisionCount = 10000;
+
+  std::vector<TransformStore::Handle> links;
+  std::vector<ignition::math::Pose3d> linkPoses;
+  for (unsigned int i = 0; i < linkCount; ++i)
+  {
+    linkPoses.push_back(RandomPose());
+    links.push_back(store.Add(TransformStore::InvalidHandle, linkPoses[i]));
+  }
+
+  std::vector<TransformStore::Handle> collisions;
+  std::vector<ignition::math::Pose3d> collisionPoses;
+  std::vector<ignition::math::Pose3d> targets(collisionCount);
+  for (unsigned int i = 0; i < collisionCount; ++i)
+  {
+    collisionPoses.push_back(RandomPose());
+    collisions.push_back(store.Add(links[i % linkCount], collisionPoses[i],
+        &targets[i]));
+
+    // Targets are set as soon as the transform is added
+    ExpectPoseNear(targets[i], collisionPoses[i] + linkPoses[i % linkCount]);
+  }
+  EXPECT_EQ(store.Size(), linkCount + collisionCount);
+
+  for (unsigned int step = 0; step < 3; ++step)
+  {
+    // Move a subset of the links
+    for (unsigned int i = step; i < linkCount; i += 3)
+    {
+      linkPoses[i] = RandomPose();
+      store.SetWorldPose(links[i], linkPoses[i]);
+    }
+
+    // Remove a link and the last collision
+    store.Remove(links[step * 7]);
+    store.Remove(collisions.back());
+    collisions.pop_back();
+    collisionPoses.pop_back();
+
+    store.Update();
+
+    for (unsigned int i = 0; i < collisions.size(); ++i)
+    {
+      const unsigned int link = i % linkCount;
+      ignition::math::Pose3d expected = collisionPoses[i];
+      if (store.Valid(links[link]))
+        expected = collisionPoses[i] + linkPoses[link];
+      ExpectPoseNear(store.WorldPose(collisions[i]), expected);
+      ExpectPoseNear(targets[i], expected);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,972 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include <ignition/math/AxisAlignedBox.hh>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+#include "gazebo/physics/TriggerManager.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Edge length of the grid cells, in meters.
+static const double cellSize = 2.0;
+
+/// \brief Boxes that cover more cells than this are kept out of the grid,
+/// and are candidates for everything.
+static const int64_t maxCells = 512;
+
+/// \brief Cell coordinates are clamped to this magnitude.
+static const double maxCellIndex = 1 << 20;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Cells covered by a box.
+    class CellRange
+    {
+      /// \brief Equality operator.
+      /// \param[in] _other Range to compare with.
+      /// \return True if both ranges cover the same cells.
+      public: bool operator==(const CellRange &_other) const
+      {
+        if (this->valid != _other.valid || this->unbounded != _other.unbounded)
+          return false;
+        if (!this->valid || this->unbounded)
+          return true;
+        return std::equal(this->min, this->min + 3, _other.min) &&
+               std::equal(this->max, this->max + 3, _other.max);
+      }
+
+      /// \brief True if the range is in a grid.
+      public: bool valid = false;
+
+      /// \brief True if the box covers too many cells to be in the grid.
+      public: bool unbounded = false;
+
+      /// \brief Index of the first cell, along each axis.
+      public: int min[3] = {0, 0, 0};
+
+      /// \brief Index of the last cell, along each axis.
+      public: int max[3] = {0, 0, 0};
+    };
+
+    /// \brief Uniform grid of ids.
+    class TriggerGrid
+    {
+      /// \brief Add an id to the cells of a range.
+      /// \param[in] _id The id.
+      /// \param[in] _range The range.
+      public: void Insert(const unsigned int _id, const CellRange &_range);
+
+      /// \brief Remove an id from the cells of a range.
+      /// \param[in] _id The id.
+      /// \param[in] _range The range it was inserted with.
+      public: void Erase(const unsigned int _id, const CellRange &_range);
+
+      /// \brief Get the ids in the cells of a range, and the unbounded ids.
+      /// \param[in] _range The range.
+      /// \param[out] _ids The ids are added to this set.
+      public: void Query(const CellRange &_range,
+                  std::set<unsigned int> &_ids) const;
+
+      /// \brief Call a function for each cell of a range.
+      /// \param[in] _range The range.
+      /// \param[in] _func Function called with the key of each cell.
+      public: template<typename F>
+              static void ForEachCell(const CellRange &_range, F _func)
+              {
+                for (int x = _range.min[0]; x <= _range.max[0]; ++x)
+                {
+                  for (int y = _range.min[1]; y <= _range.max[1]; ++y)
+                  {
+                    for (int z = _range.min[2]; z <= _range.max[2]; ++z)
+                    {
+                      _func((static_cast<int64_t>(x & 0x1FFFFF) << 42) |
+                            (static_cast<int64_t>(y & 0x1FFFFF) << 21) |
+                            static_cast<int64_t>(z & 0x1FFFFF));
+                    }
+                  }
+                }
+              }
+
+      /// \brief Ids in each cell.
+      public: std::unordered_map<int64_t, std::vector<unsigned int>> cells;
+
+      /// \brief Ids that are in no cell.
+      public: std::set<unsigned int> unbounded;
+
+      /// \brief All the ids.
+      public: std::set<unsigned int> all;
+    };
+
+    /// \brief Entity tracked by the manager.
+    class TrackedEntity
+    {
+      /// \brief The entity.
+      public: EntityPtr entity;
+
+      /// \brief Scoped name of the entity.
+      public: std::string name;
+
+      /// \brief True for models of the world, false for entities that
+      /// volumes asked for.
+      public: bool model = true;
+
+      /// \brief World pose at the last update.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief World bounding box, or the origin when no volume uses
+      /// bounding boxes.
+      public: ignition::math::AxisAlignedBox box;
+
+      /// \brief Cells covered by the box.
+      public: CellRange cells;
+
+      /// \brief Ids of the volumes the entity is in.
+      public: std::set<unsigned int> triggers;
+    };
+
+    /// \brief Trigger volume with its state.
+    class Trigger
+    {
+      /// \brief The description of the volume.
+      public: TriggerVolume volume;
+
+      /// \brief Function called on enter and exit.
+      public: TriggerCallback callback;
+
+      /// \brief Publisher of trigger events.
+      public: transport::PublisherPtr pub;
+
+      /// \brief Entity the volume moves with.
+      public: boost::weak_ptr<Entity> frame;
+
+      /// \brief False while the frame entity doesn't exist.
+      public: bool active = false;
+
+      /// \brief World pose of the volume.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Cells covered by the volume.
+      public: CellRange cells;
+
+      /// \brief Names of the entities that can trigger the volume.
+      public: std::set<std::string> entities;
+
+      /// \brief Names of the entities that can't trigger the volume.
+      public: std::set<std::string> ignore;
+
+      /// \brief Ids of the entities inside.
+      public: std::set<unsigned int> members;
+    };
+
+    /// \brief An entity entered or left a volume.
+    class PendingEvent
+    {
+      /// \brief Id of the volume.
+      public: unsigned int trigger;
+
+      /// \brief The entity.
+      public: EntityPtr entity;
+
+      /// \brief True if the entity entered the volume.
+      public: bool entered;
+    };
+
+    /// \internal
+    /// \brief Private data for TriggerManager.
+    class TriggerManagerPrivate
+    {
+      /// \brief Start tracking an entity.
+      /// \param[in] _entity The entity.
+      /// \param[in] _model True if it's a model of the world.
+      public: void Track(const EntityPtr &_entity, const bool _model);
+
+      /// \brief Stop tracking an entity, and leave all its volumes.
+      /// \param[in] _id Id of the entity.
+      public: void Untrack(const unsigned int _id);
+
+      /// \brief Recompute the box of an entity, and move it in the grid.
+      /// \param[in] _id Id of the entity.
+      /// \param[in] _entity The entity.
+      public: void Refresh(const unsigned int _id, TrackedEntity &_entity);
+
+      /// \brief Recompute the pose of a volume, and move it in the grid.
+      /// \param[in] _id Id of the volume.
+      /// \param[in] _trigger The volume.
+      /// \return True if the volume moved or was activated.
+      public: bool Refresh(const unsigned int _id, Trigger &_trigger);
+
+      /// \brief Make a volume inactive, and make all its entities leave.
+      /// \param[in] _id Id of the volume.
+      /// \param[in] _trigger The volume.
+      public: void Deactivate(const unsigned int _id, Trigger &_trigger);
+
+      /// \brief Test if an entity is in a volume, and record the change.
+      /// \param[in] _triggerId Id of the volume.
+      /// \param[in] _trigger The volume.
+      /// \param[in] _entityId Id of the entity.
+      /// \param[in] _entity The entity.
+      /// \param[in] _notify True to queue an event for the change.
+      public: void Evaluate(const unsigned int _triggerId, Trigger &_trigger,
+                  const unsigned int _entityId, TrackedEntity &_entity,
+                  const bool _notify);
+
+      /// \brief Pointer to the world.
+      public: WorldPtr world;
+
+      /// \brief Protects everything. Recursive so that callbacks can use
+      /// the manager.
+      public: mutable std::recursive_mutex mutex;
+
+      /// \brief Id of the next volume.
+      public: unsigned int nextId = 1;
+
+      /// \brief The volumes, by id.
+      public: std::map<unsigned int, Trigger> triggers;
+
+      /// \brief The tracked entities, by entity id.
+      public: std::unordered_map<unsigned int, TrackedEntity> entities;
+
+      /// \brief Ids of the tracked entities, by scoped name.
+      public: std::unordered_map<std::string, unsigned int> names;
+
+      /// \brief Names asked for by volumes that don't exist yet.
+      public: std::set<std::string> pendingNames;
+
+      /// \brief Grid of the tracked entities.
+      public: TriggerGrid entityGrid;
+
+      /// \brief Grid of the active volumes.
+      public: TriggerGrid triggerGrid;
+
+      /// \brief Number of volumes that use bounding boxes.
+      public: unsigned int overlapCount = 0;
+
+      /// \brief Entities to test on the next update.
+      public: std::set<unsigned int> dirtyEntities;
+
+      /// \brief Volumes to test on the next update.
+      public: std::set<unsigned int> dirtyTriggers;
+
+      /// \brief Events not yet delivered.
+      public: std::vector<PendingEvent> events;
+
+      /// \brief Node for the trigger event topics.
+      public: transport::NodePtr node;
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if a box has a valid extent.
+/// \param[in] _box The box.
+/// \return True if min <= max on all axes.
+static bool ValidBox(const ignition::math::AxisAlignedBox &_box)
+{
+  return _box.Min().X() <= _box.Max().X() &&
+         _box.Min().Y() <= _box.Max().Y() &&
+         _box.Min().Z() <= _box.Max().Z();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the cells covered by a box.
+/// \param[in] _box The box.
+/// \return The range of cells.
+static CellRange Cells(const ignition::math::AxisAlignedBox &_box)
+{
+  CellRange range;
+  range.valid = true;
+
+  int64_t count = 1;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const double min = _box.Min()[i] / cellSize;
+    const double max = _box.Max()[i] / cellSize;
+    if (!std::isfinite(min) || !std::isfinite(max))
+    {
+      range.unbounded = true;
+      return range;
+    }
+
+    range.min[i] = static_cast<int>(std::floor(
+          ignition::math::clamp(min, -maxCellIndex, maxCellIndex)));
+    range.max[i] = static_cast<int>(std::floor(
+          ignition::math::clamp(max, -maxCellIndex, maxCellIndex)));
+    count *= range.max[i] - range.min[i] + 1;
+  }
+
+  range.unbounded = count > maxCells;
+  return range;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the half extents of the box around a volume.
+/// \param[in] _volume The volume.
+/// \return Half extents, in the frame of the volume.
+static ignition::math::Vector3d HalfSize(const TriggerVolume &_volume)
+{
+  switch (_volume.shape)
+  {
+    case TriggerVolume::SPHERE:
+      return ignition::math::Vector3d(
+          _volume.radius, _volume.radius, _volume.radius);
+    case TriggerVolume::CYLINDER:
+      return ignition::math::Vector3d(
+          _volume.radius, _volume.radius, _volume.length * 0.5);
+    case TriggerVolume::BOX:
+    default:
+      return _volume.size * 0.5;
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the axis aligned box around a box rotated by a pose.
+/// \param[in] _min Minimum corner of the box.
+/// \param[in] _max Maximum corner of the box.
+/// \param[in] _pose The pose.
+/// \return The axis aligned box.
+static ignition::math::AxisAlignedBox TransformBox(
+    const ignition::math::Vector3d &_min, const ignition::math::Vector3d &_max,
+    const ignition::math::Pose3d &_pose)
+{
+  ignition::math::Vector3d min(ignition::math::MAX_D, ignition::math::MAX_D,
+      ignition::math::MAX_D);
+  ignition::math::Vector3d max(ignition::math::LOW_D, ignition::math::LOW_D,
+      ignition::math::LOW_D);
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    ignition::math::Vector3d corner(
+        (i & 1) ? _max.X() : _min.X(),
+        (i & 2) ? _max.Y() : _min.Y(),
+        (i & 4) ? _max.Z() : _min.Z());
+    corner = _pose.Rot().RotateVector(corner) + _pose.Pos();
+    min.Min(corner);
+    max.Max(corner);
+  }
+  return ignition::math::AxisAlignedBox(min, max);
+}
+
+/////////////////////////////////////////////////
+/// \brief Test if an entity is in a volume.
+/// \param[in] _trigger The volume.
+/// \param[in] _entity The entity.
+/// \return True if the entity is inside.
+static bool Inside(const Trigger &_trigger, const TrackedEntity &_entity)
+{
+  const TriggerVolume &volume = _trigger.volume;
+  const ignition::math::Vector3d half = HalfSize(volume);
+
+  // Closest point to the center of the volume, in the frame of the volume
+  ignition::math::Vector3d closest;
+  if (volume.overlap && ValidBox(_entity.box))
+  {
+    auto box = TransformBox(_entity.box.Min(), _entity.box.Max(),
+        _trigger.pose.Inverse());
+    closest.Set(
+        ignition::math::clamp(0.0, box.Min().X(), box.Max().X()),
+        ignition::math::clamp(0.0, box.Min().Y(), box.Max().Y()),
+        ignition::math::clamp(0.0, box.Min().Z(), box.Max().Z()));
+  }
+  else
+  {
+    closest = _trigger.pose.Rot().RotateVectorReverse(
+        _entity.pose.Pos() - _trigger.pose.Pos());
+  }
+
+  switch (volume.shape)
+  {
+    case TriggerVolume::SPHERE:
+      return closest.SquaredLength() <= volume.radius * volume.radius;
+    case TriggerVolume::CYLINDER:
+      return std::abs(closest.Z()) <= half.Z() &&
+          closest.X() * closest.X() + closest.Y() * closest.Y() <=
+          volume.radius * volume.radius;
+    case TriggerVolume::BOX:
+    default:
+      return std::abs(closest.X()) <= half.X() &&
+          std::abs(closest.Y()) <= half.Y() &&
+          std::abs(closest.Z()) <= half.Z();
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if a scoped name is an entity or is inside an entity.
+/// \param[in] _name The scoped name.
+/// \param[in] _parent Scoped name of the entity.
+/// \return True if _name is _parent or one of its descendants.
+static bool InEntity(const std::string &_name, const std::string &_parent)
+{
+  return _name.compare(0, _parent.size(), _parent) == 0 &&
+      (_name.size() == _parent.size() ||
+       _name.compare(_parent.size(), 2, "::") == 0);
+}
+
+/////////////////////////////////////////////////
+void TriggerGrid::Insert(const unsigned int _id, const CellRange &_range)
+{
+  if (!_range.valid)
+    return;
+
+  this->all.insert(_id);
+  if (_range.unbounded)
+  {
+    this->unbounded.insert(_id);
+    return;
+  }
+
+  ForEachCell(_range, [&](const int64_t _key)
+      {
+        this->cells[_key].push_back(_id);
+      });
+}
+
+/////////////////////////////////////////////////
+void TriggerGrid::Erase(const unsigned int _id, const CellRange &_range)
+{
+  if (!_range.valid)
+    return;
+
+  this->all.erase(_id);
+  if (_range.unbounded)
+  {
+    this->unbounded.erase(_id);
+    return;
+  }
+
+  ForEachCell(_range, [&](const int64_t _key)
+      {
+        auto cell = this->cells.find(_key);
+        if (cell == this->cells.end())
+          return;
+
+        auto &ids = cell->second;
+        auto iter = std::find(ids.begin(), ids.end(), _id);
+        if (iter != ids.end())
+        {
+          *iter = ids.back();
+          ids.pop_back();
+        }
+        if (ids.empty())
+          this->cells.erase(cell);
+      });
+}
+
+/////////////////////////////////////////////////
+void TriggerGrid::Query(const CellRange &_range,
+    std::set<unsigned int> &_ids) const
+{
+  if (!_range.valid)
+    return;
+
+  if (_range.unbounded)
+  {
+    _ids.insert(this->all.begin(), this->all.end());
+    return;
+  }
+
+  ForEachCell(_range, [&](const int64_t _key)
+      {
+        auto cell = this->cells.find(_key);
+        if (cell != this->cells.end())
+          _ids.insert(cell->second.begin(), cell->second.end());
+      });
+  _ids.insert(this->unbounded.begin(), this->unbounded.end());
+}
+
+/////////////////////////////////////////////////
+void TriggerManagerPrivate::Track(const EntityPtr &_entity, const bool _model)
+{
+  const unsigned int id = _entity->GetId();
+  if (this->entities.count(id))
+    return;
+
+  TrackedEntity &tracked = this->entities[id];
+  tracked.entity = _entity;
+  tracked.name = _entity->GetScopedName();
+  tracked.model = _model;
+  tracked.pose = _entity->WorldPose();
+  this->Refresh(id, tracked);
+
+  this->names[tracked.name] = id;
+  this->pendingNames.erase(tracked.name);
+}
+
+/////////////////////////////////////////////////
+void TriggerManagerPrivate::Untrack(const unsigned int _id)
+{
+  auto iter = this->entities.find(_id);
+  if (iter == this->entities.end())
+    return;
+
+  TrackedEntity &tracked = iter->second;
+  for (auto const &triggerId : tracked.triggers)
+  {
+    auto trigger = this->triggers.find(triggerId);
+    if (trigger == this->triggers.end())
+      continue;
+
+    trigger->second.members.erase(_id);
+    this->events.push_back({triggerId, tracked.entity, false});
+  }
+
+  // Volumes that asked for this entity by name will track it again if it
+  // comes back.
+  for (auto const &trigger : this->triggers)
+  {
+    if (trigger.second.entities.count(tracked.name))
+      this->pendingNames.insert(tracked.name);
+  }
+
+  this->entityGrid.Erase(_id, tracked.cells);
+  this->names.erase(tracked.name);
+  this->dirtyEntities.erase(_id);
+  this->entities.erase(iter);
+}
+
+/////////////////////////////////////////////////
+void TriggerManagerPrivate::Refresh(const unsigned int _id,
+    TrackedEntity &_entity)
+{
+  const ignition::math::Vector3d &pos = _entity.pose.Pos();
+  _entity.box = ignition::math::AxisAlignedBox(pos, pos);
+  if (this->overlapCount > 0)
+  {
+    ignition::math::AxisAlignedBox box = _entity.entity->BoundingBox();
+    if (ValidBox(box))
+      _entity.box.Merge(box);
+  }
+
+  CellRange cells = Cells(_entity.box);
+  if (!(cells == _entity.cells))
+  {
+    this->entityGrid.Erase(_id, _entity.cells);
+    this->entityGrid.Insert(_id, cells);
+    _entity.cells = cells;
+  }
+
+  this->dirtyEntities.insert(_id);
+}
+
+/////////////////////////////////////////////////
+bool TriggerManagerPrivate::Refresh(const unsigned int _id,
+    Trigger &_trigger)
+{
+  ignition::math::Pose3d pose = _trigger.volume.pose;
+  if (!_trigger.volume.frame.empty())
+  {
+    EntityPtr frame = _trigger.frame.lock();
+    if (!frame)
+    {
+      if (_trigger.active)
+        this->Deactivate(_id, _trigger);
+      return false;
+    }
+    pose = _trigger.volume.pose + frame->WorldPose();
+  }
+
+  if (_trigger.active && pose == _trigger.pose)
+    return false;
+
+  _trigger.active = true;
+  _trigger.pose = pose;
+
+  const ignition::math::Vector3d half = HalfSize(_trigger.volume);
+  CellRange cells = Cells(TransformBox(-half, half, pose));
+  if (!(cells == _trigger.cells))
+  {
+    this->triggerGrid.Erase(_id, _trigger.cells);
+    this->triggerGrid.Insert(_id, cells);
+    _trigger.cells = cells;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void TriggerManagerPrivate::Deactivate(const unsigned int _id,
+    Trigger &_trigger)
+{
+  for (auto const &entityId : _trigger.members)
+  {
+    auto entity = this->entities.find(entityId);
+    if (entity == this->entities.end())
+      continue;
+
+    entity->second.triggers.erase(_id);
+    this->events.push_back({_id, entity->second.entity, false});
+  }
+  _trigger.members.clear();
+
+  this->triggerGrid.Erase(_id, _trigger.cells);
+  _trigger.cells = CellRange();
+  _trigger.active = false;
+}
+
+/////////////////////////////////////////////////
+void TriggerManagerPrivate::Evaluate(const unsigned int _triggerId,
+    Trigger &_trigger, const unsigned int _entityId, TrackedEntity &_entity,
+    const bool _notify)
+{
+  bool inside = _trigger.active;
+  if (inside)
+  {
+    if (!_trigger.entities.empty())
+      inside = _trigger.entities.count(_entity.name) > 0;
+    else
+      inside = _entity.model;
+  }
+  inside = inside && !_trigger.ignore.count(_entity.name) &&
+      (_trigger.volume.includeStatic || !_entity.entity->IsStatic()) &&
+      Inside(_trigger, _entity);
+
+  if (inside == (_trigger.members.count(_entityId) > 0))
+    return;
+
+  if (inside)
+  {
+    _trigger.members.insert(_entityId);
+    _entity.triggers.insert(_triggerId);
+  }
+  else
+  {
+    _trigger.members.erase(_entityId);
+    _entity.triggers.erase(_triggerId);
+  }
+
+  if (_notify)
+    this->events.push_back({_triggerId, _entity.entity, inside});
+}
+
+/////////////////////////////////////////////////
+TriggerManager::TriggerManager(const WorldPtr _world)
+  : dataPtr(new TriggerManagerPrivate)
+{
+  this->dataPtr->world = _world;
+}
+
+/////////////////////////////////////////////////
+TriggerManager::~TriggerManager()
+{
+  this->dataPtr->world.reset();
+}
+
+/////////////////////////////////////////////////
+unsigned int TriggerManager::Add(const TriggerVolume &_volume,
+    const TriggerCallback &_callback)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  const unsigned int id = this->dataPtr->nextId++;
+  Trigger &trigger = this->dataPtr->triggers[id];
+  trigger.volume = _volume;
+  trigger.callback = _callback;
+  trigger.entities.insert(_volume.entities.begin(), _volume.entities.end());
+  trigger.ignore.insert(_volume.ignore.begin(), _volume.ignore.end());
+
+  if (!_volume.topic.empty())
+  {
+    if (!this->dataPtr->node)
+    {
+      this->dataPtr->node = transport::NodePtr(new transport::Node());
+      this->dataPtr->node->Init(this->dataPtr->world->Name());
+    }
+    trigger.pub =
+        this->dataPtr->node->Advertise<msgs::TriggerEvent>(_volume.topic);
+  }
+
+  // Bounding boxes are only computed while a volume uses them
+  if (_volume.overlap && this->dataPtr->overlapCount++ == 0)
+  {
+    for (auto &entity : this->dataPtr->entities)
+      this->dataPtr->Refresh(entity.first, entity.second);
+  }
+
+  // Track the entities asked for by name
+  for (auto const &name : trigger.entities)
+  {
+    if (this->dataPtr->names.count(name))
+      continue;
+
+    EntityPtr entity = this->dataPtr->world->EntityByName(name);
+    if (entity)
+      this->dataPtr->Track(entity, false);
+    else
+      this->dataPtr->pendingNames.insert(name);
+  }
+
+  if (!_volume.frame.empty())
+    trigger.frame = this->dataPtr->world->EntityByName(_volume.frame);
+  this->dataPtr->Refresh(id, trigger);
+
+  // Find the entities already inside, without notifying
+  std::set<unsigned int> candidates;
+  this->dataPtr->entityGrid.Query(trigger.cells, candidates);
+  for (auto const &entityId : candidates)
+  {
+    auto entity = this->dataPtr->entities.find(entityId);
+    if (entity != this->dataPtr->entities.end())
+      this->dataPtr->Evaluate(id, trigger, entityId, entity->second, false);
+  }
+
+  return id;
+}
+
+/////////////////////////////////////////////////
+void TriggerManager::Remove(const unsigned int _id)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  auto iter = this->dataPtr->triggers.find(_id);
+  if (iter == this->dataPtr->triggers.end())
+    return;
+
+  Trigger &trigger = iter->second;
+  for (auto const &entityId : trigger.members)
+  {
+    auto entity = this->dataPtr->entities.find(entityId);
+    if (entity != this->dataPtr->entities.end())
+      entity->second.triggers.erase(_id);
+  }
+  this->dataPtr->triggerGrid.Erase(_id, trigger.cells);
+
+  if (trigger.volume.overlap && --this->dataPtr->overlapCount == 0)
+  {
+    for (auto &entity : this->dataPtr->entities)
+      this->dataPtr->Refresh(entity.first, entity.second);
+  }
+
+  auto &events = this->dataPtr->events;
+  events.erase(std::remove_if(events.begin(), events.end(),
+      [_id](const PendingEvent &_event)
+      {
+        return _event.trigger == _id;
+      }), events.end());
+
+  this->dataPtr->dirtyTriggers.erase(_id);
+  this->dataPtr->triggers.erase(iter);
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> TriggerManager::Entities(const unsigned int _id) const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  std::vector<EntityPtr> result;
+  auto iter = this->dataPtr->triggers.find(_id);
+  if (iter == this->dataPtr->triggers.end())
+    return result;
+
+  for (auto const &entityId : iter->second.members)
+  {
+    auto entity = this->dataPtr->entities.find(entityId);
+    if (entity != this->dataPtr->entities.end())
+      result.push_back(entity->second.entity);
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+size_t TriggerManager::Count() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->triggers.size();
+}
+
+/////////////////////////////////////////////////
+void TriggerManager::AddModel(const ModelPtr &_model)
+{
+  if (!_model)
+    return;
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  this->dataPtr->Track(_model, true);
+  const std::string modelName = _model->GetScopedName();
+
+  // Entities of the model that volumes asked for
+  std::vector<std::string> found;
+  for (auto const &name : this->dataPtr->pendingNames)
+  {
+    if (InEntity(name, modelName))
+      found.push_back(name);
+  }
+  for (auto const &name : found)
+  {
+    EntityPtr entity = this->dataPtr->world->EntityByName(name);
+    if (entity)
+      this->dataPtr->Track(entity, false);
+  }
+
+  // Volumes that move with the model or one of its entities
+  for (auto &trigger : this->dataPtr->triggers)
+  {
+    const std::string &frame = trigger.second.volume.frame;
+    if (!frame.empty() && !trigger.second.frame.lock() &&
+        InEntity(frame, modelName))
+    {
+      trigger.second.frame = this->dataPtr->world->EntityByName(frame);
+      if (this->dataPtr->Refresh(trigger.first, trigger.second))
+        this->dataPtr->dirtyTriggers.insert(trigger.first);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void TriggerManager::RemoveModel(const ModelPtr &_model)
+{
+  if (!_model)
+    return;
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  const std::string modelName = _model->GetScopedName();
+
+  std::vector<unsigned int> removed;
+  for (auto const &entity : this->dataPtr->entities)
+  {
+    if (InEntity(entity.second.name, modelName))
+      removed.push_back(entity.first);
+  }
+  for (auto const &id : removed)
+    this->dataPtr->Untrack(id);
+
+  // Volumes that moved with the model
+  for (auto &trigger : this->dataPtr->triggers)
+  {
+    if (!trigger.second.volume.frame.empty() &&
+        InEntity(trigger.second.volume.frame, modelName))
+    {
+      trigger.second.frame.reset();
+      if (trigger.second.active)
+        this->dataPtr->Deactivate(trigger.first, trigger.second);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void TriggerManager::Update()
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+
+  if (this->dataPtr->triggers.empty())
+  {
+    this->dataPtr->dirtyEntities.clear();
+    this->dataPtr->events.clear();
+    return;
+  }
+
+  // Volumes that move with an entity
+  for (auto &trigger : this->dataPtr->triggers)
+  {
+    if (!trigger.second.volume.frame.empty() &&
+        this->dataPtr->Refresh(trigger.first, trigger.second))
+    {
+      this->dataPtr->dirtyTriggers.insert(trigger.first);
+    }
+  }
+
+  // Entities that moved
+  for (auto &entity : this->dataPtr->entities)
+  {
+    ignition::math::Pose3d pose = entity.second.entity->WorldPose();
+    if (pose != entity.second.pose)
+    {
+      entity.second.pose = pose;
+      this->dataPtr->Refresh(entity.first, entity.second);
+    }
+  }
+
+  std::set<unsigned int> candidates;
+  for (auto const &triggerId : this->dataPtr->dirtyTriggers)
+  {
+    auto trigger = this->dataPtr->triggers.find(triggerId);
+    if (trigger == this->dataPtr->triggers.end())
+      continue;
+
+    candidates = trigger->second.members;
+    this->dataPtr->entityGrid.Query(trigger->second.cells, candidates);
+    for (auto const &entityId : candidates)
+    {
+      auto entity = this->dataPtr->entities.find(entityId);
+      if (entity != this->dataPtr->entities.end())
+      {
+        this->dataPtr->Evaluate(triggerId, trigger->second, entityId,
+            entity->second, true);
+      }
+    }
+  }
+  this->dataPtr->dirtyTriggers.clear();
+
+  for (auto const &entityId : this->dataPtr->dirtyEntities)
+  {
+    auto entity = this->dataPtr->entities.find(entityId);
+    if (entity == this->dataPtr->entities.end())
+      continue;
+
+    candidates = entity->second.triggers;
+    this->dataPtr->triggerGrid.Query(entity->second.cells, candidates);
+    for (auto const &triggerId : candidates)
+    {
+      auto trigger = this->dataPtr->triggers.find(triggerId);
+      if (trigger != this->dataPtr->triggers.end())
+      {
+        this->dataPtr->Evaluate(triggerId, trigger->second, entityId,
+            entity->second, true);
+      }
+    }
+  }
+  this->dataPtr->dirtyEntities.clear();
+
+  // Deliver the events. Callbacks may add or remove volumes.
+  std::vector<PendingEvent> events;
+  events.swap(this->dataPtr->events);
+  for (auto const &event : events)
+  {
+    auto trigger = this->dataPtr->triggers.find(event.trigger);
+    if (trigger == this->dataPtr->triggers.end())
+      continue;
+
+    if (trigger->second.pub)
+    {
+      msgs::TriggerEvent msg;
+      msg.set_trigger(trigger->second.volume.name);
+      msg.set_entity(event.entity->GetScopedName());
+      msg.set_entered(event.entered);
+      msgs::Set(msg.mutable_sim_time(), this->dataPtr->world->SimTime());
+      trigger->second.pub->Publish(msg);
+    }
+
+    // Copied, since the callback may remove its own volume
+    TriggerCallback callback = trigger->second.callback;
+    if (callback)
+      callback(event.entity, event.entered);
+  }
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_TRIGGERMANAGER_HH_
+#define GAZEBO_PHYSICS_TRIGGERMANAGER_HH_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class TriggerManagerPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class TriggerVolume TriggerManager.hh physics/physics.hh
+    /// \brief Description of a trigger volume.
+    class GZ_PHYSICS_VISIBLE TriggerVolume
+    {
+      /// \brief Shapes of a volume.
+      public: enum Shape
+              {
+                /// \brief Box of size "size".
+                BOX,
+
+                /// \brief Sphere of radius "radius".
+                SPHERE,
+
+                /// \brief Cylinder of radius "radius" and length "length",
+                /// along the Z axis of the volume.
+                CYLINDER
+              };
+
+      /// \brief Name of the volume, used in trigger events.
+      public: std::string name;
+
+      /// \brief Shape of the volume.
+      public: Shape shape = BOX;
+
+      /// \brief Size of a box.
+      public: ignition::math::Vector3d size = ignition::math::Vector3d::One;
+
+      /// \brief Radius of a sphere or cylinder.
+      public: double radius = 0.5;
+
+      /// \brief Length of a cylinder.
+      public: double length = 1.0;
+
+      /// \brief Pose of the center of the volume, in the frame of the
+      /// "frame" entity, or in the world frame.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Scoped name of the entity the volume moves with. Empty for
+      /// a volume fixed in the world. The volume is inactive while the
+      /// entity doesn't exist.
+      public: std::string frame;
+
+      /// \brief Scoped names of the entities that can trigger the volume.
+      /// Entities other than models, such as links, can be listed. Empty
+      /// to let all models trigger the volume.
+      public: std::vector<std::string> entities;
+
+      /// \brief Scoped names of entities that never trigger the volume.
+      public: std::vector<std::string> ignore;
+
+      /// \brief True to let static models trigger the volume.
+      public: bool includeStatic = false;
+
+      /// \brief True if an entity is inside when its bounding box overlaps
+      /// the volume, false if it is inside when its origin is in the
+      /// volume.
+      public: bool overlap = false;
+
+      /// \brief Topic on which to publish msgs::TriggerEvent messages.
+      /// Empty to not publish.
+      public: std::string topic;
+    };
+
+    /// \brief Function called when an entity enters or leaves a volume.
+    /// \param[in] _entity The entity.
+    /// \param[in] _entered True if the entity entered the volume, false if
+    /// it left.
+    using TriggerCallback =
+        std::function<void(const EntityPtr &_entity, const bool _entered)>;
+
+    /// \class TriggerManager TriggerManager.hh physics/physics.hh
+    /// \brief Detects entities entering and leaving trigger volumes.
+    ///
+    /// The manager keeps the bounding boxes of the models, and of other
+    /// entities that volumes ask for, in a uniform grid, and the bounding
+    /// boxes of the volumes in another. Each world update compares the
+    /// pose of every tracked entity with the last one, and only the
+    /// entities and volumes that moved are tested against the volumes and
+    /// entities of the cells they cover. The cost of an update is one pose
+    /// comparison per tracked entity plus the tests of what moved, however
+    /// many volumes there are. Nothing is done while there are no volumes.
+    ///
+    /// Callbacks are called from the world thread, at the end of the
+    /// world update. All functions are thread safe.
+    class GZ_PHYSICS_VISIBLE TriggerManager
+    {
+      /// \brief Constructor.
+      /// \param[in] _world Pointer to the world.
+      public: explicit TriggerManager(const WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~TriggerManager();
+
+      /// \brief Add a trigger volume. The entities already inside are
+      /// returned by Entities, without calling the callback.
+      /// \param[in] _volume Description of the volume.
+      /// \param[in] _callback Function called when an entity enters or
+      /// leaves the volume, may be empty.
+      /// \return Id of the volume, never 0.
+      public: unsigned int Add(const TriggerVolume &_volume,
+                  const TriggerCallback &_callback = TriggerCallback());
+
+      /// \brief Remove a trigger volume. Its callback isn't called anymore
+      /// once this returns.
+      /// \param[in] _id Id of the volume.
+      public: void Remove(const unsigned int _id);
+
+      /// \brief Get the entities inside a trigger volume.
+      /// \param[in] _id Id of the volume.
+      /// \return The entities, empty for unknown ids.
+      public: std::vector<EntityPtr> Entities(const unsigned int _id) const;
+
+      /// \brief Get the number of trigger volumes.
+      /// \return Number of volumes.
+      public: size_t Count() const;
+
+      /// \brief Start tracking a model. Called by the world when a model is
+      /// added.
+      /// \param[in] _model The model.
+      public: void AddModel(const ModelPtr &_model);
+
+      /// \brief Stop tracking a model and the entities it contains. Called
+      /// by the world when a model is removed. The volumes the model was
+      /// in report that it left, on the next update.
+      /// \param[in] _model The model.
+      public: void RemoveModel(const ModelPtr &_model);
+
+      /// \brief Update the tracked entities and volumes, and call the
+      /// callbacks of the volumes entered or left.
+      public: void Update();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<TriggerManagerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gazebo/physics/TriggerManager.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class TriggerManagerTest : public ServerFixture
+{
+  /// \brief Record an event.
+  /// \param[in] _entity The entity.
+  /// \param[in] _entered True if it entered.
+  public: void OnEvent(const physics::EntityPtr &_entity, const bool _entered)
+  {
+    this->events.push_back(std::make_pair(_entity->GetName(), _entered));
+  }
+
+  /// \brief Events received, entity name and entered flag.
+  public: std::vector<std::pair<std::string, bool>> events;
+};
+
+/////////////////////////////////////////////////
+TEST_F(TriggerManagerTest, EnterExit)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::TriggerManagerPtr triggers = world->Triggers();
+  ASSERT_TRUE(triggers != nullptr);
+  EXPECT_EQ(triggers->Count(), 0u);
+
+  this->SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  physics::TriggerVolume volume;
+  volume.name = "region";
+  volume.size.Set(2, 2, 2);
+  volume.pose.Pos().Set(5, 0, 0.5);
+  unsigned int id = triggers->Add(volume,
+      std::bind(&TriggerManagerTest::OnEvent, this, std::placeholders::_1,
+        std::placeholders::_2));
+  EXPECT_NE(id, 0u);
+  EXPECT_EQ(triggers->Count(), 1u);
+  EXPECT_TRUE(triggers->Entities(id).empty());
+
+  // Enter
+  box->SetWorldPose(ignition::math::Pose3d(5.5, 0.5, 0.5, 0, 0, 0));
+  world->Step(1);
+  ASSERT_EQ(this->events.size(), 1u);
+  EXPECT_EQ(this->events[0].first, "box");
+  EXPECT_TRUE(this->events[0].second);
+  ASSERT_EQ(triggers->Entities(id).size(), 1u);
+  EXPECT_EQ(triggers->Entities(id)[0], box);
+
+  // Moving inside doesn't notify
+  box->SetWorldPose(ignition::math::Pose3d(4.5, -0.5, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_EQ(this->events.size(), 1u);
+
+  // Exit
+  box->SetWorldPose(ignition::math::Pose3d(0, 0, 0.5, 0, 0, 0));
+  world->Step(1);
+  ASSERT_EQ(this->events.size(), 2u);
+  EXPECT_FALSE(this->events[1].second);
+  EXPECT_TRUE(triggers->Entities(id).empty());
+
+  // A volume added around an entity contains it without notifying
+  volume.pose.Pos().Set(0, 0, 0.5);
+  unsigned int id2 = triggers->Add(volume,
+      std::bind(&TriggerManagerTest::OnEvent, this, std::placeholders::_1,
+        std::placeholders::_2));
+  EXPECT_NE(id2, id);
+  EXPECT_EQ(triggers->Entities(id2).size(), 1u);
+  world->Step(1);
+  EXPECT_EQ(this->events.size(), 2u);
+
+  // Removed volumes don't notify
+  triggers->Remove(id2);
+  EXPECT_EQ(triggers->Count(), 1u);
+  EXPECT_TRUE(triggers->Entities(id2).empty());
+  box->SetWorldPose(ignition::math::Pose3d(20, 0, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_EQ(this->events.size(), 2u);
+
+  // Removing a model inside a volume makes it leave
+  box->SetWorldPose(ignition::math::Pose3d(5, 0, 0.5, 0, 0, 0));
+  world->Step(1);
+  ASSERT_EQ(this->events.size(), 3u);
+  EXPECT_TRUE(this->events[2].second);
+
+  world->RemoveModel("box");
+  box.reset();
+  world->Step(1);
+  ASSERT_EQ(this->events.size(), 4u);
+  EXPECT_EQ(this->events[3].first, "box");
+  EXPECT_FALSE(this->events[3].second);
+  EXPECT_TRUE(triggers->Entities(id).empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(TriggerManagerTest, Shapes)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  physics::TriggerManagerPtr triggers = world->Triggers();
+  ASSERT_TRUE(triggers != nullptr);
+
+  this->SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  physics::TriggerVolume sphere;
+  sphere.shape = physics::TriggerVolume::SPHERE;
+  sphere.radius = 1.0;
+  sphere.pose.Pos().Set(10, 0, 0.5);
+  unsigned int sphereId = triggers->Add(sphere);
+
+  // Cylinder along the world Y axis
+  physics::TriggerVolume cylinder;
+  cylinder.shape = physics::TriggerVolume::CYLINDER;
+  cylinder.radius = 1.0;
+  cylinder.length = 10.0;
+  cylinder.pose.Set(-10, 0, 0.5, IGN_PI * 0.5, 0, 0);
+  unsigned int cylinderId = triggers->Add(cylinder);
+
+  // Inside the box around the sphere, outside the sphere
+  box->SetWorldPose(ignition::math::Pose3d(10.8, 0.8, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_TRUE(triggers->Entities(sphereId).empty());
+
+  box->SetWorldPose(ignition::math::Pose3d(10.5, 0.5, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_EQ(triggers->Entities(sphereId).size(), 1u);
+
+  // Along the axis of the cylinder
+  box->SetWorldPose(ignition::math::Pose3d(-10, 4, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_TRUE(triggers->Entities(sphereId).empty());
+  EXPECT_EQ(triggers->Entities(cylinderId).size(), 1u);
+
+  box->SetWorldPose(ignition::math::Pose3d(-10, 6, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_TRUE(triggers->Entities(cylinderId).empty());
+
+  // Bounding box overlap. The box is 1 m wide, its origin is outside.
+  physics::TriggerVolume overlap;
+  overlap.size.Set(2, 2, 2);
+  overlap.pose.Pos().Set(0, 10, 0.5);
+  unsigned int originId = triggers->Add(overlap);
+  overlap.overlap = true;
+  unsigned int overlapId = triggers->Add(overlap);
+
+  box->SetWorldPose(ignition::math::Pose3d(1.4, 10, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_TRUE(triggers->Entities(originId).empty());
+  EXPECT_EQ(triggers->Entities(overlapId).size(), 1u);
+
+  box->SetWorldPose(ignition::math::Pose3d(1.6, 10, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_TRUE(triggers->Entities(overlapId).empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(TriggerManagerTest, Filters)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  physics::TriggerManagerPtr triggers = world->Triggers();
+  ASSERT_TRUE(triggers != nullptr);
+
+  this->SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  this->SpawnBox("other", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0.5, 0, 0.5));
+
+  // The ground plane is static, at the origin
+  physics::TriggerVolume volume;
+  volume.size.Set(4, 4, 4);
+  unsigned int all = triggers->Add(volume);
+  EXPECT_EQ(triggers->Entities(all).size(), 2u);
+
+  volume.includeStatic = true;
+  unsigned int withStatic = triggers->Add(volume);
+  EXPECT_EQ(triggers->Entities(withStatic).size(), 3u);
+
+  volume.includeStatic = false;
+  volume.ignore = {"other"};
+  unsigned int ignoring = triggers->Add(volume);
+  ASSERT_EQ(triggers->Entities(ignoring).size(), 1u);
+  EXPECT_EQ(triggers->Entities(ignoring)[0]->GetName(), "box");
+
+  // Links can be listed by name
+  volume.ignore.clear();
+  volume.entities = {"other::body"};
+  unsigned int link = triggers->Add(volume);
+  ASSERT_EQ(triggers->Entities(link).size(), 1u);
+  EXPECT_EQ(triggers->Entities(link)[0]->GetScopedName(), "other::body");
+
+  // Entities that don't exist yet are found when they are added
+  volume.entities = {"late"};
+  unsigned int late = triggers->Add(volume);
+  EXPECT_TRUE(triggers->Entities(late).empty());
+  this->SpawnBox("late", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(-0.5, 0, 0.5));
+  world->Step(1);
+  EXPECT_EQ(triggers->Entities(late).size(), 1u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(TriggerManagerTest, Frame)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  physics::TriggerManagerPtr triggers = world->Triggers();
+  ASSERT_TRUE(triggers != nullptr);
+
+  this->SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  this->SpawnBox("carrier", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(10, 0, 0.5));
+  physics::ModelPtr carrier = world->ModelByName("carrier");
+  ASSERT_TRUE(carrier != nullptr);
+
+  // Sphere 2 m in front of the carrier
+  physics::TriggerVolume volume;
+  volume.shape = physics::TriggerVolume::SPHERE;
+  volume.radius = 1.0;
+  volume.pose.Pos().Set(2, 0, 0);
+  volume.frame = "carrier::body";
+  volume.ignore = {"carrier"};
+  volume.topic = "~/test/trigger";
+  unsigned int id = triggers->Add(volume,
+      std::bind(&TriggerManagerTest::OnEvent, this, std::placeholders::_1,
+        std::placeholders::_2));
+  EXPECT_TRUE(triggers->Entities(id).empty());
+
+  // Facing the box from the other side of the world
+  carrier->SetWorldPose(ignition::math::Pose3d(-2, 0, 0.5, 0, 0, 0));
+  world->Step(1);
+  ASSERT_EQ(this->events.size(), 1u);
+  EXPECT_TRUE(this->events[0].second);
+
+  // Turning around
+  carrier->SetWorldPose(ignition::math::Pose3d(-2, 0, 0.5, 0, 0, IGN_PI));
+  world->Step(1);
+  ASSERT_EQ(this->events.size(), 2u);
+  EXPECT_FALSE(this->events[1].second);
+
+  carrier->SetWorldPose(ignition::math::Pose3d(2, 0, 0.5, 0, 0, IGN_PI));
+  world->Step(1);
+  ASSERT_EQ(this->events.size(), 3u);
+  EXPECT_TRUE(this->events[2].second);
+
+  // The volume is inactive without its frame
+  world->RemoveModel("carrier");
+  carrier.reset();
+  world->Step(1);
+  ASSERT_EQ(this->events.size(), 4u);
+  EXPECT_FALSE(this->events[3].second);
+  EXPECT_TRUE(triggers->Entities(id).empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
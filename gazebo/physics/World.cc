@@ -22,10 +22,12 @@
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
 #include <deque>
 #include <list>
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -38,7 +40,6 @@
 #include <ignition/msgs/stringmsg.pb.h>
 
 #include "ignition/common/Profiler.hh"
-#include "ignition/common/URI.hh"
 #include "gazebo/common/FuelModelDatabase.hh"
 
 #include "gazebo/transport/Node.hh"
@@ -51,6 +52,7 @@
 #include "gazebo/common/ModelDatabase.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/EventProfiler.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Plugin.hh"
@@ -74,6 +76,7 @@
 #include "gazebo/physics/Atmosphere.hh"
 #include "gazebo/physics/AtmosphereFactory.hh"
 #include "gazebo/physics/PresetManager.hh"
+#include "gazebo/physics/TriggerManager.hh"
 #include "gazebo/physics/UserCmdManager.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/Light.hh"
@@ -121,6 +124,9 @@ World::World(const std::string &_name)
   this->dataPtr->factorySDF.reset(new sdf::SDF);
   sdf::initFile("root.sdf", this->dataPtr->factorySDF);
 
+  // Created here so that models inserted before Load are queued
+  this->dataPtr->factoryPipeline.reset(new FactoryPipeline());
+
   this->dataPtr->logPlayStateSDF.reset(new sdf::Element);
   sdf::initFile("state.sdf", this->dataPtr->logPlayStateSDF);
 
@@ -155,6 +161,7 @@ World::World(const std::string &_name)
   this->dataPtr->logLastStatePlayedSimTime = common::Time(0);
   this->dataPtr->logLastStatePlayedRealTime = common::Time(0);
   this->dataPtr->logPlayRealTimeFactor = 0.0;
+  this->dataPtr->logPlayContinuous = true;
 
   this->dataPtr->connections.push_back(
      event::Events::ConnectStep(std::bind(&World::OnStep, this)));
@@ -241,8 +248,15 @@ void World::Load(sdf::ElementPtr _sdf)
         msgs::GUIFromSDF(this->dataPtr->sdf->GetElement("gui")));
   }
 
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+    if (!this->dataPtr->factoryPipeline)
+      this->dataPtr->factoryPipeline.reset(new FactoryPipeline());
+  }
   this->dataPtr->factorySub = this->dataPtr->node->Subscribe("~/factory",
                                            &World::OnFactoryMsg, this);
+  this->dataPtr->factoryBatchSub = this->dataPtr->node->Subscribe(
+      "~/factory/batch", &World::OnFactoryBatchMsg, this);
   this->dataPtr->controlSub = this->dataPtr->node->Subscribe("~/world_control",
                                            &World::OnControl, this);
   this->dataPtr->playbackControlSub = this->dataPtr->node->Subscribe(
@@ -270,6 +284,8 @@ void World::Load(sdf::ElementPtr _sdf)
         "~/world_stats", 100, 5);
   this->dataPtr->modelPub = this->dataPtr->node->Advertise<msgs::Model>(
       "~/model/info");
+  this->dataPtr->modelBatchPub =
+      this->dataPtr->node->Advertise<msgs::Model_V>("~/model/info/batch");
   this->dataPtr->lightPub = this->dataPtr->node->Advertise<msgs::Light>(
       "~/light/modify");
   this->dataPtr->lightFactoryPub = this->dataPtr->node->Advertise<msgs::Light>(
@@ -338,6 +354,9 @@ void World::Load(sdf::ElementPtr _sdf)
   if (this->dataPtr->sphericalCoordinates == nullptr)
     gzthrow("Unable to create spherical coordinates data structure\n");
 
+  // This should come before loading of entities
+  this->dataPtr->triggerManager.reset(new TriggerManager(shared_from_this()));
+
   this->dataPtr->rootElement.reset(new Base(BasePtr()));
   this->dataPtr->rootElement->SetName(this->Name());
   this->dataPtr->rootElement->SetWorld(shared_from_this());
@@ -480,6 +499,12 @@ void World::Init(UpdateScenePosesFunc _func)
 
   this->dataPtr->updateScenePoses = _func;
 
+  // Collisions follow the initial link poses and state
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->setWorldPoseMutex);
+    this->dataPtr->transforms.Update();
+  }
+
   this->dataPtr->initialized = true;
 
   // Mark the world initialization
@@ -566,6 +591,12 @@ void World::RunLoop()
   else
   {
     this->dataPtr->enablePhysicsEngine = false;
+
+    // Keyframe of the world loaded from the log, before its first frame, so
+    // that any seek can rebuild the world from a keyframe
+    this->LogAddKeyframe(
+        util::LogPlay::Instance()->LogStartTime() - common::Time(0, 1));
+
     for (this->dataPtr->iterations = 0; !this->dataPtr->stop &&
         (!this->dataPtr->stopIterations ||
          (this->dataPtr->iterations < this->dataPtr->stopIterations));)
@@ -601,7 +632,7 @@ void World::LogStep()
         this->dataPtr->stepInc = 1;
 
       std::string data;
-      if (!util::LogPlay::Instance()->Step(this->dataPtr->stepInc, data))
+      if (!this->LogStepFrames(this->dataPtr->stepInc, data))
       {
         // There are no more chunks, time to exit.
         this->SetPaused(true);
@@ -611,10 +642,7 @@ void World::LogStep()
       {
         this->dataPtr->stepInc = 1;
 
-        this->dataPtr->logPlayStateSDF->Clear();
-        sdf::readString(data, this->dataPtr->logPlayStateSDF);
-
-        this->dataPtr->logPlayState.Load(this->dataPtr->logPlayStateSDF);
+        this->LogLoadFrame(data);
 
         // If it's the first step, we're going back in time or
         // rt factor is close to zero, don't sleep.
@@ -638,19 +666,14 @@ void World::LogStep()
           }
         }
 
-        // If the log file does not contain iterations we have to manually
-        // increase the iteration counter in logPlayState.
-        if (!util::LogPlay::Instance()->HasIterations())
-        {
-          this->dataPtr->logPlayState.SetIterations(
-            this->dataPtr->iterations + 1);
-        }
-
         this->dataPtr->logLastStatePlayedRealTime = common::Time::GetWallTime();
         this->dataPtr->logLastStatePlayedSimTime =
             this->dataPtr->logPlayState.GetSimTime();
         this->SetState(this->dataPtr->logPlayState);
         this->Update();
+
+        if (this->dataPtr->logPlayContinuous)
+          this->LogAddKeyframe(this->dataPtr->logPlayState.GetSimTime());
       }
 
       if (this->dataPtr->stepInc > 0)
@@ -663,6 +686,131 @@ void World::LogStep()
   this->ProcessMessages();
 }
 
+//////////////////////////////////////////////////
+bool World::LogStepFrames(const int _steps, std::string &_frame)
+{
+  util::LogPlay *logPlay = util::LogPlay::Instance();
+
+  // Going back can't undo the frames in between, so rebuild the world at
+  // the time of the target frame instead
+  if (_steps < 0)
+  {
+    if (!logPlay->Step(_steps, _frame))
+      return false;
+
+    this->LogLoadFrame(_frame);
+    this->LogSeek(this->dataPtr->logPlayState.GetSimTime());
+    return logPlay->Step(_frame);
+  }
+
+  // Apply the frames that are stepped over without updating the world, so
+  // that the entities they insert or delete are kept
+  bool stepped = false;
+  std::string frame;
+  for (int i = 0; i < _steps && logPlay->Step(frame); ++i)
+  {
+    if (stepped)
+    {
+      this->LogLoadFrame(_frame);
+      this->SetState(this->dataPtr->logPlayState);
+    }
+    _frame.swap(frame);
+    stepped = true;
+  }
+
+  return stepped;
+}
+
+//////////////////////////////////////////////////
+void World::LogLoadFrame(const std::string &_frame)
+{
+  this->dataPtr->logPlayStateSDF->Clear();
+  sdf::readString(_frame, this->dataPtr->logPlayStateSDF);
+  this->dataPtr->logPlayState.Load(this->dataPtr->logPlayStateSDF);
+
+  // If the log file does not contain iterations we have to manually
+  // increase the iteration counter in logPlayState.
+  if (!util::LogPlay::Instance()->HasIterations())
+  {
+    this->dataPtr->logPlayState.SetIterations(
+      this->dataPtr->iterations + 1);
+  }
+}
+
+//////////////////////////////////////////////////
+void World::LogAddKeyframe(const common::Time &_simTime)
+{
+  util::LogPlay *logPlay = util::LogPlay::Instance();
+  if (!logPlay->KeyframeDue(_simTime))
+    return;
+
+  // Frames hold the filtered state, the keyframe holds every entity so that
+  // seeking can tell which ones didn't exist yet.
+  WorldState keyframe(shared_from_this());
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>"
+         << keyframe
+         << "</sdf>";
+  logPlay->AddKeyframe(_simTime, stream.str());
+}
+
+//////////////////////////////////////////////////
+void World::LogSeek(const common::Time &_simTime)
+{
+  // Rebuild the world from the closest keyframe, so that the log keeps
+  // being played continuously. Without keyframes, only the frame at the
+  // target time is applied.
+  std::string keyframe;
+  std::vector<std::string> frames;
+  if (util::LogPlay::Instance()->SeekKeyframe(_simTime, keyframe, frames))
+  {
+    this->LogSeekKeyframe(keyframe, frames);
+    this->dataPtr->logPlayContinuous = true;
+  }
+  else
+  {
+    util::LogPlay::Instance()->Seek(_simTime);
+    this->dataPtr->logPlayContinuous = false;
+  }
+}
+
+//////////////////////////////////////////////////
+void World::LogSeekKeyframe(const std::string &_keyframe,
+    const std::vector<std::string> &_frames)
+{
+  this->dataPtr->logPlayStateSDF->Clear();
+  sdf::readString(_keyframe, this->dataPtr->logPlayStateSDF);
+  this->dataPtr->logPlayState.Load(this->dataPtr->logPlayStateSDF);
+
+  // Remove the entities inserted after the keyframe
+  std::vector<std::string> deletions;
+  for (auto const &model : this->Models())
+  {
+    if (!this->dataPtr->logPlayState.HasModelState(model->GetName()))
+      deletions.push_back(model->GetName());
+  }
+  for (auto const &light : this->Lights())
+  {
+    if (!this->dataPtr->logPlayState.HasLightState(light->GetName()))
+      deletions.push_back(light->GetName());
+  }
+  this->dataPtr->logPlayState.SetDeletions(deletions);
+  this->SetState(this->dataPtr->logPlayState);
+
+  // Frames are applied without updating the world, LogStep updates it with
+  // the next one.
+  for (auto const &frame : _frames)
+  {
+    this->LogLoadFrame(frame);
+    this->SetState(this->dataPtr->logPlayState);
+  }
+
+  // Don't wait for the time skipped by the seek
+  this->dataPtr->logLastStatePlayedRealTime = common::Time::GetWallTime();
+  this->dataPtr->logLastStatePlayedSimTime =
+      this->dataPtr->logPlayState.GetSimTime();
+}
+
 //////////////////////////////////////////////////
 void World::_SetSensorsInitialized(const bool _init)
 {
@@ -841,6 +989,12 @@ void World::Update()
   IGN_PROFILE_BEGIN("Update");
   // Update all the models
   (*this.*dataPtr->modelUpdateFunc)();
+
+  // Collisions follow links that plugins moved
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->setWorldPoseMutex);
+    this->dataPtr->transforms.Update();
+  }
   IGN_PROFILE_END();
   DIAG_TIMER_LAP("World::Update", "Model::Update");
 
@@ -893,9 +1047,24 @@ void World::Update()
       boost::recursive_mutex::scoped_lock plock(
           *this->Physics()->GetPhysicsUpdateMutex());
 
-      for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
+      // Apply all dirty poses under a single lock, then queue the pose
+      // messages of their models under another.
       {
-        dirtyEntity->SetWorldPose(dirtyEntity->DirtyPose(), false);
+        std::lock_guard<std::mutex> lock(this->dataPtr->setWorldPoseMutex);
+        for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
+          dirtyEntity->ApplyDirtyPose();
+
+        // Propagate the new link poses to the collisions in one pass
+        this->dataPtr->transforms.Update();
+      }
+      {
+        std::lock_guard<std::recursive_mutex> lock(
+            this->dataPtr->receiveMutex);
+        for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
+        {
+          this->dataPtr->publishModelPoses.insert(
+              dirtyEntity->GetParentModel());
+        }
       }
 
       this->dataPtr->dirtyPoses.clear();
@@ -905,6 +1074,11 @@ void World::Update()
     DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
   }
 
+  IGN_PROFILE_BEGIN("UpdateTriggers");
+  this->dataPtr->triggerManager->Update();
+  IGN_PROFILE_END();
+  DIAG_TIMER_LAP("World::Update", "TriggerManager::Update");
+
   IGN_PROFILE_BEGIN("LogRecordNotify");
   // Only update state information if logging data.
   if (util::LogRecord::Instance()->Running())
@@ -940,7 +1114,8 @@ void World::Fini()
   {
     this->dataPtr->deleteEntity.clear();
     this->dataPtr->requestMsgs.clear();
-    this->dataPtr->factoryMsgs.clear();
+    if (this->dataPtr->factoryPipeline)
+      this->dataPtr->factoryPipeline->Stop();
     this->dataPtr->modelMsgs.clear();
     this->dataPtr->lightFactoryMsgs.clear();
     this->dataPtr->lightModifyMsgs.clear();
@@ -952,10 +1127,12 @@ void World::Fini()
     this->dataPtr->responsePub.reset();
     this->dataPtr->statPub.reset();
     this->dataPtr->modelPub.reset();
+    this->dataPtr->modelBatchPub.reset();
     this->dataPtr->lightPub.reset();
     this->dataPtr->lightFactoryPub.reset();
 
     this->dataPtr->factorySub.reset();
+    this->dataPtr->factoryBatchSub.reset();
     this->dataPtr->controlSub.reset();
     this->dataPtr->playbackControlSub.reset();
     this->dataPtr->requestSub.reset();
@@ -965,6 +1142,12 @@ void World::Fini()
     this->dataPtr->lightModifySub.reset();
     this->dataPtr->modelSub.reset();
 
+    {
+      std::lock_guard<std::recursive_mutex> lock(
+          this->dataPtr->receiveMutex);
+      this->dataPtr->factoryPipeline.reset();
+    }
+
     if (this->dataPtr->node)
       this->dataPtr->node->Fini();
     this->dataPtr->node.reset();
@@ -977,6 +1160,9 @@ void World::Fini()
   this->dataPtr->testRay.reset();
   this->dataPtr->plugins.clear();
 
+  // After the plugins, which may remove their trigger volumes
+  this->dataPtr->triggerManager.reset();
+
   this->dataPtr->publishModelPoses.clear();
   this->dataPtr->publishModelScales.clear();
   this->dataPtr->publishLightPoses.clear();
@@ -1008,6 +1194,7 @@ void World::Fini()
     this->dataPtr->rootElement->Fini();
     this->dataPtr->rootElement.reset();
   }
+  this->dataPtr->transforms.Clear();
   this->dataPtr->prevStates[0].SetWorld(WorldPtr());
   this->dataPtr->prevStates[1].SetWorld(WorldPtr());
   this->dataPtr->prevUnfilteredState.SetWorld(WorldPtr());
@@ -1214,9 +1401,82 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->PublishModelPose(model);
   this->dataPtr->models.push_back(model);
+  this->dataPtr->triggerManager->AddModel(model);
   return model;
 }
 
+//////////////////////////////////////////////////
+Model_V World::LoadModels(const std::vector<sdf::ElementPtr> &_sdfs,
+    BasePtr _parent, const std::vector<bool> &_batched)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->loadModelMutex);
+  Model_V result;
+
+  std::unordered_set<std::string> names;
+  for (auto const &m : this->dataPtr->models)
+    names.insert(m->GetName());
+
+  msgs::Model_V modelsMsg;
+  for (size_t i = 0; i < _sdfs.size(); ++i)
+  {
+    const sdf::ElementPtr &modelSdf = _sdfs[i];
+    if (modelSdf->GetName() != "model")
+    {
+      gzerr << "SDF is missing the <model> tag:\n";
+      continue;
+    }
+
+    std::string modelName = modelSdf->Get<std::string>("name");
+    if (!names.insert(modelName).second)
+    {
+      gzwarn << "Model with name [" << modelName << "] already exists. "
+        << "Not inserting model.\n";
+      continue;
+    }
+
+    try
+    {
+      ModelPtr model = this->dataPtr->physicsEngine->CreateModel(_parent);
+      model->SetWorld(shared_from_this());
+      model->Load(modelSdf);
+
+      event::Events::addEntity(model->GetScopedName());
+
+      // Only models which were requested in a batch are described on
+      // ~/model/info/batch, all others on ~/model/info as before.
+      if (i < _batched.size() && _batched[i])
+      {
+        model->FillMsg(*modelsMsg.add_models());
+      }
+      else
+      {
+        msgs::Model msg;
+        model->FillMsg(msg);
+        this->dataPtr->modelPub->Publish(msg);
+      }
+
+      this->PublishModelPose(model);
+      this->dataPtr->models.push_back(model);
+      this->dataPtr->triggerManager->AddModel(model);
+      result.push_back(model);
+    }
+    catch(...)
+    {
+      gzerr << "Loading model [" << modelName << "] failed\n";
+    }
+  }
+
+  if (result.empty())
+    return result;
+
+  if (modelsMsg.models_size() > 0 && this->dataPtr->modelBatchPub)
+    this->dataPtr->modelBatchPub->Publish(modelsMsg);
+
+  this->EnableAllModels();
+
+  return result;
+}
+
 //////////////////////////////////////////////////
 LightPtr World::LoadLight(const sdf::ElementPtr &_sdf, const BasePtr &_parent)
 {
@@ -1269,6 +1529,7 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
   this->EnableAllModels();
   this->PublishModelPose(actor);
   this->dataPtr->models.push_back(actor);
+  this->dataPtr->triggerManager->AddModel(actor);
 
   return actor;
 }
@@ -1298,17 +1559,20 @@ void World::LoadEntities(sdf::ElementPtr _sdf, BasePtr _parent)
 
   if (_sdf->HasElement("model"))
   {
+    std::vector<sdf::ElementPtr> modelElems;
     sdf::ElementPtr childElem = _sdf->GetElement("model");
 
     while (childElem)
     {
-      this->LoadModel(childElem, _parent);
+      modelElems.push_back(childElem);
 
       // TODO : Put back in the ability to nest models. We should do this
       // without requiring a joint.
 
       childElem = childElem->GetNextElement("model");
     }
+
+    this->LoadModels(modelElems, _parent);
   }
 
   if (_sdf->HasElement("actor"))
@@ -1516,7 +1780,16 @@ void World::SetPaused(const bool _p)
 void World::OnFactoryMsg(ConstFactoryPtr &_msg)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
-  this->dataPtr->factoryMsgs.push_back(*_msg);
+  if (this->dataPtr->factoryPipeline)
+    this->dataPtr->factoryPipeline->Push(*_msg);
+}
+
+//////////////////////////////////////////////////
+void World::OnFactoryBatchMsg(ConstFactory_VPtr &_msg)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  if (this->dataPtr->factoryPipeline)
+    this->dataPtr->factoryPipeline->PushBatch(*_msg);
 }
 
 //////////////////////////////////////////////////
@@ -1591,14 +1864,27 @@ void World::ProcessPlaybackControlMsgs()
 
     if (msg.has_seek())
     {
-      common::Time targetSimTime = msgs::Convert(msg.seek());
-      util::LogPlay::Instance()->Seek(targetSimTime);
+      this->LogSeek(msgs::Convert(msg.seek()));
       this->dataPtr->stepInc = 1;
     }
 
     if (msg.has_rewind() && msg.rewind())
     {
-      util::LogPlay::Instance()->Rewind();
+      // The keyframe of the loaded world brings back the entities that
+      // were deleted since
+      std::string keyframe;
+      std::vector<std::string> frames;
+      if (util::LogPlay::Instance()->SeekKeyframe(
+            util::LogPlay::Instance()->LogStartTime(), keyframe, frames))
+      {
+        this->LogSeekKeyframe(keyframe, frames);
+        this->dataPtr->logPlayContinuous = true;
+      }
+      else
+      {
+        util::LogPlay::Instance()->Rewind();
+        this->dataPtr->logPlayContinuous = false;
+      }
       this->dataPtr->stepInc = 1;
       if (!util::LogPlay::Instance()->HasIterations())
         this->dataPtr->iterations = 0;
@@ -1606,8 +1892,9 @@ void World::ProcessPlaybackControlMsgs()
 
     if (msg.has_forward() && msg.forward())
     {
-      util::LogPlay::Instance()->Forward();
-      this->dataPtr->stepInc = -1;
+      // The next step plays the last frame
+      this->LogSeek(util::LogPlay::Instance()->LogEndTime());
+      this->dataPtr->stepInc = 1;
       this->SetPaused(true);
       // ToDo: Update iterations if the log doesn't have it.
     }
@@ -1701,6 +1988,8 @@ void World::ModelUpdateSingleLoop()
 //////////////////////////////////////////////////
 void World::LoadPlugins()
 {
+  this->dataPtr->physicsEngine->InitPendingModels();
+
   // Load the plugins
   if (this->dataPtr->sdf->HasElement("plugin"))
   {
@@ -1741,6 +2030,10 @@ void World::LoadPlugin(const std::string &_filename,
             << "Plugin filename[" << _filename << "] name[" << _name << "]\n";
       return;
     }
+    // Tag event connections made by the plugin for timing
+    event::EventProfiler::OwnerScope profilerOwner(_filename, _name,
+        this->Name());
+
     plugin->Load(shared_from_this(), _sdf);
     this->dataPtr->plugins.push_back(plugin);
 
@@ -2086,60 +2379,39 @@ void World::ProcessLightFactoryMsgs()
 //////////////////////////////////////////////////
 void World::ProcessFactoryMsgs()
 {
-  std::list<sdf::ElementPtr> modelsToLoad, lightsToLoad;
+  std::vector<sdf::ElementPtr> modelsToLoad;
+  std::vector<bool> modelsBatched;
+  std::list<sdf::ElementPtr> lightsToLoad;
 
-  std::list<msgs::Factory> factoryMsgsCopy;
+  // Parsing, URI resolution and mesh loading were done by the factory
+  // pipeline's worker threads.
+  std::list<FactoryPipeline::Prepared> factoryMsgsCopy;
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
-
-    std::copy(this->dataPtr->factoryMsgs.begin(),
-      this->dataPtr->factoryMsgs.end(),
-      std::back_inserter(factoryMsgsCopy));
-    this->dataPtr->factoryMsgs.clear();
+    if (this->dataPtr->factoryPipeline)
+      factoryMsgsCopy = this->dataPtr->factoryPipeline->PopReady();
   }
 
-  for (auto const &factoryMsg : factoryMsgsCopy)
-  {
+  if (factoryMsgsCopy.empty())
+    return;
 
-    this->dataPtr->factorySDF->Clear();
+  // Names of the existing models and of the models about to be loaded,
+  // built once for all the messages.
+  std::unordered_set<std::string> modelNames;
+  for (auto const &m : this->dataPtr->models)
+    modelNames.insert(m->GetName());
 
-    if (factoryMsg.has_sdf() && !factoryMsg.sdf().empty())
-    {
-      // SDF Parsing happens here
-      if (!sdf::readString(factoryMsg.sdf(), this->dataPtr->factorySDF))
-      {
-        gzerr << "Unable to read sdf string[" << factoryMsg.sdf() << "]\n";
-        continue;
-      }
-    }
-    else if (factoryMsg.has_sdf_filename() &&
-            !factoryMsg.sdf_filename().empty())
-    {
-      std::string filename;
-      // If http(s), look at Fuel
-      auto uri = ignition::common::URI(factoryMsg.sdf_filename());
-      if (uri.Valid() && (uri.Scheme() == "https" || uri.Scheme() == "http"))
-      {
-        filename = common::FuelModelDatabase::Instance()->ModelFile(
-            factoryMsg.sdf_filename());
-      }
-      // Otherwise, look at database
-      else
-      {
-        filename = common::ModelDatabase::Instance()->GetModelFile(
-            factoryMsg.sdf_filename());
-      }
-
-      if (!sdf::readFile(filename, this->dataPtr->factorySDF))
-      {
-        gzerr << "Unable to read sdf file [" << filename << "]\n";
-        continue;
-      }
+  for (auto const &prepared : factoryMsgsCopy)
+  {
+    const msgs::Factory &factoryMsg = prepared.msg;
+    sdf::SDFPtr factorySDF = prepared.sdf;
 
-      common::convertToFullPaths(this->dataPtr->factorySDF->Root());
-    }
-    else if (factoryMsg.has_clone_model_name())
+    // Only clones are left for the world to resolve
+    if (!factorySDF)
     {
+      this->dataPtr->factorySDF->Clear();
+      factorySDF = this->dataPtr->factorySDF;
+
       ModelPtr model = this->ModelByName(factoryMsg.clone_model_name());
       if (!model)
       {
@@ -2148,21 +2420,14 @@ void World::ProcessFactoryMsgs()
         continue;
       }
 
-      this->dataPtr->factorySDF->Root()->InsertElement(
-          model->GetSDF()->Clone());
+      factorySDF->Root()->InsertElement(model->GetSDF()->Clone());
 
       std::string newName = model->GetName() + "_clone";
       newName = this->UniqueModelName(newName);
 
-      this->dataPtr->factorySDF->Root()->GetElement("model")->GetAttribute(
+      factorySDF->Root()->GetElement("model")->GetAttribute(
           "name")->Set(newName);
     }
-    else
-    {
-      gzerr << "Unable to load sdf from factory message."
-        << "No SDF or SDF filename specified.\n";
-      continue;
-    }
 
     if (factoryMsg.has_edit_name())
     {
@@ -2171,10 +2436,10 @@ void World::ProcessFactoryMsgs()
       if (base)
       {
         sdf::ElementPtr elem;
-        if (this->dataPtr->factorySDF->Root()->GetName() == "sdf")
-          elem = this->dataPtr->factorySDF->Root()->GetFirstElement();
+        if (factorySDF->Root()->GetName() == "sdf")
+          elem = factorySDF->Root()->GetFirstElement();
         else
-          elem = this->dataPtr->factorySDF->Root();
+          elem = factorySDF->Root();
 
         base->UpdateParameters(elem);
       }
@@ -2185,12 +2450,12 @@ void World::ProcessFactoryMsgs()
       bool isModel = false;
       bool isLight = false;
 
-      sdf::ElementPtr elem = this->dataPtr->factorySDF->Root()->Clone();
+      sdf::ElementPtr elem = factorySDF->Root()->Clone();
 
       if (!elem)
       {
         gzerr << "Invalid SDF:";
-        this->dataPtr->factorySDF->Root()->PrintValues("");
+        factorySDF->Root()->PrintValues("");
         continue;
       }
 
@@ -2215,7 +2480,7 @@ void World::ProcessFactoryMsgs()
       else
       {
         gzerr << "Unable to find a model, light, or actor in:\n";
-        this->dataPtr->factorySDF->Root()->PrintValues("");
+        factorySDF->Root()->PrintValues("");
         continue;
       }
 
@@ -2243,7 +2508,7 @@ void World::ProcessFactoryMsgs()
         }
 
         // Model with the given name already exists
-        if (this->ModelByName(entityName))
+        if (modelNames.count(entityName))
         {
           // If allow renaming is disabled
           if (!factoryMsg.allow_renaming())
@@ -2254,11 +2519,16 @@ void World::ProcessFactoryMsgs()
             continue;
           }
 
-          entityName = this->UniqueModelName(entityName);
+          std::string baseName = entityName;
+          int i = 0;
+          while (modelNames.count(entityName))
+            entityName = baseName + "_" + std::to_string(i++);
           elem->GetAttribute("name")->Set(entityName);
         }
 
+        modelNames.insert(entityName);
         modelsToLoad.push_back(elem);
+        modelsBatched.push_back(prepared.batch);
       }
       else if (isLight)
       {
@@ -2268,22 +2538,40 @@ void World::ProcessFactoryMsgs()
   }
 
   // Load models
-  for (auto const &elem : modelsToLoad)
+  if (!modelsToLoad.empty())
   {
-    try
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
+    std::lock_guard<std::mutex> lock(this->dataPtr->factoryDeleteMutex);
 
-      ModelPtr model = this->LoadModel(elem, this->dataPtr->rootElement);
-      if (model != nullptr)
+    Model_V models = this->LoadModels(modelsToLoad,
+        this->dataPtr->rootElement, modelsBatched);
+    Model_V initialized;
+    for (auto const &model : models)
+    {
+      try
       {
         model->Init();
-        model->LoadPlugins();
+        initialized.push_back(model);
+      }
+      catch(...)
+      {
+        gzerr << "Loading model from factory message failed\n";
       }
     }
-    catch(...)
+
+    // Let the physics engine finish adding all the models at once, before
+    // plugins use them
+    this->dataPtr->physicsEngine->InitPendingModels();
+
+    for (auto const &model : initialized)
     {
-      gzerr << "Loading model from factory message failed\n";
+      try
+      {
+        model->LoadPlugins();
+      }
+      catch(...)
+      {
+        gzerr << "Loading model from factory message failed\n";
+      }
     }
   }
 
@@ -2403,6 +2691,7 @@ void World::SetState(const WorldState &_state)
         if (model != nullptr)
         {
           model->Init();
+          this->dataPtr->physicsEngine->InitPendingModels();
           if (!util::LogPlay::Instance()->IsOpen())
             model->LoadPlugins();
         }
@@ -2470,7 +2759,8 @@ void World::InsertModelFile(const std::string &_sdfFilename)
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   msgs::Factory msg;
   msg.set_sdf_filename(_sdfFilename);
-  this->dataPtr->factoryMsgs.push_back(msg);
+  if (this->dataPtr->factoryPipeline)
+    this->dataPtr->factoryPipeline->Push(msg);
 }
 
 //////////////////////////////////////////////////
@@ -2479,7 +2769,8 @@ void World::InsertModelSDF(const sdf::SDF &_sdf)
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   msgs::Factory msg;
   msg.set_sdf(_sdf.ToString());
-  this->dataPtr->factoryMsgs.push_back(msg);
+  if (this->dataPtr->factoryPipeline)
+    this->dataPtr->factoryPipeline->Push(msg);
 }
 
 //////////////////////////////////////////////////
@@ -2488,7 +2779,20 @@ void World::InsertModelString(const std::string &_sdfString)
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   msgs::Factory msg;
   msg.set_sdf(_sdfString);
-  this->dataPtr->factoryMsgs.push_back(msg);
+  if (this->dataPtr->factoryPipeline)
+    this->dataPtr->factoryPipeline->Push(msg);
+}
+
+//////////////////////////////////////////////////
+void World::InsertModelStrings(const std::vector<std::string> &_sdfStrings)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  msgs::Factory_V msgs;
+  for (auto const &sdfString : _sdfStrings)
+    msgs.add_factory()->set_sdf(sdfString);
+
+  if (this->dataPtr->factoryPipeline)
+    this->dataPtr->factoryPipeline->PushBatch(msgs);
 }
 
 //////////////////////////////////////////////////
@@ -2864,6 +3168,13 @@ void World::ProcessMessages()
     this->ProcessLightModifyMsgs();
     this->dataPtr->prevProcessMsgsTime = common::Time::GetWallTime();
   }
+
+  // Collisions follow links that were moved outside of a step, by messages,
+  // states or while paused
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->setWorldPoseMutex);
+    this->dataPtr->transforms.Update();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -3038,17 +3349,14 @@ void World::RemoveModel(const std::string &_name)
 
   // Remove all the dirty poses from the delete entity.
   {
-    for (auto entity = this->dataPtr->dirtyPoses.begin();
-             entity != this->dataPtr->dirtyPoses.end(); ++entity)
-    {
-      if ((*entity)->GetName() == _name ||
-         ((*entity)->GetParent() && (*entity)->GetParent()->GetName() == _name))
-      {
-        this->dataPtr->dirtyPoses.erase(entity++);
-      }
-      else
-        ++entity;
-    }
+    auto &dirtyPoses = this->dataPtr->dirtyPoses;
+    dirtyPoses.erase(std::remove_if(dirtyPoses.begin(), dirtyPoses.end(),
+        [&_name](Entity *_entity)
+        {
+          return _entity->GetName() == _name ||
+              (_entity->GetParent() &&
+               _entity->GetParent()->GetName() == _name);
+        }), dirtyPoses.end());
   }
 
   // Remove from SDF
@@ -3085,6 +3393,7 @@ void World::RemoveModel(const std::string &_name)
     {
       if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
       {
+        this->dataPtr->triggerManager->RemoveModel(*model);
         this->dataPtr->models.erase(model);
         this->dataPtr->rootElement->RemoveChild(_name);
         break;
@@ -3179,6 +3488,18 @@ std::mutex &World::WorldPoseMutex() const
   return this->dataPtr->setWorldPoseMutex;
 }
 
+/////////////////////////////////////////////////
+TransformStore &World::Transforms() const
+{
+  return this->dataPtr->transforms;
+}
+
+/////////////////////////////////////////////////
+TriggerManagerPtr World::Triggers() const
+{
+  return this->dataPtr->triggerManager;
+}
+
 /////////////////////////////////////////////////
 bool World::PhysicsEnabled() const
 {
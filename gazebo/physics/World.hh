@@ -312,6 +312,14 @@ namespace gazebo
       /// \param[in] _sdf A reference to an SDF object.
       public: void InsertModelSDF(const sdf::SDF &_sdf);
 
+      /// \brief Insert a batch of models from SDF strings.
+      /// The models are loaded together in a single step, with one check
+      /// of their names, one pass enabling the models, and one
+      /// msgs::Model_V published on ~/model/info/batch.
+      /// \param[in] _sdfStrings Strings containing valid SDF markup.
+      public: void InsertModelStrings(
+                  const std::vector<std::string> &_sdfStrings);
+
       /// \brief Return a version of the name with "<world_name>::" removed
       /// \param[in] _name Usually the name of an entity.
       /// \return The stripped world name.
@@ -347,6 +355,15 @@ namespace gazebo
       /// \return Reference to the mutex.
       public: std::mutex &WorldPoseMutex() const;
 
+      /// \brief Get the store of link and collision world poses.
+      /// \return Reference to the transform store.
+      public: TransformStore &Transforms() const;
+
+      /// \brief Get the manager of the trigger volumes of this world.
+      /// \return Pointer to the trigger manager, null before the world is
+      /// loaded and after it is finalized.
+      public: TriggerManagerPtr Triggers() const;
+
       /// \brief check if physics engine is enabled/disabled.
       /// \param True if the physics engine is enabled.
       public: bool PhysicsEnabled() const;
@@ -489,6 +506,21 @@ namespace gazebo
       /// \return Pointer to the newly created Model.
       private: ModelPtr LoadModel(sdf::ElementPtr _sdf, BasePtr _parent);
 
+      /// \brief Load a batch of models. Names are checked against an index
+      /// of the existing models built once for the batch and the models are
+      /// enabled in a single pass. Models which were requested in a batch
+      /// are described in a single msgs::Model_V on ~/model/info/batch, all
+      /// other models by one msgs::Model each on ~/model/info. Models whose
+      /// name is already used are skipped.
+      /// \param[in] _sdfs SDF elements containing the Model descriptions.
+      /// \param[in] _parent Parent of the models.
+      /// \param[in] _batched For each element of _sdfs, true if the model
+      /// was requested in a batch. Missing entries are false.
+      /// \return Pointers to the newly created Models.
+      private: Model_V LoadModels(const std::vector<sdf::ElementPtr> &_sdfs,
+                   BasePtr _parent,
+                   const std::vector<bool> &_batched = std::vector<bool>());
+
       /// \brief Load a light.
       /// \param[in] _sdf SDF element containing the Light description.
       /// \param[in] _parent Parent of the light.
@@ -517,6 +549,35 @@ namespace gazebo
       /// \brief Step the world once by reading from a log file.
       private: void LogStep();
 
+      /// \brief Step through the frames of the log file. Frames that are
+      /// stepped over are applied without updating the world, and stepping
+      /// back rebuilds the world with LogSeek.
+      /// \param[in] _steps Number of frames to step, negative to go back.
+      /// \param[out] _frame The frame stepped to.
+      /// \return False if there are no more frames.
+      private: bool LogStepFrames(const int _steps, std::string &_frame);
+
+      /// \brief Load a frame of the log file into logPlayState.
+      /// \param[in] _frame The frame.
+      private: void LogLoadFrame(const std::string &_frame);
+
+      /// \brief Cache the current state as a keyframe of the log file, if
+      /// one is due.
+      /// \param[in] _simTime Simulation time of the state.
+      private: void LogAddKeyframe(const common::Time &_simTime);
+
+      /// \brief Rebuild the world at a time of the log file, so that the
+      /// next step plays the first frame at or after that time.
+      /// \param[in] _simTime Target simulation time.
+      private: void LogSeek(const common::Time &_simTime);
+
+      /// \brief Apply a keyframe of the log file and the frames that follow
+      /// it, as returned by util::LogPlay::SeekKeyframe.
+      /// \param[in] _keyframe Full state of the world at the keyframe.
+      /// \param[in] _frames Frames after the keyframe.
+      private: void LogSeekKeyframe(const std::string &_keyframe,
+                   const std::vector<std::string> &_frames);
+
       /// \brief Update the world.
       private: void Update();
 
@@ -553,6 +614,10 @@ namespace gazebo
       /// \param[in] _data The factory message.
       private: void OnFactoryMsg(ConstFactoryPtr &_data);
 
+      /// \brief Called when a batch of factory messages is received.
+      /// \param[in] _msg The factory messages.
+      private: void OnFactoryBatchMsg(ConstFactory_VPtr &_msg);
+
       /// \brief Called when a model message is received.
       /// \param[in] _msg The model message.
       private: void OnModelMsg(ConstModelPtr &_msg);
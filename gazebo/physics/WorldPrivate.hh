@@ -39,7 +39,9 @@
 
 #include "gazebo/transport/TransportTypes.hh"
 
+#include "gazebo/physics/FactoryPipeline.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/TransformStore.hh"
 #include "gazebo/physics/WorldState.hh"
 
 namespace gazebo
@@ -107,6 +109,9 @@ namespace gazebo
       /// \brief Publisher for model messages.
       public: transport::PublisherPtr modelPub;
 
+      /// \brief Publisher for batches of model messages.
+      public: transport::PublisherPtr modelBatchPub;
+
       /// \brief Publisher for gui messages.
       public: transport::PublisherPtr guiPub;
 
@@ -131,6 +136,9 @@ namespace gazebo
       /// \brief Subscriber to factory messages.
       public: transport::SubscriberPtr factorySub;
 
+      /// \brief Subscriber to batches of factory messages.
+      public: transport::SubscriberPtr factoryBatchSub;
+
       /// \brief Subscriber to joint messages.
       public: transport::SubscriberPtr jointSub;
 
@@ -182,6 +190,9 @@ namespace gazebo
       /// Entity::SetWorldPose to call Entity::setWorldPoseFunc
       public: std::mutex setWorldPoseMutex;
 
+      /// \brief World poses of links and collisions.
+      public: TransformStore transforms;
+
       /// \brief Used by World classs in following calls:
       /// World::Step for then entire function
       /// World::StepWorld for changing World::stepInc,
@@ -202,8 +213,8 @@ namespace gazebo
       /// \brief Request message buffer.
       public: std::list<msgs::Request> requestMsgs;
 
-      /// \brief Factory message buffer.
-      public: std::list<msgs::Factory> factoryMsgs;
+      /// \brief Prepares factory messages on worker threads.
+      public: std::unique_ptr<FactoryPipeline> factoryPipeline;
 
       /// \brief Model message buffer.
       public: std::list<msgs::Model> modelMsgs;
@@ -341,7 +352,7 @@ namespace gazebo
       /// \brief when physics engine makes an update and changes a link pose,
       /// this flag is set to trigger Entity::SetWorldPose on the
       /// physics::Link in World::Update.
-      public: std::list<Entity*> dirtyPoses;
+      public: std::vector<Entity*> dirtyPoses;
 
       /// \brief Class to manage preset simulation parameter profiles.
       public: PresetManagerPtr presetManager;
@@ -349,6 +360,9 @@ namespace gazebo
       /// \brief Class to manage user commands.
       public: UserCmdManagerPtr userCmdManager;
 
+      /// \brief Trigger volumes of the world.
+      public: TriggerManagerPtr triggerManager;
+
       /// \brief True if sensors have been initialized. This should be set
       /// by the SensorManager.
       public: std::atomic_bool sensorsInitialized;
@@ -365,6 +379,11 @@ namespace gazebo
       /// \brief Log play real time factor
       public: double logPlayRealTimeFactor;
 
+      /// \brief True if every frame of the log file was played in order
+      /// since the world was loaded from it or since the last keyframe, so
+      /// that the state of the world can be cached as a keyframe.
+      public: bool logPlayContinuous;
+
       /// \brief URI of this world.
       public: common::URI uri;
 
@@ -100,6 +100,162 @@ TEST_F(WorldTest, UniqueModelName)
   EXPECT_EQ(world->UniqueModelName(modelName), modelName + "_1");
 }
 
+/// \brief Number of model batch messages received.
+int batchCount = 0;
+
+/// \brief Number of models in the last model batch message.
+int batchSize = 0;
+
+//////////////////////////////////////////////////
+/// \brief Callback for model batch messages.
+/// \param[in] _msg The message.
+void OnModelBatch(ConstModel_VPtr &_msg)
+{
+  ++batchCount;
+  batchSize = _msg->models_size();
+}
+
+//////////////////////////////////////////////////
+/// \brief Test inserting a batch of models.
+TEST_F(WorldTest, InsertModelStrings)
+{
+  // Load a blank world
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  EXPECT_EQ(world->ModelCount(), 0u);
+
+  // Listen to the coalesced model info message
+  auto sub = this->node->Subscribe("~/model/info/batch", &OnModelBatch);
+
+  // The last model has the same name as the first one, so it is renamed
+  const unsigned int count = 50;
+  std::vector<std::string> sdfStrings;
+  for (unsigned int i = 0; i <= count; ++i)
+  {
+    msgs::Model msg;
+    msg.set_name("model_" + std::to_string(i % count));
+    msg.add_link();
+    msg.mutable_link(0)->set_name("l");
+
+    sdfStrings.push_back("<sdf version='" + std::string(SDF_VERSION) + "'>"
+        + msgs::ModelToSDF(msg)->ToString("") + "</sdf>");
+  }
+  world->InsertModelStrings(sdfStrings);
+
+  // All models appear in the same step
+  int sleep = 0;
+  int maxSleep = 50;
+  while (sleep < maxSleep && world->ModelCount() == 0u)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_EQ(world->ModelCount(), count + 1);
+  for (unsigned int i = 0; i < count; ++i)
+    EXPECT_TRUE(world->ModelByName("model_" + std::to_string(i)) != nullptr);
+  EXPECT_TRUE(world->ModelByName("model_0_0") != nullptr);
+
+  sleep = 0;
+  while (sleep < maxSleep && batchCount == 0)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_EQ(batchCount, 1);
+  EXPECT_EQ(batchSize, static_cast<int>(count + 1));
+}
+
+/// \brief Number of model info messages received.
+int infoCount = 0;
+
+//////////////////////////////////////////////////
+/// \brief Callback for model info messages.
+/// \param[in] _msg The message.
+void OnModelInfo(ConstModelPtr &/*_msg*/)
+{
+  ++infoCount;
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that models which weren't requested in a batch are each
+/// described on ~/model/info, even when they are loaded in the same step.
+TEST_F(WorldTest, InsertModelsInfo)
+{
+  // Load a blank world
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  infoCount = 0;
+  batchCount = 0;
+  auto infoSub = this->node->Subscribe("~/model/info", &OnModelInfo);
+  auto batchSub = this->node->Subscribe("~/model/info/batch", &OnModelBatch);
+
+  // Two spawns pushed back to back
+  const unsigned int count = 2;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    msgs::Model msg;
+    msg.set_name("model_" + std::to_string(i));
+    msg.add_link();
+    msg.mutable_link(0)->set_name("l");
+
+    world->InsertModelString("<sdf version='" + std::string(SDF_VERSION) +
+        "'>" + msgs::ModelToSDF(msg)->ToString("") + "</sdf>");
+  }
+
+  int sleep = 0;
+  int maxSleep = 50;
+  while (sleep < maxSleep &&
+      (world->ModelCount() < count || infoCount < static_cast<int>(count)))
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_EQ(world->ModelCount(), count);
+  EXPECT_EQ(infoCount, static_cast<int>(count));
+  EXPECT_EQ(batchCount, 0);
+}
+
+//////////////////////////////////////////////////
+/// \brief Test inserting a model before the world is loaded.
+TEST_F(WorldTest, InsertModelBeforeLoad)
+{
+  // The server's world provides transport
+  this->Load("worlds/blank.world", true);
+
+  physics::WorldPtr world = physics::create_world("before_load");
+  ASSERT_TRUE(world != nullptr);
+
+  msgs::Model msg;
+  msg.set_name("box");
+  msgs::AddBoxLink(msg, 1.0, ignition::math::Vector3d::One);
+  world->InsertModelString("<sdf version='" + std::string(SDF_VERSION) +
+      "'>" + msgs::ModelToSDF(msg)->ToString("") + "</sdf>");
+
+  sdf::SDFPtr worldSDF(new sdf::SDF);
+  sdf::initFile("root.sdf", worldSDF);
+  ASSERT_TRUE(sdf::readString("<sdf version='" + std::string(SDF_VERSION) +
+      "'><world name='before_load'></world></sdf>", worldSDF));
+
+  physics::load_world(world, worldSDF->Root()->GetElement("world"));
+  physics::init_world(world, nullptr);
+  physics::run_world(world);
+
+  // The model queued before Load is inserted once the world runs
+  int sleep = 0;
+  int maxSleep = 50;
+  while (sleep < maxSleep && !world->ModelByName("box"))
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_TRUE(world->ModelByName("box") != nullptr);
+
+  physics::stop_world(world);
+}
+
 //////////////////////////////////////////////////
 /// \brief Test publishing a factory message to edit a model.
 TEST_F(WorldTest, EditName)
@@ -28,12 +28,51 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Terrain shape that skips boxes above the per-tile height bounds
+/// of a memory-mapped heightmap before Bullet reads any height.
+class HeightmapTerrainShape : public btHeightfieldTerrainShape
+{
+  /// \brief Constructor, see btHeightfieldTerrainShape.
+  /// \param[in] _heightmap Heightmap that owns the heights.
+  public: HeightmapTerrainShape(const HeightmapShape *_heightmap,
+              int _width, int _length, const void *_heights,
+              btScalar _heightScale, btScalar _minHeight, btScalar _maxHeight,
+              int _upAxis, PHY_ScalarType _heightDataType, bool _flipQuadEdges)
+          : btHeightfieldTerrainShape(_width, _length, _heights, _heightScale,
+              _minHeight, _maxHeight, _upAxis, _heightDataType,
+              _flipQuadEdges),
+            heightmap(_heightmap)
+  {
+  }
+
+  // Documentation inherited
+  public: virtual void processAllTriangles(btTriangleCallback *_callback,
+              const btVector3 &_aabbMin, const btVector3 &_aabbMax) const
+  {
+    // Bullet centers the heights on m_localOrigin
+    const double z = this->m_localOrigin.getZ();
+    if (this->heightmap->AboveHeights(ignition::math::AxisAlignedBox(
+            _aabbMin.getX(), _aabbMin.getY(), _aabbMin.getZ() + z,
+            _aabbMax.getX(), _aabbMax.getY(), _aabbMax.getZ() + z)))
+    {
+      return;
+    }
+
+    btHeightfieldTerrainShape::processAllTriangles(
+        _callback, _aabbMin, _aabbMax);
+  }
+
+  /// \brief Heightmap that owns the heights.
+  private: const HeightmapShape *heightmap;
+};
+
 //////////////////////////////////////////////////
 BulletHeightmapShape::BulletHeightmapShape(CollisionPtr _parent)
     : HeightmapShape(_parent)
 {
   // Bullet need the height values flipped in the y direction
   this->flipY = true;
+  this->mapHeights = true;
 }
 
 //////////////////////////////////////////////////
@@ -53,10 +92,11 @@ void BulletHeightmapShape::Init()
   int upIndex = 2;
   btVector3 localScaling(this->scale.X(), this->scale.Y(), 1.0);
 
-  this->heightFieldShape  = new btHeightfieldTerrainShape(
+  this->heightFieldShape  = new HeightmapTerrainShape(
+      this,
       this->vertSize,     // # of heights along width
       this->vertSize,     // # of height along height
-      &this->heights[0],  // The heights
+      this->HeightData(), // The heights
       1,                  // Height scaling
       minHeight,          // Min height
       maxHeight,          // Max height
@@ -15,6 +15,8 @@
  *
 */
 
+#include <algorithm>
+
 // required for HAVE_DART_BULLET define
 #include <gazebo/gazebo_config.h>
 
@@ -116,6 +118,7 @@ void DARTPhysics::Init()
 //////////////////////////////////////////////////
 void DARTPhysics::Fini()
 {
+  this->dataPtr->links.clear();
   PhysicsEngine::Fini();
 }
 
@@ -451,26 +454,11 @@ void DARTPhysics::UpdatePhysics()
   this->dataPtr->dtWorld->step(
         this->dataPtr->resetAllForcesAfterSimulationStep);
 
-  // Update all the transformation of DART's links to gazebo's links
-  // TODO: How to visit all the links in the world?
-  unsigned int modelCount = this->world->ModelCount();
-  ModelPtr modelItr;
-
-  for (unsigned int i = 0; i < modelCount; ++i)
-  {
-    modelItr = this->world->ModelByIndex(i);
-    // TODO: need to improve speed
-    Link_V links = modelItr->GetLinks();
-    unsigned int linkCount = links.size();
-    DARTLinkPtr dartLinkItr;
-
-    for (unsigned int j = 0; j < linkCount; ++j)
-    {
-      dartLinkItr
-          = boost::dynamic_pointer_cast<DARTLink>(links.at(j));
-      dartLinkItr->updateDirtyPoseFromDARTTransformation();
-    }
-  }
+  // Update all the transformation of DART's links to gazebo's links.
+  // DART computes body node transforms lazily and caches them along each
+  // skeleton, so this loop stays serial.
+  for (auto link : this->dataPtr->links)
+    link->updateDirtyPoseFromDARTTransformation();
 
   RetrieveDARTCollisions(
         this,
@@ -479,6 +467,19 @@ void DARTPhysics::UpdatePhysics()
   IGN_PROFILE_END();
 }
 
+//////////////////////////////////////////////////
+void DARTPhysics::AddLink(DARTLink *_link)
+{
+  this->dataPtr->links.push_back(_link);
+}
+
+//////////////////////////////////////////////////
+void DARTPhysics::RemoveLink(const DARTLink *_link)
+{
+  this->dataPtr->links.erase(std::remove(this->dataPtr->links.begin(),
+      this->dataPtr->links.end(), _link), this->dataPtr->links.end());
+}
+
 //////////////////////////////////////////////////
 std::string DARTPhysics::GetType() const
 {
@@ -154,6 +154,16 @@ namespace gazebo
       /// \return The pointer to DART World.
       public: dart::simulation::WorldPtr DARTWorld() const;
 
+      /// \brief Add a link whose pose is written back after each step.
+      /// Called when the link is initialized.
+      /// \param[in] _link The link.
+      public: void AddLink(DARTLink *_link);
+
+      /// \brief Remove a link added with AddLink. Called when the link is
+      /// destroyed.
+      /// \param[in] _link The link.
+      public: void RemoveLink(const DARTLink *_link);
+
       /// \brief Returns a string with the name of the used collision detector.
       /// \return the name of the collision detector, or if no collision
       /// detector has been loaded yet, the empty string is returned.
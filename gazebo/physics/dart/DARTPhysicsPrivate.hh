@@ -18,7 +18,10 @@
 #ifndef _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 #define _GAZEBO_DARTPHYSICS_PRIVATE_HH_
 
+#include <vector>
+
 #include "gazebo/physics/dart/dart_inc.h"
+#include "gazebo/physics/dart/DARTTypes.hh"
 
 namespace gazebo
 {
@@ -50,6 +53,10 @@ namespace gazebo
       /// and torques (both internal and external) after completing a simulation
       /// step. Default value is true.
       public: bool resetAllForcesAfterSimulationStep;
+
+      /// \brief All initialized links, whose pose is written back after
+      /// each step.
+      public: std::vector<DARTLink *> links;
     };
   }
 }
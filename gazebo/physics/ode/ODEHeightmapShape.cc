@@ -16,6 +16,7 @@
 */
 #include "gazebo/common/Exception.hh"
 #include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/World.hh"
 #include "gazebo/physics/ode/ODEHeightmapShape.hh"
 
 using namespace gazebo;
@@ -26,11 +27,14 @@ ODEHeightmapShape::ODEHeightmapShape(CollisionPtr _parent)
     : HeightmapShape(_parent)
 {
   this->flipY = false;
+  this->mapHeights = true;
 }
 
 //////////////////////////////////////////////////
 ODEHeightmapShape::~ODEHeightmapShape()
 {
+  if (this->odePhysics)
+    this->odePhysics->RemoveMappedHeightmap(this->mappedCollision);
 }
 
 //////////////////////////////////////////////////
@@ -112,7 +116,7 @@ void ODEHeightmapShape::Init()
   // Step 3: Setup a callback method for ODE
   setOdeHeightfieldDetails(
       this->odeData,
-      this->heights.data(),
+      this->HeightData(),
       // in meters
       this->Size().X(),
       // in meters
@@ -159,4 +163,16 @@ void ODEHeightmapShape::Init()
   // q[3] = 0;
   // dGeomSetOffsetQuaternion(oParent->getCollisionId(), q);
   dGeomSetQuaternion(oParent->GetCollisionId(), q);
+
+  // Let the collision callback skip geoms above the mapped terrain
+  if (this->mappedHeights.Valid() && !this->odePhysics)
+  {
+    this->odePhysics = boost::dynamic_pointer_cast<ODEPhysics>(
+        this->world->Physics());
+    if (this->odePhysics)
+    {
+      this->mappedCollision = oParent.get();
+      this->odePhysics->AddMappedHeightmap(this->mappedCollision);
+    }
+  }
 }
@@ -52,6 +52,13 @@ namespace gazebo
 
       /// \brief The heightmap data.
       private: dHeightfieldDataID odeData;
+
+      /// \brief Physics engine the collision is registered with when the
+      /// heights are memory-mapped.
+      private: ODEPhysicsPtr odePhysics;
+
+      /// \brief Collision registered with odePhysics.
+      private: const ODECollision *mappedCollision = nullptr;
     };
     /// \}
   }
@@ -125,6 +125,34 @@ class Colliders_TBB
   private: dContactGeom* contactCollisions;
 };
 
+//////////////////////////////////////////////////
+/// \brief Check whether a geom lies above a heightmap, using the per-tile
+/// bounds of memory-mapped heights.
+/// \param[in] _heightmap Collision of a mapped heightmap, registered with
+/// ODEPhysics::AddMappedHeightmap.
+/// \param[in] _geom The other geom of the pair.
+/// \return True if the pair can be skipped.
+static bool AboveHeightmap(ODECollision *_heightmap, dGeomID _geom)
+{
+  HeightmapShapePtr shape =
+    boost::static_pointer_cast<HeightmapShape>(_heightmap->GetShape());
+
+  // The field frame is a translation of the world frame only when the
+  // heightmap is not rotated
+  const ignition::math::Pose3d pose = _heightmap->WorldPose();
+  if (pose.Rot() != ignition::math::Quaterniond::Identity)
+    return false;
+
+  dReal aabb[6];
+  dGeomGetAABB(_geom, aabb);
+
+  const ignition::math::Vector3d offset =
+    pose.Pos() + ignition::math::Vector3d(0, 0, shape->Pos().Z());
+  return shape->AboveHeights(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(aabb[0], aabb[2], aabb[4]) - offset,
+      ignition::math::Vector3d(aabb[1], aabb[3], aabb[5]) - offset));
+}
+
 //////////////////////////////////////////////////
 extern "C" void dMessageQuiet(int, const char *, va_list)
 {
@@ -578,6 +606,18 @@ dWorldID ODEPhysics::GetWorldId()
   return this->dataPtr->worldId;
 }
 
+//////////////////////////////////////////////////
+void ODEPhysics::AddMappedHeightmap(const ODECollision *_collision)
+{
+  this->dataPtr->mappedHeightmaps.insert(_collision);
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::RemoveMappedHeightmap(const ODECollision *_collision)
+{
+  this->dataPtr->mappedHeightmaps.erase(_collision);
+}
+
 //////////////////////////////////////////////////
 void ODEPhysics::ConvertMass(InertialPtr _inertial, void *_engineMass)
 {
@@ -996,6 +1036,15 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
     // Make sure both collision pointers are valid.
     if (collision1 && collision2)
     {
+      // Skip geoms that are above the terrain of a mapped heightmap
+      const auto &mapped = self->dataPtr->mappedHeightmaps;
+      if (!mapped.empty() &&
+          ((mapped.count(collision1) && AboveHeightmap(collision1, _o2)) ||
+           (mapped.count(collision2) && AboveHeightmap(collision2, _o1))))
+      {
+        return;
+      }
+
       // Add either a tri-mesh collider or a regular collider.
       if (collision1->HasType(Base::MESH_SHAPE) ||
           collision2->HasType(Base::MESH_SHAPE))
@@ -232,6 +232,16 @@ namespace gazebo
       /// \return The world id.
       public: dWorldID GetWorldId();
 
+      /// \brief Register the collision of a memory-mapped heightmap. Geoms
+      /// above the terrain of registered heightmaps are skipped without
+      /// running the heightfield collider.
+      /// \param[in] _collision Collision of the heightmap.
+      public: void AddMappedHeightmap(const ODECollision *_collision);
+
+      /// \brief Unregister the collision of a memory-mapped heightmap.
+      /// \param[in] _collision Collision of the heightmap.
+      public: void RemoveMappedHeightmap(const ODECollision *_collision);
+
       /// \brief Convert an ODE mass to Inertial.
       /// \param[out] _intertial Pointer to an Inertial object.
       /// \param[in] _odeMass Pointer to an ODE mass that will be converted.
@@ -20,6 +20,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include <utility>
 
@@ -92,6 +93,9 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief Collisions of the memory-mapped heightmaps.
+      public: std::unordered_set<const ODECollision *> mappedHeightmaps;
     };
   }
 }
@@ -154,6 +154,15 @@ void SimbodyJoint::Reset()
   Joint::Reset();
 }
 
+//////////////////////////////////////////////////
+void SimbodyJoint::Fini()
+{
+  if (this->simbodyPhysics)
+    this->simbodyPhysics->RemoveJoint(this);
+
+  Joint::Fini();
+}
+
 //////////////////////////////////////////////////
 void SimbodyJoint::CacheForceTorque()
 {
@@ -518,10 +527,9 @@ void SimbodyJoint::SetUpperLimit(const unsigned int _index,
               << "tracker.\n";
       }
     }
-    else
-    {
-      gzerr << "SetUpperLimit: State not initialized, SetUpperLimit failed.\n";
-    }
+    // Otherwise the model is waiting to be added to the system. The limit
+    // is stored by Joint::SetUpperLimit, and applied by
+    // SimbodyPhysics::InitPendingModels once the system is built.
   }
   else
   {
@@ -552,10 +560,9 @@ void SimbodyJoint::SetLowerLimit(const unsigned int _index,
               << "tracker.\n";
       }
     }
-    else
-    {
-      gzerr << "SetLowerLimit: State not initialized, SetLowerLimit failed.\n";
-    }
+    // Otherwise the model is waiting to be added to the system. The limit
+    // is stored by Joint::SetLowerLimit, and applied by
+    // SimbodyPhysics::InitPendingModels once the system is built.
   }
   else
   {
@@ -48,6 +48,9 @@ namespace gazebo
       // Documentation inherited.
       public: virtual void Reset() override;
 
+      // Documentation inherited.
+      public: virtual void Fini() override;
+
       // Documentation inherited.
       public: virtual LinkPtr GetJointLink(unsigned int _index) const override;
 
@@ -107,6 +107,9 @@ void SimbodyLink::Init()
 //////////////////////////////////////////////////
 void SimbodyLink::Fini()
 {
+  if (this->simbodyPhysics)
+    this->simbodyPhysics->RemoveLink(this);
+
   this->gravityModeConnection.reset();
   this->staticLinkConnection.reset();
   Link::Fini();
@@ -15,6 +15,10 @@
  *
 */
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
 #include <string>
 
 #include <ignition/common/Profiler.hh>
@@ -69,6 +73,10 @@ using namespace SimTK;
 
 GZ_REGISTER_PHYSICS_ENGINE("simbody", SimbodyPhysics)
 
+/// \brief Number of links from which link poses are written back in
+/// parallel after each step.
+static const size_t parallelWritebackLinks = 256;
+
 //////////////////////////////////////////////////
 SimbodyPhysics::SimbodyPhysics(WorldPtr _world)
     : PhysicsEngine(_world), system(), matter(system), forces(system),
@@ -251,6 +259,7 @@ void SimbodyPhysics::OnPhysicsMsg(ConstPhysicsPtr &_msg)
 //////////////////////////////////////////////////
 void SimbodyPhysics::Reset()
 {
+  this->InitPendingModels();
   this->integ->initialize(this->system.getDefaultState());
 
   // restore potentially user run-time modified gravity
@@ -260,47 +269,30 @@ void SimbodyPhysics::Reset()
 //////////////////////////////////////////////////
 void SimbodyPhysics::Init()
 {
+  this->InitPendingModels();
   this->simbodyPhysicsInitialized = true;
 }
 
 //////////////////////////////////////////////////
 void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
 {
-  // Before building a new system, transfer all joints in existing
-  // models, save Simbody joint states in Gazebo Model.
-  const SimTK::State& currentState = this->integ->getState();
-  double stateTime = 0;
-  bool simbodyStateSaved = false;
-
-  if (currentState.getSystemStage() != SimTK::Stage::Empty)
+  // Before the first model of a batch changes the system, save the Simbody
+  // states of the existing links and joints. The state is not valid for
+  // the system anymore once a model is added.
+  if (this->pendingModels.empty())
   {
-    stateTime = currentState.getTime();
-    physics::Model_V models = this->world->Models();
-    for (physics::Model_V::iterator mi = models.begin();
-         mi != models.end(); ++mi)
-    {
-      if ((*mi) != _model)
-      {
-        physics::Joint_V joints = (*mi)->GetJoints();
-        for (physics::Joint_V::iterator jx = joints.begin();
-             jx != joints.end(); ++jx)
-        {
-          SimbodyJointPtr simbodyJoint =
-            boost::dynamic_pointer_cast<physics::SimbodyJoint>(*jx);
-          simbodyJoint->SaveSimbodyState(currentState);
-        }
+    const SimTK::State& currentState = this->integ->getState();
+    this->pendingStateSaved = false;
 
-        physics::Link_V links = (*mi)->GetLinks();
-        for (physics::Link_V::iterator lx = links.begin();
-             lx != links.end(); ++lx)
-        {
-          SimbodyLinkPtr simbodyLink =
-            boost::dynamic_pointer_cast<physics::SimbodyLink>(*lx);
-          simbodyLink->SaveSimbodyState(currentState);
-        }
-      }
+    if (currentState.getSystemStage() != SimTK::Stage::Empty)
+    {
+      this->pendingStateTime = currentState.getTime();
+      for (auto joint : this->joints)
+        joint->SaveSimbodyState(currentState);
+      for (auto link : this->links)
+        link->SaveSimbodyState(currentState);
+      this->pendingStateSaved = true;
     }
-    simbodyStateSaved = true;
   }
 
   try
@@ -327,6 +319,20 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
     gzthrow(std::string("Simbody build EXCEPTION: ") + e.what());
   }
 
+  this->pendingModels.push_back(_model);
+}
+
+//////////////////////////////////////////////////
+void SimbodyPhysics::InitPendingModels()
+{
+  if (this->pendingModels.empty())
+    return;
+
+  IGN_PROFILE("SimbodyPhysics::InitPendingModels");
+
+  Model_V models;
+  std::swap(models, this->pendingModels);
+
   try
   {
     //------------------------ CREATE SIMBODY SYSTEM ---------------------------
@@ -338,66 +344,84 @@ void SimbodyPhysics::InitModel(const physics::ModelPtr _model)
     gzthrow(std::string("Simbody init EXCEPTION: ") + e.what());
   }
 
+  // Realize the topology once for all the models added since the last
+  // call
   SimTK::State state = this->system.realizeTopology();
 
+  // Register the links and joints of the new models
+  for (auto const &model : models)
+  {
+    for (auto const &link : model->GetLinks())
+    {
+      SimbodyLink *simbodyLink = dynamic_cast<SimbodyLink *>(link.get());
+      if (simbodyLink)
+        this->links.push_back(simbodyLink);
+      else
+        gzerr << "failed to cast link [" << link->GetName()
+              << "] as simbody link\n";
+    }
+
+    for (auto const &joint : model->GetJoints())
+    {
+      SimbodyJoint *simbodyJoint = dynamic_cast<SimbodyJoint *>(joint.get());
+      if (simbodyJoint)
+        this->joints.push_back(simbodyJoint);
+      else
+        gzerr << "simbodyJoint [" << joint->GetName()
+              << "]is not a SimbodyJointPtr\n";
+    }
+  }
+
   // Restore Gazebo saved Joint states
   // back into Simbody state.
-  if (simbodyStateSaved)
+  if (this->pendingStateSaved)
   {
     // set/retsore state time.
-    state.setTime(stateTime);
+    state.setTime(this->pendingStateTime);
 
-    physics::Model_V models = this->world->Models();
-    for (physics::Model_V::iterator mi = models.begin();
-         mi != models.end(); ++mi)
-    {
-      physics::Joint_V joints = (*mi)->GetJoints();
-      for (physics::Joint_V::iterator jx = joints.begin();
-           jx != joints.end(); ++jx)
-      {
-        SimbodyJointPtr simbodyJoint =
-          boost::dynamic_pointer_cast<physics::SimbodyJoint>(*jx);
-        simbodyJoint->RestoreSimbodyState(state);
-      }
-      physics::Link_V links = (*mi)->GetLinks();
-      for (physics::Link_V::iterator lx = links.begin();
-           lx != links.end(); ++lx)
-      {
-        SimbodyLinkPtr simbodyLink =
-          boost::dynamic_pointer_cast<physics::SimbodyLink>(*lx);
-        simbodyLink->RestoreSimbodyState(state);
-      }
-    }
+    for (auto joint : this->joints)
+      joint->RestoreSimbodyState(state);
+    for (auto link : this->links)
+      link->RestoreSimbodyState(state);
+    this->pendingStateSaved = false;
   }
 
   // initialize integrator from state
   this->integ->initialize(state);
 
-  // mark links as initialized
-  Link_V links = _model->GetLinks();
-  for (Link_V::iterator li = links.begin(); li != links.end(); ++li)
+  // mark links and joints as initialized
+  for (auto const &model : models)
   {
-    physics::SimbodyLinkPtr simbodyLink =
-      boost::dynamic_pointer_cast<physics::SimbodyLink>(*li);
-    if (simbodyLink)
-      simbodyLink->physicsInitialized = true;
-    else
-      gzerr << "failed to cast link [" << (*li)->GetName()
-            << "] as simbody link\n";
-  }
+    for (auto const &link : model->GetLinks())
+    {
+      SimbodyLink *simbodyLink = dynamic_cast<SimbodyLink *>(link.get());
+      if (simbodyLink)
+        simbodyLink->physicsInitialized = true;
+    }
+
+    for (auto const &joint : model->GetJoints())
+    {
+      SimbodyJoint *simbodyJoint = dynamic_cast<SimbodyJoint *>(joint.get());
+      if (!simbodyJoint)
+        continue;
 
-  // mark joints as initialized
-  physics::Joint_V joints = _model->GetJoints();
-  for (physics::Joint_V::iterator ji = joints.begin();
-       ji != joints.end(); ++ji)
-  {
-    SimbodyJointPtr simbodyJoint =
-      boost::dynamic_pointer_cast<SimbodyJoint>(*ji);
-    if (simbodyJoint)
       simbodyJoint->physicsInitialized = true;
-    else
-      gzerr << "simbodyJoint [" << (*ji)->GetName()
-            << "]is not a SimbodyJointPtr\n";
+
+      // Apply the limits set while the model was pending, such as the ones
+      // set by Joint::Init
+      const unsigned int dof = std::min(simbodyJoint->DOF(),
+          static_cast<unsigned int>(MAX_JOINT_AXIS));
+      for (unsigned int i = 0; i < dof; ++i)
+      {
+        const double low = simbodyJoint->LowerLimit(i);
+        const double high = simbodyJoint->UpperLimit(i);
+        if (!simbodyJoint->limitForce[i].isEmptyHandle() && low <= high)
+        {
+          simbodyJoint->limitForce[i].setBounds(
+              this->integ->updAdvancedState(), low, high);
+        }
+      }
+    }
   }
 
   this->simbodyPhysicsInitialized = true;
@@ -416,6 +440,8 @@ void SimbodyPhysics::UpdateCollision()
   IGN_PROFILE_BEGIN("UpdateCollision");
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
+  this->InitPendingModels();
+
   this->contactManager->ResetCount();
 
   // Get all contacts from Simbody
@@ -649,6 +675,8 @@ void SimbodyPhysics::UpdatePhysics()
   // need to lock, otherwise might conflict with world resetting
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
 
+  this->InitPendingModels();
+
   common::Time currTime =  this->world->RealTime();
 
   // Simbody cannot step the integrator without a subsystem
@@ -683,33 +711,31 @@ void SimbodyPhysics::UpdatePhysics()
   //       << "]\n";
   // this->lastUpdateTime = currTime;
 
-  // pushing new entity pose into dirtyPoses for visualization
-  physics::Model_V models = this->world->Models();
-  for (physics::Model_V::iterator mi = models.begin();
-       mi != models.end(); ++mi)
+  // Reading body transforms from the realized state does not modify it,
+  // so the link poses of large worlds are computed in parallel.
+  auto updatePoses = [&](const tbb::blocked_range<size_t> &_r)
   {
-    physics::Link_V links = (*mi)->GetLinks();
-    for (physics::Link_V::iterator lx = links.begin();
-         lx != links.end(); ++lx)
+    for (size_t i = _r.begin(); i != _r.end(); ++i)
     {
-      physics::SimbodyLinkPtr simbodyLink =
-        boost::dynamic_pointer_cast<physics::SimbodyLink>(*lx);
-      auto pose = SimbodyPhysics::Transform2PoseIgn(
-        simbodyLink->masterMobod.getBodyTransform(s));
-      simbodyLink->SetDirtyPose(pose);
-      this->world->dataPtr->dirtyPoses.push_back(
-        boost::static_pointer_cast<Entity>(*lx).get());
+      SimbodyLink *simbodyLink = this->links[i];
+      simbodyLink->SetDirtyPose(SimbodyPhysics::Transform2PoseIgn(
+          simbodyLink->masterMobod.getBodyTransform(s)));
     }
+  };
+  tbb::blocked_range<size_t> linkRange(0, this->links.size());
+  if (this->links.size() >= parallelWritebackLinks)
+    tbb::parallel_for(linkRange, updatePoses);
+  else
+    updatePoses(linkRange);
 
-    physics::Joint_V joints = (*mi)->GetJoints();
-    for (physics::Joint_V::iterator jx = joints.begin();
-         jx != joints.end(); ++jx)
-    {
-      SimbodyJointPtr simbodyJoint =
-        boost::dynamic_pointer_cast<physics::SimbodyJoint>(*jx);
-      simbodyJoint->CacheForceTorque();
-    }
-  }
+  // pushing new entity pose into dirtyPoses for visualization
+  for (auto link : this->links)
+    this->world->dataPtr->dirtyPoses.push_back(link);
+
+  // Reaction forces are computed through the system, so they are cached
+  // serially.
+  for (auto joint : this->joints)
+    joint->CacheForceTorque();
 
   // FIXME:  this needs to happen before forces are applied for the next step
   // FIXME:  but after we've gotten everything from current state
@@ -720,9 +746,26 @@ void SimbodyPhysics::UpdatePhysics()
 //////////////////////////////////////////////////
 void SimbodyPhysics::Fini()
 {
+  this->links.clear();
+  this->joints.clear();
+  this->pendingModels.clear();
   PhysicsEngine::Fini();
 }
 
+//////////////////////////////////////////////////
+void SimbodyPhysics::RemoveLink(const SimbodyLink *_link)
+{
+  this->links.erase(std::remove(this->links.begin(), this->links.end(),
+      _link), this->links.end());
+}
+
+//////////////////////////////////////////////////
+void SimbodyPhysics::RemoveJoint(const SimbodyJoint *_joint)
+{
+  this->joints.erase(std::remove(this->joints.begin(), this->joints.end(),
+      _joint), this->joints.end());
+}
+
 //////////////////////////////////////////////////
 LinkPtr SimbodyPhysics::CreateLink(ModelPtr _parent)
 {
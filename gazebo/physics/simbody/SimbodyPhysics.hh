@@ -18,6 +18,7 @@
 #ifndef GAZEBO_PHYSICS_SIMBODY_SIMBODYPHYSICS_HH
 #define GAZEBO_PHYSICS_SIMBODY_SIMBODYPHYSICS_HH
 #include <string>
+#include <vector>
 
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
@@ -56,10 +57,16 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Reset();
 
-      /// \brief Add a Model to the Simbody system.
+      /// \brief Add a Model to the Simbody system. Realizing the new
+      /// topology and carrying the state over is deferred to
+      /// InitPendingModels, so that models added in the same step share a
+      /// single rebuild.
       /// \param[in] _model Pointer to the model to add into Simbody.
       public: void InitModel(const physics::ModelPtr _model);
 
+      // Documentation inherited
+      public: virtual void InitPendingModels();
+
       // Documentation inherited
       public: virtual void InitForThread();
 
@@ -207,6 +214,16 @@ namespace gazebo
       private: void AddCollisionsToLink(const physics::SimbodyLink *_link,
         SimTK::MobilizedBody &_mobod, SimTK::ContactCliqueId _modelClique);
 
+      /// \brief Remove a link from the links whose pose is written back
+      /// after each step. Called when the link is destroyed.
+      /// \param[in] _link The link.
+      public: void RemoveLink(const SimbodyLink *_link);
+
+      /// \brief Remove a joint from the joints whose wrench is cached
+      /// after each step. Called when the joint is destroyed.
+      /// \param[in] _joint The joint.
+      public: void RemoveJoint(const SimbodyJoint *_joint);
+
       public: SimTK::MultibodySystem system;
       public: SimTK::SimbodyMatterSubsystem matter;
       public: SimTK::GeneralForceSubsystem forces;
@@ -268,6 +285,28 @@ namespace gazebo
 
       private: SimTK::MultibodySystem *dynamicsWorld;
 
+      /// \brief Links of all models added to the Simbody system, in the
+      /// order the models were added. Their pose is written back after
+      /// each step.
+      private: std::vector<SimbodyLink *> links;
+
+      /// \brief Joints of all models added to the Simbody system, in the
+      /// order the models were added. Their wrench is cached after each
+      /// step.
+      private: std::vector<SimbodyJoint *> joints;
+
+      /// \brief Models added to the system since the topology was last
+      /// realized.
+      private: Model_V pendingModels;
+
+      /// \brief True if the state of the links and joints was saved
+      /// before the pending models were added.
+      private: bool pendingStateSaved = false;
+
+      /// \brief Time of the state saved before the pending models were
+      /// added.
+      private: double pendingStateTime = 0;
+
       private: common::Time lastUpdateTime;
 
       private: double stepTimeDouble;
@@ -357,10 +357,9 @@ void SimbodyScrewJoint::SetUpperLimit(const unsigned int _index,
         gzerr << "Should never be here. Joint index invalid limit not set.\n";
       }
     }
-    else
-    {
-      gzerr << "SetUpperLimit: State not initialized, SetUpperLimit failed.\n";
-    }
+    // Otherwise the model is waiting to be added to the system. The limit
+    // is stored by Joint::SetUpperLimit, and applied by
+    // SimbodyPhysics::InitPendingModels once the system is built.
   }
   else
   {
@@ -432,10 +431,9 @@ void SimbodyScrewJoint::SetLowerLimit(const unsigned int _index,
         gzerr << "Should never be here. Joint index invalid limit not set.\n";
       }
     }
-    else
-    {
-      gzerr << "SetLowerLimit: State not initialized, SetLowerLimit failed.\n";
-    }
+    // Otherwise the model is waiting to be added to the system. The limit
+    // is stored by Joint::SetLowerLimit, and applied by
+    // SimbodyPhysics::InitPendingModels once the system is built.
   }
   else
   {
@@ -1446,6 +1446,10 @@ void Camera::SetCaptureDataOnce()
 bool Camera::StartVideo(const std::string &_format,
                         const std::string &_filename)
 {
+  // Encode on a separate thread so that recording doesn't slow down
+  // rendering. Frames are dropped while the encoder is 4 frames behind.
+  this->dataPtr->videoEncoder.SetFrameQueue(4);
+
   return this->dataPtr->videoEncoder.Start(_format, _filename,
       this->ImageWidth(), this->ImageHeight());
 }
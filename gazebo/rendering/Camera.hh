@@ -492,7 +492,8 @@ namespace gazebo
       /// \brief Capture data once and save to disk
       public: void SetCaptureDataOnce();
 
-      /// \brief Turn on video recording.
+      /// \brief Turn on video recording. Frames are encoded on a separate
+      /// thread, and dropped while the encoder falls behind.
       /// \param[in] _format String that represents the video type.
       /// Supported types include: "avi", "ogv", mp4", "v4l2". If using
       /// "v4l2", you must also specify a _filename.
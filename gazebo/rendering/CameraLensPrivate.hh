@@ -143,6 +143,13 @@ namespace gazebo
       /// \brief SDF element of the lens
       public: sdf::ElementPtr sdf;
 
+      /// \brief Lens parameters, aspect ratio and horizontal FOV used to
+      /// compute faceMask.
+      public: std::vector<double> faceMaskKey;
+
+      /// \brief Cube map faces sampled with the parameters in faceMaskKey.
+      public: unsigned int faceMask = 0;
+
       /// \brief Mutex to lock when getting or setting lens data
       public: std::recursive_mutex dataMutex;
     };
@@ -16,6 +16,7 @@
 */
 #include <math.h>
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <ignition/common/Profiler.hh>
@@ -35,10 +36,39 @@ enum {POSITION_BINDING, TEXCOORD_BINDING};
 /// \brief Private implementation
 class gazebo::rendering::DynamicLinesPrivate
 {
+  /// \brief Extend the range of points to write on the next update.
+  /// \param[in] _begin First changed point.
+  /// \param[in] _end One past the last changed point.
+  public: void MarkDirty(const size_t _begin, const size_t _end);
+
   /// \brief list of colors at each point
   public: std::vector<ignition::math::Color> colors;
+
+  /// \brief First point that changed since the last update.
+  public: size_t dirtyBegin = 0;
+
+  /// \brief One past the last point that changed since the last update.
+  public: size_t dirtyEnd = 0;
+
+  /// \brief True if all points must be written on the next update.
+  public: bool fullUpdate = true;
 };
 
+/////////////////////////////////////////////////
+void DynamicLinesPrivate::MarkDirty(const size_t _begin, const size_t _end)
+{
+  if (this->dirtyBegin == this->dirtyEnd)
+  {
+    this->dirtyBegin = _begin;
+    this->dirtyEnd = _end;
+  }
+  else
+  {
+    this->dirtyBegin = std::min(this->dirtyBegin, _begin);
+    this->dirtyEnd = std::max(this->dirtyEnd, _end);
+  }
+}
+
 /////////////////////////////////////////////////
 DynamicLines::DynamicLines(RenderOpType opType)
   : dataPtr(new DynamicLinesPrivate)
@@ -72,6 +102,7 @@ void DynamicLines::AddPoint(const ignition::math::Vector3d &_pt,
 {
   this->points.push_back(_pt);
   this->dataPtr->colors.push_back(_color);
+  this->dataPtr->MarkDirty(this->points.size() - 1, this->points.size());
   this->dirty = true;
 }
 
@@ -94,6 +125,7 @@ void DynamicLines::SetPoint(const unsigned int _index,
   }
 
   this->points[_index] = _value;
+  this->dataPtr->MarkDirty(_index, _index + 1);
 
   this->dirty = true;
 }
@@ -103,6 +135,7 @@ void DynamicLines::SetColor(const unsigned int _index,
                             const ignition::math::Color &_color)
 {
   this->dataPtr->colors[_index] = _color;
+  this->dataPtr->MarkDirty(_index, _index + 1);
   this->dirty = true;
 }
 
@@ -133,6 +166,8 @@ unsigned int DynamicLines::GetPointCount() const
 void DynamicLines::Clear()
 {
   this->points.clear();
+  this->dataPtr->colors.clear();
+  this->dataPtr->fullUpdate = true;
   this->dirty = true;
 }
 
@@ -140,7 +175,10 @@ void DynamicLines::Clear()
 void DynamicLines::Update()
 {
   IGN_PROFILE("rendering::DynamicLines::Update");
-  if (this->dirty && this->points.size() > 1)
+  // A point list can draw a single point, lines need at least two.
+  const size_t minPoints =
+      this->GetOperationType() == RENDERING_POINT_LIST ? 1 : 2;
+  if (this->dirty && this->points.size() >= minPoints)
     this->FillHardwareBuffers();
 }
 
@@ -158,49 +196,70 @@ void DynamicLines::CreateVertexDeclaration()
 void DynamicLines::FillHardwareBuffers()
 {
   int size = this->points.size();
+  const size_t capacity = this->vertexBufferCapacity;
   this->PrepareHardwareBuffers(size, 0);
 
+  // Only write the points that changed, unless the buffers were recreated
+  int begin = 0;
+  int end = size;
+  if (!this->dataPtr->fullUpdate && capacity == this->vertexBufferCapacity)
+  {
+    begin = std::min(static_cast<int>(this->dataPtr->dirtyBegin), size);
+    end = std::min(static_cast<int>(this->dataPtr->dirtyEnd), size);
+  }
+  const bool partial = begin != 0 || end != size;
+
   if (!size)
   {
     this->mBox.setExtents(Ogre::Vector3::ZERO, Ogre::Vector3::ZERO);
     this->dirty = false;
   }
 
-  Ogre::HardwareVertexBufferSharedPtr vbuf =
-    this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(0);
-
-  Ogre::Real *prPos =
-    static_cast<Ogre::Real*>(vbuf->lock(Ogre::HardwareBuffer::HBL_NORMAL));
+  if (end > begin)
   {
-    for (int i = 0; i < size; i++)
-    {
-      *prPos++ = this->points[i].X();
-      *prPos++ = this->points[i].Y();
-      *prPos++ = this->points[i].Z();
+    Ogre::HardwareVertexBufferSharedPtr vbuf =
+      this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(0);
 
-      this->mBox.merge(Conversions::Convert(this->points[i]));
+    Ogre::Real *prPos = static_cast<Ogre::Real*>(vbuf->lock(
+        begin * vbuf->getVertexSize(), (end - begin) * vbuf->getVertexSize(),
+        Ogre::HardwareBuffer::HBL_NORMAL));
+    {
+      for (int i = begin; i < end; i++)
+      {
+        *prPos++ = this->points[i].X();
+        *prPos++ = this->points[i].Y();
+        *prPos++ = this->points[i].Z();
+
+        this->mBox.merge(Conversions::Convert(this->points[i]));
+      }
     }
+    vbuf->unlock();
+
+    // Update the colors
+    Ogre::HardwareVertexBufferSharedPtr cbuf =
+      this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(1);
+
+    Ogre::RGBA *colorArrayBuffer = static_cast<Ogre::RGBA*>(cbuf->lock(
+          begin * cbuf->getVertexSize(), (end - begin) * cbuf->getVertexSize(),
+          partial ? Ogre::HardwareBuffer::HBL_NORMAL :
+          Ogre::HardwareBuffer::HBL_DISCARD));
+    Ogre::RenderSystem *renderSystemForVertex =
+          Ogre::Root::getSingleton().getRenderSystem();
+    for (int i = begin; i < end; ++i)
+    {
+      Ogre::ColourValue color = Conversions::Convert(this->dataPtr->colors[i]);
+      renderSystemForVertex->convertColourValue(color,
+          &colorArrayBuffer[i - begin]);
+    }
+    cbuf->unlock();
   }
-  vbuf->unlock();
-
-  // Update the colors
-  Ogre::HardwareVertexBufferSharedPtr cbuf =
-    this->mRenderOp.vertexData->vertexBufferBinding->getBuffer(1);
-
-  Ogre::RGBA *colorArrayBuffer =
-        static_cast<Ogre::RGBA*>(cbuf->lock(Ogre::HardwareBuffer::HBL_DISCARD));
-  Ogre::RenderSystem *renderSystemForVertex =
-        Ogre::Root::getSingleton().getRenderSystem();
-  for (int i = 0; i < size; ++i)
-  {
-    Ogre::ColourValue color = Conversions::Convert(this->dataPtr->colors[i]);
-    renderSystemForVertex->convertColourValue(color, &colorArrayBuffer[i]);
-  }
-  cbuf->unlock();
 
   // need to update after mBox change, otherwise the lines goes in and out
   // of scope based on old mBox
   this->getParentSceneNode()->needUpdate();
 
+  this->dataPtr->dirtyBegin = 0;
+  this->dataPtr->dirtyEnd = 0;
+  this->dataPtr->fullUpdate = false;
   this->dirty = false;
 }
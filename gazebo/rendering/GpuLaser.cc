@@ -491,6 +491,12 @@ GpuLaser::DataIter GpuLaser::LaserDataEnd() const
       intenOffset, this->dataPtr->w2nd);
 }
 
+//////////////////////////////////////////////////
+const float *GpuLaser::LaserData() const
+{
+  return this->dataPtr->laserBuffer;
+}
+
 /////////////////////////////////////////////////
 void GpuLaser::CreateOrthoCam()
 {
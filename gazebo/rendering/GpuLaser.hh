@@ -96,6 +96,13 @@ namespace gazebo
       /// \brief Return an iterator to one past the end of the laser data
       public: DataIter LaserDataEnd() const;
 
+      /// \brief Get a pointer to the raw laser buffer. Each reading is
+      /// stored as three floats (range, intensity, unused), row by row.
+      /// \return Pointer to the laser buffer, or nullptr if no frame has
+      /// been captured yet.
+      /// \sa LaserDataBegin
+      public: const float *LaserData() const;
+
       /// \brief Connect to a laser frame signal
       /// \param[in] _subscriber Callback that is called when a new image is
       /// generated
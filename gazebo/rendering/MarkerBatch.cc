@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
+
+#include "gazebo/rendering/DynamicLines.hh"
+#include "gazebo/rendering/MarkerVisual.hh"
+#include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/MarkerBatch.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+/// \brief Private data for the MarkerBatch class
+class gazebo::rendering::MarkerBatchPrivate
+{
+  /// \brief Range of the shared vertex buffer used by a marker.
+  public: class Slot
+  {
+    /// \brief Index of the first point.
+    public: size_t offset;
+
+    /// \brief Number of points.
+    public: size_t count;
+  };
+
+  /// \brief Namespace of the markers.
+  public: std::string ns;
+
+  /// \brief Visual that draws the batch.
+  public: std::shared_ptr<MarkerVisual> visual;
+
+  /// \brief Renderable of the visual, owned by the visual.
+  public: DynamicLines *lines = nullptr;
+
+  /// \brief Slot of each marker, by marker id.
+  public: std::map<uint64_t, Slot> slots;
+
+  /// \brief True if markers were removed or resized, and the buffer has
+  /// unused ranges.
+  public: bool compact = false;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the render operation that draws a marker in a batch.
+/// \param[in] _type Marker type.
+/// \return The marker type of the batch.
+static ignition::msgs::Marker::Type BatchType(
+    const ignition::msgs::Marker::Type _type)
+{
+  switch (_type)
+  {
+    case ignition::msgs::Marker::LINE_LIST:
+    case ignition::msgs::Marker::LINE_STRIP:
+      return ignition::msgs::Marker::LINE_LIST;
+    case ignition::msgs::Marker::TRIANGLE_FAN:
+    case ignition::msgs::Marker::TRIANGLE_LIST:
+    case ignition::msgs::Marker::TRIANGLE_STRIP:
+      return ignition::msgs::Marker::TRIANGLE_LIST;
+    case ignition::msgs::Marker::POINTS:
+      return ignition::msgs::Marker::POINTS;
+    default:
+      return ignition::msgs::Marker::NONE;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the vertices of a marker in the frame of the batch, as a
+/// point, line or triangle list.
+/// \param[in] _msg The marker.
+/// \return The vertices.
+static std::vector<ignition::math::Vector3d> Vertices(
+    const ignition::msgs::Marker &_msg)
+{
+  ignition::math::Pose3d pose;
+  if (_msg.has_pose())
+    pose = ignition::msgs::Convert(_msg.pose());
+
+  ignition::math::Vector3d scale = ignition::math::Vector3d::One;
+  if (_msg.has_scale())
+    scale = ignition::msgs::Convert(_msg.scale());
+
+  std::vector<ignition::math::Vector3d> points;
+  points.reserve(_msg.point_size());
+  for (int i = 0; i < _msg.point_size(); ++i)
+  {
+    points.push_back(pose.Pos() + pose.Rot().RotateVector(
+        scale * ignition::msgs::Convert(_msg.point(i))));
+  }
+
+  const size_t n = points.size();
+  std::vector<ignition::math::Vector3d> vertices;
+  switch (_msg.type())
+  {
+    case ignition::msgs::Marker::LINE_STRIP:
+      for (size_t i = 1; i < n; ++i)
+      {
+        vertices.push_back(points[i-1]);
+        vertices.push_back(points[i]);
+      }
+      break;
+    case ignition::msgs::Marker::TRIANGLE_STRIP:
+      // Alternate the winding, as the strip does
+      for (size_t i = 2; i < n; ++i)
+      {
+        vertices.push_back(points[i % 2 ? i-1 : i-2]);
+        vertices.push_back(points[i % 2 ? i-2 : i-1]);
+        vertices.push_back(points[i]);
+      }
+      break;
+    case ignition::msgs::Marker::TRIANGLE_FAN:
+      for (size_t i = 2; i < n; ++i)
+      {
+        vertices.push_back(points[0]);
+        vertices.push_back(points[i-1]);
+        vertices.push_back(points[i]);
+      }
+      break;
+    case ignition::msgs::Marker::LINE_LIST:
+      vertices.assign(points.begin(), points.begin() + (n - n % 2));
+      break;
+    case ignition::msgs::Marker::TRIANGLE_LIST:
+      vertices.assign(points.begin(), points.begin() + (n - n % 3));
+      break;
+    default:
+      vertices = std::move(points);
+      break;
+  }
+
+  return vertices;
+}
+
+/////////////////////////////////////////////////
+MarkerBatch::MarkerBatch(const std::string &_name, VisualPtr _parent,
+    const ignition::msgs::Marker &_msg)
+: dataPtr(new MarkerBatchPrivate)
+{
+  // The visual only carries the settings shared by the batch. The points
+  // are written to its renderable directly.
+  ignition::msgs::Marker msg;
+  msg.set_action(ignition::msgs::Marker::ADD_MODIFY);
+  msg.set_type(BatchType(_msg.type()));
+  msg.set_layer(_msg.layer());
+  if (_msg.has_material())
+    msg.mutable_material()->CopyFrom(_msg.material());
+
+  this->dataPtr->ns = _msg.ns();
+  this->dataPtr->visual.reset(new MarkerVisual(_name, _parent));
+  this->dataPtr->visual->Load(msg);
+  this->dataPtr->lines = this->dataPtr->visual->Lines();
+}
+
+/////////////////////////////////////////////////
+MarkerBatch::~MarkerBatch()
+{
+  ScenePtr scene = this->dataPtr->visual->GetScene();
+  this->dataPtr->visual->Fini();
+  if (scene)
+    scene->RemoveVisual(this->dataPtr->visual);
+}
+
+/////////////////////////////////////////////////
+bool MarkerBatch::Batchable(const ignition::msgs::Marker &_msg)
+{
+  return BatchType(_msg.type()) != ignition::msgs::Marker::NONE &&
+      _msg.parent().empty();
+}
+
+/////////////////////////////////////////////////
+std::string MarkerBatch::Key(const ignition::msgs::Marker &_msg)
+{
+  std::string material;
+  _msg.material().SerializeToString(&material);
+
+  return _msg.ns() + "/" + std::to_string(_msg.layer()) + "/" +
+      std::to_string(BatchType(_msg.type())) + "/" + material;
+}
+
+/////////////////////////////////////////////////
+const std::string &MarkerBatch::Namespace() const
+{
+  return this->dataPtr->ns;
+}
+
+/////////////////////////////////////////////////
+void MarkerBatch::Set(const uint64_t _id, const ignition::msgs::Marker &_msg)
+{
+  IGN_PROFILE("rendering::MarkerBatch::Set");
+  DynamicLines *lines = this->dataPtr->lines;
+  if (!lines)
+    return;
+
+  const std::vector<ignition::math::Vector3d> vertices = Vertices(_msg);
+
+  // Update in place if the number of points didn't change
+  auto slot = this->dataPtr->slots.find(_id);
+  if (slot != this->dataPtr->slots.end())
+  {
+    if (slot->second.count == vertices.size())
+    {
+      for (size_t i = 0; i < vertices.size(); ++i)
+        lines->SetPoint(slot->second.offset + i, vertices[i]);
+      return;
+    }
+
+    this->dataPtr->slots.erase(slot);
+    this->dataPtr->compact = true;
+  }
+
+  // Otherwise append the points, the old range is dropped by Update
+  MarkerBatchPrivate::Slot newSlot;
+  newSlot.offset = lines->GetPointCount();
+  newSlot.count = vertices.size();
+  for (auto const &vertex : vertices)
+    lines->AddPoint(vertex);
+  this->dataPtr->slots[_id] = newSlot;
+}
+
+/////////////////////////////////////////////////
+bool MarkerBatch::Remove(const uint64_t _id)
+{
+  if (this->dataPtr->slots.erase(_id) == 0)
+    return false;
+
+  this->dataPtr->compact = true;
+  return true;
+}
+
+/////////////////////////////////////////////////
+size_t MarkerBatch::MarkerCount() const
+{
+  return this->dataPtr->slots.size();
+}
+
+/////////////////////////////////////////////////
+size_t MarkerBatch::PointCount() const
+{
+  return this->dataPtr->lines ? this->dataPtr->lines->GetPointCount() : 0;
+}
+
+/////////////////////////////////////////////////
+void MarkerBatch::Update()
+{
+  IGN_PROFILE("rendering::MarkerBatch::Update");
+  DynamicLines *lines = this->dataPtr->lines;
+  if (!lines)
+    return;
+
+  // Drop the ranges of removed markers, keeping the order of the others
+  if (this->dataPtr->compact)
+  {
+    std::vector<std::pair<size_t, uint64_t>> order;
+    order.reserve(this->dataPtr->slots.size());
+    for (auto const &slot : this->dataPtr->slots)
+      order.push_back(std::make_pair(slot.second.offset, slot.first));
+    std::sort(order.begin(), order.end());
+
+    std::vector<ignition::math::Vector3d> points;
+    for (auto const &entry : order)
+    {
+      auto &slot = this->dataPtr->slots[entry.second];
+      const size_t offset = points.size();
+      for (size_t i = 0; i < slot.count; ++i)
+        points.push_back(lines->Point(slot.offset + i));
+      slot.offset = offset;
+    }
+
+    lines->Clear();
+    for (auto const &point : points)
+      lines->AddPoint(point);
+
+    this->dataPtr->compact = false;
+  }
+
+  // The renderable keeps its last buffer when it has fewer points than a
+  // primitive needs
+  const size_t minPoints =
+      lines->GetOperationType() == RENDERING_POINT_LIST ? 1 : 2;
+  const bool visible = lines->GetPointCount() >= minPoints;
+  if (this->dataPtr->visual->GetVisible() != visible)
+    this->dataPtr->visual->SetVisible(visible);
+
+  lines->Update();
+}
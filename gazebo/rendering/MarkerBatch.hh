@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_MARKERBATCH_HH_
+#define GAZEBO_RENDERING_MARKERBATCH_HH_
+
+#include <memory>
+#include <string>
+
+#include <ignition/msgs.hh>
+
+#include "gazebo/rendering/RenderTypes.hh"
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class MarkerBatchPrivate;
+
+    /// \cond
+    /// \brief Draws many point, line and triangle markers that share a
+    /// namespace, layer and material with a single renderable.
+    ///
+    /// The points of each marker are transformed by its pose and scale, and
+    /// stored in one shared vertex buffer. Strips and fans are converted to
+    /// lists, so that markers can be drawn together. Markers that keep their
+    /// number of points are updated in place, and only the changed part of
+    /// the buffer is written. The MarkerManager class should instantiate
+    /// instances of this class.
+    /// \sa MarkerManager
+    class MarkerBatch
+    {
+      /// \brief Constructor.
+      /// \param[in] _name Name of the visual that draws the batch.
+      /// \param[in] _parent Parent of the visual.
+      /// \param[in] _msg A marker of the batch. Its type, layer and material
+      /// are used for the whole batch.
+      public: MarkerBatch(const std::string &_name, VisualPtr _parent,
+                  const ignition::msgs::Marker &_msg);
+
+      /// \brief Destructor. Removes the visual from the scene.
+      public: virtual ~MarkerBatch();
+
+      /// \brief Check if a marker can be drawn by a batch.
+      /// \param[in] _msg The marker.
+      /// \return True for point, line and triangle markers that aren't
+      /// attached to a parent visual.
+      public: static bool Batchable(const ignition::msgs::Marker &_msg);
+
+      /// \brief Get the key of the batch that draws a marker. Markers with
+      /// the same key can share a batch.
+      /// \param[in] _msg The marker.
+      /// \return The key.
+      public: static std::string Key(const ignition::msgs::Marker &_msg);
+
+      /// \brief Get the namespace of the markers of the batch.
+      /// \return The namespace.
+      public: const std::string &Namespace() const;
+
+      /// \brief Add a marker, or replace the points of a marker.
+      /// \param[in] _id Id of the marker.
+      /// \param[in] _msg The complete marker.
+      public: void Set(const uint64_t _id, const ignition::msgs::Marker &_msg);
+
+      /// \brief Remove a marker.
+      /// \param[in] _id Id of the marker.
+      /// \return True if the marker was in the batch.
+      public: bool Remove(const uint64_t _id);
+
+      /// \brief Get the number of markers.
+      /// \return Number of markers in the batch.
+      public: size_t MarkerCount() const;
+
+      /// \brief Get the number of points.
+      /// \return Number of points drawn by the batch.
+      public: size_t PointCount() const;
+
+      /// \brief Write the changes to the vertex buffer.
+      public: void Update();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<MarkerBatchPrivate> dataPtr;
+    };
+    /// \endcond
+  }
+}
+#endif
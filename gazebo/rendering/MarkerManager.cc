@@ -18,8 +18,11 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <ignition/msgs.hh>
 #include <ignition/transport/Node.hh>
@@ -29,6 +32,7 @@
 #include "gazebo/transport/Node.hh"
 #include "gazebo/rendering/RenderingIface.hh"
 #include "gazebo/rendering/Scene.hh"
+#include "gazebo/rendering/MarkerBatch.hh"
 #include "gazebo/rendering/MarkerVisual.hh"
 #include "gazebo/rendering/MarkerManager.hh"
 
@@ -51,6 +55,45 @@ class gazebo::rendering::MarkerManagerPrivate
   /// \brief List of marker messages.
   typedef std::list<ignition::msgs::Marker> MarkerMsgs_L;
 
+  /// \brief A marker drawn by a MarkerBatch.
+  public: class BatchedMarker
+  {
+    /// \brief The marker, with all changes applied.
+    public: ignition::msgs::Marker msg;
+
+    /// \brief Lifetime of the marker
+    public: common::Time lifetime;
+
+    /// \brief Key of the batch that draws the marker.
+    public: std::string batch;
+  };
+
+  /// \def BatchedMarker_M
+  /// \brief Map of batched markers. The key is a marker namespace, the
+  /// value is the map of markers in the namespace and their ids.
+  typedef std::map<std::string, std::map<uint64_t, BatchedMarker>>
+      BatchedMarker_M;
+
+  /// \brief Check if a marker message asks to be drawn by a batch.
+  /// \param[in] _msg The message.
+  /// \return True if the header has a "batch" entry set to "true" or "1".
+  public: static bool BatchRequested(const ignition::msgs::Marker &_msg);
+
+  /// \brief Add or modify a batched marker.
+  /// \param[in] _ns Namespace of the marker.
+  /// \param[in] _id Id of the marker.
+  /// \param[in] _msg The message.
+  /// \return True if the marker was processed successfully.
+  public: bool SetBatchedMarker(const std::string &_ns, const uint64_t _id,
+              const ignition::msgs::Marker &_msg);
+
+  /// \brief Remove a batched marker.
+  /// \param[in] _ns Namespace of the marker.
+  /// \param[in] _id Id of the marker.
+  /// \return True if the marker existed.
+  public: bool RemoveBatchedMarker(const std::string &_ns,
+              const uint64_t _id);
+
   /// \brief Process a marker message.
   /// \param[in] _msg The message data.
   /// \return True if the marker was processed successfully.
@@ -64,6 +107,14 @@ class gazebo::rendering::MarkerManagerPrivate
   /// \param[in] _req The marker message.
   public: void OnMarkerMsg(const ignition::msgs::Marker &_req);
 
+  /// \brief Callback that receives a list of marker messages. The
+  /// messages are applied together, in the same frame.
+  /// \param[in] _req The marker messages.
+  /// \param[out] _res True if the messages were queued.
+  /// \return True on success.
+  public: bool OnMarkerArray(const ignition::msgs::Marker_V &_req,
+              ignition::msgs::Boolean &_res);
+
   /// \brief Service callback that returns a list of markers.
   /// \param[out] _rep Service reply
   /// \return True on success.
@@ -85,6 +136,15 @@ class gazebo::rendering::MarkerManagerPrivate
   /// \brief List of marker message to process.
   public: MarkerMsgs_L markerMsgs;
 
+  /// \brief Markers drawn by batches.
+  public: BatchedMarker_M batchedMarkers;
+
+  /// \brief Batches by key, see MarkerBatch::Key.
+  public: std::map<std::string, std::unique_ptr<MarkerBatch>> batches;
+
+  /// \brief Number of batches created, used to name their visuals.
+  public: unsigned int batchCount = 0;
+
   /// \brief Pointer to the scene
   public: Scene *scene = nullptr;
 
@@ -142,6 +202,13 @@ bool MarkerManager::Init(Scene *_scene)
     gzerr << "Unable to advertise to the /marker service.\n";
   }
 
+  // Advertise to the marker array service
+  if (!this->dataPtr->node.Advertise("/marker_array",
+        &MarkerManagerPrivate::OnMarkerArray, this->dataPtr.get()))
+  {
+    gzerr << "Unable to advertise to the /marker_array service.\n";
+  }
+
   this->dataPtr->gznode = transport::NodePtr(new transport::Node());
   this->dataPtr->gznode->Init();
 
@@ -195,9 +262,147 @@ void MarkerManagerPrivate::OnPreRender()
     else
       ++mit;
   }
+
+  // Same for batched markers
+  std::vector<std::pair<std::string, uint64_t>> expired;
+  for (auto const &ns : this->batchedMarkers)
+  {
+    for (auto const &marker : ns.second)
+    {
+      if (marker.second.lifetime != common::Time::Zero &&
+          (marker.second.lifetime <= this->simTime ||
+          this->simTime < this->lastSimTime))
+      {
+        expired.push_back(std::make_pair(ns.first, marker.first));
+      }
+    }
+  }
+  for (auto const &marker : expired)
+    this->RemoveBatchedMarker(marker.first, marker.second);
+
+  // Write the changes of all batches
+  for (auto &batch : this->batches)
+    batch.second->Update();
+
   this->lastSimTime = this->simTime;
 }
 
+//////////////////////////////////////////////////
+bool MarkerManagerPrivate::BatchRequested(const ignition::msgs::Marker &_msg)
+{
+  for (auto const &data : _msg.header().data())
+  {
+    if (data.key() == "batch" && data.value_size() > 0)
+      return data.value(0) == "true" || data.value(0) == "1";
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool MarkerManagerPrivate::SetBatchedMarker(const std::string &_ns,
+    const uint64_t _id, const ignition::msgs::Marker &_msg)
+{
+  auto nsIter = this->batchedMarkers.find(_ns);
+  BatchedMarker *existing = nullptr;
+  if (nsIter != this->batchedMarkers.end())
+  {
+    auto markerIter = nsIter->second.find(_id);
+    if (markerIter != nsIter->second.end())
+      existing = &markerIter->second;
+  }
+
+  // Apply the changes to the current marker, in the same way that
+  // MarkerVisual does: fields that are set replace the current values.
+  ignition::msgs::Marker msg;
+  if (existing)
+  {
+    msg = existing->msg;
+    if (_msg.type() != ignition::msgs::Marker::NONE)
+      msg.set_type(_msg.type());
+    if (_msg.has_material())
+      msg.mutable_material()->CopyFrom(_msg.material());
+    if (_msg.has_scale())
+      msg.mutable_scale()->CopyFrom(_msg.scale());
+    if (_msg.has_pose())
+      msg.mutable_pose()->CopyFrom(_msg.pose());
+    if (_msg.point_size() > 0)
+      msg.mutable_point()->CopyFrom(_msg.point());
+    msg.set_layer(_msg.layer());
+  }
+  else
+  {
+    msg = _msg;
+    msg.clear_header();
+    msg.clear_lifetime();
+  }
+  msg.set_ns(_ns);
+  msg.set_id(_id);
+
+  if (!MarkerBatch::Batchable(msg))
+  {
+    gzerr << "Marker with id[" << _id << "] in namespace[" << _ns
+          << "] can't be batched. Only point, line and triangle markers "
+          << "without a parent can be batched." << std::endl;
+    return false;
+  }
+
+  common::Time lifetime = existing ? existing->lifetime : common::Time::Zero;
+  if (_msg.has_lifetime() &&
+      (_msg.lifetime().sec() > 0 ||
+      (_msg.lifetime().sec() == 0 && _msg.lifetime().nsec() > 0)))
+  {
+    lifetime = this->scene->SimTime() +
+      common::Time(_msg.lifetime().sec(), _msg.lifetime().nsec());
+  }
+
+  // Move the marker if it now belongs to another batch
+  const std::string key = MarkerBatch::Key(msg);
+  if (existing && existing->batch != key)
+    this->RemoveBatchedMarker(_ns, _id);
+
+  std::unique_ptr<MarkerBatch> &batch = this->batches[key];
+  if (!batch)
+  {
+    batch.reset(new MarkerBatch("__GZ_MARKER_BATCH_" + _ns + "_" +
+        std::to_string(this->batchCount++), this->scene->WorldVisual(), msg));
+  }
+  batch->Set(_id, msg);
+
+  BatchedMarker &marker = this->batchedMarkers[_ns][_id];
+  marker.msg = msg;
+  marker.lifetime = lifetime;
+  marker.batch = key;
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool MarkerManagerPrivate::RemoveBatchedMarker(const std::string &_ns,
+    const uint64_t _id)
+{
+  auto nsIter = this->batchedMarkers.find(_ns);
+  if (nsIter == this->batchedMarkers.end())
+    return false;
+
+  auto markerIter = nsIter->second.find(_id);
+  if (markerIter == nsIter->second.end())
+    return false;
+
+  auto batchIter = this->batches.find(markerIter->second.batch);
+  if (batchIter != this->batches.end())
+  {
+    batchIter->second->Remove(_id);
+    if (batchIter->second->MarkerCount() == 0)
+      this->batches.erase(batchIter);
+  }
+
+  nsIter->second.erase(markerIter);
+  if (nsIter->second.empty())
+    this->batchedMarkers.erase(nsIter);
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
 {
@@ -208,6 +413,7 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
 
   // Get the namespace that the marker belongs to
   Marker_M::iterator nsIter = this->markers.find(ns);
+  BatchedMarker_M::iterator batchedNsIter = this->batchedMarkers.find(ns);
 
   // If an id is given
   size_t id;
@@ -221,11 +427,13 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
     id = ignition::math::Rand::IntUniform(0, ignition::math::MAX_I32);
 
     // Make sure it's unique if namespace is given
-    if (nsIter != this->markers.end())
+    while ((nsIter != this->markers.end() &&
+            nsIter->second.find(id) != nsIter->second.end()) ||
+           (batchedNsIter != this->batchedMarkers.end() &&
+            batchedNsIter->second.find(id) != batchedNsIter->second.end()))
     {
-      while (nsIter->second.find(id) != nsIter->second.end())
-        id = ignition::math::Rand::IntUniform(ignition::math::MIN_UI32,
-                                              ignition::math::MAX_UI32);
+      id = ignition::math::Rand::IntUniform(ignition::math::MIN_UI32,
+                                            ignition::math::MAX_UI32);
     }
   }
 
@@ -234,11 +442,21 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
   if (nsIter != this->markers.end())
     markerIter = nsIter->second.find(id);
 
+  const bool hasVisual =
+      nsIter != this->markers.end() && markerIter != nsIter->second.end();
+  const bool hasBatched = batchedNsIter != this->batchedMarkers.end() &&
+      batchedNsIter->second.find(id) != batchedNsIter->second.end();
+
   // Add/modify a marker
   if (_msg.action() == ignition::msgs::Marker::ADD_MODIFY)
   {
+    // Batched markers stay batched. New markers are batched on request.
+    if (hasBatched || (!hasVisual && BatchRequested(_msg)))
+    {
+      return this->SetBatchedMarker(ns, id, _msg);
+    }
     // Modify an existing marker, identified by namespace and id
-    if (nsIter != this->markers.end() && markerIter != nsIter->second.end())
+    else if (hasVisual)
     {
       markerIter->second->Load(_msg);
     }
@@ -264,7 +482,11 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
   else if (_msg.action() == ignition::msgs::Marker::DELETE_MARKER)
   {
     // Remove the marker if it can be found.
-    if (nsIter != this->markers.end() && markerIter != nsIter->second.end())
+    if (hasBatched)
+    {
+      this->RemoveBatchedMarker(ns, id);
+    }
+    else if (hasVisual)
     {
       markerIter->second->Fini();
       this->scene->RemoveVisual(markerIter->second);
@@ -285,14 +507,34 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
   else if (_msg.action() == ignition::msgs::Marker::DELETE_ALL)
   {
     // If given namespace doesn't exist
-    if (!ns.empty() && nsIter == this->markers.end())
+    if (!ns.empty() && nsIter == this->markers.end() &&
+        batchedNsIter == this->batchedMarkers.end())
     {
       gzwarn << "Unable to delete all markers in namespace[" << ns <<
           "], namespace can't be found." << std::endl;
       return false;
     }
+
+    // An empty namespace that doesn't exist stands for all namespaces
+    const bool all = ns.empty() && nsIter == this->markers.end() &&
+        batchedNsIter == this->batchedMarkers.end();
+
+    // Remove the batches of the namespace, or all batches
+    for (auto batchIter = this->batches.begin();
+         batchIter != this->batches.end();)
+    {
+      if (all || batchIter->second->Namespace() == ns)
+        batchIter = this->batches.erase(batchIter);
+      else
+        ++batchIter;
+    }
+    if (all)
+      this->batchedMarkers.clear();
+    else if (batchedNsIter != this->batchedMarkers.end())
+      this->batchedMarkers.erase(batchedNsIter);
+
     // Remove all markers in the specified namespace
-    else if (nsIter != this->markers.end())
+    if (nsIter != this->markers.end())
     {
       for (auto it = nsIter->second.begin(); it != nsIter->second.end(); ++it)
       {
@@ -303,7 +545,7 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
       this->markers.erase(nsIter);
     }
     // Remove all markers in all namespaces.
-    else
+    else if (all)
     {
       for (nsIter = this->markers.begin();
            nsIter != this->markers.end(); ++nsIter)
@@ -333,6 +575,20 @@ void MarkerManagerPrivate::OnMarkerMsg(const ignition::msgs::Marker &_req)
   this->markerMsgs.push_back(_req);
 }
 
+/////////////////////////////////////////////////
+bool MarkerManagerPrivate::OnMarkerArray(const ignition::msgs::Marker_V &_req,
+    ignition::msgs::Boolean &_res)
+{
+  // Queue all messages under one lock, so that OnPreRender processes all
+  // of them or none of them
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (auto const &marker : _req.marker())
+    this->markerMsgs.push_back(marker);
+
+  _res.set_data(true);
+  return true;
+}
+
 /////////////////////////////////////////////////
 bool MarkerManagerPrivate::OnList(ignition::msgs::Marker_V &_rep)
 {
@@ -353,6 +609,17 @@ bool MarkerManagerPrivate::OnList(ignition::msgs::Marker_V &_rep)
     }
   }
 
+  for (auto const &ns : this->batchedMarkers)
+  {
+    for (auto const &marker : ns.second)
+    {
+      ignition::msgs::Marker *markerMsg = _rep.add_marker();
+      markerMsg->CopyFrom(marker.second.msg);
+      markerMsg->mutable_lifetime()->set_sec(marker.second.lifetime.sec);
+      markerMsg->mutable_lifetime()->set_nsec(marker.second.lifetime.nsec);
+    }
+  }
+
   return true;
 }
 
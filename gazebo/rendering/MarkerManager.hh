@@ -31,6 +31,13 @@ namespace gazebo
     /// \cond
     /// \brief Creates, deletes, and maintains marker visuals. Only the
     /// Scene class should instantiate and use this class.
+    ///
+    /// Markers are received on the /marker service, and lists of markers on
+    /// the /marker_array service. The markers of a list are applied in the
+    /// same frame. Point, line and triangle markers whose header has a
+    /// "batch" entry set to "true" are drawn by a MarkerBatch shared with
+    /// the other batched markers of the same namespace, layer and material,
+    /// instead of a visual of their own.
     class MarkerManager
     {
       /// \brief Constructor
@@ -329,6 +329,12 @@ void MarkerVisual::Fini()
   Visual::Fini();
 }
 
+/////////////////////////////////////////////////
+DynamicLines *MarkerVisual::Lines() const
+{
+  return this->dPtr->dynamicRenderable.get();
+}
+
 /////////////////////////////////////////////////
 void MarkerVisual::FillMsg(ignition::msgs::Marker &_msg)
 {
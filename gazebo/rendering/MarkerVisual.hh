@@ -57,6 +57,10 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Fini();
 
+      /// \brief Get the renderable of point, line and triangle markers.
+      /// \return The renderable, null for other marker types.
+      public: DynamicLines *Lines() const;
+
       /// \brief Populate a marker message.
       /// \param[in] _msg The message to populate.
       public: void FillMsg(ignition::msgs::Marker &_msg);
@@ -18,6 +18,11 @@
 #include <sys/stat.h>
 #include <boost/filesystem.hpp>
 
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
 #include <ignition/common/Profiler.hh>
 
 #if defined(HAVE_OPENGL)
@@ -52,6 +57,95 @@
 using namespace gazebo;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Get a key that identifies the programs produced with the current
+/// Ogre version, render system and driver.
+/// \return Hex string of the key hash.
+static std::string ShaderCacheKey()
+{
+  std::ostringstream stream;
+  stream << OGRE_VERSION << "/glsl";
+
+  Ogre::RenderSystem *renderSystem =
+      Ogre::Root::getSingleton().getRenderSystem();
+  if (renderSystem)
+  {
+    stream << "/" << renderSystem->getName();
+    const Ogre::RenderSystemCapabilities *capabilities =
+        renderSystem->getCapabilities();
+    if (capabilities)
+    {
+      stream << "/" << capabilities->getDeviceName()
+             << "/" << capabilities->getDriverVersion().toString();
+    }
+  }
+
+  std::ostringstream key;
+  key << std::hex << std::hash<std::string>()(stream.str());
+  return key.str();
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the signature of the render state generated for a material.
+/// It covers the options of the visual and the pass properties that change
+/// the generated programs, but not colours, which are shader parameters.
+/// \param[in] _material The material.
+/// \param[in] _shaderType Shader type of the visual.
+/// \param[in] _normalMap Normal map of the visual.
+/// \return The signature.
+static std::string RenderStateSignature(const Ogre::MaterialPtr &_material,
+    const std::string &_shaderType, const std::string &_normalMap)
+{
+  std::ostringstream stream;
+  stream << _shaderType << "|" << _normalMap;
+
+  if (_material.isNull() || _material->getNumTechniques() == 0)
+    return stream.str();
+
+  Ogre::Technique *technique = _material->getTechnique(0);
+  for (unsigned int p = 0; p < technique->getNumPasses(); ++p)
+  {
+    Ogre::Pass *pass = technique->getPass(p);
+    stream << "|" << pass->getLightingEnabled()
+           << "," << pass->getVertexColourTracking()
+           << "," << pass->getShadingMode()
+           << "," << pass->getFogOverride()
+           << "," << pass->getFogMode();
+
+    for (unsigned int t = 0; t < pass->getNumTextureUnitStates(); ++t)
+    {
+      Ogre::TextureUnitState *unit = pass->getTextureUnitState(t);
+      stream << ";" << unit->getTextureName()
+             << "," << unit->getTextureType()
+             << "," << unit->getContentType()
+             << "," << unit->getTextureCoordSet()
+             << "," << unit->getColourBlendMode().operation
+             << "," << unit->getNumEffects();
+    }
+  }
+
+  return stream.str();
+}
+
+//////////////////////////////////////////////////
+/// \brief Check if a material has a technique in a scheme.
+/// \param[in] _material The material.
+/// \param[in] _scheme Name of the scheme.
+/// \return True if the material has a technique in the scheme.
+static bool HasSchemeTechnique(const Ogre::MaterialPtr &_material,
+    const std::string &_scheme)
+{
+  if (_material.isNull())
+    return false;
+
+  for (unsigned int i = 0; i < _material->getNumTechniques(); ++i)
+  {
+    if (_material->getTechnique(i)->getSchemeName() == _scheme)
+      return true;
+  }
+  return false;
+}
+
 //////////////////////////////////////////////////
 RTShaderSystem::RTShaderSystem()
   : dataPtr(new RTShaderSystemPrivate)
@@ -97,9 +191,52 @@ void RTShaderSystem::Init()
     Ogre::ResourceGroupManager::getSingleton().addResourceLocation(
         coreLibsPath, "FileSystem");
 
-    // Set shader cache path.
+    // Set shader cache path. Programs of other Ogre versions, render
+    // systems and drivers are kept in other directories, so that the
+    // generated programs found in the cache always match this setup.
+    if (!cachePath.empty())
+    {
+      cachePath += ShaderCacheKey() + "/";
+      boost::system::error_code ec;
+      boost::filesystem::create_directories(cachePath, ec);
+      if (ec)
+      {
+        gzwarn << "Unable to create shader cache directory [" << cachePath
+               << "]: " << ec.message() << std::endl;
+      }
+    }
     this->dataPtr->shaderGenerator->setShaderCachePath(cachePath);
 
+#if OGRE_VERSION_MAJOR >= 1 && OGRE_VERSION_MINOR >= 8
+    // Keep the compiled programs as well, so that programs generated in
+    // previous runs don't need to be compiled again.
+    Ogre::GpuProgramManager &programManager =
+        Ogre::GpuProgramManager::getSingleton();
+    if (!cachePath.empty() && programManager.canGetCompiledShaderBuffer())
+    {
+      this->dataPtr->microcodeCacheFile = cachePath + "microcode.cache";
+      programManager.setSaveMicrocodesToCache(true);
+
+      std::fstream file(this->dataPtr->microcodeCacheFile,
+          std::ios::in | std::ios::binary);
+      if (file.is_open())
+      {
+        try
+        {
+          Ogre::DataStreamPtr stream(
+              OGRE_NEW Ogre::FileStreamDataStream(&file, false));
+          programManager.loadMicrocodeCache(stream);
+        }
+        catch(Ogre::Exception &e)
+        {
+          gzwarn << "Unable to load shader cache ["
+                 << this->dataPtr->microcodeCacheFile << "]: "
+                 << e.getDescription() << std::endl;
+        }
+      }
+    }
+#endif
+
 #if OGRE_VERSION_MAJOR >= 1 && OGRE_VERSION_MINOR <= 8
     this->dataPtr->programWriterFactory =
         OGRE_NEW CustomGLSLProgramWriterFactory();
@@ -137,6 +274,35 @@ void RTShaderSystem::Fini()
   if (!this->dataPtr->initialized)
     return;
 
+#if OGRE_VERSION_MAJOR >= 1 && OGRE_VERSION_MINOR >= 8
+  // Save the programs compiled in this run for the next one.
+  Ogre::GpuProgramManager *programManager =
+      Ogre::GpuProgramManager::getSingletonPtr();
+  if (!this->dataPtr->microcodeCacheFile.empty() && programManager &&
+      programManager->isCacheDirty())
+  {
+    std::fstream file(this->dataPtr->microcodeCacheFile,
+        std::ios::out | std::ios::binary | std::ios::trunc);
+    if (file.is_open())
+    {
+      try
+      {
+        Ogre::DataStreamPtr stream(
+            OGRE_NEW Ogre::FileStreamDataStream(&file, false));
+        programManager->saveMicrocodeCache(stream);
+      }
+      catch(Ogre::Exception &e)
+      {
+        gzwarn << "Unable to save shader cache ["
+               << this->dataPtr->microcodeCacheFile << "]: "
+               << e.getDescription() << std::endl;
+      }
+    }
+  }
+#endif
+  this->dataPtr->microcodeCacheFile.clear();
+  this->dataPtr->materialSignatures.clear();
+
   // Restore default scheme.
   Ogre::MaterialManager::getSingleton().setActiveScheme(
       Ogre::MaterialManager::DEFAULT_SCHEME_NAME);
@@ -202,6 +368,7 @@ void RTShaderSystem::RemoveScene(ScenePtr _scene)
         _scene->OgreSceneManager());
     this->dataPtr->shaderGenerator->removeAllShaderBasedTechniques();
     this->dataPtr->shaderGenerator->flushShaderCache();
+    this->dataPtr->materialSignatures.clear();
   }
 }
 
@@ -308,6 +475,25 @@ void RTShaderSystem::GenerateShaders(const VisualPtr &_vis)
           Ogre::MaterialPtr curMaterial =
             Ogre::MaterialManager::getSingleton().getByName(curMaterialName);
 
+          // Keep the generated shaders if the render state of the material
+          // would be the same. The technique check catches materials that
+          // were recreated with the same name.
+          const std::string schemeName = this->dataPtr->scenes[s]->Name() +
+              Ogre::RTShader::ShaderGenerator::DEFAULT_SCHEME_NAME;
+          const std::string signature = RenderStateSignature(curMaterial,
+              _vis->GetShaderType(), _vis->GetNormalMap());
+          std::string &lastSignature =
+              this->dataPtr->materialSignatures[schemeName + "::" +
+              curMaterialName];
+          if (lastSignature == signature &&
+              HasSchemeTechnique(curMaterial, schemeName))
+          {
+            this->dataPtr->reusedMaterials++;
+            continue;
+          }
+          lastSignature = signature;
+          this->dataPtr->generatedMaterials++;
+
           // Grab the first pass render state.
           // NOTE:For more complicated samples iterate over the passes and build
           // each one of them as desired.
@@ -625,6 +811,7 @@ void RTShaderSystem::Update()
 
   if (updateShaders)
   {
+    auto start = std::chrono::steady_clock::now();
     for (const auto &scene : this->dataPtr->scenes)
     {
       VisualPtr vis = scene->WorldVisual();
@@ -633,6 +820,21 @@ void RTShaderSystem::Update()
         this->UpdateShaders(vis);
       }
     }
+    const double elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    // The first update generates the shaders of the whole initial scene,
+    // which dominates the time to the first frame.
+    if (this->dataPtr->firstUpdate)
+    {
+      gzlog << "RTShader first update: "
+            << this->dataPtr->generatedMaterials << " materials generated, "
+            << this->dataPtr->reusedMaterials << " reused, "
+            << elapsed << " ms" << std::endl;
+      this->dataPtr->firstUpdate = false;
+    }
+    this->dataPtr->generatedMaterials = 0;
+    this->dataPtr->reusedMaterials = 0;
   }
 }
 
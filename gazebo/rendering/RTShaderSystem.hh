@@ -110,7 +110,9 @@ namespace gazebo
       /// \param[in] _set True means to use per-pixel shaders.
       public: void SetPerPixelLighting(bool _set);
 
-      /// \brief Generate shaders for an entity
+      /// \brief Generate shaders for an entity. Materials whose render
+      /// state is unchanged since the last call keep their shaders.
+      /// Generated and compiled programs are cached on disk between runs.
       /// \param[in] _vis The visual to generate shaders for.
       public: void GenerateShaders(const VisualPtr &_vis);
 
@@ -18,6 +18,7 @@
 #ifndef _GAZEBO_RTSHADERSYSTEM_PRIVATE_HH_
 #define _GAZEBO_RTSHADERSYSTEM_PRIVATE_HH_
 
+#include <map>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -86,6 +87,26 @@ namespace gazebo
 
       /// \brief Mutex to protect shaders and shadows update
       public: std::mutex updateMutex;
+
+      /// \brief Signature of the render state last generated for each
+      /// material, keyed by scheme name and material name. Materials whose
+      /// signature didn't change keep their generated shaders.
+      public: std::map<std::string, std::string> materialSignatures;
+
+      /// \brief File that holds the compiled shader programs between runs.
+      /// Empty if the render system can't save compiled programs.
+      public: std::string microcodeCacheFile;
+
+      /// \brief Number of materials whose shaders were generated since the
+      /// last report.
+      public: unsigned int generatedMaterials = 0;
+
+      /// \brief Number of materials whose shaders were reused since the
+      /// last report.
+      public: unsigned int reusedMaterials = 0;
+
+      /// \brief True until the first shader update has been reported.
+      public: bool firstUpdate = true;
     };
   }
 }
@@ -16,6 +16,7 @@
 */
 
 #include <functional>
+#include <vector>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
@@ -183,6 +184,8 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
       this->dataPtr->node->Subscribe("~/sky", &Scene::OnSkyMsg, this);
   this->dataPtr->modelInfoSub = this->dataPtr->node->Subscribe("~/model/info",
                                              &Scene::OnModelMsg, this);
+  this->dataPtr->modelInfoBatchSub = this->dataPtr->node->Subscribe(
+      "~/model/info/batch", &Scene::OnModelBatchMsg, this);
 
   this->dataPtr->roadSub =
       this->dataPtr->node->Subscribe("~/roads", &Scene::OnRoadMsg, this, true);
@@ -227,6 +230,7 @@ void Scene::Clear()
   this->dataPtr->requestSub.reset();
   this->dataPtr->responseSub.reset();
   this->dataPtr->modelInfoSub.reset();
+  this->dataPtr->modelInfoBatchSub.reset();
   this->dataPtr->responsePub.reset();
   this->dataPtr->requestPub.reset();
   this->dataPtr->roadSub.reset();
@@ -275,6 +279,9 @@ void Scene::Clear()
     this->dataPtr->worldVisual.reset();
   }
 
+  // Visuals stop batching their entities when they're removed
+  this->dataPtr->staticBatcher.reset();
+
   while (!this->dataPtr->lights.empty())
     if (this->dataPtr->lights.begin()->second)
       this->RemoveLight(this->dataPtr->lights.begin()->second);
@@ -336,6 +343,7 @@ void Scene::Load()
   this->dataPtr->initialized = false;
   Ogre::Root *root = RenderEngine::Instance()->Root();
 
+  this->dataPtr->staticBatcher.reset();
   if (this->dataPtr->manager)
     root->destroySceneManager(this->dataPtr->manager);
 
@@ -343,6 +351,9 @@ void Scene::Load()
   this->dataPtr->manager->setAmbientLight(
       Ogre::ColourValue(0.1, 0.1, 0.1, 0.1));
 
+  this->dataPtr->staticBatcher.reset(
+      new StaticBatcher(this->dataPtr->manager));
+
 #if OGRE_VERSION_MAJOR > 1 || OGRE_VERSION_MINOR >= 9
   this->dataPtr->manager->addRenderQueueListener(
       RenderEngine::Instance()->OverlaySystem());
@@ -2154,6 +2165,7 @@ void Scene::PreRender()
         Road2dPtr road(new Road2d(msg->name(), this->dataPtr->worldVisual));
         road->Load(*msg);
         this->dataPtr->visuals[road->GetId()] = road;
+        this->AddStaticBatching(road);
       }
     }
 
@@ -2161,6 +2173,14 @@ void Scene::PreRender()
     this->dataPtr->sceneSimTimePosesApplied =
         this->dataPtr->sceneSimTimePosesReceived;
   }
+
+  // Batch the static visuals once their poses are applied
+  if (this->dataPtr->staticBatcher)
+  {
+    this->dataPtr->staticBatcher->SetActive(
+        this->dataPtr->staticBatchingEnabled);
+    this->dataPtr->staticBatcher->Update();
+  }
 }
 
 /////////////////////////////////////////////////
@@ -2854,6 +2874,9 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
     visual->SetTransparency(this->dataPtr->transparent ? 0.5 : 0.0);
   visual->SetWireframe(this->dataPtr->wireframe);
 
+  if (_type == Visual::VT_VISUAL && _msg->is_static())
+    this->AddStaticBatching(visual);
+
   return true;
 }
 
@@ -3014,6 +3037,17 @@ void Scene::OnModelMsg(ConstModelPtr &_msg)
   this->dataPtr->modelMsgs.push_back(_msg);
 }
 
+/////////////////////////////////////////////////
+void Scene::OnModelBatchMsg(ConstModel_VPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+  for (auto const &model : _msg->models())
+  {
+    this->dataPtr->modelMsgs.push_back(
+        boost::make_shared<const msgs::Model>(model));
+  }
+}
+
 /////////////////////////////////////////////////
 void Scene::OnSkyMsg(ConstSkyPtr &_msg)
 {
@@ -3285,6 +3319,61 @@ unsigned int Scene::ShadowTextureSize() const
     return this->dataPtr->shadowTextureSize;
 }
 
+/////////////////////////////////////////////////
+void Scene::SetStaticBatchingEnabled(const bool _enabled)
+{
+  this->dataPtr->staticBatchingEnabled = _enabled;
+}
+
+/////////////////////////////////////////////////
+bool Scene::StaticBatchingEnabled() const
+{
+  return this->dataPtr->staticBatchingEnabled;
+}
+
+/////////////////////////////////////////////////
+unsigned int Scene::StaticBatchedVisualCount() const
+{
+  if (!this->dataPtr->staticBatcher)
+    return 0;
+  return this->dataPtr->staticBatcher->BatchedCount();
+}
+
+/////////////////////////////////////////////////
+void Scene::AddStaticBatching(VisualPtr _visual)
+{
+  // Visuals are added even while batching is disabled, so that it can be
+  // enabled later
+  if (!this->dataPtr->staticBatcher)
+    return;
+
+  Ogre::SceneNode *node = _visual->GetSceneNode();
+  for (unsigned int i = 0; i < node->numAttachedObjects(); ++i)
+  {
+    Ogre::Entity *entity =
+        dynamic_cast<Ogre::Entity *>(node->getAttachedObject(i));
+    if (entity)
+      this->dataPtr->staticBatcher->Add(entity);
+  }
+}
+
+/////////////////////////////////////////////////
+void Scene::UpdateBatching(Ogre::Entity *_entity)
+{
+  if (this->dataPtr->staticBatcher &&
+      this->dataPtr->staticBatcher->Has(_entity))
+  {
+    this->dataPtr->staticBatcher->Set(_entity);
+  }
+}
+
+/////////////////////////////////////////////////
+void Scene::RemoveBatching(Ogre::Entity *_entity)
+{
+  if (this->dataPtr->staticBatcher)
+    this->dataPtr->staticBatcher->Remove(_entity);
+}
+
 /////////////////////////////////////////////////
 void Scene::AddVisual(VisualPtr _vis)
 {
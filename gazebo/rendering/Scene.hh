@@ -605,6 +605,41 @@ namespace gazebo
       /// \sa EnableVisualizations(bool)
       public: bool EnableVisualizations() const;
 
+      /// \brief Enable or disable static batching. Visuals of static models
+      /// are merged into region partitioned static geometry, rebuilt when a
+      /// static visual is added, removed, changed or moved. Batched visuals
+      /// can't be selected with the mouse. Static batching is disabled by
+      /// default.
+      /// \param[in] _enabled True to enable static batching.
+      /// \sa StaticBatchingEnabled()
+      public: void SetStaticBatchingEnabled(const bool _enabled);
+
+      /// \brief Check whether static batching is enabled.
+      /// \return True if enabled.
+      /// \sa SetStaticBatchingEnabled(bool)
+      public: bool StaticBatchingEnabled() const;
+
+      /// \brief Get the number of visual entities drawn by static batches.
+      /// \return Number of batched entities.
+      public: unsigned int StaticBatchedVisualCount() const;
+
+      /// \internal
+      /// \brief Tell that the material, visibility or visibility flags of
+      /// an entity of a visual changed, so that its static batch is rebuilt.
+      /// Called by visuals.
+      /// \param[in] _entity The entity.
+      public: void UpdateBatching(Ogre::Entity *_entity);
+
+      /// \internal
+      /// \brief Stop batching an entity of a visual. Called
+      /// by visuals before the entity is detached or destroyed.
+      /// \param[in] _entity The entity.
+      public: void RemoveBatching(Ogre::Entity *_entity);
+
+      /// \brief Add the entities of a static visual to the static batches.
+      /// \param[in] _visual The visual.
+      private: void AddStaticBatching(VisualPtr _visual);
+
       /// \brief Helper function to setup the sky.
       private: void SetSky();
 
@@ -726,6 +761,10 @@ namespace gazebo
       /// \param[in] _msg The message data.
       private: void OnModelMsg(ConstModelPtr &_msg);
 
+      /// \brief Model batch message callback.
+      /// \param[in] _msg The message data.
+      private: void OnModelBatchMsg(ConstModel_VPtr &_msg);
+
       /// \brief Pose message callback.
       /// \param[in] _msg The message data.
       private: void OnPoseMsg(ConstPosesStampedPtr &_msg);
@@ -19,6 +19,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -33,6 +34,7 @@
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/rendering/MarkerManager.hh"
 #include "gazebo/rendering/RenderTypes.hh"
+#include "gazebo/rendering/StaticBatcher.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 namespace SkyX
@@ -271,6 +273,9 @@ namespace gazebo
       /// \brief Subscribe to model info updates
       public: transport::SubscriberPtr modelInfoSub;
 
+      /// \brief Subscribe to batches of model info updates
+      public: transport::SubscriberPtr modelInfoBatchSub;
+
       /// \brief Respond to requests.
       public: transport::PublisherPtr responsePub;
 
@@ -373,6 +378,12 @@ namespace gazebo
       /// \brief Manager of marker visuals
       public: MarkerManager markerManager;
 
+      /// \brief Merges the visuals of static models into static geometry.
+      public: std::unique_ptr<StaticBatcher> staticBatcher;
+
+      /// \brief True if static batching is enabled.
+      public: bool staticBatchingEnabled = false;
+
       /// \brief State of each layer where key is the layer id, and value is
       /// the layer's visibility.
       public: std::map<int32_t, bool> layerState;
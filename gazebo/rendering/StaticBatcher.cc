@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <map>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/rendering/ogre_gazebo.h"
+#include "gazebo/rendering/StaticBatcher.hh"
+
+using namespace gazebo;
+using namespace rendering;
+
+/// \brief Number of updates a group must stay unchanged before it's
+/// rebuilt, so that a world being loaded is built once.
+static const unsigned int settleUpdates = 10;
+
+/// \brief Size of the regions of the static geometries, in meters. Regions
+/// are culled as a whole, and merge the entities that share a material.
+static const Ogre::Real regionSize = 50;
+
+/// \brief Private data for the StaticBatcher class
+class gazebo::rendering::StaticBatcherPrivate
+{
+  /// \brief An added entity.
+  public: class Member
+  {
+    /// \brief Visibility flags the entity is shown with.
+    public: uint32_t visibilityFlags = 0;
+
+    /// \brief Key of the group of the entity.
+    public: std::string key;
+
+    /// \brief True if the group of the entity was built since the entity
+    /// last changed.
+    public: bool built = false;
+
+    /// \brief True if the entity is drawn by the static geometry.
+    public: bool batched = false;
+
+    /// \brief Visibility of the entity when its group was built.
+    public: bool visible = true;
+
+    /// \brief Derived position of the scene node when its group was built.
+    public: Ogre::Vector3 position = Ogre::Vector3::ZERO;
+
+    /// \brief Derived orientation of the scene node when its group was
+    /// built.
+    public: Ogre::Quaternion orientation = Ogre::Quaternion::IDENTITY;
+
+    /// \brief Derived scale of the scene node when its group was built.
+    public: Ogre::Vector3 scale = Ogre::Vector3::UNIT_SCALE;
+  };
+
+  /// \brief Entities drawn by one static geometry.
+  public: class Group
+  {
+    /// \brief The static geometry, null until the group is first built.
+    public: Ogre::StaticGeometry *geometry = nullptr;
+
+    /// \brief Entities of the group.
+    public: std::set<Ogre::Entity *> entities;
+
+    /// \brief True if the group changed since it was built.
+    public: bool dirty = true;
+
+    /// \brief Number of updates since the group last changed.
+    public: unsigned int settled = 0;
+  };
+
+  /// \brief Scene manager of the entities.
+  public: Ogre::SceneManager *manager = nullptr;
+
+  /// \brief True if entities are batched.
+  public: bool active = false;
+
+  /// \brief Added entities.
+  public: std::unordered_map<Ogre::Entity *, Member> members;
+
+  /// \brief Groups, by key.
+  public: std::map<std::string, Group> groups;
+
+  /// \brief Number of static geometries created, used to name them.
+  public: unsigned int geometryCount = 0;
+
+  /// \brief Number of batched entities.
+  public: size_t batchedCount = 0;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get a string that describes a material without its name, so
+/// that identical materials cloned for each visual can be told apart from
+/// different ones.
+/// \param[in] _name Name of the material.
+/// \return The description.
+static std::string MaterialSignature(const std::string &_name)
+{
+  Ogre::MaterialPtr material =
+      Ogre::MaterialManager::getSingleton().getByName(_name);
+  if (material.isNull())
+    return _name;
+
+  Ogre::MaterialSerializer serializer;
+  serializer.queueForExport(material, true, false);
+  const std::string script = serializer.getQueuedAsString();
+
+  // Skip the "material <name>" line
+  const size_t start = script.find('\n');
+  return start == std::string::npos ? script : script.substr(start);
+}
+
+//////////////////////////////////////////////////
+StaticBatcher::StaticBatcher(Ogre::SceneManager *_manager)
+  : dataPtr(new StaticBatcherPrivate)
+{
+  this->dataPtr->manager = _manager;
+}
+
+//////////////////////////////////////////////////
+StaticBatcher::~StaticBatcher()
+{
+  for (auto &group : this->dataPtr->groups)
+  {
+    this->Invalidate(group.first);
+    if (group.second.geometry)
+      this->dataPtr->manager->destroyStaticGeometry(group.second.geometry);
+  }
+  this->dataPtr->groups.clear();
+  this->dataPtr->members.clear();
+}
+
+//////////////////////////////////////////////////
+void StaticBatcher::SetActive(const bool _active)
+{
+  if (this->dataPtr->active == _active)
+    return;
+
+  this->dataPtr->active = _active;
+  for (auto const &group : this->dataPtr->groups)
+    this->Invalidate(group.first);
+}
+
+//////////////////////////////////////////////////
+void StaticBatcher::Add(Ogre::Entity *_entity)
+{
+  // Static geometry can't animate skeletons
+  if (!_entity || _entity->hasSkeleton() || this->Has(_entity))
+    return;
+
+  StaticBatcherPrivate::Member &member = this->dataPtr->members[_entity];
+  member.visibilityFlags = _entity->getVisibilityFlags();
+  member.key = Key(_entity, member.visibilityFlags);
+
+  this->dataPtr->groups[member.key].entities.insert(_entity);
+  this->Invalidate(member.key);
+}
+
+//////////////////////////////////////////////////
+bool StaticBatcher::Has(Ogre::Entity *_entity) const
+{
+  return this->dataPtr->members.find(_entity) !=
+      this->dataPtr->members.end();
+}
+
+//////////////////////////////////////////////////
+void StaticBatcher::Set(Ogre::Entity *_entity)
+{
+  auto iter = this->dataPtr->members.find(_entity);
+  if (iter == this->dataPtr->members.end())
+    return;
+
+  // The visual sets the flags of all the attached objects, so flags other
+  // than the empty ones of a batched entity are the ones it should have.
+  StaticBatcherPrivate::Member &member = iter->second;
+  if (!member.batched || _entity->getVisibilityFlags() != 0)
+    member.visibilityFlags = _entity->getVisibilityFlags();
+
+  this->Invalidate(member.key);
+
+  const std::string key = Key(_entity, member.visibilityFlags);
+  if (key != member.key)
+  {
+    this->dataPtr->groups[member.key].entities.erase(_entity);
+    member.key = key;
+    this->dataPtr->groups[member.key].entities.insert(_entity);
+    this->Invalidate(member.key);
+  }
+}
+
+//////////////////////////////////////////////////
+void StaticBatcher::Remove(Ogre::Entity *_entity)
+{
+  auto iter = this->dataPtr->members.find(_entity);
+  if (iter == this->dataPtr->members.end())
+    return;
+
+  // The geometry may use the material of the entity
+  const std::string key = iter->second.key;
+  this->Invalidate(key);
+  this->dataPtr->groups[key].entities.erase(_entity);
+  this->dataPtr->members.erase(iter);
+}
+
+//////////////////////////////////////////////////
+void StaticBatcher::Update()
+{
+  IGN_PROFILE("rendering::StaticBatcher::Update");
+
+  if (!this->dataPtr->active)
+    return;
+
+  // Static models can still be moved or hidden
+  for (auto const &iter : this->dataPtr->members)
+  {
+    const StaticBatcherPrivate::Member &member = iter.second;
+    Ogre::SceneNode *node = iter.first->getParentSceneNode();
+    if (!member.built || !node)
+      continue;
+
+    if (node->_getDerivedPosition() != member.position ||
+        node->_getDerivedOrientation() != member.orientation ||
+        node->_getDerivedScale() != member.scale ||
+        iter.first->getVisible() != member.visible)
+    {
+      this->Invalidate(member.key);
+    }
+  }
+
+  for (auto iter = this->dataPtr->groups.begin();
+       iter != this->dataPtr->groups.end();)
+  {
+    StaticBatcherPrivate::Group &group = iter->second;
+    if (group.entities.empty())
+    {
+      if (group.geometry)
+        this->dataPtr->manager->destroyStaticGeometry(group.geometry);
+      iter = this->dataPtr->groups.erase(iter);
+      continue;
+    }
+
+    if (group.dirty && ++group.settled >= settleUpdates)
+      this->Build(iter->first);
+    ++iter;
+  }
+}
+
+//////////////////////////////////////////////////
+size_t StaticBatcher::BatchedCount() const
+{
+  return this->dataPtr->batchedCount;
+}
+
+//////////////////////////////////////////////////
+std::string StaticBatcher::Key(Ogre::Entity *_entity,
+    const uint32_t _visibilityFlags)
+{
+  std::ostringstream stream;
+  stream << _visibilityFlags << " " << _entity->getCastShadows() << " "
+         << static_cast<int>(_entity->getRenderQueueGroup());
+  return stream.str();
+}
+
+//////////////////////////////////////////////////
+void StaticBatcher::Invalidate(const std::string &_key)
+{
+  StaticBatcherPrivate::Group &group = this->dataPtr->groups[_key];
+  group.dirty = true;
+  group.settled = 0;
+
+  if (group.geometry)
+    group.geometry->reset();
+
+  for (auto entity : group.entities)
+  {
+    StaticBatcherPrivate::Member &member = this->dataPtr->members[entity];
+    member.built = false;
+    if (!member.batched)
+      continue;
+
+    entity->setVisibilityFlags(member.visibilityFlags);
+    member.batched = false;
+    --this->dataPtr->batchedCount;
+  }
+}
+
+//////////////////////////////////////////////////
+void StaticBatcher::Build(const std::string &_key)
+{
+  StaticBatcherPrivate::Group &group = this->dataPtr->groups[_key];
+  group.dirty = false;
+
+  if (!group.geometry)
+  {
+    group.geometry = this->dataPtr->manager->createStaticGeometry(
+        "__GAZEBO_STATIC_BATCH__" +
+        std::to_string(this->dataPtr->geometryCount++));
+    group.geometry->setRegionDimensions(
+        Ogre::Vector3(regionSize, regionSize, regionSize));
+  }
+  group.geometry->reset();
+
+  Ogre::Entity *first = *group.entities.begin();
+  group.geometry->setVisibilityFlags(
+      this->dataPtr->members[first].visibilityFlags);
+  group.geometry->setCastShadows(first->getCastShadows());
+  group.geometry->setRenderQueueGroup(first->getRenderQueueGroup());
+
+  // Visuals clone their materials, so identical sub entities are given the
+  // same material while they're added, to be merged by the regions.
+  std::map<std::string, std::string> signatures;
+  std::map<std::string, std::string> sharedMaterials;
+
+  std::vector<Ogre::Entity *> batched;
+  for (auto entity : group.entities)
+  {
+    StaticBatcherPrivate::Member &member = this->dataPtr->members[entity];
+    Ogre::SceneNode *node = entity->getParentSceneNode();
+    if (!node)
+      continue;
+
+    member.built = true;
+    member.visible = entity->getVisible();
+    member.position = node->_getDerivedPosition();
+    member.orientation = node->_getDerivedOrientation();
+    member.scale = node->_getDerivedScale();
+    if (!member.visible)
+      continue;
+
+    std::vector<std::string> materials;
+    for (unsigned int i = 0; i < entity->getNumSubEntities(); ++i)
+    {
+      Ogre::SubEntity *subEntity = entity->getSubEntity(i);
+      const std::string material = subEntity->getMaterialName();
+      materials.push_back(material);
+
+      auto signature = signatures.find(material);
+      if (signature == signatures.end())
+      {
+        signature = signatures.insert(
+            std::make_pair(material, MaterialSignature(material))).first;
+      }
+      const std::string &shared = sharedMaterials.insert(
+          std::make_pair(signature->second, material)).first->second;
+      if (shared != material)
+        subEntity->setMaterialName(shared);
+    }
+
+    try
+    {
+      group.geometry->addEntity(entity, member.position, member.orientation,
+          member.scale);
+      batched.push_back(entity);
+    }
+    catch(Ogre::Exception &e)
+    {
+      gzwarn << "Unable to batch entity[" << entity->getName() << "]: "
+             << e.getDescription() << std::endl;
+    }
+
+    for (unsigned int i = 0; i < entity->getNumSubEntities(); ++i)
+    {
+      Ogre::SubEntity *subEntity = entity->getSubEntity(i);
+      if (subEntity->getMaterialName() != materials[i])
+        subEntity->setMaterialName(materials[i]);
+    }
+  }
+
+  try
+  {
+    group.geometry->build();
+  }
+  catch(Ogre::Exception &e)
+  {
+    gzwarn << "Unable to build static geometry: " << e.getDescription()
+           << std::endl;
+    group.geometry->reset();
+    return;
+  }
+
+  for (auto entity : batched)
+  {
+    entity->setVisibilityFlags(0);
+    this->dataPtr->members[entity].batched = true;
+    ++this->dataPtr->batchedCount;
+  }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_RENDERING_STATICBATCHER_HH_
+#define GAZEBO_RENDERING_STATICBATCHER_HH_
+
+#include <memory>
+#include <string>
+
+#include <OGRE/OgrePrerequisites.h>
+
+namespace gazebo
+{
+  namespace rendering
+  {
+    // Forward declare private data class.
+    class StaticBatcherPrivate;
+
+    /// \cond
+    /// \brief Merges the entities of static models into region partitioned
+    /// Ogre::StaticGeometry batches.
+    ///
+    /// Entities are grouped by visibility flags, shadow casting and render
+    /// queue, and each group is drawn by one static geometry whose regions
+    /// merge the entities that share a material. The entities themselves
+    /// are hidden with empty visibility flags. A group is rebuilt once it
+    /// stopped changing for a few updates after an entity was added,
+    /// removed, changed or moved; until then its entities draw themselves.
+    /// The Scene class should instantiate instances of this class.
+    /// \sa Scene::SetStaticBatchingEnabled
+    class StaticBatcher
+    {
+      /// \brief Constructor.
+      /// \param[in] _manager Scene manager of the entities.
+      public: explicit StaticBatcher(Ogre::SceneManager *_manager);
+
+      /// \brief Destructor. Shows the batched entities.
+      public: virtual ~StaticBatcher();
+
+      /// \brief Activate or deactivate batching. Entities are shown on the
+      /// next update after deactivation.
+      /// \param[in] _active True to batch entities.
+      public: void SetActive(const bool _active);
+
+      /// \brief Add the entity of a static visual.
+      /// \param[in] _entity The entity.
+      public: void Add(Ogre::Entity *_entity);
+
+      /// \brief Check if an entity was added.
+      /// \param[in] _entity The entity.
+      /// \return True if the entity was added and not removed.
+      public: bool Has(Ogre::Entity *_entity) const;
+
+      /// \brief Tell that the material, visibility flags or shadows of an
+      /// entity changed.
+      /// \param[in] _entity The entity.
+      public: void Set(Ogre::Entity *_entity);
+
+      /// \brief Remove an entity. Must be called before the entity is
+      /// detached or destroyed.
+      /// \param[in] _entity The entity.
+      public: void Remove(Ogre::Entity *_entity);
+
+      /// \brief Detect moved entities and rebuild the groups that settled.
+      /// Called once per frame, after the poses are applied.
+      public: void Update();
+
+      /// \brief Get the number of entities drawn by batches.
+      /// \return Number of batched entities.
+      public: size_t BatchedCount() const;
+
+      /// \brief Get the key of the group of an entity.
+      /// \param[in] _entity The entity.
+      /// \param[in] _visibilityFlags Visibility flags of the entity.
+      /// \return The key.
+      private: static std::string Key(Ogre::Entity *_entity,
+                   const uint32_t _visibilityFlags);
+
+      /// \brief Mark the group of an entity for rebuild, and show its
+      /// entities until then.
+      /// \param[in] _key Key of the group.
+      private: void Invalidate(const std::string &_key);
+
+      /// \brief Build the static geometry of a group, and hide its
+      /// entities.
+      /// \param[in] _key Key of the group.
+      private: void Build(const std::string &_key);
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<StaticBatcherPrivate> dataPtr;
+    };
+    /// \endcond
+  }
+}
+#endif
@@ -58,6 +58,37 @@ using namespace rendering;
 // Note: The value of ignition::math::MAX_UI32 is reserved as a flag.
 uint32_t VisualPrivate::visualIdCount = ignition::math::MAX_UI32 - 1;
 
+//////////////////////////////////////////////////
+/// \brief Get the entities attached to a scene node.
+/// \param[in] _node The scene node.
+/// \return The entities.
+static std::vector<Ogre::Entity *> AttachedEntities(Ogre::SceneNode *_node)
+{
+  std::vector<Ogre::Entity *> entities;
+  for (unsigned int i = 0; _node && i < _node->numAttachedObjects(); ++i)
+  {
+    Ogre::Entity *entity =
+        dynamic_cast<Ogre::Entity *>(_node->getAttachedObject(i));
+    if (entity)
+      entities.push_back(entity);
+  }
+  return entities;
+}
+
+//////////////////////////////////////////////////
+/// \brief Tell the scene that the entities of a visual changed, so that
+/// it rebuilds their static batches.
+/// \param[in] _vis The visual.
+static void UpdateBatching(const Visual *_vis)
+{
+  ScenePtr scene = _vis->GetScene();
+  if (!scene)
+    return;
+
+  for (auto entity : AttachedEntities(_vis->GetSceneNode()))
+    scene->UpdateBatching(entity);
+}
+
 //////////////////////////////////////////////////
 Visual::Visual(const std::string &_name, VisualPtr _parent, bool _useRTShader)
   : dataPtr(new VisualPrivate)
@@ -272,6 +303,10 @@ void Visual::DestroyAllAttachedMovableObjects(Ogre::SceneNode *_sceneNode)
   if (!_sceneNode)
     return;
 
+  // Unbatch the entities before they're destroyed
+  for (auto entity : AttachedEntities(_sceneNode))
+    this->dataPtr->scene->RemoveBatching(entity);
+
   // Destroy all the attached objects
   Ogre::SceneNode::ObjectIterator itObject =
     _sceneNode->getAttachedObjectIterator();
@@ -701,7 +736,11 @@ unsigned int Visual::GetAttachedObjectCount() const
 void Visual::DetachObjects()
 {
   if (this->dataPtr->sceneNode)
+  {
+    for (auto entity : AttachedEntities(this->dataPtr->sceneNode))
+      this->dataPtr->scene->RemoveBatching(entity);
     this->dataPtr->sceneNode->detachAllObjects();
+  }
   this->dataPtr->meshName = "";
   this->dataPtr->subMeshName = "";
   this->dataPtr->myMaterialName = "";
@@ -801,6 +840,7 @@ Ogre::MovableObject *Visual::AttachMesh(const std::string &_meshName,
   }
 
   this->AttachObject(obj);
+  UpdateBatching(this);
   return obj;
 }
 
@@ -995,6 +1035,8 @@ void Visual::SetLighting(bool _lighting)
     (*iter)->SetLighting(this->dataPtr->lighting);
   }
 
+  UpdateBatching(this);
+
   this->dataPtr->sdf->GetElement("material")
       ->GetElement("lighting")->Set(this->dataPtr->lighting);
 }
@@ -1134,6 +1176,8 @@ void Visual::SetMaterial(const std::string &_materialName, bool _unique,
     RTShaderSystem::Instance()->UpdateShaders();
   }
 
+  UpdateBatching(this);
+
   this->dataPtr->sdf->GetElement("material")->GetElement("script")
       ->GetElement("name")->Set(_materialName);
 }
@@ -1311,6 +1355,7 @@ void Visual::SetAmbient(const ignition::math::Color &_color,
   }
 
   this->dataPtr->ambient = _color;
+  UpdateBatching(this);
 
   this->dataPtr->sdf->GetElement("material")
       ->GetElement("ambient")->Set(_color);
@@ -1446,6 +1491,7 @@ void Visual::SetSpecular(const ignition::math::Color &_color,
   }
 
   this->dataPtr->specular = _color;
+  UpdateBatching(this);
 
   this->dataPtr->sdf->GetElement("material")
       ->GetElement("specular")->Set(_color);
@@ -1501,6 +1547,7 @@ void Visual::SetEmissive(const ignition::math::Color &_color,
   }
 
   this->dataPtr->emissive = _color;
+  UpdateBatching(this);
 
   this->dataPtr->sdf->GetElement("material")
       ->GetElement("emissive")->Set(_color);
@@ -1585,6 +1632,8 @@ void Visual::SetWireframe(bool _show)
       }
     }
   }
+
+  UpdateBatching(this);
 }
 
 //////////////////////////////////////////////////
@@ -1738,6 +1787,8 @@ void Visual::UpdateTransparency(const bool _cascade)
   if (this->dataPtr->useRTShader && this->dataPtr->scene->Initialized())
     RTShaderSystem::Instance()->UpdateShaders();
 
+  UpdateBatching(this);
+
   this->dataPtr->sdf->GetElement("transparency")->Set(
       this->dataPtr->transparency);
 }
@@ -2055,6 +2106,8 @@ void Visual::SetShaderType(const std::string &_type)
       "shader")->GetAttribute("type")->Set(_type);
   if (this->dataPtr->useRTShader && this->dataPtr->scene->Initialized())
     RTShaderSystem::Instance()->UpdateShaders();
+
+  UpdateBatching(this);
 }
 
 
@@ -3221,6 +3274,7 @@ void Visual::SetVisibilityFlags(uint32_t _flags)
   }
 
   this->dataPtr->visibilityFlags = _flags;
+  UpdateBatching(this);
 }
 
 //////////////////////////////////////////////////
@@ -3508,6 +3562,7 @@ Visual::VisualType Visual::GetType() const
 void Visual::SetType(const Visual::VisualType _type)
 {
   this->dataPtr->type = _type;
+  UpdateBatching(this);
 }
 
 //////////////////////////////////////////////////
@@ -30,6 +30,10 @@
 
 #endif /* HAVE_OPENGL */
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include <ignition/math/Color.hh>
 
 #include "gazebo/rendering/ogre_gazebo.h"
@@ -392,6 +396,90 @@ void CameraLens::SetUniformVariables(Ogre::Pass *_pass, const float _ratio,
   uniforms_vs->setNamedConstant("ratio", static_cast<Ogre::Real>(_ratio));
 }
 
+//////////////////////////////////////////////////
+unsigned int CameraLens::CubeFaceMask(const double _ratio,
+                                      const double _hfov) const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->dataMutex);
+
+  const double c1 = this->dataPtr->c1;
+  const double c2 = this->dataPtr->c2;
+  const double c3 = this->dataPtr->c3;
+  const double cutOffAngle = this->dataPtr->cutOffAngle;
+  const auto fun = this->dataPtr->fun.AsVector3d();
+
+  // Same focal length as in SetUniformVariables
+  double f = this->dataPtr->f;
+  const bool scaleToHFOV = this->ScaleToHFOV();
+  if (scaleToHFOV)
+  {
+    float param = (_hfov/2)/c2+c3;
+    f = 1.0/(c1*this->dataPtr->fun.Apply(param));
+  }
+
+  std::vector<double> key = {c1, c2, c3, f, cutOffAngle,
+      fun.X(), fun.Y(), fun.Z(), _ratio, _hfov,
+      static_cast<double>(scaleToHFOV)};
+  if (key == this->dataPtr->faceMaskKey)
+    return this->dataPtr->faceMask;
+
+  const unsigned int allFaces = 0x3F;
+  unsigned int mask = 0;
+  if (_ratio <= 0 || std::fabs(c1 * f) < 1e-9 || !std::isfinite(f))
+    mask = allFaces;
+
+  // Sample the image on a grid, and map each sample to the direction that
+  // the shader in wide_lens_map_fp.glsl reads from the cube map. Faces are
+  // also marked when a direction is within the margin of their edge, to
+  // cover the filtering across face edges.
+  const int samples = 64;
+  const double margin = 0.02;
+  for (int i = 0; i <= samples && mask != allFaces; ++i)
+  {
+    for (int j = 0; j <= samples; ++j)
+    {
+      const double x = -1.0 + 2.0 * i / samples;
+      const double y = (-1.0 + 2.0 * j / samples) / _ratio;
+      const double r = std::sqrt(x * x + y * y);
+
+      const double param = r / (c1 * f);
+      if (fun.X() != 0 && std::fabs(param) > 1)
+        continue;
+
+      double theta = fun.X() * std::asin(std::min(std::max(param, -1.0), 1.0))
+          + fun.Y() * std::atan(param) + fun.Z() * param;
+      theta = (theta - c3) * c2;
+
+      // Pixels beyond the cut-off angle are black
+      if (!std::isfinite(theta) || theta > cutOffAngle)
+        continue;
+
+      double dir[3] = {0, 0, 1};
+      if (r > 1e-9)
+      {
+        dir[0] = -std::sin(theta) * x / r;
+        dir[1] = std::sin(theta) * y / r;
+        dir[2] = std::cos(theta);
+      }
+
+      const double maxAbs = std::max(std::fabs(dir[0]),
+          std::max(std::fabs(dir[1]), std::fabs(dir[2])));
+      for (int a = 0; a < 3; ++a)
+      {
+        if (std::fabs(dir[a]) >= maxAbs - margin)
+          mask |= 1u << (2 * a + (dir[a] < 0 ? 1 : 0));
+      }
+    }
+  }
+
+  // The optical axis is always rendered
+  mask |= 1u << 4;
+
+  this->dataPtr->faceMaskKey = key;
+  this->dataPtr->faceMask = mask;
+  return mask;
+}
+
 //////////////////////////////////////////////////
 void CameraLens::ConvertToCustom()
 {
@@ -482,25 +570,15 @@ void WideAngleCamera::Load()
 //////////////////////////////////////////////////
 void WideAngleCamera::Fini()
 {
+  this->DestroyEnvRenderTexture();
+
   for (int i = 0; i < 6; ++i)
   {
-    RTShaderSystem::DetachViewport(this->dataPtr->envViewports[i],
-                                   this->GetScene());
-
-    this->dataPtr->envRenderTargets[i]->removeAllViewports();
-    this->dataPtr->envRenderTargets[i] = NULL;
-
     this->GetScene()->OgreSceneManager()->destroyCamera(
         this->dataPtr->envCameras[i]->getName());
     this->dataPtr->envCameras[i] = NULL;
   }
 
-  if (this->dataPtr->envCubeMapTexture)
-    Ogre::TextureManager::getSingleton().remove(
-      this->dataPtr->envCubeMapTexture->getName());
-
-  this->dataPtr->envCubeMapTexture = NULL;
-
   Camera::Fini();
 }
 
@@ -512,6 +590,37 @@ int WideAngleCamera::EnvTextureSize() const
   return this->dataPtr->envTextureSize;
 }
 
+//////////////////////////////////////////////////
+void WideAngleCamera::SetLowResolutionFaces(const bool _lowResolution)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->dataMutex);
+
+  // The cube map is recreated on the next render
+  this->dataPtr->lowResolutionFaces = _lowResolution;
+}
+
+//////////////////////////////////////////////////
+bool WideAngleCamera::LowResolutionFaces() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->dataMutex);
+
+  return this->dataPtr->lowResolutionFaces;
+}
+
+//////////////////////////////////////////////////
+unsigned int WideAngleCamera::RenderedFaceCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->dataMutex);
+
+  unsigned int count = 0;
+  for (int i = 0; i < 6; ++i)
+  {
+    if (this->dataPtr->renderedFaces & (1u << i))
+      ++count;
+  }
+  return count;
+}
+
 //////////////////////////////////////////////////
 CameraLens *WideAngleCamera::Lens() const
 {
@@ -652,13 +761,21 @@ void WideAngleCamera::CreateEnvRenderTexture(const std::string &_textureName)
   if (it != fsaaLevels.end())
     fsaa = targetFSAA;
 
+  int textureSize = this->dataPtr->envTextureSize;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->dataMutex);
+    this->dataPtr->envTextureLowResolution = this->dataPtr->lowResolutionFaces;
+  }
+  if (this->dataPtr->envTextureLowResolution)
+    textureSize = std::max(textureSize / 2, 1);
+
   this->dataPtr->envCubeMapTexture =
       Ogre::TextureManager::getSingleton().createManual(
           this->scopedUniqueName+"::"+_textureName,
           "General",
           Ogre::TEX_TYPE_CUBE_MAP,
-          this->dataPtr->envTextureSize,
-          this->dataPtr->envTextureSize,
+          textureSize,
+          textureSize,
           0,
           static_cast<Ogre::PixelFormat>(this->imageFormat),
           Ogre::TU_RENDERTARGET,
@@ -693,13 +810,58 @@ void WideAngleCamera::CreateEnvRenderTexture(const std::string &_textureName)
   }
 }
 
+//////////////////////////////////////////////////
+void WideAngleCamera::DestroyEnvRenderTexture()
+{
+  for (int i = 0; i < 6; ++i)
+  {
+    if (!this->dataPtr->envRenderTargets[i])
+      continue;
+
+    RTShaderSystem::DetachViewport(this->dataPtr->envViewports[i],
+                                   this->GetScene());
+
+    this->dataPtr->envRenderTargets[i]->removeAllViewports();
+    this->dataPtr->envRenderTargets[i] = NULL;
+    this->dataPtr->envViewports[i] = NULL;
+  }
+
+  if (this->dataPtr->envCubeMapTexture)
+    Ogre::TextureManager::getSingleton().remove(
+      this->dataPtr->envCubeMapTexture->getName());
+
+  this->dataPtr->envCubeMapTexture = NULL;
+}
+
 //////////////////////////////////////////////////
 void WideAngleCamera::RenderImpl()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->renderMutex);
 
+  bool lowResolution;
+  {
+    std::lock_guard<std::mutex> dataLock(this->dataPtr->dataMutex);
+    lowResolution = this->dataPtr->lowResolutionFaces;
+  }
+  if (lowResolution != this->dataPtr->envTextureLowResolution)
+  {
+    this->DestroyEnvRenderTexture();
+    this->CreateEnvRenderTexture(this->scopedUniqueName + "_envRttTex");
+  }
+
+  // Only render the faces that the lens mapping samples
+  const unsigned int faces = this->Lens()->CubeFaceMask(
+      this->AspectRatio(), this->HFOV().Radian());
+  {
+    std::lock_guard<std::mutex> dataLock(this->dataPtr->dataMutex);
+    this->dataPtr->renderedFaces = faces;
+  }
+
   for (int i = 0; i < 6; ++i)
-    this->dataPtr->envRenderTargets[i]->update();
+  {
+    if (faces & (1u << i))
+      this->dataPtr->envRenderTargets[i]->update();
+  }
 
   this->dataPtr->compMat->getTechnique(0)->getPass(0)->getTextureUnitState(0)->
       setTextureName(this->dataPtr->envCubeMapTexture->getName());
@@ -160,6 +160,15 @@ namespace gazebo
       public: void SetUniformVariables(Ogre::Pass *_pass, const float _ratio,
                                        const float _hfov);
 
+      /// \brief Get the cube map faces that the lens mapping samples.
+      /// Faces are indexed in Ogre cube map order (+X, -X, +Y, -Y, +Z, -Z),
+      /// where +Z is the optical axis.
+      /// \param[in] _ratio Frame aspect ratio
+      /// \param[in] _hfov Horizontal field of view
+      /// \return Bit mask with bit i set if face i is sampled
+      public: unsigned int CubeFaceMask(const double _ratio,
+                                        const double _hfov) const;
+
       /// \internal
       /// \brief Converts projection type from one of presets to `custom`
       private: void ConvertToCustom();
@@ -213,6 +222,21 @@ namespace gazebo
       /// \param[in] _size Texture size
       public: void SetEnvTextureSize(const int _size);
 
+      /// \brief Render the cube map faces at half the environment texture
+      /// size. This trades image sharpness for rendering time.
+      /// \param[in] _lowResolution True to use half resolution faces
+      public: void SetLowResolutionFaces(const bool _lowResolution);
+
+      /// \brief Check if the cube map faces use half resolution
+      /// \return True if the faces use half the environment texture size
+      public: bool LowResolutionFaces() const;
+
+      /// \brief Get the number of cube map faces rendered each frame. Faces
+      /// that the lens doesn't sample, given its field of view and cut-off
+      /// angle, are skipped.
+      /// \return Number of rendered faces, between 1 and 6
+      public: unsigned int RenderedFaceCount() const;
+
       /// \brief Creates a set of 6 cameras pointing in different directions
       protected: void CreateEnvCameras();
 
@@ -240,6 +264,9 @@ namespace gazebo
       /// \param[in] _textureName Name used as a base for environment texture
       protected: void CreateEnvRenderTexture(const std::string &_textureName);
 
+      /// \brief Destroy the environment texture and its render targets
+      protected: void DestroyEnvRenderTexture();
+
       // Documentation inherited
       protected: void RenderImpl() override;
 
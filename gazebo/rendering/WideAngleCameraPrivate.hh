@@ -62,6 +62,16 @@ namespace gazebo
       /// \brief A single cube map texture
       public: Ogre::Texture *envCubeMapTexture;
 
+      /// \brief Cube map faces rendered in the last frame, one bit per face
+      public: unsigned int renderedFaces = 0x3F;
+
+      /// \brief True to render the faces at half the environment texture
+      /// size
+      public: bool lowResolutionFaces = false;
+
+      /// \brief True if envCubeMapTexture was created at half size
+      public: bool envTextureLowResolution = false;
+
       /// \brief Pointer to material, used for second rendering pass
       public: Ogre::MaterialPtr compMat;
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/math/Angle.hh>
+#include <sdf/sdf.hh>
+
+#include "test/util.hh"
+
+#include "gazebo/rendering/WideAngleCamera.hh"
+
+using namespace gazebo;
+class CameraLens_TEST : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Bit of each cube map face.
+static const unsigned int posX = 1u << 0;
+static const unsigned int negX = 1u << 1;
+static const unsigned int posY = 1u << 2;
+static const unsigned int negY = 1u << 3;
+static const unsigned int posZ = 1u << 4;
+static const unsigned int negZ = 1u << 5;
+
+/////////////////////////////////////////////////
+TEST_F(CameraLens_TEST, CubeFaceMask)
+{
+  sdf::ElementPtr cameraSdf(new sdf::Element);
+  ASSERT_TRUE(sdf::initFile("camera.sdf", cameraSdf));
+  sdf::ElementPtr lensSdf = cameraSdf->GetElement("lens");
+
+  rendering::CameraLens lens;
+  lens.Load(lensSdf);
+  lens.SetScaleToHFOV(true);
+
+  // Narrow pinhole lens: only the forward face
+  lens.SetType("gnomonical");
+  lens.SetCutOffAngle(IGN_PI * 0.5);
+  EXPECT_EQ(lens.CubeFaceMask(1.0, IGN_DTOR(60)), posZ);
+
+  // Wide image: the horizontal faces, but not the vertical ones
+  EXPECT_EQ(lens.CubeFaceMask(16.0 / 9.0, IGN_DTOR(100)),
+      posX | negX | posZ);
+
+  // 190 degree fisheye: everything but the back face
+  lens.SetType("equidistant");
+  lens.SetCutOffAngle(IGN_DTOR(95));
+  EXPECT_EQ(lens.CubeFaceMask(1.0, IGN_DTOR(190)),
+      posX | negX | posY | negY | posZ);
+  lens.SetType("stereographic");
+  EXPECT_EQ(lens.CubeFaceMask(4.0 / 3.0, IGN_DTOR(190)),
+      posX | negX | posY | negY | posZ);
+
+  // Full sphere
+  lens.SetType("equidistant");
+  lens.SetCutOffAngle(IGN_PI);
+  EXPECT_EQ(lens.CubeFaceMask(1.0, 2 * IGN_PI),
+      posX | negX | posY | negY | posZ | negZ);
+
+  // The cut-off angle limits the faces even with a wide FOV
+  lens.SetCutOffAngle(IGN_DTOR(30));
+  EXPECT_EQ(lens.CubeFaceMask(1.0, 2 * IGN_PI), posZ);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -731,48 +731,21 @@ bool GpuRaySensor::UpdateImpl(const bool /*_force*/)
   scan->set_range_min(this->dataPtr->rangeMin);
   scan->set_range_max(this->dataPtr->rangeMax);
 
-  const int numRays = this->dataPtr->vertRangeCount *
+  const unsigned int numRays = this->dataPtr->vertRangeCount *
     this->dataPtr->horzRangeCount;
-  if (scan->ranges_size() != numRays)
-  {
-    // gzdbg << "Size mismatch; allocating memory\n";
-    scan->clear_ranges();
-    scan->clear_intensities();
-    for (int i = 0; i < numRays; ++i)
-    {
-      scan->add_ranges(ignition::math::NAN_F);
-      scan->add_intensities(ignition::math::NAN_F);
-    }
-  }
-
-  auto dataIter = this->dataPtr->laserCam->LaserDataBegin();
-  auto dataEnd = this->dataPtr->laserCam->LaserDataEnd();
-  for (int i = 0; dataIter != dataEnd; ++dataIter, ++i)
-  {
-    const rendering::GpuLaserData data = *dataIter;
-    double range = data.range;
-    double intensity = data.intensity;
-
-    // Mask ranges outside of min/max to +/- inf, as per REP 117
-    if (range >= this->dataPtr->rangeMax)
-    {
-      range = ignition::math::INF_D;
-    }
-    else if (range <= this->dataPtr->rangeMin)
-    {
-      range = -ignition::math::INF_D;
-    }
-    else if (this->noises.find(GPU_RAY_NOISE) != this->noises.end())
-    {
-      range = this->noises[GPU_RAY_NOISE]->Apply(range);
-      range = ignition::math::clamp(range,
-          this->dataPtr->rangeMin, this->dataPtr->rangeMax);
-    }
 
-    range = ignition::math::isnan(range) ? this->dataPtr->rangeMax : range;
-    scan->set_ranges(i, range);
-    scan->set_intensities(i, intensity);
-  }
+  // Clamp, apply noise and convert the whole frame in bulk, then copy the
+  // packed arrays into the message.
+  auto noiseIter = this->noises.find(GPU_RAY_NOISE);
+  this->dataPtr->scanProcessor.SetRange(
+      this->dataPtr->rangeMin, this->dataPtr->rangeMax);
+  this->dataPtr->scanProcessor.SetNoise(
+      noiseIter != this->noises.end() ? noiseIter->second : nullptr);
+
+  // Data stuffed into three floats (RGB): range in R, intensity in G
+  this->dataPtr->scanProcessor.Process(
+      this->dataPtr->laserCam->LaserData(), numRays, 3, 0, 1);
+  this->dataPtr->scanProcessor.Fill(*scan);
 
   if (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections())
     this->dataPtr->scanPub->Publish(this->dataPtr->laserMsg);
@@ -25,6 +25,7 @@
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/sensors/LaserScanProcessor.hh"
 
 namespace gazebo
 {
@@ -85,6 +86,9 @@ namespace gazebo
       /// \brief Publisher to publish ray sensor data
       public: transport::PublisherPtr scanPub;
 
+      /// \brief Bulk post-processing of the rendered laser data.
+      public: LaserScanProcessor scanProcessor;
+
       /// \brief True if the sensor was rendered.
       public: bool rendered;
 
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ignition/common/Profiler.hh>
+
+#include "gazebo/sensors/Noise.hh"
+#include "gazebo/sensors/LaserScanProcessorPrivate.hh"
+#include "gazebo/sensors/LaserScanProcessor.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+//////////////////////////////////////////////////
+LaserScanProcessor::LaserScanProcessor()
+  : dataPtr(new LaserScanProcessorPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+LaserScanProcessor::~LaserScanProcessor()
+{
+}
+
+//////////////////////////////////////////////////
+void LaserScanProcessor::SetRange(const double _min, const double _max)
+{
+  this->dataPtr->rangeMin = _min;
+  this->dataPtr->rangeMax = _max;
+}
+
+//////////////////////////////////////////////////
+void LaserScanProcessor::SetNoise(const NoisePtr &_noise)
+{
+  this->dataPtr->noise = _noise;
+}
+
+//////////////////////////////////////////////////
+void LaserScanProcessor::Process(const float *_data,
+    const unsigned int _count, const unsigned int _stride,
+    const unsigned int _rangeOffset, const unsigned int _intensityOffset)
+{
+  IGN_PROFILE("LaserScanProcessor::Process");
+
+  // resize() is a no-op once the buffers match the scan size, so the
+  // steady state does not allocate.
+  this->dataPtr->ranges.resize(_count);
+  this->dataPtr->intensities.resize(_count);
+
+  if (!_data || _count == 0)
+    return;
+
+  double *ranges = this->dataPtr->ranges.data();
+  double *intensities = this->dataPtr->intensities.data();
+  const double rangeMin = this->dataPtr->rangeMin;
+  const double rangeMax = this->dataPtr->rangeMax;
+  const double inf = std::numeric_limits<double>::infinity();
+
+  // Unpack and mask ranges outside of min/max to +/- inf, as per REP 117.
+  // The loop body is branch free so it compiles to vector blends.
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    const double range = _data[i * _stride + _rangeOffset];
+    intensities[i] = _data[i * _stride + _intensityOffset];
+    ranges[i] = range >= rangeMax ? inf :
+        (range <= rangeMin ? -inf : range);
+  }
+
+  // Apply noise to the readings that were not masked. Noise models carry
+  // their own state (random generator, bias walk), so this pass is kept
+  // separate from the vectorized ones.
+  if (this->dataPtr->noise)
+  {
+    Noise *noise = this->dataPtr->noise.get();
+    for (unsigned int i = 0; i < _count; ++i)
+    {
+      if (!std::isinf(ranges[i]))
+      {
+        ranges[i] = std::min(std::max(noise->Apply(ranges[i]), rangeMin),
+            rangeMax);
+      }
+    }
+  }
+
+  // Replace NaN readings with the maximum range.
+  for (unsigned int i = 0; i < _count; ++i)
+    ranges[i] = std::isnan(ranges[i]) ? rangeMax : ranges[i];
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &LaserScanProcessor::Ranges() const
+{
+  return this->dataPtr->ranges;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &LaserScanProcessor::Intensities() const
+{
+  return this->dataPtr->intensities;
+}
+
+//////////////////////////////////////////////////
+void LaserScanProcessor::Fill(msgs::LaserScan &_scan) const
+{
+  IGN_PROFILE("LaserScanProcessor::Fill");
+
+  const int count = static_cast<int>(this->dataPtr->ranges.size());
+
+  // Resize() only reallocates when the scan size changes.
+  _scan.mutable_ranges()->Resize(count, 0.0);
+  _scan.mutable_intensities()->Resize(count, 0.0);
+
+  std::copy(this->dataPtr->ranges.begin(), this->dataPtr->ranges.end(),
+      _scan.mutable_ranges()->mutable_data());
+  std::copy(this->dataPtr->intensities.begin(),
+      this->dataPtr->intensities.end(),
+      _scan.mutable_intensities()->mutable_data());
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_LASERSCANPROCESSOR_HH_
+#define GAZEBO_SENSORS_LASERSCANPROCESSOR_HH_
+
+#include <memory>
+#include <vector>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/sensors/SensorTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declare private data class
+    class LaserScanProcessorPrivate;
+
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class LaserScanProcessor LaserScanProcessor.hh sensors/sensors.hh
+    /// \brief Bulk post-processing of raw laser returns.
+    ///
+    /// Converts an interleaved float buffer, such as the one produced by
+    /// rendering::GpuLaser, into packed range and intensity arrays. Ranges
+    /// outside of [min, max] are masked to +/- infinity as per REP 117,
+    /// noise is applied to the remaining readings, and NaN readings are
+    /// replaced by the maximum range. Each stage is a separate flat loop
+    /// over preallocated storage so that the compiler can vectorize it.
+    class GZ_SENSORS_VISIBLE LaserScanProcessor
+    {
+      /// \brief Constructor
+      public: LaserScanProcessor();
+
+      /// \brief Destructor
+      public: ~LaserScanProcessor();
+
+      /// \brief Set the valid range interval.
+      /// \param[in] _min Minimum range.
+      /// \param[in] _max Maximum range.
+      public: void SetRange(const double _min, const double _max);
+
+      /// \brief Set the noise model applied to in-range readings.
+      /// \param[in] _noise Noise model, or nullptr to disable noise.
+      public: void SetNoise(const NoisePtr &_noise);
+
+      /// \brief Process a frame of laser data. The output arrays are
+      /// resized to _count; if _data is null their contents are left
+      /// untouched.
+      /// \param[in] _data Interleaved laser buffer.
+      /// \param[in] _count Number of readings in _data.
+      /// \param[in] _stride Number of floats per reading.
+      /// \param[in] _rangeOffset Offset of the range value in a reading.
+      /// \param[in] _intensityOffset Offset of the intensity value in a
+      /// reading.
+      public: void Process(const float *_data, const unsigned int _count,
+                  const unsigned int _stride,
+                  const unsigned int _rangeOffset,
+                  const unsigned int _intensityOffset);
+
+      /// \brief Get the processed ranges.
+      /// \return Ranges of the last processed frame.
+      public: const std::vector<double> &Ranges() const;
+
+      /// \brief Get the processed intensities.
+      /// \return Intensities of the last processed frame.
+      public: const std::vector<double> &Intensities() const;
+
+      /// \brief Copy the processed ranges and intensities into a laser scan
+      /// message. The repeated fields are resized once and filled with a
+      /// single bulk copy.
+      /// \param[out] _scan Message to fill.
+      public: void Fill(msgs::LaserScan &_scan) const;
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<LaserScanProcessorPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
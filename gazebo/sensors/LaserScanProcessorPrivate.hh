@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_LASERSCANPROCESSORPRIVATE_HH_
+#define GAZEBO_SENSORS_LASERSCANPROCESSORPRIVATE_HH_
+
+#include <vector>
+
+#include "gazebo/sensors/SensorTypes.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \internal
+    /// \brief Laser scan processor private data.
+    class LaserScanProcessorPrivate
+    {
+      /// \brief The minimum range.
+      public: double rangeMin = 0.0;
+
+      /// \brief The maximum range.
+      public: double rangeMax = 0.0;
+
+      /// \brief Noise model, may be null.
+      public: NoisePtr noise;
+
+      /// \brief Packed output ranges, reused across frames.
+      public: std::vector<double> ranges;
+
+      /// \brief Packed output intensities, reused across frames.
+      public: std::vector<double> intensities;
+    };
+  }
+}
+#endif
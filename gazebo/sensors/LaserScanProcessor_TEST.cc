@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "gazebo/sensors/Noise.hh"
+#include "gazebo/sensors/LaserScanProcessor.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class LaserScanProcessorTest : public gazebo::testing::AutoLogFixture { };
+
+//////////////////////////////////////////////////
+TEST_F(LaserScanProcessorTest, MaskAndConvert)
+{
+  // Three floats per reading: range, intensity, unused
+  std::vector<float> data = {
+    0.05f, 1.0f, 0.0f,
+    0.5f, 2.0f, 0.0f,
+    10.0f, 3.0f, 0.0f,
+    NAN, 4.0f, 0.0f,
+    12.0f, 5.0f, 0.0f};
+
+  sensors::LaserScanProcessor processor;
+  processor.SetRange(0.1, 10.0);
+  processor.Process(data.data(), 5, 3, 0, 1);
+
+  const std::vector<double> &ranges = processor.Ranges();
+  const std::vector<double> &intensities = processor.Intensities();
+  ASSERT_EQ(5u, ranges.size());
+  ASSERT_EQ(5u, intensities.size());
+
+  EXPECT_TRUE(std::isinf(ranges[0]));
+  EXPECT_LT(ranges[0], 0.0);
+  EXPECT_DOUBLE_EQ(0.5, ranges[1]);
+  EXPECT_TRUE(std::isinf(ranges[2]));
+  EXPECT_GT(ranges[2], 0.0);
+  EXPECT_DOUBLE_EQ(10.0, ranges[3]);
+  EXPECT_TRUE(std::isinf(ranges[4]));
+  EXPECT_GT(ranges[4], 0.0);
+
+  for (unsigned int i = 0; i < 5; ++i)
+    EXPECT_DOUBLE_EQ(i + 1.0, intensities[i]);
+
+  msgs::LaserScan scan;
+  processor.Fill(scan);
+  ASSERT_EQ(5, scan.ranges_size());
+  ASSERT_EQ(5, scan.intensities_size());
+  EXPECT_DOUBLE_EQ(0.5, scan.ranges(1));
+  EXPECT_DOUBLE_EQ(10.0, scan.ranges(3));
+  EXPECT_DOUBLE_EQ(5.0, scan.intensities(4));
+
+  // Smaller frame shrinks the message
+  processor.Process(data.data(), 2, 3, 0, 1);
+  processor.Fill(scan);
+  EXPECT_EQ(2, scan.ranges_size());
+  EXPECT_EQ(2, scan.intensities_size());
+}
+
+//////////////////////////////////////////////////
+TEST_F(LaserScanProcessorTest, Noise)
+{
+  std::vector<float> data = {
+    0.05f, 0.0f, 0.0f,
+    0.5f, 0.0f, 0.0f,
+    9.95f, 0.0f, 0.0f,
+    12.0f, 0.0f, 0.0f};
+
+  // Custom noise that pushes readings by a fixed offset
+  sensors::NoisePtr noise(new sensors::Noise(sensors::Noise::CUSTOM));
+  noise->SetCustomNoiseCallback(
+      [](double _in) -> double { return _in + 0.1; });
+
+  sensors::LaserScanProcessor processor;
+  processor.SetRange(0.1, 10.0);
+  processor.SetNoise(noise);
+  processor.Process(data.data(), 4, 3, 0, 1);
+
+  const std::vector<double> &ranges = processor.Ranges();
+  ASSERT_EQ(4u, ranges.size());
+
+  // Masked readings are not affected by noise
+  EXPECT_TRUE(std::isinf(ranges[0]));
+  EXPECT_LT(ranges[0], 0.0);
+  EXPECT_NEAR(0.6, ranges[1], 1e-6);
+  // Noisy readings are clamped to the valid range
+  EXPECT_DOUBLE_EQ(10.0, ranges[2]);
+  EXPECT_TRUE(std::isinf(ranges[3]));
+  EXPECT_GT(ranges[3], 0.0);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -25,6 +25,7 @@
 #include "gazebo/physics/PhysicsEngine.hh"
 
 #include "gazebo/common/Timer.hh"
+#include "gazebo/common/EventProfiler.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Plugin.hh"
@@ -343,6 +344,10 @@ void Sensor::LoadPlugin(sdf::ElementPtr _sdf)
       return;
     }
 
+    // Tag event connections made by the plugin for timing
+    event::EventProfiler::OwnerScope profilerOwner(filename, name,
+        this->ScopedName());
+
     SensorPtr myself = shared_from_this();
     plugin->Load(myself, _sdf);
     plugin->Init();
@@ -49,6 +49,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
@@ -65,6 +67,9 @@ using namespace transport;
 
 extern void dummy_callback_fn(uint32_t);
 
+/// \brief Size of the chunks sampled messages are read in.
+static const std::size_t sampleChunkSize = 65536;
+
 unsigned int Connection::idCounter = 0;
 IOManager *Connection::iomanager = NULL;
 
@@ -286,6 +291,88 @@ void Connection::StopRead()
   this->readQuit = true;
 }
 
+//////////////////////////////////////////////////
+void Connection::AsyncSample(const SampleCallback &_cb)
+{
+  boost::mutex::scoped_lock lock(this->socketMutex);
+  if (!this->IsOpen())
+  {
+    gzerr << "AsyncSample on a closed socket\n";
+    return;
+  }
+
+  this->inboundHeader.resize(HEADER_LENGTH);
+  boost::asio::async_read(*this->socket,
+      boost::asio::buffer(this->inboundHeader),
+      common::weakBind(&Connection::OnSampleHeader, this->shared_from_this(),
+        boost::asio::placeholders::error, _cb));
+}
+
+//////////////////////////////////////////////////
+void Connection::OnSampleHeader(const boost::system::error_code &_e,
+    SampleCallback _cb)
+{
+  if (_e)
+  {
+    if (_e.value() == boost::asio::error::eof)
+      this->isOpen = false;
+    return;
+  }
+
+  this->sampleStart = common::Time::GetWallTime();
+  this->sampleSize = this->ParseHeader(
+      std::string(&this->inboundHeader[0], this->inboundHeader.size()));
+  this->sampleRemaining = this->sampleSize;
+
+  if (this->sampleSize == 0)
+  {
+    gzerr << "Header is empty\n";
+    return;
+  }
+
+  this->ReadSampleChunk(_cb);
+}
+
+//////////////////////////////////////////////////
+void Connection::ReadSampleChunk(SampleCallback _cb)
+{
+  boost::mutex::scoped_lock lock(this->socketMutex);
+  if (!this->IsOpen())
+    return;
+
+  this->sampleBuffer.resize(sampleChunkSize);
+  boost::asio::async_read(*this->socket,
+      boost::asio::buffer(this->sampleBuffer,
+        std::min(this->sampleRemaining, sampleChunkSize)),
+      common::weakBind(&Connection::OnSampleData, this->shared_from_this(),
+        boost::asio::placeholders::error,
+        boost::asio::placeholders::bytes_transferred, _cb));
+}
+
+//////////////////////////////////////////////////
+void Connection::OnSampleData(const boost::system::error_code &_e,
+    std::size_t _bytes, SampleCallback _cb)
+{
+  if (_e)
+  {
+    if (_e.value() == boost::asio::error::eof)
+      this->isOpen = false;
+    return;
+  }
+
+  this->sampleRemaining -= std::min(_bytes, this->sampleRemaining);
+  if (this->sampleRemaining > 0)
+  {
+    this->ReadSampleChunk(_cb);
+    return;
+  }
+
+  _cb(this->sampleSize, this->sampleStart, common::Time::GetWallTime());
+
+  // The loop ends when the connection is closed or cancelled
+  this->AsyncSample(_cb);
+}
+
 //////////////////////////////////////////////////
 void Connection::EnqueueMsg(const std::string &_buffer, bool _force)
 {
@@ -425,6 +512,12 @@ void Connection::OnWrite(const boost::system::error_code &_e)
     // It will reach this point if the remote connection disconnects.
     this->Shutdown();
   }
+  else
+  {
+    // Start writing the messages that were queued during this write,
+    // instead of waiting for the next update of the connection manager.
+    this->ProcessWriteQueue();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -641,37 +734,6 @@ std::size_t Connection::ParseHeader(const std::string &header)
   return data_size;
 }
 
-//////////////////////////////////////////////////
-void Connection::ReadLoop(const ReadCallback &cb)
-{
-  std::string data;
-
-  this->readQuit = false;
-  while (!this->readQuit)
-  {
-    try
-    {
-      if (this->socket->available() >= HEADER_LENGTH)
-      {
-        if (this->Read(data))
-        {
-          (cb)(data);
-        }
-      }
-      else
-      {
-        common::Time::MSleep(10);
-        continue;
-      }
-    }
-    catch(std::exception &e)
-    {
-      // The connection closed
-      break;
-    }
-  }
-}
-
 //////////////////////////////////////////////////
 boost::asio::ip::tcp::endpoint Connection::GetLocalEndpoint()
 {
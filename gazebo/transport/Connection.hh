@@ -36,6 +36,7 @@
 #include "gazebo/common/Event.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/common/WeakBind.hh"
 #include "gazebo/util/system.hh"
 
@@ -133,6 +134,24 @@ namespace gazebo
       /// \brief Stop the read loop
       public: void StopRead();
 
+      /// \brief The signature of a connection sample callback
+      /// \param[in] _size Size of the message in bytes.
+      /// \param[in] _start Wall time at which the header of the message
+      /// was received.
+      /// \param[in] _end Wall time at which the last byte of the message
+      /// was received.
+      typedef boost::function<void(std::size_t _size,
+          const common::Time &_start, const common::Time &_end)>
+          SampleCallback;
+
+      /// \brief Read messages continuously, passing only their framing to a
+      /// callback. The messages are read in chunks into a reused buffer and
+      /// dropped, so they're neither copied nor parsed, and the callback is
+      /// called on the IO thread without a task. Must not be mixed with
+      /// AsyncRead on the same connection.
+      /// \param[in] _cb The callback to invoke for each received message.
+      public: void AsyncSample(const SampleCallback &_cb);
+
       /// \brief Shutdown the socket
       public: void Shutdown();
 
@@ -356,13 +375,27 @@ namespace gazebo
       /// \param[in] _e Error code for accept method
       private: void OnAccept(const boost::system::error_code &_e);
 
+      /// \brief Handle a completed read of a message header, when sampling.
+      /// \param[in] _e Error code, if any, associated with the read
+      /// \param[in] _cb Callback to invoke for each received message.
+      private: void OnSampleHeader(const boost::system::error_code &_e,
+                   SampleCallback _cb);
+
+      /// \brief Read the next chunk of a sampled message.
+      /// \param[in] _cb Callback to invoke for each received message.
+      private: void ReadSampleChunk(SampleCallback _cb);
+
+      /// \brief Handle a completed read of a chunk of a sampled message.
+      /// \param[in] _e Error code, if any, associated with the read
+      /// \param[in] _bytes Number of bytes read.
+      /// \param[in] _cb Callback to invoke for each received message.
+      private: void OnSampleData(const boost::system::error_code &_e,
+                   std::size_t _bytes, SampleCallback _cb);
+
       /// \brief Parse a header to get the size of a packet
       /// \param[in] _header Header as a string
       private: std::size_t ParseHeader(const std::string &_header);
 
-      /// \brief the read thread
-      private: void ReadLoop(const ReadCallback &_cb);
-
       /// \brief Get the local endpoint
       /// \return The endpoint
       private: static boost::asio::ip::tcp::endpoint GetLocalEndpoint();
@@ -421,6 +454,19 @@ namespace gazebo
       /// \brief Content data from a new message.
       private: std::vector<char> inboundData;
 
+      /// \brief Buffer the chunks of sampled messages are read into.
+      private: std::vector<char> sampleBuffer;
+
+      /// \brief Size of the sampled message being read.
+      private: std::size_t sampleSize = 0;
+
+      /// \brief Number of bytes of the sampled message left to read.
+      private: std::size_t sampleRemaining = 0;
+
+      /// \brief Wall time at which the header of the sampled message being
+      /// read was received.
+      private: common::Time sampleStart;
+
       /// \brief Set to true to stop reading on the connection.
       private: bool readQuit;
 
@@ -63,6 +63,7 @@ ConnectionManager::ConnectionManager()
   this->initialized = false;
   this->stop = false;
   this->stopped = true;
+  this->updatePending = false;
 
   this->eventConnections.push_back(
       event::Events::ConnectStop(boost::bind(&ConnectionManager::Stop, this)));
@@ -189,6 +190,16 @@ bool ConnectionManager::Init(const std::string &_masterHost,
   this->masterConn->AsyncRead(
       boost::bind(&ConnectionManager::OnMasterRead, this, _1));
 
+  // Ask the master whether it understands batched advertisements. Older
+  // masters don't answer, so single advertisements are sent to them.
+  {
+    boost::recursive_mutex::scoped_lock lock(this->advertiseMutex);
+    this->masterBatches = false;
+  }
+  msgs::Request *request = msgs::CreateRequest("batch_support");
+  this->masterConn->EnqueueMsg(msgs::Package("request", *request), true);
+  delete request;
+
   this->initialized = true;
 
   // Tell the user what address will be publicized to other nodes.
@@ -214,6 +225,7 @@ void ConnectionManager::Fini()
 
   if (this->masterConn)
   {
+    this->SendAdvertisements();
     this->masterConn->ProcessWriteQueue();
     this->masterConn->Shutdown();
     this->masterConn.reset();
@@ -270,6 +282,8 @@ void ConnectionManager::RunUpdate()
     }
   }
 
+  this->SendAdvertisements();
+
   if (this->masterConn)
     this->masterConn->ProcessWriteQueue();
 
@@ -301,15 +315,23 @@ void ConnectionManager::RunUpdate()
 //////////////////////////////////////////////////
 void ConnectionManager::Run()
 {
-  boost::mutex::scoped_lock lock(this->updateMutex);
-
   this->stopped = false;
 
   while (!this->stop && this->masterConn && this->masterConn->IsOpen())
   {
     this->RunUpdate();
+
+    // Wait for the next trigger. Triggers that arrive while updating are
+    // kept in updatePending, so they are not lost. The timeout only bounds
+    // how long closed connections stay in the list.
+    boost::mutex::scoped_lock lock(this->updateMutex);
     this->updateCondition.timed_wait(lock,
-       boost::posix_time::milliseconds(100));
+       boost::posix_time::milliseconds(100),
+       [this]
+       {
+         return this->updatePending || this->stop;
+       });
+    this->updatePending = false;
   }
   this->RunUpdate();
 
@@ -353,24 +375,52 @@ void ConnectionManager::ProcessMessage(const std::string &_data)
   {
     msgs::Publish result;
     result.ParseFromString(packet.serialized_data());
+
+    boost::recursive_mutex::scoped_lock lock(this->listMutex);
     this->publishers.push_back(result);
   }
-  else if (packet.type() == "publisher_del")
+  else if (packet.type() == "publisher_add_batch")
   {
-    msgs::Publish result;
+    msgs::Publishers result;
     result.ParseFromString(packet.serialized_data());
 
+    boost::recursive_mutex::scoped_lock lock(this->listMutex);
+    for (auto const &pub : result.publisher())
+      this->publishers.push_back(pub);
+  }
+  else if (packet.type() == "publisher_del" ||
+           packet.type() == "publisher_del_batch")
+  {
+    msgs::Publishers result;
+    if (packet.type() == "publisher_del")
+      result.add_publisher()->ParseFromString(packet.serialized_data());
+    else
+      result.ParseFromString(packet.serialized_data());
+
+    // Remove all the publishers in one pass over the list
+    std::set<std::string> removed;
+    for (auto const &pub : result.publisher())
+    {
+      removed.insert(pub.topic() + "@" + pub.host() + ":" +
+          std::to_string(pub.port()));
+    }
+
+    boost::recursive_mutex::scoped_lock lock(this->listMutex);
     std::list<msgs::Publish>::iterator iter = this->publishers.begin();
     while (iter != this->publishers.end())
     {
-      if ((*iter).topic() == result.topic() &&
-          (*iter).host() == result.host() &&
-          (*iter).port() == result.port())
+      if (removed.count((*iter).topic() + "@" + (*iter).host() + ":" +
+            std::to_string((*iter).port())))
         iter = this->publishers.erase(iter);
       else
         ++iter;
     }
   }
+  else if (packet.type() == "batch_support")
+  {
+    boost::recursive_mutex::scoped_lock lock(this->advertiseMutex);
+    this->masterBatches = true;
+  }
   else if (packet.type() == "topic_namespace_add")
   {
     msgs::GzString result;
@@ -497,13 +547,54 @@ void ConnectionManager::Advertise(const std::string &topic,
   if (!this->initialized)
     return;
 
-  msgs::Publish msg;
-  msg.set_topic(topic);
-  msg.set_msg_type(msgType);
-  msg.set_host(this->serverConn->GetLocalAddress());
-  msg.set_port(this->serverConn->GetLocalPort());
+  {
+    boost::recursive_mutex::scoped_lock lock(this->advertiseMutex);
+    msgs::Publish *msg = this->advertisements.add_publisher();
+    msg->set_topic(topic);
+    msg->set_msg_type(msgType);
+    msg->set_host(this->serverConn->GetLocalAddress());
+    msg->set_port(this->serverConn->GetLocalPort());
+  }
 
-  this->masterConn->EnqueueMsg(msgs::Package("advertise", msg));
+  // The advertisements made until the next update are sent to the master
+  // together.
+  this->TriggerUpdate();
+}
+
+//////////////////////////////////////////////////
+void ConnectionManager::SendAdvertisements()
+{
+  // The lock is held while enqueuing, so that no other message to the
+  // master can overtake the advertisements.
+  boost::recursive_mutex::scoped_lock lock(this->advertiseMutex);
+  if (this->advertisements.publisher_size() == 0)
+    return;
+
+  msgs::Publishers pubs;
+  pubs.Swap(&this->advertisements);
+
+  if (!this->masterConn)
+    return;
+
+  if (pubs.publisher_size() > 1 && this->masterBatches)
+  {
+    this->masterConn->EnqueueMsg(msgs::Package("advertise_batch", pubs));
+  }
+  else
+  {
+    for (auto const &pub : pubs.publisher())
+      this->masterConn->EnqueueMsg(msgs::Package("advertise", pub));
+  }
+}
+
+//////////////////////////////////////////////////
+void ConnectionManager::EnqueueMasterMsg(const std::string &_msg,
+    bool _force)
+{
+  boost::recursive_mutex::scoped_lock lock(this->advertiseMutex);
+  this->SendAdvertisements();
+  if (this->masterConn)
+    this->masterConn->EnqueueMsg(_msg, _force);
 }
 
 //////////////////////////////////////////////////
@@ -514,7 +605,7 @@ void ConnectionManager::RegisterTopicNamespace(const std::string &_name)
 
   msgs::GzString msg;
   msg.set_data(_name);
-  this->masterConn->EnqueueMsg(msgs::Package("register_topic_namespace", msg));
+  this->EnqueueMasterMsg(msgs::Package("register_topic_namespace", msg));
 }
 
 //////////////////////////////////////////////////
@@ -530,10 +621,7 @@ void ConnectionManager::Unadvertise(const std::string &_topic)
     msg.set_port(this->serverConn->GetLocalPort());
   }
 
-  if (this->masterConn)
-  {
-    this->masterConn->EnqueueMsg(msgs::Package("unadvertise", msg), true);
-  }
+  this->EnqueueMasterMsg(msgs::Package("unadvertise", msg), true);
 }
 
 //////////////////////////////////////////////////
@@ -571,7 +659,7 @@ void ConnectionManager::GetTopicNamespaces(std::list<std::string> &_namespaces)
 void ConnectionManager::Unsubscribe(const msgs::Subscribe &_sub)
 {
   // Inform the master that we want to unsubscribe from a topic.
-  this->masterConn->EnqueueMsg(msgs::Package("unsubscribe", _sub), true);
+  this->EnqueueMasterMsg(msgs::Package("unsubscribe", _sub), true);
 }
 
 //////////////////////////////////////////////////
@@ -587,7 +675,7 @@ void ConnectionManager::Unsubscribe(const std::string &_topic,
     msg.set_port(this->serverConn->GetLocalPort());
 
     // Inform the master that we want to unsubscribe from a topic.
-    this->masterConn->EnqueueMsg(msgs::Package("unsubscribe", msg), true);
+    this->EnqueueMasterMsg(msgs::Package("unsubscribe", msg), true);
   }
 }
 
@@ -620,7 +708,7 @@ void ConnectionManager::Subscribe(const std::string &_topic,
     // Inform the master that we want to subscribe to a topic.
     // This will result in Connection::OnMasterRead getting called with a
     // packet type of "publisher_update"
-    this->masterConn->EnqueueMsg(msgs::Package("subscribe", msg));
+    this->EnqueueMasterMsg(msgs::Package("subscribe", msg));
   }
 }
 
@@ -697,5 +785,9 @@ ConnectionPtr ConnectionManager::FindConnection(const std::string &_host,
 //////////////////////////////////////////////////
 void ConnectionManager::TriggerUpdate()
 {
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    this->updatePending = true;
+  }
   this->updateCondition.notify_all();
 }
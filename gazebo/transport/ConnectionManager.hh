@@ -164,12 +164,38 @@ namespace gazebo
       /// \brief Run the manager update loop once
       private: void RunUpdate();
 
+      /// \brief Send the pending advertisements to the master, in a single
+      /// message if there are many and the master supports batches.
+      private: void SendAdvertisements();
+
+      /// \brief Send a message to the master, after the pending
+      /// advertisements, so that the master gets all messages in the order
+      /// in which they were made.
+      /// \param[in] _msg The packed message.
+      /// \param[in] _force True to write the message immediately.
+      private: void EnqueueMasterMsg(const std::string &_msg,
+                                     bool _force = false);
+
       /// \brief Condition used to trigger an update.
       private: boost::condition_variable updateCondition;
 
       /// \brief Mutex for updateCondition
       private: boost::mutex updateMutex;
 
+      /// \brief True if an update was triggered since the last update.
+      private: bool updatePending;
+
+      /// \brief Advertisements not yet sent to the master.
+      private: msgs::Publishers advertisements;
+
+      /// \brief Mutex to protect advertisements and masterBatches, and to
+      /// order the messages sent to the master.
+      private: boost::recursive_mutex advertiseMutex;
+
+      /// \brief True once the master acknowledged that it understands the
+      /// batched "advertise_batch" message.
+      private: bool masterBatches = false;
+
       private: ConnectionPtr masterConn;
       private: ConnectionPtr serverConn;
 
@@ -16,7 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <stdlib.h>
 
 #include "gazebo/transport/Connection.hh"
@@ -64,6 +66,61 @@ TEST_F(Connection, IPWhiteList)
     setenv("GAZEBO_IP_WHITE_LIST", ipEnv, 1);
 }
 
+/////////////////////////////////////////////////
+TEST_F(Connection, AsyncSample)
+{
+  std::mutex mutex;
+  transport::ConnectionPtr accepted;
+  transport::ConnectionPtr server(new transport::Connection());
+  server->Listen(0, [&](const transport::ConnectionPtr &_conn)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        accepted = _conn;
+      });
+
+  transport::ConnectionPtr client(new transport::Connection());
+  ASSERT_TRUE(client->Connect("127.0.0.1", server->GetLocalPort()));
+
+  for (int i = 0; i < 100; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (accepted)
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+  ASSERT_TRUE(accepted != nullptr);
+
+  std::vector<std::size_t> sampled;
+  client->AsyncSample([&](const std::size_t _size,
+        const common::Time &_start, const common::Time &_end)
+      {
+        EXPECT_LE(_start, _end);
+        std::lock_guard<std::mutex> lock(mutex);
+        sampled.push_back(_size);
+      });
+
+  // Sizes around and above the size of the chunks messages are read in
+  const std::vector<std::size_t> sizes = {1, 100, 65536, 65537, 1000000};
+  for (auto size : sizes)
+    accepted->EnqueueMsg(std::string(size, 'x'), true);
+
+  for (int i = 0; i < 500; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (sampled.size() >= sizes.size())
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(sampled, sizes);
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -20,6 +20,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/EventProfiler.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/transport/transport.hh"
 #include "gazebo/util/DiagnosticsPrivate.hh"
@@ -72,6 +73,9 @@ void DiagnosticManager::Fini()
 {
   this->dataPtr->updateConnection.reset();
 
+  event::EventProfiler::SetEnabled(false);
+  event::EventProfiler::Reset();
+
   this->dataPtr->timers.clear();
 
   this->dataPtr->pub.reset();
@@ -92,6 +96,26 @@ void DiagnosticManager::Init(const std::string &_worldName)
 
   this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
       std::bind(&DiagnosticManager::Update, this, std::placeholders::_1));
+
+  // Name the world update events for plugin timing reports
+  event::EventProfiler::SetEventName(&event::Events::worldUpdateBegin,
+      "worldUpdateBegin");
+  event::EventProfiler::SetEventName(&event::Events::beforePhysicsUpdate,
+      "beforePhysicsUpdate");
+  event::EventProfiler::SetEventName(&event::Events::worldUpdateEnd,
+      "worldUpdateEnd");
+}
+
+//////////////////////////////////////////////////
+void DiagnosticManager::SetPluginTimingEnabled(const bool _enable)
+{
+  this->dataPtr->pluginTiming = _enable;
+}
+
+//////////////////////////////////////////////////
+bool DiagnosticManager::PluginTimingEnabled() const
+{
+  return this->dataPtr->pluginTiming;
 }
 
 //////////////////////////////////////////////////
@@ -116,7 +140,39 @@ void DiagnosticManager::Update(const common::UpdateInfo &_info)
   msgs::Set(this->dataPtr->msg.mutable_real_time(), _info.realTime);
   msgs::Set(this->dataPtr->msg.mutable_sim_time(), _info.simTime);
 
-  if (this->dataPtr->pub && this->dataPtr->pub->HasConnections())
+  const bool hasConnections =
+    this->dataPtr->pub && this->dataPtr->pub->HasConnections();
+
+  // This callback is connected before any plugin is loaded, so it runs
+  // first in the step and closes the timing of the previous step.
+  const bool pluginTiming = this->dataPtr->pluginTiming || hasConnections;
+  if (pluginTiming)
+  {
+    event::EventProfiler::EndStep();
+    this->dataPtr->msg.clear_plugin_time();
+    for (auto const &stats : event::EventProfiler::Stats())
+    {
+      msgs::Diagnostics::PluginTime *pluginTime =
+        this->dataPtr->msg.add_plugin_time();
+      pluginTime->set_filename(stats.filename);
+      pluginTime->set_name(stats.name);
+      pluginTime->set_scope(stats.scope);
+      pluginTime->set_event(stats.event);
+      pluginTime->set_steps(stats.steps);
+      pluginTime->set_total(stats.total);
+      pluginTime->set_max(stats.max);
+      for (auto const &count : stats.histogram)
+        pluginTime->add_histogram(count);
+    }
+  }
+  else if (event::EventProfiler::Enabled())
+  {
+    event::EventProfiler::Reset();
+    this->dataPtr->msg.clear_plugin_time();
+  }
+  event::EventProfiler::SetEnabled(pluginTiming);
+
+  if (hasConnections)
     this->dataPtr->pub->Publish(this->dataPtr->msg);
 
   this->dataPtr->msg.clear_time();
@@ -126,6 +126,18 @@ namespace gazebo
       /// \return Label of the specified timer
       public: std::string Label(const int _index) const;
 
+      /// \brief Enable timing of plugin event callbacks. Timing is also
+      /// enabled automatically while the ~/diagnostics topic has
+      /// subscribers, e.g. `gz stats --plugins`.
+      /// \param[in] _enable True to enable plugin timing.
+      /// \sa event::EventProfiler
+      public: void SetPluginTimingEnabled(const bool _enable);
+
+      /// \brief Get whether plugin timing was explicitly enabled.
+      /// \return True if plugin timing was enabled with
+      /// SetPluginTimingEnabled.
+      public: bool PluginTimingEnabled() const;
+
       /// \brief Get the path in which logs are stored.
       /// \return The path in which logs are stored.
       public: boost::filesystem::path LogPath() const;
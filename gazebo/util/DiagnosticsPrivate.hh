@@ -53,6 +53,9 @@ namespace gazebo
 
       /// \brief Pointer to the update event connection
       public: event::ConnectionPtr updateConnection;
+
+      /// \brief True if plugin timing was explicitly enabled.
+      public: bool pluginTiming = false;
     };
 
     /// \brief Private data for the DiagnosticTimer class
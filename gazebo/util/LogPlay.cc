@@ -23,6 +23,7 @@
 #endif
 
 #include <algorithm>
+#include <iterator>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
@@ -45,6 +46,14 @@
 #include "gazebo/util/LogPlayPrivate.hh"
 #include "gazebo/util/LogPlay.hh"
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
+
 using namespace gazebo;
 using namespace util;
 
@@ -144,6 +153,20 @@ void LogPlay::Open(const std::string &_logFile)
   // Store the filename for future use.
   this->dataPtr->filename = _logFile;
 
+  // Index the chunks, so that they can be accessed directly.
+  this->dataPtr->chunks.clear();
+  this->dataPtr->chunkIndex = 0;
+
+  // Keyframes belong to the previous log file.
+  this->dataPtr->keyframes.clear();
+  this->dataPtr->keyframeBytes = 0;
+  this->dataPtr->keyframeInterval = this->dataPtr->kKeyframeInterval;
+  for (auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+       xml; xml = xml->NextSiblingElement("chunk"))
+  {
+    this->dataPtr->chunks.push_back(xml);
+  }
+
   // Read in the header.
   this->ReadHeader();
 
@@ -538,6 +561,7 @@ bool LogPlay::Rewind()
   this->dataPtr->currentChunk.clear();
   this->dataPtr->logCurrXml =
     this->dataPtr->logStartXml->FirstChildElement("chunk");
+  this->dataPtr->chunkIndex = 0;
 
   if (!this->dataPtr->logCurrXml)
   {
@@ -578,6 +602,7 @@ bool LogPlay::Forward()
   // Get the last chunk.
   this->dataPtr->logCurrXml =
     this->dataPtr->logStartXml->LastChildElement("chunk");
+  this->dataPtr->chunkIndex = this->ChunkCount() - 1;
 
   if (!this->dataPtr->logCurrXml)
   {
@@ -630,18 +655,8 @@ bool LogPlay::Seek(const common::Time &_time)
         return false;
 
       // Search the <sim_time> in the first frame of the current chunk.
-      auto from = frame.find(this->dataPtr->kStartTime);
-      auto to = frame.find(
-          this->dataPtr->kEndTime, from + this->dataPtr->kStartTime.size());
-      if (from != std::string::npos && to != std::string::npos)
-      {
-        auto length = to - from - this->dataPtr->kStartTime.size();
-        auto logTimeStr = frame.substr(
-            from + this->dataPtr->kStartTime.size(), length);
-        std::stringstream ss(logTimeStr);
-        ss >> logTime;
+      if (this->dataPtr->FrameTime(frame, logTime))
         break;
-      }
     }
 
     // Chunk found.
@@ -666,22 +681,146 @@ bool LogPlay::Seek(const common::Time &_time)
     if (!this->StepBack(frame))
       break;
 
-    // Search the <sim_time> in the frame of the current chunk.
-    auto from = frame.find(this->dataPtr->kStartTime);
-    auto to = frame.find(
-        this->dataPtr->kEndTime, from + this->dataPtr->kStartTime.size());
-    if (from != std::string::npos && to != std::string::npos)
+    // Search the <sim_time> in the frame of the current chunk, until the
+    // frame is found.
+    if (this->dataPtr->FrameTime(frame, logTime) && logTime < _time)
+      break;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void LogPlay::SetKeyframeMemory(const size_t _bytes)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->keyframeMemory = _bytes;
+  this->dataPtr->ThinKeyframes();
+}
+
+/////////////////////////////////////////////////
+size_t LogPlay::KeyframeMemory() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->keyframeMemory;
+}
+
+/////////////////////////////////////////////////
+unsigned int LogPlay::KeyframeCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return static_cast<unsigned int>(this->dataPtr->keyframes.size());
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::KeyframeDue(const common::Time &_time) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  if (this->dataPtr->keyframeMemory == 0)
+    return false;
+
+  // Check the closest keyframes on both sides, since the log may have been
+  // played from anywhere.
+  auto next = this->dataPtr->keyframes.lower_bound(_time);
+  if (next != this->dataPtr->keyframes.end() &&
+      next->first - _time < this->dataPtr->keyframeInterval)
+  {
+    return false;
+  }
+
+  if (next != this->dataPtr->keyframes.begin() &&
+      _time - std::prev(next)->first < this->dataPtr->keyframeInterval)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void LogPlay::AddKeyframe(const common::Time &_time,
+    const std::string &_state)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  if (this->dataPtr->keyframeMemory == 0 || this->dataPtr->chunks.empty())
+    return;
+
+  auto &keyframe = this->dataPtr->keyframes[_time];
+  this->dataPtr->keyframeBytes -= keyframe.state.size();
+  this->dataPtr->keyframeBytes += _state.size();
+  keyframe.state = _state;
+  keyframe.chunk = this->dataPtr->chunkIndex;
+  keyframe.offset = this->dataPtr->currentChunk.size() - this->dataPtr->end;
+
+  this->dataPtr->ThinKeyframes();
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::SeekKeyframe(const common::Time &_time,
+    std::string &_keyframe, std::vector<std::string> &_frames)
+{
+  _frames.clear();
+
+  // Past the end of the log, the next step plays the last frame.
+  common::Time time = _time;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+    time = std::min(time, this->dataPtr->logEndTime);
+
+    // Last keyframe before the target time.
+    auto iter = this->dataPtr->keyframes.lower_bound(time);
+    if (iter == this->dataPtr->keyframes.begin())
+      return false;
+    --iter;
+
+    const LogPlayPrivate::Keyframe &keyframe = iter->second;
+
+    // Scrubbing often stays in the same chunk, which is then already
+    // decoded.
+    if (keyframe.chunk != this->dataPtr->chunkIndex ||
+        this->dataPtr->currentChunk.empty())
     {
-      auto length = to - from - this->dataPtr->kStartTime.size();
-      auto logTimeStr = frame.substr(
-          from + this->dataPtr->kStartTime.size(), length);
-      std::stringstream ss(logTimeStr);
-      ss >> logTime;
+      this->dataPtr->logCurrXml = this->dataPtr->chunks[keyframe.chunk];
+      this->dataPtr->chunkIndex = keyframe.chunk;
+      if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+                                    this->dataPtr->currentChunk))
+      {
+        this->dataPtr->currentChunk.clear();
+        return false;
+      }
+    }
 
-      // frame found.
-      if (logTime < _time)
-        break;
+    if (keyframe.offset > this->dataPtr->currentChunk.size())
+    {
+      gzerr << "Invalid keyframe position in chunk[" << keyframe.chunk
+            << "]\n";
+      return false;
+    }
+
+    this->dataPtr->end = this->dataPtr->currentChunk.size() - keyframe.offset;
+    this->dataPtr->start = this->dataPtr->currentChunk.rfind(
+        this->dataPtr->kStartFrame, this->dataPtr->end);
+    if (this->dataPtr->start == std::string::npos)
+      this->dataPtr->start = 0;
+
+    _keyframe = keyframe.state;
+  }
+
+  // Collect the frames up to the target, and leave the next one for Step.
+  std::string frame;
+  while (this->Step(frame))
+  {
+    common::Time frameTime;
+    if (this->dataPtr->FrameTime(frame, frameTime) && frameTime >= time)
+    {
+      this->StepBack(frame);
+      break;
     }
+    _frames.push_back(frame);
   }
 
   return true;
@@ -690,21 +829,23 @@ bool LogPlay::Seek(const common::Time &_time)
 /////////////////////////////////////////////////
 bool LogPlay::Chunk(unsigned int _index, std::string &_data) const
 {
-  unsigned int count = 0;
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
+  if (_index >= this->dataPtr->chunks.size())
+    return false;
 
-  while (this->dataPtr->logCurrXml && count < _index)
-  {
-    count++;
-    this->dataPtr->logCurrXml =
-      this->dataPtr->logCurrXml->NextSiblingElement("chunk");
-  }
+  this->dataPtr->logCurrXml = this->dataPtr->chunks[_index];
+  this->dataPtr->chunkIndex = _index;
+  return this->dataPtr->ChunkData(this->dataPtr->logCurrXml, _data);
+}
 
-  if (this->dataPtr->logCurrXml && count == _index)
-    return this->dataPtr->ChunkData(this->dataPtr->logCurrXml, _data);
-  else
+/////////////////////////////////////////////////
+bool LogPlay::DecodeChunk(const unsigned int _index, std::string &_data) const
+{
+  if (_index >= this->dataPtr->chunks.size())
     return false;
+
+  std::string encoding;
+  return this->dataPtr->DecodeChunk(this->dataPtr->chunks[_index], encoding,
+      _data);
 }
 
 /////////////////////////////////////////////////
@@ -719,24 +860,38 @@ bool LogPlayPrivate::ChunkData(
     return false;
   }
 
+  return this->DecodeChunk(_xml, this->encoding, _data);
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::DecodeChunk(
+    const tinyxml2::XMLElement *_xml,
+    std::string &_encoding,
+    std::string &_data) const
+{
+  if (!_xml)
+    return false;
+
   /// Get the chunk's encoding
-  this->encoding = _xml->Attribute("encoding");
+  const char *encoding = _xml->Attribute("encoding");
+  _encoding = encoding ? encoding : "";
 
   // Make sure there is an encoding value.
-  if (this->encoding.empty())
+  if (_encoding.empty())
   {
     gzthrow("Encoding missing for a chunk in log file[" + this->filename + "]");
   }
 
-  if (this->encoding == "txt")
-    _data = _xml->GetText();
-  else if (this->encoding == "bz2")
-  {
-    std::string data = _xml->GetText();
-    std::string buffer;
+  const char *text = _xml->GetText();
+  if (!text)
+    text = "";
 
+  if (_encoding == "txt")
+    _data = text;
+  else if (_encoding == "bz2")
+  {
     // Decode the base64 string
-    buffer = Base64Decode(data);
+    std::string buffer = Base64Decode(text);
 
     // Decompress the bz2 data
     {
@@ -749,13 +904,10 @@ bool LogPlayPrivate::ChunkData(
       _data += '\0';
     }
   }
-  else if (this->encoding == "zlib")
+  else if (_encoding == "zlib")
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
-
     // Decode the base64 string
-    buffer = Base64Decode(data);
+    std::string buffer = Base64Decode(text);
 
     // Decompress the zlib data
     {
@@ -768,9 +920,78 @@ bool LogPlayPrivate::ChunkData(
       _data += '\0';
     }
   }
+#ifdef HAVE_ZSTD
+  else if (_encoding == "zstd")
+  {
+    // Decode the base64 string
+    std::string buffer = Base64Decode(text);
+
+    // Decompress the zstd data, which stores its size
+    const auto size = ZSTD_getFrameContentSize(buffer.data(), buffer.size());
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN)
+    {
+      gzerr << "Invalid zstd chunk in log file[" << this->filename << "]\n";
+      return false;
+    }
+
+    _data.resize(size);
+    const size_t result = ZSTD_decompress(&_data[0], _data.size(),
+        buffer.data(), buffer.size());
+    if (ZSTD_isError(result))
+    {
+      gzerr << "Unable to decompress chunk in log file[" << this->filename
+            << "]: " << ZSTD_getErrorName(result) << std::endl;
+      return false;
+    }
+    _data.resize(result);
+    _data += '\0';
+  }
+#endif
+#ifdef HAVE_LZ4
+  else if (_encoding == "lz4")
+  {
+    // Decode the base64 string
+    std::string buffer = Base64Decode(text);
+
+    LZ4F_dctx *context = nullptr;
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)))
+    {
+      gzerr << "Unable to create lz4 decompression context\n";
+      return false;
+    }
+
+    // Decompress the lz4 frame
+    _data.clear();
+    char out[65536];
+    const char *in = buffer.data();
+    size_t inSize = buffer.size();
+    size_t result = 1;
+    while (result != 0)
+    {
+      size_t outUsed = sizeof(out);
+      size_t inUsed = inSize;
+      result = LZ4F_decompress(context, out, &outUsed, in, &inUsed, nullptr);
+      if (LZ4F_isError(result) || (outUsed == 0 && inUsed == 0))
+        break;
+
+      _data.append(out, outUsed);
+      in += inUsed;
+      inSize -= inUsed;
+    }
+    LZ4F_freeDecompressionContext(context);
+
+    if (result != 0)
+    {
+      gzerr << "Unable to decompress chunk in log file[" << this->filename
+            << "]\n";
+      return false;
+    }
+    _data += '\0';
+  }
+#endif
   else
   {
-    gzerr << "Invalid encoding[" << this->encoding << "] in log file["
+    gzerr << "Invalid encoding[" << _encoding << "] in log file["
       << this->filename << "]\n";
     return false;
   }
@@ -779,24 +1000,62 @@ bool LogPlayPrivate::ChunkData(
 }
 
 /////////////////////////////////////////////////
-std::string LogPlay::Encoding() const
+bool LogPlayPrivate::FrameTime(const std::string &_frame,
+    common::Time &_time) const
 {
-  return this->dataPtr->encoding;
+  auto from = _frame.find(this->kStartTime);
+  if (from == std::string::npos)
+    return false;
+
+  from += this->kStartTime.size();
+  auto to = _frame.find(this->kEndTime, from);
+  if (to == std::string::npos)
+    return false;
+
+  std::stringstream ss(_frame.substr(from, to - from));
+  ss >> _time;
+  return true;
 }
 
 /////////////////////////////////////////////////
-unsigned int LogPlay::ChunkCount() const
+void LogPlayPrivate::ThinKeyframes()
 {
-  unsigned int count = 0;
-  auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
-
-  while (xml)
+  while (this->keyframeBytes > this->keyframeMemory)
   {
-    count++;
-    xml = xml->NextSiblingElement("chunk");
+    // A single keyframe over the budget can't be thinned.
+    if (this->keyframes.size() <= 1)
+    {
+      this->keyframes.clear();
+      this->keyframeBytes = 0;
+      break;
+    }
+
+    // Keep keyframes spread over the log, at twice the interval.
+    this->keyframeInterval = common::Time(this->keyframeInterval.Double() * 2);
+    auto kept = this->keyframes.begin();
+    for (auto iter = std::next(kept); iter != this->keyframes.end();)
+    {
+      if (iter->first - kept->first < this->keyframeInterval)
+      {
+        this->keyframeBytes -= iter->second.state.size();
+        iter = this->keyframes.erase(iter);
+      }
+      else
+        kept = iter++;
+    }
   }
+}
+
+/////////////////////////////////////////////////
+std::string LogPlay::Encoding() const
+{
+  return this->dataPtr->encoding;
+}
 
-  return count;
+/////////////////////////////////////////////////
+unsigned int LogPlay::ChunkCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->chunks.size());
 }
 
 /////////////////////////////////////////////////
@@ -807,6 +1066,7 @@ bool LogPlay::NextChunk()
     return false;
 
   this->dataPtr->logCurrXml = next;
+  ++this->dataPtr->chunkIndex;
   if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
                                 this->dataPtr->currentChunk))
   {
@@ -827,6 +1087,7 @@ bool LogPlay::PrevChunk()
     return false;
 
   this->dataPtr->logCurrXml = prev;
+  --this->dataPtr->chunkIndex;
   if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
                                 this->dataPtr->currentChunk))
   {
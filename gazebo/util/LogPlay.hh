@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gazebo/common/SingletonT.hh"
 #include "gazebo/common/Time.hh"
@@ -121,6 +122,52 @@ namespace gazebo
       /// \return True if operation succeed or false otherwise.
       public: bool Seek(const common::Time &_time);
 
+      /// \brief Jump to the last keyframe before a time, and get the frames
+      /// between the keyframe and that time. The next Step() call will return
+      /// the first frame at or after the time, or the last frame for times
+      /// past the end of the log. Applying the keyframe and the
+      /// frames reproduces the state of the world at that time, including
+      /// the entities inserted and deleted in between.
+      /// \param[in] _time Target simulation time.
+      /// \param[out] _keyframe Full state of the world at the keyframe, as a
+      /// log frame.
+      /// \param[out] _frames Frames between the keyframe and the target time.
+      /// \return False if there is no keyframe before the time, in which case
+      /// Seek should be used.
+      /// \sa AddKeyframe
+      public: bool SeekKeyframe(const common::Time &_time,
+                  std::string &_keyframe, std::vector<std::string> &_frames);
+
+      /// \brief Check if a keyframe should be added at a time, which is the
+      /// case when no keyframe is within the keyframe interval of it.
+      /// \param[in] _time Simulation time of the frame last returned by
+      /// Step().
+      /// \return True if a keyframe should be added.
+      public: bool KeyframeDue(const common::Time &_time) const;
+
+      /// \brief Cache the full state of the world after the frame last
+      /// returned by Step(), so that SeekKeyframe can start from it. Keyframes
+      /// are built while the log is played, and are dropped when another log
+      /// file is opened.
+      /// \param[in] _time Simulation time of the frame.
+      /// \param[in] _state Full state of the world, as a log frame.
+      public: void AddKeyframe(const common::Time &_time,
+                  const std::string &_state);
+
+      /// \brief Set the maximum memory used by keyframes. When they don't
+      /// fit, the interval between keyframes is doubled and the keyframes
+      /// closer than that are dropped.
+      /// \param[in] _bytes Memory in bytes, 0 to disable keyframes.
+      public: void SetKeyframeMemory(const size_t _bytes);
+
+      /// \brief Get the maximum memory used by keyframes.
+      /// \return Memory in bytes.
+      public: size_t KeyframeMemory() const;
+
+      /// \brief Get the number of cached keyframes.
+      /// \return Number of keyframes.
+      public: unsigned int KeyframeCount() const;
+
       /// \brief Jump to the beginning of the log file. The next step() call
       /// will return the first data "chunk".
       /// \return True If the function succeed or false otherwise.
@@ -140,6 +187,15 @@ namespace gazebo
       /// \return True if the _index was valid.
       public: bool Chunk(const unsigned int _index, std::string &_data) const;
 
+      /// \brief Decode the data of a chunk without moving the playback
+      /// position or changing the current encoding. Unlike Chunk, this
+      /// function can be called from multiple threads at the same time.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return True if the _index was valid and the chunk was decoded.
+      public: bool DecodeChunk(const unsigned int _index,
+                  std::string &_data) const;
+
       /// \brief Get the type of encoding used for current chunck in the
       /// open log file.
       /// \return The type of encoding. An empty string will be returned if
@@ -25,8 +25,10 @@
 #include <tinyxml2.h>
 #endif
 
+#include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "gazebo/common/Time.hh"
 #include "gazebo/util/system.hh"
@@ -39,6 +41,21 @@ namespace gazebo
     /// \brief Private data for log play
     class LogPlayPrivate
     {
+      /// \brief Full state of the world cached at a frame of the log.
+      public: class Keyframe
+      {
+        /// \brief The state, as a log frame.
+        public: std::string state;
+
+        /// \brief Index of the chunk that contains the frame.
+        public: unsigned int chunk = 0;
+
+        /// \brief Distance from the end of the frame to the end of the
+        /// decoded chunk. Unlike the distance from the beginning, it doesn't
+        /// change when Rewind removes the header frame of the first chunk.
+        public: size_t offset = 0;
+      };
+
       /// \brief Helper function to get chunk data from XML.
       /// \param[in] _xml Pointer to an xml block that has state data.
       /// \param[out] _data Storage for the chunk's data.
@@ -47,6 +64,28 @@ namespace gazebo
                   tinyxml2::XMLElement *_xml,
                   std::string &_data);
 
+      /// \brief Decode the data of a chunk without changing the state of
+      /// the playback. Safe to call from multiple threads.
+      /// \param[in] _xml Pointer to an xml block that has state data.
+      /// \param[out] _encoding Encoding of the chunk.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return True if the chunk was successfully decoded.
+      public: bool DecodeChunk(
+                  const tinyxml2::XMLElement *_xml,
+                  std::string &_encoding,
+                  std::string &_data) const;
+
+      /// \brief Get the simulation time of a frame.
+      /// \param[in] _frame The frame.
+      /// \param[out] _time Simulation time of the frame.
+      /// \return True if the frame has a simulation time.
+      public: bool FrameTime(const std::string &_frame,
+                  common::Time &_time) const;
+
+      /// \brief Drop keyframes until they fit in the keyframe memory,
+      /// doubling the keyframe interval each time.
+      public: void ThinKeyframes();
+
       /// \brief Max number of chunks to inspect when looking for XML elements.
       public: const unsigned int kNumChunksToTry = 2u;
 
@@ -68,9 +107,15 @@ namespace gazebo
       /// \brief Start of the log.
       public: tinyxml2::XMLElement *logStartXml = nullptr;
 
+      /// \brief All chunks of the log, in order.
+      public: std::vector<tinyxml2::XMLElement *> chunks;
+
       /// \brief Current position in the log file.
       public: tinyxml2::XMLElement *logCurrXml = nullptr;
 
+      /// \brief Index of logCurrXml in chunks.
+      public: unsigned int chunkIndex = 0;
+
       /// \brief Name of the log file.
       public: std::string filename;
 
@@ -111,6 +156,21 @@ namespace gazebo
       /// may not include this tag in the log files.
       public: bool iterationsFound = false;
 
+      /// \brief Default interval between keyframes (simulation time).
+      public: const common::Time kKeyframeInterval = common::Time(0.1);
+
+      /// \brief Cached keyframes, by simulation time.
+      public: std::map<common::Time, Keyframe> keyframes;
+
+      /// \brief Memory used by the states of the keyframes, in bytes.
+      public: size_t keyframeBytes = 0;
+
+      /// \brief Maximum memory used by the states of the keyframes, in bytes.
+      public: size_t keyframeMemory = 256u * 1024u * 1024u;
+
+      /// \brief Minimum simulation time between two keyframes.
+      public: common::Time keyframeInterval = kKeyframeInterval;
+
       /// \brief A mutex to avoid race conditions.
       public: std::mutex mutex;
     };
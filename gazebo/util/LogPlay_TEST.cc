@@ -17,8 +17,10 @@
 
 #include <gtest/gtest.h>
 #include <boost/filesystem.hpp>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/util/LogPlay.hh"
@@ -146,6 +148,54 @@ TEST_F(LogPlay_TEST, Chunks)
   EXPECT_FALSE(player->Chunk(player->ChunkCount(), chunk));
 }
 
+/////////////////////////////////////////////////
+/// \brief Test decoding chunks from several threads.
+TEST_F(LogPlay_TEST, DecodeChunk)
+{
+  gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+
+  boost::filesystem::path logFilePath(TEST_PATH);
+  logFilePath /= boost::filesystem::path("logs");
+  logFilePath /= boost::filesystem::path("state.log");
+
+  EXPECT_NO_THROW(player->Open(logFilePath.string()));
+
+  const unsigned int count = player->ChunkCount();
+  ASSERT_GT(count, 0u);
+
+  // Expected data, read sequentially
+  std::vector<std::string> expected(count);
+  for (unsigned int i = 0; i < count; ++i)
+    EXPECT_TRUE(player->Chunk(i, expected[i]));
+
+  // Decoding doesn't change the encoding of the current chunk
+  EXPECT_TRUE(player->Rewind());
+  std::string frame;
+  EXPECT_TRUE(player->Step(frame));
+  const std::string encoding = player->Encoding();
+
+  std::vector<std::string> decoded(count);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < 4; ++t)
+  {
+    threads.push_back(std::thread([&, t]()
+    {
+      for (unsigned int i = t; i < count; i += 4)
+        EXPECT_TRUE(player->DecodeChunk(i, decoded[i]));
+    }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (unsigned int i = 0; i < count; ++i)
+    EXPECT_EQ(decoded[i], expected[i]);
+  EXPECT_EQ(player->Encoding(), encoding);
+
+  // Invalid indexes
+  std::string chunk;
+  EXPECT_FALSE(player->DecodeChunk(count, chunk));
+}
+
 /////////////////////////////////////////////////
 /// \brief Test Rewind().
 TEST_F(LogPlay_TEST, Rewind)
@@ -406,6 +456,96 @@ TEST_F(LogPlay_TEST, Seek)
   EXPECT_EQ(shasum, expectedShashum4);
 }
 
+/////////////////////////////////////////////////
+/// \brief Get the simulation time of a frame.
+/// \param[in] _frame The frame.
+/// \param[out] _time Simulation time of the frame.
+/// \return True if the frame has a simulation time.
+static bool FrameTime(const std::string &_frame, common::Time &_time)
+{
+  auto from = _frame.find("<sim_time>");
+  auto to = _frame.find("</sim_time>");
+  if (from == std::string::npos || to == std::string::npos)
+    return false;
+
+  std::stringstream ss(_frame.substr(from + 10, to - from - 10));
+  ss >> _time;
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Test SeekKeyframe().
+TEST_F(LogPlay_TEST, Keyframes)
+{
+  gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+
+  // Open a correct log file.
+  boost::filesystem::path logFilePath(TEST_PATH);
+  logFilePath /= boost::filesystem::path("logs");
+  logFilePath /= boost::filesystem::path("state.log");
+
+  EXPECT_NO_THROW(player->Open(logFilePath.string()));
+  EXPECT_EQ(player->KeyframeMemory(), 256u * 1024u * 1024u);
+  EXPECT_EQ(player->KeyframeCount(), 0u);
+
+  // No keyframes yet.
+  std::string keyframe;
+  std::vector<std::string> frames;
+  EXPECT_FALSE(player->SeekKeyframe(common::Time(30.0), keyframe, frames));
+
+  // Play the log and use the frames as keyframes.
+  std::string frame;
+  common::Time frameTime;
+  while (player->Step(frame))
+  {
+    if (FrameTime(frame, frameTime) && player->KeyframeDue(frameTime))
+      player->AddKeyframe(frameTime, frame);
+  }
+  EXPECT_GT(player->KeyframeCount(), 10u);
+  EXPECT_FALSE(player->KeyframeDue(frameTime));
+
+  // The next step returns the same frame as after Seek.
+  EXPECT_TRUE(player->SeekKeyframe(common::Time(30.0), keyframe, frames));
+  ASSERT_TRUE(FrameTime(keyframe, frameTime));
+  EXPECT_LT(frameTime, common::Time(30.0));
+  for (auto const &f : frames)
+  {
+    ASSERT_TRUE(FrameTime(f, frameTime));
+    EXPECT_LT(frameTime, common::Time(30.0));
+  }
+  EXPECT_TRUE(player->Step(frame));
+  std::string shasum = gazebo::common::get_sha1<std::string>(frame);
+  EXPECT_EQ(shasum, "a2af44bc561194dfeae9526c224d56bb332a4233");
+
+  // Seeking backwards.
+  EXPECT_TRUE(player->SeekKeyframe(common::Time(29.0), keyframe, frames));
+  ASSERT_TRUE(player->Step(frame));
+  ASSERT_TRUE(FrameTime(frame, frameTime));
+  EXPECT_GE(frameTime, common::Time(29.0));
+
+  // Seek handles times before the first keyframe.
+  EXPECT_FALSE(player->SeekKeyframe(common::Time(25.0), keyframe, frames));
+
+  // After the end of the log, the next step returns the last frame, as
+  // after Seek.
+  EXPECT_TRUE(player->SeekKeyframe(common::Time(35.0), keyframe, frames));
+  EXPECT_TRUE(player->Step(frame));
+  shasum = gazebo::common::get_sha1<std::string>(frame);
+  EXPECT_EQ(shasum, "961cf9dcd38c12f33a8b2f3a3a6fdb879b2faa98");
+
+  // Keyframes are thinned to fit in memory.
+  const unsigned int count = player->KeyframeCount();
+  player->SetKeyframeMemory(keyframe.size() * count / 3);
+  EXPECT_LT(player->KeyframeCount(), count);
+  EXPECT_GT(player->KeyframeCount(), 0u);
+
+  player->SetKeyframeMemory(0);
+  EXPECT_EQ(player->KeyframeCount(), 0u);
+  EXPECT_FALSE(player->KeyframeDue(frameTime));
+
+  player->SetKeyframeMemory(256u * 1024u * 1024u);
+}
+
 /////////////////////////////////////////////////
 /// \brief Test reading a log file that is missing the closing </gazebo_log>
 /// tag
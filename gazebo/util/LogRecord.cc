@@ -25,6 +25,8 @@
   #define access _access
 #endif
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 
 #include <boost/archive/iterators/base64_from_binary.hpp>
@@ -55,9 +57,44 @@
 #include "gazebo/util/LogRecordPrivate.hh"
 #include "gazebo/util/LogRecord.hh"
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef HAVE_LZ4
+#include <lz4frame.h>
+#endif
+
 using namespace gazebo;
 using namespace util;
 
+/// \brief Encodings of the log data, as listed in error messages.
+static const char *kEncodings = "bz2, zlib, txt"
+#ifdef HAVE_ZSTD
+  ", zstd"
+#endif
+#ifdef HAVE_LZ4
+  ", lz4"
+#endif
+  ;
+
+//////////////////////////////////////////////////
+/// \brief Check if log data can be written with an encoding.
+/// \param[in] _encoding The encoding.
+/// \return True if the encoding is supported.
+static bool ValidEncoding(const std::string &_encoding)
+{
+#ifdef HAVE_ZSTD
+  if (_encoding == "zstd")
+    return true;
+#endif
+#ifdef HAVE_LZ4
+  if (_encoding == "lz4")
+    return true;
+#endif
+  return _encoding == "bz2" || _encoding == "txt" || _encoding == "zlib";
+}
+
 //////////////////////////////////////////////////
 LogRecord::LogRecord()
 : dataPtr(new LogRecordPrivate)
@@ -93,6 +130,12 @@ LogRecord::LogRecord()
 
   this->dataPtr->logsEnd = this->dataPtr->logs.end();
 
+  // Write the chunks as soon as they are encoded.
+  this->dataPtr->encoder.encodedCallback = [this]()
+  {
+    this->dataPtr->dataAvailableCondition.notify_one();
+  };
+
   this->dataPtr->connections.push_back(
      event::Events::ConnectPause(
        std::bind(&LogRecord::OnPause, this, std::placeholders::_1)));
@@ -186,9 +229,11 @@ bool LogRecord::Start(const std::string &_encoding, const std::string &_path)
   if (!boost::filesystem::exists(this->dataPtr->logCompletePath))
     boost::filesystem::create_directories(this->dataPtr->logCompletePath);
 
-  if (_encoding != "bz2" && _encoding != "txt" && _encoding != "zlib")
+  if (!ValidEncoding(_encoding))
+  {
     gzthrow("Invalid log encoding[" + _encoding +
-            "]. Must be one of [bz2, zlib, txt]");
+            "]. Must be one of [" + kEncodings + "]");
+  }
 
   this->dataPtr->encoding = _encoding;
 
@@ -383,6 +428,7 @@ void LogRecord::Add(const std::string &_name, const std::string &_filename,
   try
   {
     newLog = new LogRecordPrivate::Log(this, _filename, _logCallback);
+    newLog->encoder = &this->dataPtr->encoder;
   }
   catch(...)
   {
@@ -747,7 +793,7 @@ void LogRecord::RunWrite()
 }
 
 //////////////////////////////////////////////////
-void LogRecord::Write(const bool /*_force*/)
+void LogRecord::Write(const bool _force)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->writeMutex);
 
@@ -756,7 +802,7 @@ void LogRecord::Write(const bool /*_force*/)
       this->dataPtr->updateIter != this->dataPtr->logsEnd;
       ++this->dataPtr->updateIter)
   {
-    this->dataPtr->updateIter->second->Write();
+    this->dataPtr->updateIter->second->Write(_force);
   }
 }
 
@@ -766,6 +812,176 @@ common::Time LogRecord::RunTime() const
   return this->dataPtr->currTime - this->dataPtr->startTime;
 }
 
+//////////////////////////////////////////////////
+LogRecordPrivate::ChunkEncoder::~ChunkEncoder()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = true;
+  }
+  this->queueCondition.notify_all();
+
+  for (auto &worker : this->workers)
+    worker.join();
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::ChunkEncoder::Push(std::shared_ptr<Chunk> _chunk)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (this->workers.empty())
+    {
+      const unsigned int count =
+          std::max(1u, std::min(4u, std::thread::hardware_concurrency()));
+      for (unsigned int i = 0; i < count; ++i)
+        this->workers.push_back(std::thread(&ChunkEncoder::Run, this));
+    }
+
+    // A few chunks per worker keep them busy.
+    if (this->queue.size() < this->workers.size() * 2)
+    {
+      this->queue.push_back(_chunk);
+      this->queueCondition.notify_one();
+      return;
+    }
+  }
+
+  // The workers fell behind, so encode on this thread.
+  Encode(*_chunk);
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  _chunk->encoded = true;
+  this->encodedCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+bool LogRecordPrivate::ChunkEncoder::Encoded(const Chunk &_chunk)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return _chunk.encoded;
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::ChunkEncoder::Wait(const Chunk &_chunk)
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  this->encodedCondition.wait(lock, [&_chunk]
+  {
+    return _chunk.encoded;
+  });
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::ChunkEncoder::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->queueCondition.wait(lock, [this]
+    {
+      return this->stop || !this->queue.empty();
+    });
+
+    // Finish the queued chunks before stopping, Wait would block on them
+    // otherwise.
+    if (this->queue.empty())
+      break;
+
+    std::shared_ptr<Chunk> chunk = this->queue.front();
+    this->queue.pop_front();
+
+    lock.unlock();
+    Encode(*chunk);
+    lock.lock();
+
+    chunk->encoded = true;
+    this->encodedCondition.notify_all();
+
+    if (this->encodedCallback)
+    {
+      lock.unlock();
+      this->encodedCallback();
+      lock.lock();
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void LogRecordPrivate::ChunkEncoder::Encode(Chunk &_chunk)
+{
+  std::string element = "<chunk encoding='" + _chunk.encoding + "'>\n";
+  element.append("<![CDATA[");
+
+  // Compress the data. The compressed data is encoded in base64 to fit in
+  // the XML document.
+  std::string str;
+  if (_chunk.encoding == "bz2")
+  {
+    // Compress to bzip2
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::bzip2_compressor());
+    out.push(std::back_inserter(str));
+    boost::iostreams::copy(boost::make_iterator_range(_chunk.data), out);
+  }
+  else if (_chunk.encoding == "zlib")
+  {
+    // Compress to zlib
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::zlib_compressor());
+    out.push(std::back_inserter(str));
+    boost::iostreams::copy(boost::make_iterator_range(_chunk.data), out);
+  }
+#ifdef HAVE_ZSTD
+  else if (_chunk.encoding == "zstd")
+  {
+    str.resize(ZSTD_compressBound(_chunk.data.size()));
+    size_t size = ZSTD_compress(&str[0], str.size(),
+        _chunk.data.data(), _chunk.data.size(), ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(size))
+    {
+      gzerr << "Unable to compress log data: " << ZSTD_getErrorName(size)
+            << std::endl;
+      size = 0;
+    }
+    str.resize(size);
+  }
+#endif
+#ifdef HAVE_LZ4
+  else if (_chunk.encoding == "lz4")
+  {
+    // The frame stores the content size, so that it's checked when reading
+    LZ4F_preferences_t prefs;
+    std::memset(&prefs, 0, sizeof(prefs));
+    prefs.frameInfo.contentSize = _chunk.data.size();
+
+    str.resize(LZ4F_compressFrameBound(_chunk.data.size(), &prefs));
+    size_t size = LZ4F_compressFrame(&str[0], str.size(),
+        _chunk.data.data(), _chunk.data.size(), &prefs);
+    if (LZ4F_isError(size))
+    {
+      gzerr << "Unable to compress log data: " << LZ4F_getErrorName(size)
+            << std::endl;
+      size = 0;
+    }
+    str.resize(size);
+  }
+#endif
+  else if (_chunk.encoding == "txt")
+    element.append(_chunk.data);
+  else
+    gzerr << "Unknown log file encoding[" << _chunk.encoding << "]\n";
+
+  if (!str.empty())
+    Base64Encode(str.c_str(), str.size(), element);
+
+  element.append("]]>\n");
+  element.append("</chunk>\n");
+
+  _chunk.data.swap(element);
+}
+
 //////////////////////////////////////////////////
 LogRecordPrivate::Log::Log(LogRecord *_parent,
     const std::string &_relativeFilename,
@@ -791,70 +1007,41 @@ unsigned int LogRecordPrivate::Log::Update()
   // Get log data via the callback.
   if (this->logCB(stream))
   {
-    std::string data = stream.str();
-    if (!data.empty())
+    auto chunk = std::make_shared<Chunk>();
+    chunk->data = stream.str();
+    if (!chunk->data.empty())
     {
-      const std::string &encodingLocal = this->parent->Encoding();
-
-      this->buffer.append("<chunk encoding='");
-      this->buffer.append(encodingLocal);
-      this->buffer.append("'>\n");
-
-      this->buffer.append("<![CDATA[");
-      // Compress the data.
-      if (encodingLocal == "bz2")
-      {
-        std::string str;
-
-        // Compress to bzip2
-        {
-          boost::iostreams::filtering_ostream out;
-          out.push(boost::iostreams::bzip2_compressor());
-          out.push(std::back_inserter(str));
-          boost::iostreams::copy(boost::make_iterator_range(data), out);
-        }
-
-        // Encode in base64.
-        Base64Encode(str.c_str(), str.size(), this->buffer);
-      }
-      else if (encodingLocal == "zlib")
+      chunk->encoding = this->parent->Encoding();
+      chunk->size = chunk->data.size();
+      this->chunksSize += chunk->size;
+      this->chunks.push_back(chunk);
+
+      // Compression runs on the encoder threads, Write keeps the order.
+      if (this->encoder)
+        this->encoder->Push(chunk);
+      else
       {
-        std::string str;
-
-        // Compress to zlib
-        {
-          boost::iostreams::filtering_ostream out;
-          out.push(boost::iostreams::zlib_compressor());
-          out.push(std::back_inserter(str));
-          boost::iostreams::copy(boost::make_iterator_range(data), out);
-        }
-
-        // Encode in base64.
-        Base64Encode(str.c_str(), str.size(), this->buffer);
+        ChunkEncoder::Encode(*chunk);
+        chunk->encoded = true;
       }
-      else if (encodingLocal == "txt")
-        this->buffer.append(data);
-      else
-        gzerr << "Unknown log file encoding[" << encodingLocal << "]\n";
-      this->buffer.append("]]>\n");
-
-      this->buffer.append("</chunk>\n");
     }
   }
 
-  return this->buffer.size();
+  return this->BufferSize();
 }
 
 //////////////////////////////////////////////////
 void LogRecordPrivate::Log::ClearBuffer()
 {
+  this->chunks.clear();
+  this->chunksSize = 0;
   this->buffer.clear();
 }
 
 //////////////////////////////////////////////////
 unsigned int LogRecordPrivate::Log::BufferSize()
 {
-  return this->buffer.size();
+  return this->buffer.size() + this->chunksSize;
 }
 
 //////////////////////////////////////////////////
@@ -875,7 +1062,7 @@ void LogRecordPrivate::Log::Stop()
   if (this->logFile.is_open())
   {
     this->Update();
-    this->Write();
+    this->Write(true);
 
     std::string xmlEnd = "</gazebo_log>";
     this->logFile.write(xmlEnd.c_str(), xmlEnd.size());
@@ -910,7 +1097,7 @@ void LogRecordPrivate::Log::Start(const boost::filesystem::path &_path)
 }
 
 //////////////////////////////////////////////////
-void LogRecordPrivate::Log::Write()
+void LogRecordPrivate::Log::Write(const bool _wait)
 {
   // Make sure the file is open for writing
   if (!this->logFile.is_open())
@@ -933,10 +1120,27 @@ void LogRecordPrivate::Log::Write()
           << "Unable to write log data.\n";
 
     // We have to clear the buffer, or else it may grow indefinitely.
-    this->buffer.clear();
+    this->ClearBuffer();
     return;
   }
 
+  // Append the encoded chunks in order.
+  while (!this->chunks.empty())
+  {
+    const Chunk &chunk = *this->chunks.front();
+    if (this->encoder)
+    {
+      if (_wait)
+        this->encoder->Wait(chunk);
+      else if (!this->encoder->Encoded(chunk))
+        break;
+    }
+
+    this->buffer.append(chunk.data);
+    this->chunksSize -= chunk.size;
+    this->chunks.pop_front();
+  }
+
   // Write out the contents of the buffer.
   this->logFile.write(this->buffer.c_str(), this->buffer.size());
   this->logFile.flush();
@@ -38,7 +38,8 @@ namespace gazebo
     /// \sa LogRecord::Start
     class LogRecordParams
     {
-      /// \brief The type of encoding (txt, zlib, or bz2).
+      /// \brief The type of encoding (txt, zlib, bz2, or zstd and lz4 when
+      /// Gazebo is built with them).
       public: std::string encoding = "zlib";
 
       /// \brief Path in which to store log files.
@@ -176,14 +177,15 @@ namespace gazebo
       public: bool Start(const LogRecordParams &_params);
 
       /// \brief Start the logger.
-      /// \param[in] _encoding The type of encoding (txt, zlib, or bz2).
+      /// \param[in] _encoding The type of encoding (txt, zlib, bz2, or zstd
+      /// and lz4 when Gazebo is built with them).
       /// \param[in] _path Path in which to store log files.
       public: bool Start(const std::string &_encoding="zlib",
                          const std::string &_path="");
 
       /// \brief Get the encoding used.
-      /// \return Either [txt, zlib, or bz2], where txt is plain txt and bz2
-      /// and zlib are compressed data with Base64 encoding.
+      /// \return Either [txt, zlib, bz2, zstd, or lz4], where txt is plain
+      /// txt and the others are compressed data with Base64 encoding.
       public: const std::string &Encoding() const;
 
       /// \brief Get the filename for a log object.
@@ -225,7 +227,8 @@ namespace gazebo
       public: bool SaveFiles(const std::set<std::string> &resources);
 
       /// \brief Write all logs.
-      /// \param[in] _force True to skip waiting on dataAvailableCondition.
+      /// \param[in] _force True to also wait for the chunks that are still
+      /// being compressed, instead of leaving them for the next write.
       public: void Write(const bool _force = false);
 
       /// \brief Get the size of the buffer.
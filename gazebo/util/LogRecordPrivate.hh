@@ -17,11 +17,15 @@
 #ifndef _GAZEBO_UTIL_LOGRECORD_PRIVATE_HH_
 #define _GAZEBO_UTIL_LOGRECORD_PRIVATE_HH_
 
+#include <deque>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <thread>
+#include <vector>
 #include <functional>
 #include <condition_variable>
 #include <boost/filesystem.hpp>
@@ -39,6 +43,77 @@ namespace gazebo
       /// \brief Destructor (makes style checker happy)
       public: virtual ~LogRecordPrivate() = default;
 
+      /// \brief A chunk of log data.
+      public: class Chunk
+      {
+        /// \brief Encoding of the chunk.
+        public: std::string encoding;
+
+        /// \brief Data of the chunk, replaced by the <chunk> element once
+        /// encoded.
+        public: std::string data;
+
+        /// \brief Size of the data before encoding.
+        public: size_t size = 0;
+
+        /// \brief True once encoded.
+        public: bool encoded = false;
+      };
+
+      /// \brief Compresses and encodes chunks on worker threads, so that
+      /// the chunks of a log, and of different logs, are encoded in
+      /// parallel.
+      public: class ChunkEncoder
+      {
+        /// \brief Destructor. Stops the worker threads.
+        public: virtual ~ChunkEncoder();
+
+        /// \brief Queue a chunk for encoding. The worker threads are started
+        /// on the first call. When the workers fall behind, the chunk is
+        /// encoded by the calling thread instead, which bounds the memory
+        /// held by the queue.
+        /// \param[in] _chunk The chunk.
+        public: void Push(std::shared_ptr<Chunk> _chunk);
+
+        /// \brief Check if a chunk is encoded.
+        /// \param[in] _chunk The chunk.
+        /// \return True if the chunk is encoded.
+        public: bool Encoded(const Chunk &_chunk);
+
+        /// \brief Wait for a chunk to be encoded.
+        /// \param[in] _chunk The chunk.
+        public: void Wait(const Chunk &_chunk);
+
+        /// \brief Compress and encode the data of a chunk into a <chunk>
+        /// element.
+        /// \param[in,out] _chunk The chunk.
+        public: static void Encode(Chunk &_chunk);
+
+        /// \brief Called by the worker threads after they encode a chunk.
+        public: std::function<void()> encodedCallback;
+
+        /// \brief Worker thread loop.
+        private: void Run();
+
+        /// \brief Protects the members below, and the encoded flags.
+        private: std::mutex mutex;
+
+        /// \brief Signaled when a chunk is queued or the workers stop.
+        private: std::condition_variable queueCondition;
+
+        /// \brief Signaled when a chunk is encoded.
+        private: std::condition_variable encodedCondition;
+
+        /// \brief Chunks waiting for a worker, in push order.
+        private: std::deque<std::shared_ptr<Chunk>> queue;
+
+        /// \brief Worker threads.
+        private: std::vector<std::thread> workers;
+
+        /// \brief True to stop the workers.
+        private: bool stop = false;
+      };
+
       /// \brief Log helper class
       public: class Log
       {
@@ -61,8 +136,10 @@ namespace gazebo
         /// \brief Stop logging.
         public: void Stop();
 
-        /// \brief Write data to disk.
-        public: void Write();
+        /// \brief Write data to disk. Chunks are written in order, up to
+        /// the first one that is still being encoded.
+        /// \param[in] _wait True to wait for all the chunks to be encoded.
+        public: void Write(const bool _wait = false);
 
         /// \brief Update the data buffer.
         /// \return The size of the data buffer.
@@ -90,6 +167,15 @@ namespace gazebo
         /// \brief Callback from which to get data.
         public: std::function<bool (std::ostringstream &)> logCB;
 
+        /// \brief Encoder of the chunks, shared by all logs.
+        public: ChunkEncoder *encoder = nullptr;
+
+        /// \brief Chunks not written yet, in order.
+        public: std::deque<std::shared_ptr<Chunk>> chunks;
+
+        /// \brief Size of the data of the chunks before encoding.
+        public: size_t chunksSize = 0;
+
         /// \brief Data buffer.
         public: std::string buffer;
 
@@ -217,6 +303,10 @@ namespace gazebo
 
       /// \brief List of saved files if record with resources is enabled.
       public: std::set<std::string> savedFiles;
+
+      /// \brief Encoder of the chunks of all the logs. Last, so that its
+      /// workers stop before the members they use are destroyed.
+      public: ChunkEncoder encoder;
     };
     /// \}
   }
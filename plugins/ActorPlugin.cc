@@ -32,6 +32,13 @@ ActorPlugin::ActorPlugin()
 {
 }
 
+/////////////////////////////////////////////////
+ActorPlugin::~ActorPlugin()
+{
+  if (this->obstacleTrigger != 0 && this->world && this->world->Triggers())
+    this->world->Triggers()->Remove(this->obstacleTrigger);
+}
+
 /////////////////////////////////////////////////
 void ActorPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
 {
@@ -76,6 +83,20 @@ void ActorPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
       modelElem = modelElem->GetNextElement("model");
     }
   }
+
+  // Track the obstacles near the actor
+  auto triggers = this->world->Triggers();
+  if (!triggers)
+    return;
+
+  physics::TriggerVolume volume;
+  volume.name = this->actor->GetScopedName() + "/obstacles";
+  volume.shape = physics::TriggerVolume::SPHERE;
+  volume.radius = 4.0;
+  volume.frame = this->actor->GetScopedName();
+  volume.ignore = this->ignoreModels;
+  volume.includeStatic = true;
+  this->obstacleTrigger = triggers->Add(volume);
 }
 
 /////////////////////////////////////////////////
@@ -131,22 +152,22 @@ void ActorPlugin::ChooseNewTarget()
 /////////////////////////////////////////////////
 void ActorPlugin::HandleObstacles(ignition::math::Vector3d &_pos)
 {
-  for (unsigned int i = 0; i < this->world->ModelCount(); ++i)
+  auto triggers = this->world->Triggers();
+  if (this->obstacleTrigger == 0 || !triggers)
+    return;
+
+  // Only the models near the actor, which aren't ignored
+  for (auto const &model : triggers->Entities(this->obstacleTrigger))
   {
-    physics::ModelPtr model = this->world->ModelByIndex(i);
-    if (std::find(this->ignoreModels.begin(), this->ignoreModels.end(),
-          model->GetName()) == this->ignoreModels.end())
+    ignition::math::Vector3d offset = model->WorldPose().Pos() -
+      this->actor->WorldPose().Pos();
+    double modelDist = offset.Length();
+    if (modelDist < 4.0)
     {
-      ignition::math::Vector3d offset = model->WorldPose().Pos() -
-        this->actor->WorldPose().Pos();
-      double modelDist = offset.Length();
-      if (modelDist < 4.0)
-      {
-        double invModelDist = this->obstacleWeight / modelDist;
-        offset.Normalize();
-        offset *= invModelDist;
-        _pos -= offset;
-      }
+      double invModelDist = this->obstacleWeight / modelDist;
+      offset.Normalize();
+      offset *= invModelDist;
+      _pos -= offset;
     }
   }
 }
@@ -32,6 +32,9 @@ namespace gazebo
     /// \brief Constructor
     public: ActorPlugin();
 
+    /// \brief Destructor
+    public: virtual ~ActorPlugin();
+
     /// \brief Load the actor plugin.
     /// \param[in] _model Pointer to the parent model.
     /// \param[in] _sdf Pointer to the plugin's SDF elements.
@@ -89,6 +92,11 @@ namespace gazebo
 
     /// \brief Custom trajectory info.
     private: physics::TrajectoryInfoPtr trajectoryInfo;
+
+    /// \brief Id of the trigger volume around the actor, which tracks the
+    /// obstacles to avoid. 0 if the world has no trigger manager, in which
+    /// case obstacles aren't avoided.
+    private: unsigned int obstacleTrigger = 0;
   };
 }
 #endif
@@ -17,49 +17,30 @@
 
 #include <string>
 
-#include <ignition/math/OrientedBox.hh>
 #include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
 #include <ignition/msgs/boolean.pb.h>
 #include <ignition/transport/Node.hh>
 
-#include "gazebo/common/Events.hh"
-#include "gazebo/common/UpdateInfo.hh"
-
-#include "gazebo/physics/Entity.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/TriggerManager.hh"
 #include "gazebo/physics/World.hh"
 
 #include "ContainPlugin.hh"
 
 namespace gazebo
 {
-  namespace physics
-  {
-    typedef boost::weak_ptr<physics::Entity> EntityWeakPtr;
-  }
-
   /// \brief Private data class for the ContainPlugin class
   class ContainPluginPrivate
   {
-    /// \brief Connection to world update.
-    public: event::ConnectionPtr updateConnection;
-
     /// \brief Pointer to the world.
     public: physics::WorldPtr world;
 
-    /// \brief Scoped name of the entity we're checking.
-    public: std::string entityName;
+    /// \brief Id of the trigger volume while enabled, 0 while disabled.
+    public: unsigned int trigger = 0;
 
-    /// \brief Pointer to the entity we're checking.
-    public: physics::EntityWeakPtr entity;
-
-    /// \brief Box representing the volume to check.
-    public: ignition::math::OrientedBoxd box;
-
-    /// \brief pointer to an entity whose pose the geometry will track
-    public: physics::EntityWeakPtr containerEntity;
-
-    /// \brief scoped name of entity to track
-    public: std::string containerEntityName;
+    /// \brief Volume to check.
+    public: physics::TriggerVolume volume;
 
     /// \brief Ignition transport node for communication
     public: ignition::transport::Node ignNode;
@@ -87,6 +68,16 @@ ContainPlugin::ContainPlugin() : WorldPlugin(),
 {
 }
 
+/////////////////////////////////////////////////
+ContainPlugin::~ContainPlugin()
+{
+  if (this->dataPtr->trigger != 0 && this->dataPtr->world &&
+      this->dataPtr->world->Triggers())
+  {
+    this->dataPtr->world->Triggers()->Remove(this->dataPtr->trigger);
+  }
+}
+
 /////////////////////////////////////////////////
 void ContainPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
 {
@@ -97,7 +88,7 @@ void ContainPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
           << "initialized." << std::endl;
     return;
   }
-  this->dataPtr->entityName = _sdf->Get<std::string>("entity");
+  this->dataPtr->volume.entities.push_back(_sdf->Get<std::string>("entity"));
 
   // Namespace
   if (!_sdf->HasElement("namespace"))
@@ -115,11 +106,11 @@ void ContainPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
           << "initialized." << std::endl;
     return;
   }
-  auto pose = _sdf->Get<ignition::math::Pose3d>("pose");
+  this->dataPtr->volume.pose = _sdf->Get<ignition::math::Pose3d>("pose");
   sdf::ParamPtr frameParam = _sdf->GetElement("pose")->GetAttribute("frame");
   if (frameParam)
   {
-    this->dataPtr->containerEntityName = frameParam->GetAsString();
+    this->dataPtr->volume.frame = frameParam->GetAsString();
   }
 
   // Geometry
@@ -146,9 +137,10 @@ void ContainPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
           << "initialized." << std::endl;
     return;
   }
-  auto size = boxElem->Get<ignition::math::Vector3d>("size");
-
-  this->dataPtr->box = ignition::math::OrientedBoxd(size, pose);
+  this->dataPtr->volume.name = this->dataPtr->ns;
+  this->dataPtr->volume.shape = physics::TriggerVolume::BOX;
+  this->dataPtr->volume.size = boxElem->Get<ignition::math::Vector3d>("size");
+  this->dataPtr->volume.includeStatic = true;
 
   this->dataPtr->world = _world;
 
@@ -182,14 +174,14 @@ bool ContainPlugin::EnableIgn(const ignition::msgs::Boolean &_req,
 bool ContainPlugin::Enable(const bool _enable)
 {
   // Already started
-  if (_enable && this->dataPtr->updateConnection)
+  if (_enable && this->dataPtr->trigger != 0)
   {
     gzwarn << "Contain plugin is already enabled." << std::endl;
     return false;
   }
 
   // Already stopped
-  if (!_enable && !this->dataPtr->updateConnection)
+  if (!_enable && this->dataPtr->trigger == 0)
   {
     gzwarn << "Contain plugin is already disabled." << std::endl;
     return false;
@@ -198,15 +190,26 @@ bool ContainPlugin::Enable(const bool _enable)
   // Start
   if (_enable)
   {
-    // Start update
-    this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
-        std::bind(&ContainPlugin::OnUpdate, this, std::placeholders::_1));
-
     auto topic = "/" + this->dataPtr->ns + "/contain";
 
     this->dataPtr->containIgnPub =
         this->dataPtr->ignNode.Advertise<ignition::msgs::Boolean>(topic);
 
+    // Get notified when the entity enters or leaves the volume
+    auto triggers = this->dataPtr->world->Triggers();
+    if (!triggers)
+      return false;
+
+    this->dataPtr->trigger = triggers->Add(this->dataPtr->volume,
+        [this](const physics::EntityPtr &, const bool _entered)
+        {
+          this->PublishContains(_entered);
+        });
+
+    // Publish the initial state
+    this->PublishContains(
+        !triggers->Entities(this->dataPtr->trigger).empty());
+
     gzmsg << "Started contain plugin [" << this->dataPtr->ns << "]"
           << std::endl;
 
@@ -215,7 +218,10 @@ bool ContainPlugin::Enable(const bool _enable)
 
   // Stop
   {
-    this->dataPtr->updateConnection.reset();
+    auto triggers = this->dataPtr->world->Triggers();
+    if (triggers)
+      triggers->Remove(this->dataPtr->trigger);
+    this->dataPtr->trigger = 0;
     this->dataPtr->containIgnPub = ignition::transport::Node::Publisher();
     this->dataPtr->contain = -1;
 
@@ -226,60 +232,6 @@ bool ContainPlugin::Enable(const bool _enable)
   }
 }
 
-/////////////////////////////////////////////////
-void ContainPlugin::OnUpdate(const common::UpdateInfo &/*_info*/)
-{
-  // Only get the entity once
-  physics::EntityPtr entity = this->dataPtr->entity.lock();
-  if (!entity)
-  {
-    this->dataPtr->entity = this->dataPtr->world->EntityByName(
-        this->dataPtr->entityName);
-    entity = this->dataPtr->entity.lock();
-    if (!entity)
-    {
-      // Could not find entity being tested
-      this->PublishContains(false);
-      return;
-    }
-  }
-
-  ignition::math::Vector3d entityInWorldFrame =
-    entity->WorldPose().Pos();
-
-  ignition::math::Vector3d entityInBoxFrame;
-  if (!this->dataPtr->containerEntityName.empty())
-  {
-    physics::EntityPtr referenceEntity = this->dataPtr->containerEntity.lock();
-    // box is in a potentially moving reference frame
-    if (!referenceEntity)
-    {
-      this->dataPtr->containerEntity = this->dataPtr->world->EntityByName(
-        this->dataPtr->containerEntityName);
-      referenceEntity = this->dataPtr->containerEntity.lock();
-      if (!referenceEntity)
-      {
-        // Could not find reference entity
-        this->PublishContains(false);
-        return;
-      }
-    }
-
-    auto worldToBox = referenceEntity->WorldPose();
-    auto boxToWorld = worldToBox.Inverse();
-    // Transform the entity vector from world frame to the frame the box is in
-    entityInBoxFrame = (boxToWorld.Rot() * entityInWorldFrame)
-      + boxToWorld.Pos();
-  }
-  else
-  {
-    // box frame is world frame
-    entityInBoxFrame = entityInWorldFrame;
-  }
-
-  this->PublishContains(this->dataPtr->box.Contains(entityInBoxFrame));
-}
-
 //////////////////////////////////////////////////
 void ContainPlugin::PublishContains(const bool _contains)
 {
@@ -71,13 +71,12 @@ namespace gazebo
     // Documentation inherited
     public: ContainPlugin();
 
+    /// \brief Destructor.
+    public: ~ContainPlugin() override;
+
     // Documentation inherited
     public: void Load(physics::WorldPtr _world, sdf::ElementPtr _sdf) override;
 
-    /// \brief Called every world iteration on world update begin.
-    /// \param[in] _info Update info.
-    private: void OnUpdate(const common::UpdateInfo &_info);
-
     /// \brief Enables or disables the plugin.
     /// \param[in] _enable False to disable and true to enable the plugin.
     /// \return True when the operation succeed or false otherwise
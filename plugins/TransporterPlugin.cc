@@ -23,6 +23,7 @@
 #include <gazebo/common/Assert.hh>
 #include <gazebo/common/Console.hh>
 
+#include <gazebo/physics/TriggerManager.hh>
 #include <gazebo/physics/World.hh>
 #include <gazebo/physics/Model.hh>
 
@@ -43,6 +44,11 @@ TransporterPlugin::TransporterPlugin()
 /////////////////////////////////////////////////
 TransporterPlugin::~TransporterPlugin()
 {
+  if (!this->dataPtr->world || !this->dataPtr->world->Triggers())
+    return;
+
+  for (auto const &pad : this->dataPtr->pads)
+    this->dataPtr->world->Triggers()->Remove(pad.second->trigger);
 }
 
 /////////////////////////////////////////////////
@@ -98,6 +104,13 @@ void TransporterPlugin::Load(physics::WorldPtr _world, sdf::ElementPtr _sdf)
     sdf::ElementPtr inElem = padElem->GetElement("incoming");
     pad->incomingPose = inElem->Get<ignition::math::Pose3d>("pose");
 
+    // Track the models in the outgoing box
+    physics::TriggerVolume volume;
+    volume.name = pad->name;
+    volume.size = pad->outgoingBox.Size();
+    volume.pose.Pos() = pad->outgoingBox.Center();
+    pad->trigger = _world->Triggers()->Add(volume);
+
     // Store the pad
     this->dataPtr->pads[pad->name] = pad;
 
@@ -149,42 +162,33 @@ void TransporterPlugin::OnActivation(ConstGzStringPtr &_msg)
 /////////////////////////////////////////////////
 void TransporterPlugin::Update()
 {
+  physics::TriggerManagerPtr triggers = this->dataPtr->world->Triggers();
+  if (!triggers)
+    return;
+
   IGN_PROFILE("TransporterPlugin::Update");
   IGN_PROFILE_BEGIN("Update");
-  // Get all the models
-  physics::Model_V models = this->dataPtr->world->Models();
 
   std::lock_guard<std::mutex> lock(this->dataPtr->padMutex);
 
-  // Process each model.
-  for (auto const &model : models)
+  // Iterate over all pads
+  for (auto const &padIter : this->dataPtr->pads)
   {
-    // Skip models that are static
-    if (model->IsStatic())
-      continue;
-
-    // Get the model's pose
-    ignition::math::Pose3d modelPose = model->WorldPose();
-
-    // Iterate over all pads
-    for (auto const &padIter : this->dataPtr->pads)
+    // Process each non-static model in the pad's outgoing box.
+    for (auto const &model : triggers->Entities(padIter.second->trigger))
     {
-      // Check if the model is in the pad's outgoing box.
-      if (padIter.second->outgoingBox.Contains(modelPose.Pos()))
+      // Get the destination pad
+      auto const &destIter = this->dataPtr->pads.find(padIter.second->dest);
+
+      // Make sure we can transport the model
+      if (destIter != this->dataPtr->pads.end() &&
+          (padIter.second->autoActivation || padIter.second->activated))
       {
-        // Get the destination pad
-        auto const &destIter = this->dataPtr->pads.find(padIter.second->dest);
-
-        // Make sure we can transport the model
-        if (destIter != this->dataPtr->pads.end() &&
-            (padIter.second->autoActivation || padIter.second->activated))
-        {
-          // Move the model
-          model->SetWorldPose(destIter->second->incomingPose);
-
-          // Deactivate the pad. This is used by manually activated pads.
-          padIter.second->activated = false;
-        }
+        // Move the model
+        model->SetWorldPose(destIter->second->incomingPose);
+
+        // Deactivate the pad. This is used by manually activated pads.
+        padIter.second->activated = false;
       }
     }
   }
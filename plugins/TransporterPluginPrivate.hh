@@ -58,6 +58,9 @@ namespace gazebo
       /// It is set to true when a string message that contains
       /// the name of the pad is sent over the activation topic.
       public: bool activated = false;
+
+      /// \brief Id of the trigger volume of the outgoing box.
+      public: unsigned int trigger = 0;
     };
 
     /// \brief World pointer.
@@ -40,6 +40,8 @@ void RegionEventBoxPlugin::Load(physics::ModelPtr _parent, sdf::ElementPtr _sdf)
 
   this->modelSub = this->node->Subscribe("~/model/info",
       &RegionEventBoxPlugin::OnModelMsg, this);
+  this->modelBatchSub = this->node->Subscribe("~/model/info/batch",
+      &RegionEventBoxPlugin::OnModelBatchMsg, this);
 
   sdf::ElementPtr linkEl = this->model->GetSDF()->GetElement("link");
 
@@ -99,6 +101,20 @@ void RegionEventBoxPlugin::OnModelMsg(ConstModelPtr &_msg)
   }
 }
 
+//////////////////////////////////////////////////
+void RegionEventBoxPlugin::OnModelBatchMsg(ConstModel_VPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->receiveMutex);
+  for (auto const &modelMsg : _msg->models())
+  {
+    if (modelMsg.name() == this->modelName && modelMsg.has_scale())
+    {
+      this->boxScale = msgs::ConvertIgn(modelMsg.scale());
+      this->hasStaleSizeAndPose = true;
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 void RegionEventBoxPlugin::OnUpdate(const common::UpdateInfo &_info)
 {
@@ -52,6 +52,10 @@ namespace gazebo
     /// \param[in] _msg model msg
     public: void OnModelMsg(ConstModelPtr &_msg);
 
+    /// \brief Callback when a batch of model messages is received.
+    /// \param[in] _msg batch of model msgs
+    public: void OnModelBatchMsg(ConstModel_VPtr &_msg);
+
     /// \brief Updates the box event plugin at every physics iteration
     /// \param[in] _info Update info
     public: void OnUpdate(const common::UpdateInfo &_info);
@@ -114,6 +118,9 @@ namespace gazebo
     /// \brief Subscriber to model/info topic.
     private: transport::SubscriberPtr modelSub;
 
+    /// \brief Subscriber to model/info/batch topic.
+    private: transport::SubscriberPtr modelBatchSub;
+
     /// \brief Flag set when box region size or pose has changed.
     private: bool hasStaleSizeAndPose;
 
@@ -38,6 +38,16 @@ void SimEventsPlugin::OnModelInfo(ConstModelPtr &_msg)
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void SimEventsPlugin::OnModelInfoBatch(ConstModel_VPtr &_msg)
+{
+  for (auto const &model : _msg->models())
+  {
+    if (models.insert(model.name()).second)
+      SimEventConnector::spawnModel(model.name(), true);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 SimEventsPlugin::~SimEventsPlugin()
 {
@@ -83,6 +93,8 @@ void SimEventsPlugin::Load(physics::WorldPtr _parent, sdf::ElementPtr _sdf)
   // Subscribe to model spawning
   this->spawnSub = this->node->Subscribe("~/model/info",
       &SimEventsPlugin::OnModelInfo, this);
+  this->spawnBatchSub = this->node->Subscribe("~/model/info/batch",
+      &SimEventsPlugin::OnModelInfoBatch, this);
 
   // detect model deletion
   this->requestSub = this->node->Subscribe("~/request",
@@ -48,6 +48,10 @@ namespace gazebo
     /// \param[in] _msg model message
     private: void OnModelInfo(ConstModelPtr &_msg);
 
+    /// \brief callback for ~/model/info/batch topic
+    /// \param[in] _msg batch of model messages
+    private: void OnModelInfoBatch(ConstModel_VPtr &_msg);
+
     /// \brief callback for ~/request topic
     /// \param [in] _msg the request message
     private: void OnRequest(ConstRequestPtr &_msg);
@@ -73,6 +77,9 @@ namespace gazebo
     /// \brief subscription to the model/info
     private: transport::SubscriberPtr spawnSub;
 
+    /// \brief subscription to the model/info/batch
+    private: transport::SubscriberPtr spawnBatchSub;
+
     /// \brief known models that have been spawned already
     private: std::set<std::string> models;
 
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/test/ServerFixture.hh"
+#include "gazebo/util/LogPlay.hh"
+#include "gazebo/util/LogRecord.hh"
+
+using namespace gazebo;
+
+class LogEncodingTest : public ServerFixture,
+                        public testing::WithParamInterface<const char *>
+{
+};
+
+/////////////////////////////////////////////////
+// Record a falling box, with chunks compressed on the encoder threads, and
+// check that the log plays back every frame in order.
+TEST_P(LogEncodingTest, RecordAndPlay)
+{
+  const std::string encoding = GetParam();
+
+  boost::filesystem::path tmpDir =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gazebo_log_%%%%%%");
+  boost::filesystem::create_directories(tmpDir);
+
+  util::LogRecord *recorder = util::LogRecord::Instance();
+  recorder->Init("test");
+
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  this->SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 0, 10), ignition::math::Vector3d::Zero);
+  world->Step(10);
+
+  EXPECT_TRUE(recorder->Start(encoding, tmpDir.string()));
+  EXPECT_EQ(recorder->Encoding(), encoding);
+
+  // Enough states for several chunks
+  world->Step(3000);
+
+  std::string filename = recorder->Filename();
+  recorder->Stop();
+  recorder->Fini();
+
+  util::LogPlay *player = util::LogPlay::Instance();
+  ASSERT_NO_THROW(player->Open(filename));
+  EXPECT_GT(player->ChunkCount(), 1u);
+
+  // The world description, then states in order
+  std::string frame;
+  ASSERT_TRUE(player->Step(frame));
+  EXPECT_NE(frame.find("<world name='default'>"), std::string::npos);
+
+  unsigned int frames = 0;
+  common::Time prevTime;
+  while (player->Step(frame))
+  {
+    auto from = frame.find("<sim_time>");
+    auto to = frame.find("</sim_time>");
+    ASSERT_NE(from, std::string::npos);
+    ASSERT_NE(to, std::string::npos);
+
+    common::Time simTime;
+    std::stringstream ss(frame.substr(from + 10, to - from - 10));
+    ss >> simTime;
+    EXPECT_GT(simTime, prevTime);
+    prevTime = simTime;
+    ++frames;
+  }
+  EXPECT_GT(frames, 100u);
+  EXPECT_EQ(player->Encoding(), encoding);
+
+  boost::filesystem::remove_all(tmpDir);
+}
+
+INSTANTIATE_TEST_CASE_P(Encodings, LogEncodingTest,
+    ::testing::Values("txt", "bz2", "zlib"
+#ifdef HAVE_ZSTD
+                      , "zstd"
+#endif
+#ifdef HAVE_LZ4
+                      , "lz4"
+#endif
+                      ),);  // NOLINT
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -595,5 +595,155 @@ void Marker_TEST::CornerCases()
   delete mainWindow;
 }
 
+/////////////////////////////////////////////////
+void Marker_TEST::Batch()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty_bright.world", false, false, false);
+
+  gazebo::gui::MainWindow *mainWindow = new gazebo::gui::MainWindow();
+  QVERIFY(mainWindow != nullptr);
+
+  // Create the main window.
+  mainWindow->Load();
+  mainWindow->Init();
+  mainWindow->show();
+
+  this->ProcessEventsAndDraw(mainWindow);
+
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  QVERIFY(scene != nullptr);
+
+  // Create our node for communication
+  ignition::transport::Node node;
+
+  std::string listTopic = "/marker/list";
+
+  // Publish many line lists in one request, all asking to be batched
+  const int markerCount = 100;
+  ignition::msgs::Marker_V markers;
+  for (int i = 0; i < markerCount; ++i)
+  {
+    auto markerMsg = markers.add_marker();
+    markerMsg->set_ns("batched");
+    markerMsg->set_id(i + 1);
+    markerMsg->set_action(ignition::msgs::Marker::ADD_MODIFY);
+    markerMsg->set_type(ignition::msgs::Marker::LINE_LIST);
+    auto data = markerMsg->mutable_header()->add_data();
+    data->set_key("batch");
+    data->add_value("true");
+    ignition::msgs::Set(markerMsg->add_point(),
+        ignition::math::Vector3d(i * 0.1, 0, 0));
+    ignition::msgs::Set(markerMsg->add_point(),
+        ignition::math::Vector3d(i * 0.1, 1, 0));
+  }
+
+  {
+    auto visCount = scene->VisualCount();
+
+    ignition::msgs::Boolean rep;
+    bool result;
+    QVERIFY(node.Request("/marker_array", markers, 5000u, rep, result));
+    QVERIFY(result);
+    QVERIFY(rep.data());
+
+    this->ProcessEventsAndDraw(mainWindow);
+
+    // All markers share a single visual
+    QCOMPARE(scene->VisualCount(), visCount + 1);
+    QVERIFY(scene->GetVisual("__GZ_MARKER_VISUAL_batched_1") == nullptr);
+  }
+
+  // Batched markers are listed like any other marker
+  {
+    ignition::msgs::Marker_V rep;
+    bool result;
+    QVERIFY(node.Request(listTopic, 5000u, rep, result));
+    QCOMPARE(rep.marker().size(), markerCount);
+  }
+
+  // Remove one marker
+  {
+    ignition::msgs::Marker markerMsg;
+    markerMsg.set_ns("batched");
+    markerMsg.set_id(1);
+    markerMsg.set_action(ignition::msgs::Marker::DELETE_MARKER);
+    QVERIFY(node.Request("/marker", markerMsg));
+
+    this->ProcessEventsAndDraw(mainWindow);
+
+    ignition::msgs::Marker_V rep;
+    bool result;
+    QVERIFY(node.Request(listTopic, 5000u, rep, result));
+    QCOMPARE(rep.marker().size(), markerCount - 1);
+  }
+
+  // A single point is enough to draw a batch of points
+  {
+    ignition::msgs::Marker markerMsg;
+    markerMsg.set_ns("batched/nested");
+    markerMsg.set_id(1);
+    markerMsg.set_action(ignition::msgs::Marker::ADD_MODIFY);
+    markerMsg.set_type(ignition::msgs::Marker::POINTS);
+    auto data = markerMsg.mutable_header()->add_data();
+    data->set_key("batch");
+    data->add_value("true");
+    ignition::msgs::Set(markerMsg.add_point(),
+        ignition::math::Vector3d(0, 0, 1));
+    QVERIFY(node.Request("/marker", markerMsg));
+
+    this->ProcessEventsAndDraw(mainWindow);
+
+    auto vis = scene->GetVisual("__GZ_MARKER_BATCH_batched/nested_1");
+    QVERIFY(vis != nullptr);
+    QVERIFY(vis->GetVisible());
+  }
+
+  // Delete the namespace, which removes the batch visual but not the batch
+  // of the namespace whose name starts with it
+  {
+    auto visCount = scene->VisualCount();
+
+    ignition::msgs::Marker markerMsg;
+    markerMsg.set_ns("batched");
+    markerMsg.set_action(ignition::msgs::Marker::DELETE_ALL);
+    QVERIFY(node.Request("/marker", markerMsg));
+
+    this->ProcessEventsAndDraw(mainWindow);
+
+    QCOMPARE(scene->VisualCount(), visCount - 1);
+    QVERIFY(scene->GetVisual("__GZ_MARKER_BATCH_batched/nested_1") !=
+        nullptr);
+
+    ignition::msgs::Marker_V rep;
+    bool result;
+    QVERIFY(node.Request(listTopic, 5000u, rep, result));
+    QCOMPARE(rep.marker().size(), 1);
+  }
+
+  // Delete the nested namespace
+  {
+    ignition::msgs::Marker markerMsg;
+    markerMsg.set_ns("batched/nested");
+    markerMsg.set_action(ignition::msgs::Marker::DELETE_ALL);
+    QVERIFY(node.Request("/marker", markerMsg));
+
+    this->ProcessEventsAndDraw(mainWindow);
+
+    QVERIFY(scene->GetVisual("__GZ_MARKER_BATCH_batched/nested_1") ==
+        nullptr);
+
+    ignition::msgs::Marker_V rep;
+    bool result;
+    QVERIFY(node.Request(listTopic, 5000u, rep, result));
+    QCOMPARE(rep.marker().size(), 0);
+  }
+
+  mainWindow->close();
+  delete mainWindow;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(Marker_TEST)
@@ -29,5 +29,8 @@ class Marker_TEST : public QTestFixture
 
   /// \brief Test corner cases.
   private slots: void CornerCases();
+
+  /// \brief Test batched markers and the marker array service.
+  private slots: void Batch();
 };
 #endif
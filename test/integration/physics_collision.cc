@@ -19,6 +19,7 @@
 #include <ignition/math/Helpers.hh>
 
 #include "gazebo/physics/physics.hh"
+#include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/test/helper_physics_generator.hh"
 
@@ -349,6 +350,52 @@ TEST_F(PhysicsCollisionTest, ModelSelfCollide)
   Unload();
 }
 
+/////////////////////////////////////////////////
+// Static ODE collisions have no body, so their geom is placed from the
+// collision world pose as soon as the model is moved.
+TEST_F(PhysicsCollisionTest, StaticSetWorldPose)
+{
+  Load("worlds/empty.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnBox("static_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  physics::ModelPtr model = world->ModelByName("static_box");
+  ASSERT_TRUE(model != NULL);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != NULL);
+  ASSERT_EQ(link->GetCollisions().size(), 1u);
+  physics::ODECollisionPtr collision =
+      boost::dynamic_pointer_cast<physics::ODECollision>(
+      link->GetCollisions()[0]);
+  ASSERT_TRUE(collision != NULL);
+
+  const ignition::math::Pose3d pose(3, 4, 0.5, 0, 0, 0.3);
+  model->SetWorldPose(pose);
+
+  // The collision and its geom follow without stepping
+  EXPECT_EQ(collision->WorldPose(), pose);
+  const dReal *pos = dGeomGetPosition(collision->GetCollisionId());
+  EXPECT_NEAR(pos[0], pose.Pos().X(), 1e-6);
+  EXPECT_NEAR(pos[1], pose.Pos().Y(), 1e-6);
+  EXPECT_NEAR(pos[2], pose.Pos().Z(), 1e-6);
+  dQuaternion q;
+  dGeomGetQuaternion(collision->GetCollisionId(), q);
+  EXPECT_EQ(ignition::math::Quaterniond(q[0], q[1], q[2], q[3]), pose.Rot());
+
+  // A sphere dropped on the new pose rests on the box
+  SpawnSphere("sphere", ignition::math::Vector3d(3, 4, 2),
+      ignition::math::Vector3d::Zero);
+  physics::ModelPtr sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(sphere != NULL);
+  world->Step(1000);
+  EXPECT_NEAR(sphere->WorldPose().Pos().Z(), 1.5, g_physics_tol);
+
+  Unload();
+}
+
 /////////////////////////////////////////////////
 TEST_P(PhysicsCollisionTest, GetBoundingBox)
 {
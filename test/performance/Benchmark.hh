@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TEST_PERFORMANCE_BENCHMARK_HH_
+#define GAZEBO_TEST_PERFORMANCE_BENCHMARK_HH_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// \brief Replace the global allocation functions of the test executable so
+/// that gazebo::test::benchmark::AllocationCount() counts every heap
+/// allocation, including the ones made inside the gazebo libraries. Use this
+/// macro once, at global scope, in a benchmark source file.
+#define GZ_BENCHMARK_COUNT_ALLOCATIONS() \
+  void *operator new(std::size_t _size) \
+  { \
+    ++gazebo::test::benchmark::AllocationCount(); \
+    if (void *ptr = std::malloc(_size ? _size : 1)) \
+      return ptr; \
+    throw std::bad_alloc(); \
+  } \
+  void *operator new[](std::size_t _size) \
+  { \
+    return operator new(_size); \
+  } \
+  void operator delete(void *_ptr) noexcept \
+  { \
+    std::free(_ptr); \
+  } \
+  void operator delete[](void *_ptr) noexcept \
+  { \
+    std::free(_ptr); \
+  } \
+  void operator delete(void *_ptr, std::size_t) noexcept \
+  { \
+    std::free(_ptr); \
+  } \
+  void operator delete[](void *_ptr, std::size_t) noexcept \
+  { \
+    std::free(_ptr); \
+  }
+
+namespace gazebo
+{
+  namespace test
+  {
+    namespace benchmark
+    {
+      /// \brief Number of heap allocations made so far. Only counts when
+      /// GZ_BENCHMARK_COUNT_ALLOCATIONS is used in the executable.
+      /// \return Reference to the allocation counter.
+      inline std::atomic<uint64_t> &AllocationCount()
+      {
+        static std::atomic<uint64_t> count(0);
+        return count;
+      }
+
+      /// \brief Reset the peak resident set size of the process to its
+      /// current resident set size, so that PeakRss() doesn't include the
+      /// benchmarks run before in the same executable. Needs Linux 4.0 or
+      /// later, does nothing otherwise.
+      inline void ResetPeakRss()
+      {
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+      }
+
+      /// \brief Peak resident set size of the process, since it started or
+      /// since the last call to ResetPeakRss().
+      /// \return Peak RSS in kilobytes, or 0 if it can't be read.
+      inline uint64_t PeakRss()
+      {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+          if (line.compare(0, 6, "VmHWM:") == 0)
+            return std::strtoull(line.c_str() + 6, nullptr, 10);
+        }
+        return 0;
+      }
+
+      /// \brief Nearest-rank percentile of a set of samples.
+      /// \param[in] _samples Samples, need not be sorted.
+      /// \param[in] _p Percentile in [0, 100].
+      /// \return The percentile, or 0 if there are no samples.
+      inline double Percentile(std::vector<double> _samples, const double _p)
+      {
+        if (_samples.empty())
+          return 0;
+
+        size_t rank = static_cast<size_t>(
+            std::ceil(_p / 100.0 * _samples.size()));
+        rank = std::min(std::max(rank, static_cast<size_t>(1)),
+            _samples.size());
+        std::nth_element(_samples.begin(), _samples.begin() + rank - 1,
+            _samples.end());
+        return _samples[rank - 1];
+      }
+
+      /// \brief Result of one benchmark run.
+      class Result
+      {
+        /// \brief Constructor
+        /// \param[in] _benchmark Name of the benchmark.
+        /// \param[in] _variant Variant, e.g. the physics engine.
+        public: Result(const std::string &_benchmark,
+                    const std::string &_variant)
+                : benchmark(_benchmark), variant(_variant)
+        {
+        }
+
+        /// \brief Add a metric.
+        /// \param[in] _name Name of the metric, including its unit.
+        /// \param[in] _value Value of the metric.
+        public: void Add(const std::string &_name, const double _value)
+        {
+          this->metrics.push_back(std::make_pair(_name, _value));
+        }
+
+        /// \brief Print the result and append it as one JSON object per line
+        /// to the file named by the GAZEBO_BENCHMARK_RESULTS environment
+        /// variable, if set.
+        public: void Write() const
+        {
+          std::ostringstream json;
+          json << std::setprecision(9)
+               << "{\"benchmark\": \"" << this->benchmark << "\", "
+               << "\"variant\": \"" << this->variant << "\"";
+          for (auto const &metric : this->metrics)
+            json << ", \"" << metric.first << "\": " << metric.second;
+          json << "}";
+
+          std::cout << "[benchmark] " << json.str() << std::endl;
+
+          const char *path = std::getenv("GAZEBO_BENCHMARK_RESULTS");
+          if (path)
+          {
+            std::ofstream out(path, std::ios::out | std::ios::app);
+            out << json.str() << std::endl;
+          }
+        }
+
+        /// \brief Metrics in insertion order.
+        public: const std::vector<std::pair<std::string, double>> &Metrics()
+                const
+        {
+          return this->metrics;
+        }
+
+        /// \brief Name of the benchmark.
+        private: std::string benchmark;
+
+        /// \brief Variant of the benchmark.
+        private: std::string variant;
+
+        /// \brief Metrics.
+        private: std::vector<std::pair<std::string, double>> metrics;
+      };
+    }
+  }
+}
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/sensors/Noise.hh"
+#include "gazebo/sensors/LaserScanProcessor.hh"
+
+using namespace gazebo;
+
+// 128 beams by 2048 columns, three floats per reading
+static const unsigned int g_beams = 128;
+static const unsigned int g_columns = 2048;
+static const unsigned int g_iterations = 50;
+static const double g_rangeMin = 0.1;
+static const double g_rangeMax = 100.0;
+
+/////////////////////////////////////////////////
+sensors::NoisePtr GaussianNoise()
+{
+  std::ostringstream noiseStream;
+  noiseStream << "<sdf version='1.6'>"
+              << "  <noise type='gaussian'>"
+              << "    <mean>0.0</mean>"
+              << "    <stddev>0.01</stddev>"
+              << "  </noise>"
+              << "</sdf>";
+
+  sdf::ElementPtr sdf(new sdf::Element);
+  sdf::initFile("noise.sdf", sdf);
+  sdf::readString(noiseStream.str(), sdf);
+
+  return sensors::NoiseFactory::NewNoiseModel(sdf);
+}
+
+/////////////////////////////////////////////////
+std::vector<float> LaserFrame()
+{
+  std::vector<float> data(g_beams * g_columns * 3);
+  for (unsigned int i = 0; i < g_beams * g_columns; ++i)
+  {
+    data[i * 3] = ignition::math::Rand::DblUniform(0, g_rangeMax * 1.1);
+    data[i * 3 + 1] = ignition::math::Rand::DblUniform(0, 1);
+    data[i * 3 + 2] = 0;
+  }
+  return data;
+}
+
+/////////////////////////////////////////////////
+/// \brief Per-ray post processing, as done by GpuRaySensor before bulk
+/// processing was added.
+void PerRay(const std::vector<float> &_data, sensors::NoisePtr _noise,
+    msgs::LaserScan &_scan)
+{
+  const int numRays = g_beams * g_columns;
+  if (_scan.ranges_size() != numRays)
+  {
+    _scan.clear_ranges();
+    _scan.clear_intensities();
+    for (int i = 0; i < numRays; ++i)
+    {
+      _scan.add_ranges(ignition::math::NAN_F);
+      _scan.add_intensities(ignition::math::NAN_F);
+    }
+  }
+
+  for (int i = 0; i < numRays; ++i)
+  {
+    double range = _data[i * 3];
+    double intensity = _data[i * 3 + 1];
+
+    if (range >= g_rangeMax)
+      range = ignition::math::INF_D;
+    else if (range <= g_rangeMin)
+      range = -ignition::math::INF_D;
+    else if (_noise)
+    {
+      range = _noise->Apply(range);
+      range = ignition::math::clamp(range, g_rangeMin, g_rangeMax);
+    }
+
+    range = ignition::math::isnan(range) ? g_rangeMax : range;
+    _scan.set_ranges(i, range);
+    _scan.set_intensities(i, intensity);
+  }
+}
+
+/////////////////////////////////////////////////
+void Benchmark(sensors::NoisePtr _noise, const std::string &_label)
+{
+  std::vector<float> data = LaserFrame();
+
+  msgs::LaserScan perRayScan;
+  common::Time start = common::Time::GetWallTime();
+  for (unsigned int i = 0; i < g_iterations; ++i)
+    PerRay(data, _noise, perRayScan);
+  common::Time perRayTime = common::Time::GetWallTime() - start;
+
+  sensors::LaserScanProcessor processor;
+  processor.SetRange(g_rangeMin, g_rangeMax);
+  processor.SetNoise(_noise);
+  msgs::LaserScan bulkScan;
+  start = common::Time::GetWallTime();
+  for (unsigned int i = 0; i < g_iterations; ++i)
+  {
+    processor.Process(data.data(), g_beams * g_columns, 3, 0, 1);
+    processor.Fill(bulkScan);
+  }
+  common::Time bulkTime = common::Time::GetWallTime() - start;
+
+  gzmsg << _label << ": " << g_beams << "x" << g_columns << " scan, "
+        << g_iterations << " frames. Per-ray [" << perRayTime.Double()
+        << "s] Bulk [" << bulkTime.Double() << "s]" << std::endl;
+
+  ASSERT_EQ(perRayScan.ranges_size(), bulkScan.ranges_size());
+  ASSERT_EQ(perRayScan.intensities_size(), bulkScan.intensities_size());
+
+  // Without noise both paths must produce identical scans
+  if (!_noise)
+  {
+    for (int i = 0; i < bulkScan.ranges_size(); ++i)
+    {
+      EXPECT_DOUBLE_EQ(perRayScan.ranges(i), bulkScan.ranges(i));
+      EXPECT_DOUBLE_EQ(perRayScan.intensities(i), bulkScan.intensities(i));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(LaserScanProcessor, NoNoise)
+{
+  Benchmark(nullptr, "No noise");
+}
+
+/////////////////////////////////////////////////
+TEST(LaserScanProcessor, GaussianNoise)
+{
+  sensors::NoisePtr noise = GaussianNoise();
+  ASSERT_NE(nullptr, noise);
+  Benchmark(noise, "Gaussian noise");
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Map shape benchmark. Extrudes a large floorplan image into box
+// collisions or merged triangle meshes, drops boxes between the walls and
+// reports the load time, the number of collisions and the step time
+// percentiles of each output. Set GAZEBO_BENCHMARK_RESULTS to a file path
+// to collect the results as JSON lines.
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Image.hh"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/performance/Benchmark.hh"
+
+using namespace gazebo;
+
+/// \brief Size of the floorplan image in pixels.
+static const unsigned int imageSize = 4096;
+
+/// \brief Distance between walls in pixels.
+static const unsigned int roomSize = 64;
+
+/// \brief Size of a pixel in meters.
+static const double mapScale = 0.05;
+
+class MapShapeBenchmark : public ServerFixture,
+    public testing::WithParamInterface<std::tuple<const char *, unsigned int>>
+{
+  /// \brief Write a floorplan of square rooms with doors to a PNG file.
+  /// \param[in] _filename Path of the file to write.
+  public: static void WriteFloorplan(const std::string &_filename);
+
+  /// \brief Get the SDF of a static model extruding an image.
+  /// \param[in] _filename Path of the image.
+  /// \param[in] _output Output of the map shape.
+  /// \param[in] _tileSize Size of the mesh tiles in pixels.
+  /// \return Model SDF.
+  public: static std::string MapSdf(const std::string &_filename,
+              const std::string &_output, const unsigned int _tileSize);
+
+  /// \brief Record the time at which a step starts.
+  public: void OnWorldUpdateBegin();
+
+  /// \brief Start times of the measured steps.
+  public: std::vector<std::chrono::steady_clock::time_point> stepStarts;
+
+  /// \brief Protects stepStarts.
+  public: std::mutex mutex;
+};
+
+/////////////////////////////////////////////////
+void MapShapeBenchmark::WriteFloorplan(const std::string &_filename)
+{
+  // White floor, black walls two pixels thick around each room, with a
+  // door in the middle of each wall
+  std::vector<unsigned char> data(imageSize * imageSize * 3, 255);
+  for (unsigned int y = 0; y < imageSize; ++y)
+  {
+    for (unsigned int x = 0; x < imageSize; ++x)
+    {
+      const unsigned int rx = x % roomSize;
+      const unsigned int ry = y % roomSize;
+      const bool door = (rx > roomSize / 2 - 8 && rx < roomSize / 2 + 8) ||
+                        (ry > roomSize / 2 - 8 && ry < roomSize / 2 + 8);
+      if ((rx < 2 || ry < 2) && !door)
+      {
+        const unsigned int i = (y * imageSize + x) * 3;
+        data[i] = data[i + 1] = data[i + 2] = 0;
+      }
+    }
+  }
+
+  common::Image image;
+  image.SetFromData(data.data(), imageSize, imageSize,
+      common::Image::RGB_INT8);
+  image.SavePNG(_filename);
+}
+
+/////////////////////////////////////////////////
+std::string MapShapeBenchmark::MapSdf(const std::string &_filename,
+    const std::string &_output, const unsigned int _tileSize)
+{
+  std::ostringstream sdf;
+  sdf << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='map'>"
+      << "  <static>true</static>"
+      << "  <link name='link'>"
+      << "    <collision name='collision'>"
+      << "      <geometry><image>"
+      << "        <uri>" << _filename << "</uri>"
+      << "        <scale>" << mapScale << "</scale>"
+      << "        <threshold>200</threshold>"
+      << "        <height>2</height>"
+      << "        <granularity>1</granularity>"
+      << "        <gz:output>" << _output << "</gz:output>"
+      << "        <gz:tile_size>" << _tileSize << "</gz:tile_size>"
+      << "      </image></geometry>"
+      << "    </collision>"
+      << "  </link>"
+      << "</model>"
+      << "</sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+void MapShapeBenchmark::OnWorldUpdateBegin()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->stepStarts.push_back(std::chrono::steady_clock::now());
+}
+
+/////////////////////////////////////////////////
+TEST_P(MapShapeBenchmark, Floorplan)
+{
+  const std::string output = std::get<0>(GetParam());
+  const unsigned int tileSize = std::get<1>(GetParam());
+  const unsigned int steps = 1000;
+
+  boost::filesystem::path imagePath =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gazebo_floorplan_%%%%%%.png");
+  WriteFloorplan(imagePath.string());
+
+  test::benchmark::ResetPeakRss();
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Step as fast as possible, so that the step times measure the collision
+  // checks instead of the real time throttle
+  world->Physics()->SetRealTimeUpdateRate(0.0);
+
+  const common::Time loadStart = common::Time::GetWallTime();
+  this->SpawnSDF(MapSdf(imagePath.string(), output, tileSize));
+  int sleep = 0;
+  while (!world->ModelByName("map") && sleep++ < 6000)
+    common::Time::MSleep(10);
+  const double loadTime = (common::Time::GetWallTime() - loadStart).Double();
+  boost::filesystem::remove(imagePath);
+
+  physics::ModelPtr map = world->ModelByName("map");
+  ASSERT_TRUE(map != nullptr);
+  physics::CollisionPtr collision =
+      map->GetLink("link")->GetCollision("collision");
+  ASSERT_TRUE(collision != nullptr);
+  boost::shared_ptr<physics::MapShape> shape =
+      boost::dynamic_pointer_cast<physics::MapShape>(collision->GetShape());
+  ASSERT_TRUE(shape != nullptr);
+  EXPECT_GT(shape->CollisionCount(), 0u);
+
+  // Boxes falling into rooms spread over the map, so that the broadphase
+  // works against the walls around them
+  const double roomMeters = roomSize * mapScale;
+  for (unsigned int i = 0; i < 100; ++i)
+  {
+    const double x = ((i % 10) * 6 + 0.5) * roomMeters;
+    const double y = ((i / 10) * 6 + 0.5) * roomMeters;
+    this->SpawnBox("box_" + std::to_string(i),
+        ignition::math::Vector3d(0.5, 0.5, 0.5),
+        ignition::math::Vector3d(x, y, 1.0),
+        ignition::math::Vector3d::Zero);
+  }
+
+  world->Step(100);
+
+  event::ConnectionPtr connection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&MapShapeBenchmark::OnWorldUpdateBegin, this));
+  const uint32_t targetIterations = world->Iterations() + steps;
+  const common::Time stallTimeout(60);
+  uint32_t iterations = world->Iterations();
+  common::Time progressTime = common::Time::GetWallTime();
+  world->SetPaused(false);
+  while (iterations < targetIterations)
+  {
+    common::Time::MSleep(1);
+    if (world->Iterations() != iterations)
+    {
+      iterations = world->Iterations();
+      progressTime = common::Time::GetWallTime();
+    }
+    ASSERT_LT(common::Time::GetWallTime() - progressTime, stallTimeout)
+      << "World stalled at iteration " << iterations << " of "
+      << targetIterations;
+  }
+  world->SetPaused(true);
+  connection.reset();
+
+  std::vector<double> stepTimes;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (size_t i = 1; i < this->stepStarts.size(); ++i)
+    {
+      stepTimes.push_back(std::chrono::duration<double, std::micro>(
+          this->stepStarts[i] - this->stepStarts[i-1]).count());
+    }
+  }
+  ASSERT_FALSE(stepTimes.empty());
+
+  test::benchmark::Result result("map_shape",
+      output + (output == "mesh" ? "_" + std::to_string(tileSize) : ""));
+  result.Add("image_pixels", imageSize * imageSize);
+  result.Add("collisions", shape->CollisionCount());
+  result.Add("load_time_s", loadTime);
+  result.Add("step_p50_us", test::benchmark::Percentile(stepTimes, 50));
+  result.Add("step_p90_us", test::benchmark::Percentile(stepTimes, 90));
+  result.Add("step_p99_us", test::benchmark::Percentile(stepTimes, 99));
+  result.Add("peak_rss_kb", test::benchmark::PeakRss());
+  result.Write();
+  for (auto const &metric : result.Metrics())
+    this->RecordProperty(metric.first, std::to_string(metric.second));
+}
+
+INSTANTIATE_TEST_CASE_P(Outputs, MapShapeBenchmark,
+    ::testing::Values(std::make_tuple("boxes", 0u),
+                      std::make_tuple("mesh", 0u),
+                      std::make_tuple("mesh", 1024u)),);  // NOLINT
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
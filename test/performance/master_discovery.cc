@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Topic discovery benchmark. Several clients connect to a master and
+// advertise many topics, either one message per topic or one batch per
+// client. Measures the time until all topics are listed by the master, and
+// the time until they are all gone once the clients disconnect. Set
+// GAZEBO_BENCHMARK_RESULTS to a file path to collect the results as JSON
+// lines.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "gazebo/Master.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/Connection.hh"
+#include "test/performance/Benchmark.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+/// \brief Number of clients that advertise topics.
+static const unsigned int clientCount = 8;
+
+class MasterDiscovery : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Advertise topics and report.
+  /// \param[in] _variant Name of the benchmark variant.
+  /// \param[in] _port Port of the master.
+  /// \param[in] _topicCount Total number of topics.
+  /// \param[in] _batched True to advertise the topics of a client in one
+  /// message.
+  public: void Run(const std::string &_variant, const uint16_t _port,
+              const unsigned int _topicCount, const bool _batched);
+
+  /// \brief Connect to the master and read the initial messages.
+  /// \param[in] _port Port of the master.
+  /// \param[in] _batches True to tell the master that the client
+  /// understands batched messages.
+  /// \return The connection, null on failure.
+  public: static transport::ConnectionPtr Connect(const uint16_t _port,
+              const bool _batches = false);
+
+  /// \brief Get the number of topics known by the master.
+  /// \param[in] _conn Connection to the master, that isn't read
+  /// asynchronously.
+  /// \return Number of topics.
+  public: static int TopicCount(transport::ConnectionPtr _conn);
+
+  /// \brief Count the messages received by a client, and keep reading.
+  /// \param[in] _conn The client connection.
+  /// \param[in] _data The message.
+  public: void OnClientRead(boost::weak_ptr<transport::Connection> _conn,
+              const std::string &_data);
+
+  /// \brief Number of messages received by the clients.
+  public: std::atomic<uint64_t> received{0};
+};
+
+/////////////////////////////////////////////////
+transport::ConnectionPtr MasterDiscovery::Connect(const uint16_t _port,
+    const bool _batches)
+{
+  transport::ConnectionPtr conn(new transport::Connection());
+  if (!conn->Connect("localhost", _port))
+    return transport::ConnectionPtr();
+
+  // Version, topic namespaces and publishers
+  std::string data;
+  for (unsigned int i = 0; i < 3; ++i)
+    conn->Read(data);
+
+  if (_batches)
+  {
+    msgs::Request *request = msgs::CreateRequest("batch_support");
+    conn->EnqueueMsg(msgs::Package("request", *request), true);
+    delete request;
+  }
+
+  return conn;
+}
+
+/////////////////////////////////////////////////
+int MasterDiscovery::TopicCount(transport::ConnectionPtr _conn)
+{
+  msgs::Request *request = msgs::CreateRequest("get_topics");
+  _conn->EnqueueMsg(msgs::Package("request", *request), true);
+  delete request;
+
+  // Skip the announcements that arrive before the answer
+  std::string data;
+  msgs::Packet packet;
+  while (_conn->IsOpen() && _conn->Read(data))
+  {
+    packet.ParseFromString(data);
+    if (packet.type() == "topic_list")
+    {
+      msgs::GzString_V topics;
+      topics.ParseFromString(packet.serialized_data());
+      return topics.data_size();
+    }
+  }
+  return -1;
+}
+
+/////////////////////////////////////////////////
+void MasterDiscovery::OnClientRead(
+    boost::weak_ptr<transport::Connection> _conn, const std::string &_data)
+{
+  transport::ConnectionPtr conn = _conn.lock();
+  if (_data.empty() || !conn || !conn->IsOpen())
+    return;
+
+  ++this->received;
+  conn->AsyncRead(boost::bind(&MasterDiscovery::OnClientRead, this, _conn,
+        _1));
+}
+
+/////////////////////////////////////////////////
+void MasterDiscovery::Run(const std::string &_variant, const uint16_t _port,
+    const unsigned int _topicCount, const bool _batched)
+{
+  Master master;
+  master.Init(_port);
+  master.RunThread();
+
+  transport::ConnectionPtr query = Connect(_port);
+  ASSERT_TRUE(query != nullptr);
+  const int initialCount = TopicCount(query);
+  ASSERT_GE(initialCount, 0);
+
+  std::vector<transport::ConnectionPtr> clients;
+  for (unsigned int i = 0; i < clientCount; ++i)
+  {
+    transport::ConnectionPtr client = Connect(_port, _batched);
+    ASSERT_TRUE(client != nullptr);
+    client->AsyncRead(boost::bind(&MasterDiscovery::OnClientRead, this,
+          boost::weak_ptr<transport::Connection>(client), _1));
+    clients.push_back(client);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (unsigned int i = 0; i < clientCount; ++i)
+  {
+    msgs::Publishers pubs;
+    for (unsigned int j = i; j < _topicCount; j += clientCount)
+    {
+      msgs::Publish *pub = pubs.add_publisher();
+      pub->set_topic("/gazebo/default/bench/" + std::to_string(j));
+      pub->set_msg_type("gazebo.msgs.GzString");
+      pub->set_host(clients[i]->GetLocalAddress());
+      pub->set_port(clients[i]->GetLocalPort());
+
+      if (!_batched)
+        clients[i]->EnqueueMsg(msgs::Package("advertise", *pub));
+    }
+
+    if (_batched)
+      clients[i]->EnqueueMsg(msgs::Package("advertise_batch", pubs));
+  }
+
+  int count = initialCount;
+  while (count < initialCount + static_cast<int>(_topicCount) &&
+         std::chrono::steady_clock::now() - start < std::chrono::seconds(120))
+  {
+    count = TopicCount(query);
+  }
+  auto discovered = std::chrono::steady_clock::now();
+  EXPECT_EQ(count, initialCount + static_cast<int>(_topicCount));
+
+  for (auto &client : clients)
+    client->Shutdown();
+  clients.clear();
+
+  while (count > initialCount &&
+         std::chrono::steady_clock::now() - discovered <
+         std::chrono::seconds(120))
+  {
+    count = TopicCount(query);
+  }
+  auto removed = std::chrono::steady_clock::now();
+  EXPECT_EQ(count, initialCount);
+
+  query->Shutdown();
+  master.Stop();
+  master.Fini();
+
+  test::benchmark::Result result("master_discovery", _variant);
+  result.Add("topics", _topicCount);
+  result.Add("clients", clientCount);
+  result.Add("discovery_ms", std::chrono::duration<double, std::milli>(
+        discovered - start).count());
+  result.Add("teardown_ms", std::chrono::duration<double, std::milli>(
+        removed - discovered).count());
+  result.Add("client_messages", this->received.load());
+  result.Write();
+
+  for (auto const &metric : result.Metrics())
+    this->RecordProperty(metric.first, std::to_string(metric.second));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MasterDiscovery, Topics1k)
+{
+  Run("1k", 11441, 1000, false);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MasterDiscovery, Topics4k)
+{
+  Run("4k", 11442, 4000, false);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MasterDiscovery, Topics16k)
+{
+  Run("16k", 11443, 16000, false);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MasterDiscovery, Topics16kBatched)
+{
+  Run("16k_batched", 11444, 16000, true);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
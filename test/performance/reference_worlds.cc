@@ -0,0 +1,510 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Reference world benchmarks. Each benchmark builds a world, runs it
+// headless as fast as possible on every physics engine and reports
+// real-time factor, step time percentiles, heap allocations and peak RSS.
+// Set GAZEBO_BENCHMARK_RESULTS to a file path to collect the results as
+// JSON lines, and GAZEBO_BENCHMARK_STEPS to change the number of measured
+// steps.
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/test/ServerFixture.hh"
+#include "gazebo/test/helper_physics_generator.hh"
+#include "test/performance/Benchmark.hh"
+
+using namespace gazebo;
+
+GZ_BENCHMARK_COUNT_ALLOCATIONS()
+
+class ReferenceWorlds : public ServerFixture,
+                        public testing::WithParamInterface<const char*>
+{
+  /// \brief Write a world to a temporary file, load it, run it and report.
+  /// \param[in] _benchmark Name of the benchmark.
+  /// \param[in] _physicsEngine Physics engine to use.
+  /// \param[in] _models SDF of the models in the world.
+  /// \param[in] _setup Optional function called after the world is loaded.
+  public: void Run(const std::string &_benchmark,
+              const std::string &_physicsEngine, const std::string &_models,
+              std::function<void ()> _setup = nullptr);
+
+  /// \brief Get the SDF of a complete world.
+  /// \param[in] _physicsEngine Physics engine to use.
+  /// \param[in] _models SDF of the models in the world.
+  /// \return World SDF.
+  public: static std::string WorldSdf(const std::string &_physicsEngine,
+              const std::string &_models);
+
+  /// \brief Get the SDF of a box model.
+  /// \param[in] _name Model name.
+  /// \param[in] _pos Model position.
+  /// \param[in] _size Box size.
+  /// \return Model SDF.
+  public: static std::string BoxSdf(const std::string &_name,
+              const ignition::math::Vector3d &_pos, const double _size);
+
+  /// \brief Get the SDF of a serial arm with revolute joints.
+  /// \param[in] _name Model name.
+  /// \param[in] _pos Model position.
+  /// \param[in] _links Number of links.
+  /// \return Model SDF.
+  public: static std::string ArmSdf(const std::string &_name,
+              const ignition::math::Vector3d &_pos, const unsigned int _links);
+
+  /// \brief Get the SDF of a static model with a ray sensor.
+  /// \param[in] _name Model name.
+  /// \param[in] _pos Model position.
+  /// \return Model SDF.
+  public: static std::string LidarSdf(const std::string &_name,
+              const ignition::math::Vector3d &_pos);
+
+  /// \brief Write a terrain mesh to an OBJ file.
+  /// \param[in] _filename Path of the file to write.
+  /// \param[in] _cells Number of grid cells along each side.
+  /// \param[in] _size Side length of the terrain.
+  public: static void WriteTerrainMesh(const std::string &_filename,
+              const unsigned int _cells, const double _size);
+
+  /// \brief World update begin callback, records step times.
+  public: void OnWorldUpdateBegin();
+
+  /// \brief Wall time of each world update begin.
+  private: std::vector<std::chrono::steady_clock::time_point> stepStarts;
+
+  /// \brief Protects stepStarts.
+  private: std::mutex mutex;
+};
+
+/////////////////////////////////////////////////
+std::string ReferenceWorlds::WorldSdf(const std::string &_physicsEngine,
+    const std::string &_models)
+{
+  std::ostringstream sdf;
+  sdf << "<?xml version='1.0'?>"
+      << "<sdf version='1.6'>"
+      << "<world name='default'>"
+      << "<physics name='default' type='" << _physicsEngine << "'>"
+      << "  <max_step_size>0.001</max_step_size>"
+      << "  <real_time_factor>1</real_time_factor>"
+      << "  <real_time_update_rate>0</real_time_update_rate>"
+      << "</physics>"
+      << "<model name='ground_plane'>"
+      << "  <static>true</static>"
+      << "  <link name='link'>"
+      << "    <collision name='collision'>"
+      << "      <geometry><plane><normal>0 0 1</normal>"
+      << "        <size>1000 1000</size></plane></geometry>"
+      << "    </collision>"
+      << "  </link>"
+      << "</model>"
+      << _models
+      << "</world>"
+      << "</sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+std::string ReferenceWorlds::BoxSdf(const std::string &_name,
+    const ignition::math::Vector3d &_pos, const double _size)
+{
+  std::ostringstream sdf;
+  sdf << "<model name='" << _name << "'>"
+      << "  <pose>" << _pos << " 0 0 0</pose>"
+      << "  <link name='link'>"
+      << "    <inertial><mass>1.0</mass></inertial>"
+      << "    <collision name='collision'>"
+      << "      <geometry><box><size>" << _size << " " << _size << " "
+      << _size << "</size></box></geometry>"
+      << "    </collision>"
+      << "    <visual name='visual'>"
+      << "      <geometry><box><size>" << _size << " " << _size << " "
+      << _size << "</size></box></geometry>"
+      << "    </visual>"
+      << "  </link>"
+      << "</model>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+std::string ReferenceWorlds::ArmSdf(const std::string &_name,
+    const ignition::math::Vector3d &_pos, const unsigned int _links)
+{
+  const double length = 0.3;
+
+  std::ostringstream sdf;
+  sdf << "<model name='" << _name << "'>"
+      << "  <pose>" << _pos << " 0 0 0</pose>";
+
+  for (unsigned int i = 0; i < _links; ++i)
+  {
+    sdf << "<link name='link_" << i << "'>"
+        << "  <pose>0 0 " << (i + 0.5) * length << " 0 0 0</pose>"
+        << "  <inertial><mass>1.0</mass>"
+        << "    <inertia><ixx>0.01</ixx><iyy>0.01</iyy><izz>0.002</izz>"
+        << "    <ixy>0</ixy><ixz>0</ixz><iyz>0</iyz></inertia>"
+        << "  </inertial>"
+        << "  <collision name='collision'>"
+        << "    <geometry><box><size>0.1 0.1 " << length * 0.9
+        << "</size></box></geometry>"
+        << "  </collision>"
+        << "</link>";
+
+    // Alternate joint axes so that the arm moves in 3D
+    sdf << "<joint name='joint_" << i << "' type='revolute'>"
+        << "  <parent>" << (i == 0 ? "world" : "link_" + std::to_string(i-1))
+        << "</parent>"
+        << "  <child>link_" << i << "</child>"
+        << "  <pose>0 0 " << -0.5 * length << " 0 0 0</pose>"
+        << "  <axis><xyz>" << (i % 2 == 0 ? "1 0 0" : "0 1 0") << "</xyz>"
+        << "    <dynamics><damping>0.1</damping></dynamics>"
+        << "  </axis>"
+        << "</joint>";
+  }
+  sdf << "</model>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+std::string ReferenceWorlds::LidarSdf(const std::string &_name,
+    const ignition::math::Vector3d &_pos)
+{
+  std::ostringstream sdf;
+  sdf << "<model name='" << _name << "'>"
+      << "  <static>true</static>"
+      << "  <pose>" << _pos << " 0 0 0</pose>"
+      << "  <link name='link'>"
+      << "    <sensor name='lidar' type='ray'>"
+      << "      <always_on>true</always_on>"
+      << "      <update_rate>10</update_rate>"
+      << "      <ray>"
+      << "        <scan>"
+      << "          <horizontal>"
+      << "            <samples>640</samples><resolution>1</resolution>"
+      << "            <min_angle>-3.14</min_angle><max_angle>3.14</max_angle>"
+      << "          </horizontal>"
+      << "          <vertical><samples>16</samples><resolution>1</resolution>"
+      << "            <min_angle>-0.26</min_angle><max_angle>0.26</max_angle>"
+      << "          </vertical>"
+      << "        </scan>"
+      << "        <range><min>0.1</min><max>30</max>"
+      << "          <resolution>0.01</resolution></range>"
+      << "      </ray>"
+      << "    </sensor>"
+      << "  </link>"
+      << "</model>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+void ReferenceWorlds::WriteTerrainMesh(const std::string &_filename,
+    const unsigned int _cells, const double _size)
+{
+  std::ofstream out(_filename.c_str());
+  const double step = _size / _cells;
+  for (unsigned int y = 0; y <= _cells; ++y)
+  {
+    for (unsigned int x = 0; x <= _cells; ++x)
+    {
+      const double px = x * step - _size * 0.5;
+      const double py = y * step - _size * 0.5;
+      const double pz = 0.5 * std::sin(px * 0.3) * std::cos(py * 0.2);
+      out << "v " << px << " " << py << " " << pz << "\n";
+    }
+  }
+
+  // OBJ indices are 1-based
+  const unsigned int row = _cells + 1;
+  for (unsigned int y = 0; y < _cells; ++y)
+  {
+    for (unsigned int x = 0; x < _cells; ++x)
+    {
+      const unsigned int i = y * row + x + 1;
+      out << "f " << i << " " << i + 1 << " " << i + row + 1 << "\n";
+      out << "f " << i << " " << i + row + 1 << " " << i + row << "\n";
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void ReferenceWorlds::OnWorldUpdateBegin()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->stepStarts.push_back(std::chrono::steady_clock::now());
+}
+
+/////////////////////////////////////////////////
+void ReferenceWorlds::Run(const std::string &_benchmark,
+    const std::string &_physicsEngine, const std::string &_models,
+    std::function<void ()> _setup)
+{
+  unsigned int steps = 2000;
+  const char *stepsEnv = std::getenv("GAZEBO_BENCHMARK_STEPS");
+  if (stepsEnv)
+    steps = std::max(1, std::atoi(stepsEnv));
+  const unsigned int warmupSteps = 100;
+
+  boost::filesystem::path worldPath =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gazebo_benchmark_%%%%%%.world");
+  {
+    std::ofstream out(worldPath.string().c_str());
+    out << WorldSdf(_physicsEngine, _models);
+  }
+
+  test::benchmark::ResetPeakRss();
+  const common::Time loadStart = common::Time::GetWallTime();
+  Load(worldPath.string(), true, _physicsEngine);
+  const double loadTime = (common::Time::GetWallTime() - loadStart).Double();
+  boost::filesystem::remove(worldPath);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  ASSERT_EQ(_physicsEngine, world->Physics()->GetType());
+
+  if (_setup)
+    _setup();
+
+  world->Step(warmupSteps);
+
+  // Reserve the step samples, so that recording them doesn't count as an
+  // allocation of the step. The world may take a few more steps before it
+  // is paused.
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stepStarts.clear();
+    this->stepStarts.reserve(2 * steps + 100);
+  }
+
+  event::ConnectionPtr connection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&ReferenceWorlds::OnWorldUpdateBegin, this));
+
+  const uint64_t allocStart = test::benchmark::AllocationCount();
+  const common::Time simStart = world->SimTime();
+  const common::Time wallStart = common::Time::GetWallTime();
+  const uint32_t targetIterations = world->Iterations() + steps;
+
+  // Run unpaused, as fast as possible, until enough steps were taken. Fail
+  // if the world stops stepping.
+  const common::Time stallTimeout(60);
+  uint32_t iterations = world->Iterations();
+  common::Time progressTime = common::Time::GetWallTime();
+  world->SetPaused(false);
+  while (iterations < targetIterations)
+  {
+    common::Time::MSleep(1);
+    if (world->Iterations() != iterations)
+    {
+      iterations = world->Iterations();
+      progressTime = common::Time::GetWallTime();
+    }
+    ASSERT_LT(common::Time::GetWallTime() - progressTime, stallTimeout)
+      << "World stalled at iteration " << iterations << " of "
+      << targetIterations;
+  }
+  world->SetPaused(true);
+
+  const double wallElapsed =
+    (common::Time::GetWallTime() - wallStart).Double();
+  const double simElapsed = (world->SimTime() - simStart).Double();
+  const uint64_t allocations =
+    test::benchmark::AllocationCount() - allocStart;
+  connection.reset();
+
+  std::vector<double> stepTimes;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (size_t i = 1; i < this->stepStarts.size(); ++i)
+    {
+      stepTimes.push_back(std::chrono::duration<double, std::micro>(
+          this->stepStarts[i] - this->stepStarts[i-1]).count());
+    }
+  }
+  ASSERT_FALSE(stepTimes.empty());
+
+  const double stepCount = static_cast<double>(stepTimes.size());
+  test::benchmark::Result result(_benchmark, _physicsEngine);
+  result.Add("model_count", world->ModelCount());
+  result.Add("load_time_s", loadTime);
+  result.Add("steps", stepCount);
+  result.Add("rtf", wallElapsed > 0 ? simElapsed / wallElapsed : 0.0);
+  result.Add("step_p50_us", test::benchmark::Percentile(stepTimes, 50));
+  result.Add("step_p90_us", test::benchmark::Percentile(stepTimes, 90));
+  result.Add("step_p99_us", test::benchmark::Percentile(stepTimes, 99));
+  result.Add("step_max_us", test::benchmark::Percentile(stepTimes, 100));
+  result.Add("allocations_per_step", allocations / stepCount);
+  result.Add("peak_rss_kb", test::benchmark::PeakRss());
+  result.Write();
+
+  for (auto const &metric : result.Metrics())
+    this->RecordProperty(metric.first, std::to_string(metric.second));
+}
+
+/////////////////////////////////////////////////
+// Many boxes resting on the ground, not touching each other.
+TEST_P(ReferenceWorlds, FreeBoxes)
+{
+  std::string models;
+  for (int x = 0; x < 25; ++x)
+  {
+    for (int y = 0; y < 20; ++y)
+    {
+      models += BoxSdf("box_" + std::to_string(x) + "_" + std::to_string(y),
+          ignition::math::Vector3d(x * 2.0, y * 2.0, 0.25), 0.5);
+    }
+  }
+  Run("free_boxes", GetParam(), models);
+}
+
+/////////////////////////////////////////////////
+// A pile of boxes dropped on top of each other.
+TEST_P(ReferenceWorlds, ContactPile)
+{
+  std::string models;
+  for (int z = 0; z < 6; ++z)
+  {
+    for (int x = 0; x < 8; ++x)
+    {
+      for (int y = 0; y < 8; ++y)
+      {
+        // Offset every other layer so that boxes land on edges
+        const double offset = (z % 2) * 0.25;
+        models += BoxSdf("box_" + std::to_string(x) + "_" +
+            std::to_string(y) + "_" + std::to_string(z),
+            ignition::math::Vector3d(x * 0.55 + offset, y * 0.55 + offset,
+              0.3 + z * 0.55), 0.5);
+      }
+    }
+  }
+  Run("contact_pile", GetParam(), models);
+}
+
+/////////////////////////////////////////////////
+// Several serial arms swinging under gravity.
+TEST_P(ReferenceWorlds, ArticulatedRobots)
+{
+  std::string models;
+  for (int i = 0; i < 10; ++i)
+  {
+    models += ArmSdf("arm_" + std::to_string(i),
+        ignition::math::Vector3d(i * 3.0, 0, 0.1), 7);
+  }
+  Run("articulated_robots", GetParam(), models);
+}
+
+/////////////////////////////////////////////////
+// A fleet of ray sensors looking at a field of boxes.
+TEST_P(ReferenceWorlds, LidarFleet)
+{
+  std::string models;
+  for (int i = 0; i < 20; ++i)
+  {
+    models += LidarSdf("lidar_" + std::to_string(i),
+        ignition::math::Vector3d((i % 5) * 4.0, (i / 5) * 4.0, 0.5));
+    models += BoxSdf("target_" + std::to_string(i),
+        ignition::math::Vector3d((i % 5) * 4.0 + 2.0, (i / 5) * 4.0, 0.25),
+        0.5);
+  }
+  Run("lidar_fleet", GetParam(), models);
+}
+
+/////////////////////////////////////////////////
+// Boxes resting on a large triangle mesh terrain.
+TEST_P(ReferenceWorlds, TrimeshTerrain)
+{
+  const std::string physicsEngine = GetParam();
+  if (physicsEngine == "simbody")
+  {
+    gzerr << "Aborting test for Simbody, mesh collisions are not supported"
+          << std::endl;
+    return;
+  }
+
+  boost::filesystem::path meshPath =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gazebo_benchmark_%%%%%%.obj");
+  WriteTerrainMesh(meshPath.string(), 256, 200.0);
+
+  std::ostringstream models;
+  models << "<model name='terrain'>"
+         << "  <static>true</static>"
+         << "  <link name='link'>"
+         << "    <collision name='collision'>"
+         << "      <geometry><mesh><uri>file://" << meshPath.string()
+         << "</uri></mesh></geometry>"
+         << "    </collision>"
+         << "  </link>"
+         << "</model>";
+  for (int i = 0; i < 50; ++i)
+  {
+    models << BoxSdf("box_" + std::to_string(i),
+        ignition::math::Vector3d((i % 10) * 5.0 - 25, (i / 10) * 5.0 - 10,
+          1.5), 0.5);
+  }
+
+  Run("trimesh_terrain", physicsEngine, models.str());
+  boost::filesystem::remove(meshPath);
+}
+
+/////////////////////////////////////////////////
+unsigned int g_poseMsgs = 0;
+void OnPoseInfo(const std::string &/*_msg*/)
+{
+  ++g_poseMsgs;
+}
+
+/////////////////////////////////////////////////
+// Many moving models with a subscriber on the pose topic, so that poses
+// are published every step.
+TEST_P(ReferenceWorlds, PosePublishing)
+{
+  std::string models;
+  for (int i = 0; i < 200; ++i)
+  {
+    models += BoxSdf("box_" + std::to_string(i),
+        ignition::math::Vector3d((i % 20) * 2.0, (i / 20) * 2.0, 2.0), 0.5);
+  }
+
+  g_poseMsgs = 0;
+  transport::SubscriberPtr poseSub;
+  Run("pose_publishing", GetParam(), models, [&]()
+      {
+        poseSub = this->node->Subscribe("~/pose/info", &OnPoseInfo);
+      });
+  poseSub.reset();
+
+  gzmsg << "Received " << g_poseMsgs << " pose messages" << std::endl;
+}
+
+INSTANTIATE_TEST_CASE_P(PhysicsEngines, ReferenceWorlds,
+    PHYSICS_ENGINE_VALUES,);  // NOLINT
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
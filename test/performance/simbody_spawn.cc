@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Spawn benchmark for Simbody. Spawns 500 boxes into a running Simbody
+// world, either with one factory message per model or as a single batch,
+// and reports the time until all models exist and the longest step while
+// spawning. Set GAZEBO_BENCHMARK_RESULTS to a file path to collect the
+// results as JSON lines.
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/performance/Benchmark.hh"
+
+using namespace gazebo;
+
+/// \brief Number of models to spawn.
+static const unsigned int modelCount = 500;
+
+class SimbodySpawn : public ServerFixture
+{
+  /// \brief Load a Simbody world, spawn the models and report.
+  /// \param[in] _variant Name of the benchmark variant.
+  /// \param[in] _batch True to spawn all models as a single batch.
+  public: void Run(const std::string &_variant, const bool _batch);
+
+  /// \brief Get the SDF of a box model.
+  /// \param[in] _name Name of the model.
+  /// \param[in] _index Index of the model, used to place it.
+  /// \return SDF string.
+  public: static std::string BoxSdf(const std::string &_name,
+              const unsigned int _index);
+
+  /// \brief Record the wall time of a world update.
+  public: void OnUpdate();
+
+  /// \brief Protects stepStarts.
+  public: std::mutex mutex;
+
+  /// \brief Wall time at the beginning of each world update.
+  public: std::vector<std::chrono::steady_clock::time_point> stepStarts;
+};
+
+/////////////////////////////////////////////////
+std::string SimbodySpawn::BoxSdf(const std::string &_name,
+    const unsigned int _index)
+{
+  // Spread the boxes on a grid so that they don't touch
+  const double x = (_index % 25) * 1.5;
+  const double y = (_index / 25) * 1.5;
+
+  std::ostringstream sdf;
+  sdf << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='" << _name << "'>"
+      << "  <pose>" << x << " " << y << " 0.25 0 0 0</pose>"
+      << "  <link name='link'>"
+      << "    <collision name='collision'>"
+      << "      <geometry><box><size>0.5 0.5 0.5</size></box></geometry>"
+      << "    </collision>"
+      << "  </link>"
+      << "</model>"
+      << "</sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+void SimbodySpawn::OnUpdate()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->stepStarts.push_back(std::chrono::steady_clock::now());
+}
+
+/////////////////////////////////////////////////
+void SimbodySpawn::Run(const std::string &_variant, const bool _batch)
+{
+  this->Load("worlds/empty.world", true, "simbody");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  const unsigned int initialCount = world->ModelCount();
+
+  std::vector<std::string> sdfs;
+  for (unsigned int i = 0; i < modelCount; ++i)
+    sdfs.push_back(BoxSdf("box_" + std::to_string(i), i));
+
+  this->stepStarts.clear();
+  event::ConnectionPtr connection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&SimbodySpawn::OnUpdate, this));
+
+  // Spawn into a running world
+  world->SetPaused(false);
+  const common::Time wallStart = common::Time::GetWallTime();
+
+  if (_batch)
+  {
+    world->InsertModelStrings(sdfs);
+  }
+  else
+  {
+    for (auto const &sdf : sdfs)
+    {
+      msgs::Factory msg;
+      msg.set_sdf(sdf);
+      this->factoryPub->Publish(msg);
+    }
+  }
+
+  const common::Time timeout(120, 0);
+  while (world->ModelCount() < initialCount + modelCount &&
+         common::Time::GetWallTime() - wallStart < timeout)
+  {
+    common::Time::MSleep(1);
+  }
+  const double spawnTime = (common::Time::GetWallTime() - wallStart).Double();
+  world->SetPaused(true);
+  connection.reset();
+
+  EXPECT_EQ(world->ModelCount(), initialCount + modelCount);
+
+  std::vector<double> stepTimes;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (size_t i = 1; i < this->stepStarts.size(); ++i)
+    {
+      stepTimes.push_back(std::chrono::duration<double, std::micro>(
+          this->stepStarts[i] - this->stepStarts[i-1]).count());
+    }
+  }
+
+  test::benchmark::Result result("simbody_spawn", _variant);
+  result.Add("model_count", modelCount);
+  result.Add("spawn_time_s", spawnTime);
+  result.Add("steps", stepTimes.size());
+  result.Add("step_p50_us", test::benchmark::Percentile(stepTimes, 50));
+  result.Add("step_max_us", test::benchmark::Percentile(stepTimes, 100));
+  result.Write();
+
+  for (auto const &metric : result.Metrics())
+    this->RecordProperty(metric.first, std::to_string(metric.second));
+}
+
+/////////////////////////////////////////////////
+// One factory message per model. Models that arrive in the same step share
+// a topology rebuild.
+TEST_F(SimbodySpawn, Individual)
+{
+#ifdef HAVE_SIMBODY
+  Run("individual", false);
+#endif
+}
+
+/////////////////////////////////////////////////
+// All models in one batch, loaded with a single topology rebuild.
+TEST_F(SimbodySpawn, Batch)
+{
+#ifdef HAVE_SIMBODY
+  Run("batch", true);
+#endif
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
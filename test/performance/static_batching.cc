@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Static batching benchmark. Renders a static model made of many wall and
+// floor pieces with a camera sensor updating as fast as possible, with and
+// without static batching, and reports the frame rate and the CPU time of
+// the render thread per frame. Runs headless, for example under Mesa with
+// "xvfb-run -s '-screen 0 1280x1024x24'". Set GAZEBO_BENCHMARK_RESULTS to a
+// file path to collect the results as JSON lines.
+
+#include <time.h>
+
+#include <atomic>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include "gazebo/rendering/rendering.hh"
+#include "gazebo/sensors/sensors.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/performance/Benchmark.hh"
+
+using namespace gazebo;
+
+/// \brief CPU time of the calling thread.
+/// \return Time in milliseconds.
+static double ThreadCpuMs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+class StaticBatching : public ServerFixture,
+    public testing::WithParamInterface<std::tuple<unsigned int, bool>>
+{
+  /// \brief Get the SDF of a static model with pieces of wall and floor on
+  /// a grid, all in one link, with a few different materials.
+  /// \param[in] _count Number of pieces.
+  /// \return SDF string.
+  public: static std::string BuildingSdf(const unsigned int _count);
+};
+
+/////////////////////////////////////////////////
+std::string StaticBatching::BuildingSdf(const unsigned int _count)
+{
+  const char *materials[] = {"Gazebo/Grey", "Gazebo/Wood", "Gazebo/Bricks"};
+  const unsigned int side =
+      static_cast<unsigned int>(std::ceil(std::sqrt(_count)));
+
+  std::ostringstream sdf;
+  sdf << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='building'>"
+      << "  <static>true</static>"
+      << "  <link name='link'>";
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    // Alternate floor tiles and wall pieces
+    const bool wall = i % 2;
+    sdf << "<visual name='visual_" << i << "'>"
+        << "  <pose>" << (i % side) * 1.0 << " "
+        << (i / side) * 1.0 - side * 0.5 << " "
+        << (wall ? 0.5 : 0.0) << " 0 0 0</pose>"
+        << "  <geometry><box><size>"
+        << (wall ? "1 0.1 1" : "1 1 0.02")
+        << "</size></box></geometry>"
+        << "  <material><script>"
+        << "    <uri>file://media/materials/scripts/gazebo.material</uri>"
+        << "    <name>" << materials[(i / 2) % 3] << "</name>"
+        << "  </script></material>"
+        << "</visual>";
+  }
+  sdf << "  </link>"
+      << "</model>"
+      << "</sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+TEST_P(StaticBatching, CameraSensor)
+{
+  const unsigned int count = std::get<0>(GetParam());
+  const bool batching = std::get<1>(GetParam());
+
+  this->Load("worlds/empty.world");
+
+  if (rendering::RenderEngine::Instance()->GetRenderPathType() ==
+      rendering::RenderEngine::NONE)
+  {
+    gzerr << "No rendering engine, unable to run static batching benchmark\n";
+    return;
+  }
+
+  rendering::ScenePtr scene = rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  scene->SetStaticBatchingEnabled(batching);
+
+  this->SpawnSDF(BuildingSdf(count));
+
+  // Wait for the last visual to reach the scene
+  const std::string lastVisual =
+      "building::link::visual_" + std::to_string(count - 1);
+  int sleep = 0;
+  while (!scene->GetVisual(lastVisual) && sleep++ < 600)
+    common::Time::MSleep(100);
+  ASSERT_TRUE(scene->GetVisual(lastVisual) != nullptr);
+
+  // Camera above the building looking at most of it, updating without
+  // limit
+  this->SpawnCamera("camera_model", "camera_sensor",
+      ignition::math::Vector3d(-10, 0, 20),
+      ignition::math::Vector3d(0, 0.8, 0), 640, 480, 0);
+  sensors::CameraSensorPtr camSensor =
+      std::dynamic_pointer_cast<sensors::CameraSensor>(
+      sensors::get_sensor("camera_sensor"));
+  ASSERT_TRUE(camSensor != nullptr);
+
+  std::atomic<unsigned int> frames(0);
+  event::ConnectionPtr frameConnection =
+      camSensor->Camera()->ConnectNewImageFrame(
+      [&frames](const unsigned char *, unsigned int, unsigned int,
+        unsigned int, const std::string &)
+      {
+        ++frames;
+      });
+
+  // CPU time of the render thread, between the start and the end of each
+  // render of the sensors
+  std::atomic<double> renderCpuMs(0);
+  std::atomic<unsigned int> renders(0);
+  double renderStart = 0;
+  event::ConnectionPtr preRenderConnection =
+      event::Events::ConnectPreRender([&renderStart]()
+      {
+        renderStart = ThreadCpuMs();
+      });
+  event::ConnectionPtr postRenderConnection =
+      event::Events::ConnectPostRender([&]()
+      {
+        renderCpuMs = renderCpuMs + (ThreadCpuMs() - renderStart);
+        ++renders;
+      });
+
+  // Wait for the batches to be built
+  sleep = 0;
+  while (batching && scene->StaticBatchedVisualCount() < count &&
+         sleep++ < 100)
+  {
+    common::Time::MSleep(100);
+  }
+  common::Time::MSleep(1000);
+
+  frames = 0;
+  renders = 0;
+  renderCpuMs = 0;
+  const common::Time start = common::Time::GetWallTime();
+  common::Time::MSleep(5000);
+  const double elapsed = (common::Time::GetWallTime() - start).Double();
+  const unsigned int measuredFrames = frames;
+  const unsigned int measuredRenders = renders;
+  const double measuredCpuMs = renderCpuMs;
+  frameConnection.reset();
+  preRenderConnection.reset();
+  postRenderConnection.reset();
+
+  EXPECT_GT(measuredFrames, 0u);
+  ASSERT_GT(measuredRenders, 0u);
+  if (batching)
+    EXPECT_GE(scene->StaticBatchedVisualCount(), count);
+  else
+    EXPECT_EQ(scene->StaticBatchedVisualCount(), 0u);
+
+  test::benchmark::Result result("static_batching",
+      std::to_string(count) + (batching ? "_batched" : "_entities"));
+  result.Add("objects", count);
+  result.Add("fps", measuredFrames / elapsed);
+  result.Add("render_cpu_ms", measuredCpuMs / measuredRenders);
+  result.Add("batched_visuals", scene->StaticBatchedVisualCount());
+  result.Write();
+  for (auto const &metric : result.Metrics())
+    this->RecordProperty(metric.first, std::to_string(metric.second));
+}
+
+INSTANTIATE_TEST_CASE_P(ObjectCounts, StaticBatching,
+    ::testing::Combine(::testing::Values(1000u, 5000u, 20000u),
+    ::testing::Bool()),);  // NOLINT
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
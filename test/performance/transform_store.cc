@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Pose propagation benchmark. Measures setting model world poses and
+// reading collision world poses, in the small world of set_world_pose.cc
+// and in a world with 10000 collisions, and the step time of that world
+// while all links move. Set GAZEBO_BENCHMARK_RESULTS to a file path to
+// collect the results as JSON lines.
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/TransformStore.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/performance/Benchmark.hh"
+
+using namespace gazebo;
+
+/// \brief Number of models in the large world.
+static const unsigned int modelCount = 1000;
+
+/// \brief Number of collisions of each model in the large world.
+static const unsigned int collisionsPerModel = 10;
+
+class TransformStoreBenchmark : public ServerFixture
+{
+  /// \brief Get the SDF of a model with one link and many collisions.
+  /// \param[in] _name Name of the model.
+  /// \param[in] _index Index of the model, used to place it.
+  /// \return SDF string.
+  public: static std::string ModelSdf(const std::string &_name,
+              const unsigned int _index);
+
+  /// \brief Load a world with modelCount models.
+  /// \return The world.
+  public: physics::WorldPtr LoadLargeWorld();
+
+  /// \brief Sum the collision world poses of a list of models, so that
+  /// the reads can't be optimized away.
+  /// \param[in] _models The models.
+  /// \return Sum of the collision positions.
+  public: static double ReadCollisions(const physics::Model_V &_models);
+
+  /// \brief Report a benchmark result.
+  /// \param[in] _result The result.
+  public: void Report(const test::benchmark::Result &_result);
+};
+
+/////////////////////////////////////////////////
+std::string TransformStoreBenchmark::ModelSdf(const std::string &_name,
+    const unsigned int _index)
+{
+  // Spread the models on a grid high above the ground, so that they fall
+  // without touching anything
+  const double x = (_index % 40) * 2.0;
+  const double y = (_index / 40) * 2.0;
+
+  std::ostringstream sdf;
+  sdf << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='" << _name << "'>"
+      << "  <pose>" << x << " " << y << " 100 0 0 0</pose>"
+      << "  <link name='link'>";
+  for (unsigned int i = 0; i < collisionsPerModel; ++i)
+  {
+    sdf << "<collision name='collision_" << i << "'>"
+        << "  <pose>" << i * 0.1 << " 0 0 0 0 " << i * 0.1 << "</pose>"
+        << "  <geometry><box><size>0.1 0.1 0.1</size></box></geometry>"
+        << "</collision>";
+  }
+  sdf << "  </link>"
+      << "</model>"
+      << "</sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+physics::WorldPtr TransformStoreBenchmark::LoadLargeWorld()
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  if (!world)
+    return world;
+
+  const unsigned int initialCount = world->ModelCount();
+
+  std::vector<std::string> sdfs;
+  for (unsigned int i = 0; i < modelCount; ++i)
+    sdfs.push_back(ModelSdf("model_" + std::to_string(i), i));
+  world->InsertModelStrings(sdfs);
+
+  // Models are created by the world thread
+  world->SetPaused(false);
+  const common::Time wallStart = common::Time::GetWallTime();
+  while (world->ModelCount() < initialCount + modelCount &&
+         common::Time::GetWallTime() - wallStart < common::Time(120, 0))
+  {
+    common::Time::MSleep(10);
+  }
+  world->SetPaused(true);
+
+  return world;
+}
+
+/////////////////////////////////////////////////
+double TransformStoreBenchmark::ReadCollisions(
+    const physics::Model_V &_models)
+{
+  double sum = 0;
+  for (auto const &model : _models)
+  {
+    for (auto const &link : model->GetLinks())
+    {
+      for (auto const &collision : link->GetCollisions())
+        sum += collision->WorldPose().Pos().Z();
+    }
+  }
+  return sum;
+}
+
+/////////////////////////////////////////////////
+void TransformStoreBenchmark::Report(const test::benchmark::Result &_result)
+{
+  _result.Write();
+  for (auto const &metric : _result.Metrics())
+    this->RecordProperty(metric.first, std::to_string(metric.second));
+}
+
+/////////////////////////////////////////////////
+// The workload of set_world_pose.cc: one model moved many times.
+TEST_F(TransformStoreBenchmark, SetWorldPose)
+{
+  this->Load("worlds/box_plane_low_friction_test.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::Model_V models = {model};
+
+  const unsigned int iterations = 1000000;
+  double sum = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    model->SetWorldPose(ignition::math::Pose3d(1, 2, 3 + (i % 2), 0, 0, 0));
+    sum += ReadCollisions(models);
+  }
+  const double elapsed = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_GT(sum, 0);
+
+  test::benchmark::Result result("transform_store", "set_world_pose");
+  result.Add("iterations", iterations);
+  result.Add("set_and_read_ns", elapsed / iterations);
+  this->Report(result);
+}
+
+/////////////////////////////////////////////////
+// Teleport every model of a world with 10000 collisions, then read all
+// collision world poses.
+TEST_F(TransformStoreBenchmark, TeleportLargeWorld)
+{
+  physics::WorldPtr world = this->LoadLargeWorld();
+  ASSERT_TRUE(world != nullptr);
+
+  physics::Model_V models;
+  for (unsigned int i = 0; i < modelCount; ++i)
+  {
+    physics::ModelPtr model = world->ModelByName("model_" + std::to_string(i));
+    ASSERT_TRUE(model != nullptr);
+    models.push_back(model);
+  }
+  EXPECT_GE(world->Transforms().Size(), modelCount * (collisionsPerModel + 1));
+
+  const unsigned int iterations = 100;
+  std::vector<double> setTimes;
+  std::vector<double> readTimes;
+  double sum = 0;
+
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (auto &model : models)
+    {
+      ignition::math::Pose3d pose = model->WorldPose();
+      pose.Pos().Z() += (i % 2) ? 0.01 : -0.01;
+      model->SetWorldPose(pose);
+    }
+    auto set = std::chrono::steady_clock::now();
+    sum += ReadCollisions(models);
+    auto read = std::chrono::steady_clock::now();
+
+    setTimes.push_back(
+        std::chrono::duration<double, std::micro>(set - start).count());
+    readTimes.push_back(
+        std::chrono::duration<double, std::micro>(read - set).count());
+  }
+
+  EXPECT_GT(sum, 0);
+
+  test::benchmark::Result result("transform_store", "teleport_10k");
+  result.Add("collisions", modelCount * collisionsPerModel);
+  result.Add("set_p50_us", test::benchmark::Percentile(setTimes, 50));
+  result.Add("read_p50_us", test::benchmark::Percentile(readTimes, 50));
+  result.Add("read_max_us", test::benchmark::Percentile(readTimes, 100));
+  this->Report(result);
+}
+
+/////////////////////////////////////////////////
+// Step a world with 10000 collisions whose links all move, so that every
+// step applies 1000 dirty poses and propagates them to the collisions.
+TEST_F(TransformStoreBenchmark, StepLargeWorld)
+{
+  physics::WorldPtr world = this->LoadLargeWorld();
+  ASSERT_TRUE(world != nullptr);
+
+  const unsigned int steps = 200;
+  std::vector<double> stepTimes;
+  for (unsigned int i = 0; i < steps; ++i)
+  {
+    auto start = std::chrono::steady_clock::now();
+    world->Step(1);
+    stepTimes.push_back(std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count());
+  }
+
+  // All collisions fell with their links
+  physics::ModelPtr model = world->ModelByName("model_0");
+  ASSERT_TRUE(model != nullptr);
+  auto collision = model->GetLink("link")->GetCollision("collision_0");
+  ASSERT_TRUE(collision != nullptr);
+  EXPECT_LT(collision->WorldPose().Pos().Z(), 100.0);
+  EXPECT_NEAR(collision->WorldPose().Pos().Z(),
+      model->GetLink("link")->WorldPose().Pos().Z(), 1e-6);
+
+  test::benchmark::Result result("transform_store", "step_10k");
+  result.Add("collisions", modelCount * collisionsPerModel);
+  result.Add("step_p50_us", test::benchmark::Percentile(stepTimes, 50));
+  result.Add("step_max_us", test::benchmark::Percentile(stepTimes, 100));
+  this->Report(result);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// Ping-pong latency benchmark. One node publishes a ping, a second node
+// answers each ping with a pong, and the round trip time of each exchange
+// is recorded. Set GAZEBO_BENCHMARK_RESULTS to a file path to collect the
+// results as JSON lines.
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gazebo/test/ServerFixture.hh"
+#include "test/performance/Benchmark.hh"
+
+using namespace gazebo;
+
+/// \brief Number of measured round trips.
+static const unsigned int iterations = 1000;
+
+/// \brief Number of round trips before measuring.
+static const unsigned int warmup = 50;
+
+class TransportLatency : public ServerFixture
+{
+  /// \brief Run the ping-pong exchange and report.
+  /// \param[in] _variant Name of the benchmark variant.
+  /// \param[in] _size Size of the payload of each message, in bytes.
+  public: void Run(const std::string &_variant, const unsigned int _size);
+
+  /// \brief Answer a ping.
+  /// \param[in] _msg The ping.
+  public: void OnPing(ConstGzStringPtr &_msg);
+
+  /// \brief Receive a pong.
+  /// \param[in] _msg The pong.
+  public: void OnPong(ConstGzStringPtr &_msg);
+
+  /// \brief Publisher of pongs.
+  public: transport::PublisherPtr pongPub;
+
+  /// \brief Protects pongs.
+  public: std::mutex mutex;
+
+  /// \brief Notified when a pong arrives.
+  public: std::condition_variable condition;
+
+  /// \brief Number of pongs received.
+  public: unsigned int pongs = 0;
+};
+
+/////////////////////////////////////////////////
+void TransportLatency::OnPing(ConstGzStringPtr &_msg)
+{
+  this->pongPub->Publish(*_msg);
+}
+
+/////////////////////////////////////////////////
+void TransportLatency::OnPong(ConstGzStringPtr &/*_msg*/)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    ++this->pongs;
+  }
+  this->condition.notify_one();
+}
+
+/////////////////////////////////////////////////
+void TransportLatency::Run(const std::string &_variant,
+    const unsigned int _size)
+{
+  this->Load("worlds/empty.world", true);
+
+  transport::NodePtr pingNode(new transport::Node());
+  pingNode->Init("default");
+  transport::NodePtr pongNode(new transport::Node());
+  pongNode->Init("default");
+
+  transport::PublisherPtr pingPub =
+    pingNode->Advertise<msgs::GzString>("~/test/ping");
+  this->pongPub = pongNode->Advertise<msgs::GzString>("~/test/pong");
+
+  transport::SubscriberPtr pingSub = pongNode->Subscribe("~/test/ping",
+      &TransportLatency::OnPing, this);
+  transport::SubscriberPtr pongSub = pingNode->Subscribe("~/test/pong",
+      &TransportLatency::OnPong, this);
+
+  pingPub->WaitForConnection();
+  this->pongPub->WaitForConnection();
+
+  msgs::GzString msg;
+  msg.set_data(std::string(_size, 'x'));
+
+  std::vector<double> roundTrips;
+  unsigned int lost = 0;
+  for (unsigned int i = 0; i < warmup + iterations; ++i)
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    const unsigned int expected = this->pongs + 1;
+
+    auto start = std::chrono::steady_clock::now();
+    pingPub->Publish(msg);
+    bool received = this->condition.wait_for(lock, std::chrono::seconds(1),
+        [&]
+        {
+          return this->pongs >= expected;
+        });
+    auto end = std::chrono::steady_clock::now();
+
+    if (!received)
+    {
+      ++lost;
+      this->pongs = expected;
+      continue;
+    }
+
+    if (i >= warmup)
+    {
+      roundTrips.push_back(
+          std::chrono::duration<double, std::micro>(end - start).count());
+    }
+  }
+
+  EXPECT_EQ(lost, 0u);
+
+  test::benchmark::Result result("transport_latency", _variant);
+  result.Add("round_trips", roundTrips.size());
+  result.Add("payload_bytes", _size);
+  result.Add("rtt_p50_us", test::benchmark::Percentile(roundTrips, 50));
+  result.Add("rtt_p99_us", test::benchmark::Percentile(roundTrips, 99));
+  result.Add("rtt_max_us", test::benchmark::Percentile(roundTrips, 100));
+  result.Write();
+
+  for (auto const &metric : result.Metrics())
+    this->RecordProperty(metric.first, std::to_string(metric.second));
+
+  pingSub.reset();
+  pongSub.reset();
+  this->pongPub.reset();
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransportLatency, Small)
+{
+  Run("small", 16);
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransportLatency, Large)
+{
+  Run("large", 100000);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -19,7 +19,10 @@
 #include <tinyxml.h>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <cmath>
 #include <streambuf>
+#include <vector>
 
 #include <gazebo/common/common.hh>
 #include <gazebo/transport/transport.hh>
@@ -900,7 +903,9 @@ StatsCommand::StatsCommand()
     ("world-name,w", po::value<std::string>(), "World name.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run.")
     ("plot,p", "Output comma-separated values, useful for processing and "
-     "plotting.");
+     "plotting.")
+    ("plugins", "Print time spent in the world update callbacks of each "
+     "plugin.");
 }
 
 /////////////////////////////////////////////////
@@ -910,6 +915,10 @@ void StatsCommand::HelpDetailed()
     "\tPrint gzserver statics to standard out. If a name for the world, \n"
     "\toption -w, is not specified, the first world found on \n"
     "\tthe Gazebo master will be used.\n"
+    "\n"
+    "\tWith --plugins, the time spent in the event callbacks of each \n"
+    "\tplugin is printed once per second. Timing is only enabled on \n"
+    "\tthe server while this command is running.\n"
     << std::endl;
 }
 
@@ -924,8 +933,14 @@ bool StatsCommand::RunImpl()
   transport::NodePtr node(new transport::Node());
   node->Init(worldName);
 
-  transport::SubscriberPtr sub =
-    node->Subscribe("~/world_stats", &StatsCommand::CB, this);
+  transport::SubscriberPtr sub;
+  if (this->vm.count("plugins"))
+  {
+    sub = node->Subscribe("~/diagnostics", &StatsCommand::DiagnosticsCB,
+        this);
+  }
+  else
+    sub = node->Subscribe("~/world_stats", &StatsCommand::CB, this);
 
   boost::mutex::scoped_lock lock(this->sigMutex);
   if (this->vm.count("duration"))
@@ -1002,6 +1017,85 @@ void StatsCommand::CB(ConstWorldStatisticsPtr &_msg)
         percent, simTime.Double(), realTime.Double(), paused);
 }
 
+/////////////////////////////////////////////////
+void StatsCommand::DiagnosticsCB(ConstDiagnosticsPtr &_msg)
+{
+  GZ_ASSERT(_msg, "Invalid message received");
+
+  // Diagnostics are published every step, only print once per second
+  common::Time now = common::Time::GetWallTime();
+  if (now - this->lastPluginPrint < common::Time(1, 0))
+    return;
+  this->lastPluginPrint = now;
+
+  // Sort by mean time per step, most expensive first
+  std::vector<const msgs::Diagnostics::PluginTime *> times;
+  for (int i = 0; i < _msg->plugin_time_size(); ++i)
+    times.push_back(&_msg->plugin_time(i));
+  std::sort(times.begin(), times.end(),
+      [](const msgs::Diagnostics::PluginTime *_a,
+         const msgs::Diagnostics::PluginTime *_b)
+      {
+        return _a->total() / _a->steps() > _b->total() / _b->steps();
+      });
+
+  const bool plot = this->vm.count("plot") > 0;
+  if (plot)
+  {
+    static bool first = true;
+    if (first)
+    {
+      std::cout << "# simtime (sec), scope, plugin name, filename, event, "
+        << "steps, mean (us), max (us), p99 (us)\n";
+      first = false;
+    }
+  }
+  else
+  {
+    printf("SimTime[%4.2f]\n", msgs::Convert(_msg->sim_time()).Double());
+    printf("%-48s %-20s %10s %10s %10s %10s\n", "Plugin", "Event", "Steps",
+        "Mean[us]", "Max[us]", "P99[us]");
+  }
+
+  for (auto const &time : times)
+  {
+    // Upper bound of the bucket holding the 99th percentile
+    uint64_t p99Count = static_cast<uint64_t>(time->steps() * 0.99);
+    uint64_t cumulative = 0;
+    double p99 = 0;
+    for (int b = 0; b < time->histogram_size(); ++b)
+    {
+      cumulative += time->histogram(b);
+      p99 = std::pow(2.0, b);
+      if (cumulative > p99Count)
+        break;
+    }
+
+    const double mean = time->total() / time->steps() * 1e6;
+    const double max = time->max() * 1e6;
+    const std::string event = time->event().empty() ? "-" : time->event();
+
+    if (plot)
+    {
+      printf("%f, %s, %s, %s, %s, %llu, %f, %f, %f\n",
+          msgs::Convert(_msg->sim_time()).Double(), time->scope().c_str(),
+          time->name().c_str(), time->filename().c_str(), event.c_str(),
+          static_cast<unsigned long long>(time->steps()),  // NOLINT
+          mean, max, p99);
+    }
+    else
+    {
+      std::string label = time->scope() + "::" + time->name() + " (" +
+        time->filename() + ")";
+      printf("%-48s %-20s %10llu %10.1f %10.1f %10.0f\n", label.c_str(),
+          event.c_str(),
+          static_cast<unsigned long long>(time->steps()),  // NOLINT
+          mean, max, p99);
+    }
+  }
+  fflush(stdout);
+}
+
 /////////////////////////////////////////////////
 SDFCommand::SDFCommand()
   : Command("sdf",
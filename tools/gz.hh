@@ -195,11 +195,18 @@ namespace gazebo
     /// \param[in] _msg World statistics message.
     private: void CB(ConstWorldStatisticsPtr &_msg);
 
+    /// \brief Diagnostics callback, prints plugin timing.
+    /// \param[in] _msg Diagnostics message.
+    private: void DiagnosticsCB(ConstDiagnosticsPtr &_msg);
+
     /// \brief Sim time buffer
     private: std::list<common::Time> simTimes;
 
     /// \brief Real time buffer
     private: std::list<common::Time> realTimes;
+
+    /// \brief Wall time at which plugin timing was last printed.
+    private: common::Time lastPluginPrint;
   };
 
   /// \brief SDF command
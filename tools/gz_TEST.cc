@@ -700,6 +700,11 @@ TEST_F(gzTest, Topic)
   output = custom_exec_str("gz topic -b /gazebo/default/world_stats -d 10");
   EXPECT_NE(output.find("Total["), std::string::npos);
 
+  // Stats
+  output = custom_exec_str("gz topic -s /gazebo/default/world_stats -d 2");
+  EXPECT_NE(output.find("Rate["), std::string::npos);
+  EXPECT_NE(output.find("Transfer[ms]"), std::string::npos);
+
   // Request
   output = custom_exec_str("gz topic -r entity_list");
   EXPECT_NE(output.find("models {"), std::string::npos);
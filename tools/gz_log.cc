@@ -22,6 +22,16 @@
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -591,6 +601,259 @@ std::string StateFilter::Filter(const std::string &_stateString)
   return result.str();
 }
 
+/////////////////////////////////////////////////
+/// \brief Read the value of the name attribute of a tag.
+/// \param[in] _tag Text of the tag, without the angle brackets.
+/// \return The name, empty if the tag has no name attribute.
+static std::string TagName(const std::string &_tag)
+{
+  size_t pos = _tag.find(" name=");
+  if (pos == std::string::npos || pos + 7 > _tag.size())
+    return std::string();
+
+  const char quote = _tag[pos + 6];
+  size_t end = _tag.find(quote, pos + 7);
+  if (end == std::string::npos)
+    return std::string();
+
+  return _tag.substr(pos + 7, end - pos - 7);
+}
+
+/////////////////////////////////////////////////
+/// \brief Convert whitespace separated values to comma separated values.
+/// \param[in] _text The values.
+/// \param[in] _count Expected number of values.
+/// \param[out] _csv The comma separated values.
+/// \return True if _text has exactly _count values.
+static bool ToCsv(const std::string &_text, const unsigned int _count,
+    std::string &_csv)
+{
+  _csv.clear();
+  unsigned int count = 0;
+  size_t pos = _text.find_first_not_of(" \t\r\n");
+  while (pos != std::string::npos)
+  {
+    size_t end = _text.find_first_of(" \t\r\n", pos);
+    if (count > 0)
+      _csv += ',';
+    _csv.append(_text, pos,
+        end == std::string::npos ? std::string::npos : end - pos);
+    ++count;
+    pos = _text.find_first_not_of(" \t\r\n", end);
+  }
+  return count == _count;
+}
+
+/////////////////////////////////////////////////
+PoseExporter::PoseExporter(const std::string &_filter)
+{
+  std::string modelFilter = _filter;
+  std::string linkFilter;
+
+  size_t slash = _filter.find('/');
+  if (slash != std::string::npos)
+  {
+    modelFilter = _filter.substr(0, slash);
+    linkFilter = _filter.substr(slash + 1);
+  }
+
+  if (modelFilter.empty())
+    modelFilter = "*";
+
+  // Every chunk with a matching model contains the text up to the first
+  // wildcard.
+  this->modelLiteral = modelFilter.substr(0,
+      modelFilter.find_first_of("*.[](){}|+?^$\\"));
+
+  boost::replace_all(modelFilter, "*", ".*");
+  this->modelRegex = boost::regex(modelFilter);
+
+  this->exportLinks = !linkFilter.empty();
+  boost::replace_all(linkFilter, "*", ".*");
+  this->linkRegex = boost::regex(linkFilter);
+}
+
+/////////////////////////////////////////////////
+std::string PoseExporter::ExportChunk(const std::string &_chunk,
+    MatchCache &_cache, size_t &_rows) const
+{
+  std::string result;
+  _rows = 0;
+
+  // Scoped names of the models, and name of the link, that enclose the
+  // current position
+  std::vector<std::string> models;
+  std::string link;
+  std::string simTime;
+  std::string pose;
+  std::string tag;
+
+  size_t pos = _chunk.find('<');
+  while (pos != std::string::npos)
+  {
+    size_t end = _chunk.find('>', pos);
+    if (end == std::string::npos)
+      break;
+
+    tag.assign(_chunk, pos + 1, end - pos - 1);
+    pos = end + 1;
+
+    if (tag.empty() || tag[0] == '?' || tag[0] == '!')
+    {
+      pos = _chunk.find('<', pos);
+      continue;
+    }
+
+    const bool closing = tag[0] == '/';
+    const bool empty = tag.back() == '/';
+    const std::string name = tag.substr(closing ? 1 : 0,
+        tag.find_first_of(" /", 1) - (closing ? 1 : 0));
+
+    if (closing)
+    {
+      if (name == "model" && !models.empty())
+        models.pop_back();
+      else if (name == "link")
+        link.clear();
+    }
+    else if (name == "world" || name == "insertions")
+    {
+      // Skip world descriptions and inserted models, which are not part
+      // of the state.
+      if (!empty)
+      {
+        end = _chunk.find("</" + name + ">", pos);
+        pos = end == std::string::npos ? end : end + name.size() + 3;
+      }
+    }
+    else if (name == "state")
+    {
+      models.clear();
+      link.clear();
+      simTime.clear();
+    }
+    else if (name == "model" && !empty)
+    {
+      models.push_back(models.empty() ? TagName(tag) :
+          models.back() + "::" + TagName(tag));
+    }
+    else if (name == "link" && !empty)
+    {
+      link = TagName(tag);
+    }
+    else if (name == "sim_time" && !empty)
+    {
+      end = _chunk.find('<', pos);
+      std::string value;
+      if (end != std::string::npos && ToCsv(_chunk.substr(pos, end - pos), 2,
+            value))
+      {
+        size_t comma = value.find(',');
+        char nsec[16];
+        std::snprintf(nsec, sizeof(nsec), "%09ld",
+            std::strtol(value.c_str() + comma + 1, nullptr, 10));
+        simTime = value.substr(0, comma) + "." + nsec;
+      }
+    }
+    else if (name == "pose" && !empty && !models.empty())
+    {
+      // Poses inside a link belong to the link, all others to the
+      // innermost model.
+      const bool isLink = !link.empty();
+      if (isLink == this->exportLinks)
+      {
+        const std::string &model = models.back();
+        const std::string key = isLink ? model + "/" + link : model;
+
+        auto match = _cache.find(key);
+        if (match == _cache.end())
+        {
+          bool matches = boost::regex_match(model, this->modelRegex) &&
+              (!isLink || boost::regex_match(link, this->linkRegex));
+          match = _cache.emplace(key, matches).first;
+        }
+
+        end = _chunk.find('<', pos);
+        if (match->second && end != std::string::npos &&
+            ToCsv(_chunk.substr(pos, end - pos), 6, pose))
+        {
+          result += simTime;
+          result += ',';
+          result += model;
+          result += ',';
+          result += link;
+          result += ',';
+          result += pose;
+          result += '\n';
+          ++_rows;
+        }
+      }
+    }
+
+    if (pos != std::string::npos)
+      pos = _chunk.find('<', pos);
+  }
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+size_t PoseExporter::Export(const gazebo::util::LogPlay &_play,
+    std::ostream &_out) const
+{
+  _out << "sim_time,model,link,x,y,z,roll,pitch,yaw\n";
+
+  const unsigned int count = _play.ChunkCount();
+
+  // Decode a few chunks per thread at a time, so that memory use doesn't
+  // grow with the size of the log.
+  const unsigned int window =
+    std::max(1u, std::thread::hardware_concurrency()) * 4;
+
+  tbb::enumerable_thread_specific<MatchCache> caches;
+  std::vector<std::string> rows(window);
+  std::vector<size_t> rowCounts(window);
+  size_t total = 0;
+
+  for (unsigned int begin = 0; begin < count; begin += window)
+  {
+    const unsigned int end = std::min(count, begin + window);
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(begin, end, 1),
+        [&](const tbb::blocked_range<unsigned int> &_r)
+    {
+      MatchCache &cache = caches.local();
+      std::string chunk;
+      for (unsigned int i = _r.begin(); i != _r.end(); ++i)
+      {
+        rows[i - begin].clear();
+        rowCounts[i - begin] = 0;
+
+        if (!_play.DecodeChunk(i, chunk))
+          continue;
+
+        // Skip chunks that can't contain a matching model
+        if (!this->modelLiteral.empty() &&
+            chunk.find(this->modelLiteral) == std::string::npos)
+        {
+          continue;
+        }
+
+        rows[i - begin] = this->ExportChunk(chunk, cache, rowCounts[i - begin]);
+      }
+    });
+
+    // Write in chunk order
+    for (unsigned int i = 0; i < end - begin; ++i)
+    {
+      _out << rows[i];
+      total += rowCounts[i];
+    }
+  }
+
+  return total;
+}
+
 /////////////////////////////////////////////////
 LogCommand::LogCommand()
   : Command("log", "Introspects and manipulates Gazebo log files.")
@@ -621,8 +884,13 @@ LogCommand::LogCommand()
      "Specify the encoding (txt, zlib, or bz2) for an output file. "
      "Valid in conjunction with the output command. See also the "
      "--output argument.")
+    ("export,x", po::value<std::string>(),
+     "Export the poses of the models, or of the links, that match the "
+     "filter to a CSV file. The filter has the form model[/link], where "
+     "both names accept '*' as a wildcard.")
     ("filter", po::value<std::string>(),
-     "Filter output. Valid only with the echo, step, and output commands");
+     "Filter output. Valid only with the echo, step, output, and export "
+     "commands");
 }
 
 /////////////////////////////////////////////////
@@ -692,7 +960,9 @@ bool LogCommand::RunImpl()
   g_stateSdf.reset(new sdf::Element);
   sdf::initFile("state.sdf", g_stateSdf);
 
-  if (this->vm.count("output"))
+  if (this->vm.count("export"))
+    this->Export(this->vm["export"].as<std::string>(), filter);
+  else if (this->vm.count("output"))
   {
     std::string encoding = this->vm.count("encoding") ?
       this->vm["encoding"].as<std::string>() : "";
@@ -980,6 +1250,42 @@ void LogCommand::Step(const std::string &_filter, bool _raw,
     std::cout << "</gazebo_log>\n";
 }
 
+/////////////////////////////////////////////////
+void LogCommand::Export(const std::string &_outFilename,
+    const std::string &_filter)
+{
+  gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
+  if (!play->IsOpen())
+  {
+    std::cerr << "No source log file specified. Use the -f command line "
+      << "argument.\n";
+    return;
+  }
+
+  std::ofstream outFile(_outFilename, std::fstream::out);
+  if (!outFile.is_open())
+  {
+    std::cerr << "Unable to open file[" << _outFilename << "] for writing.\n";
+    return;
+  }
+
+  try
+  {
+    PoseExporter exporter(_filter);
+    exporter.Export(*play, outFile);
+  }
+  catch(boost::regex_error &_e)
+  {
+    std::cerr << "Invalid filter[" << _filter << "]\n";
+  }
+  catch(gazebo::common::Exception &_e)
+  {
+    std::cerr << "Unable to export log file: " << _e.GetErrorStr() << "\n";
+  }
+
+  outFile.close();
+}
+
 /////////////////////////////////////////////////
 void LogCommand::Record(bool _start)
 {
@@ -19,8 +19,12 @@
 
 #include <string>
 #include <list>
+#include <ostream>
+#include <unordered_map>
 
+#include <boost/regex.hpp>
 #include <gazebo/physics/WorldState.hh>
+#include <gazebo/util/LogPlay.hh>
 #include "gz.hh"
 
 namespace gazebo
@@ -187,6 +191,48 @@ namespace gazebo
     private: gazebo::common::Time prevTime;
   };
 
+  /// \brief Streaming export of model and link poses to CSV. Chunks are
+  /// decoded in parallel and their frames are scanned directly, without
+  /// building world states.
+  class PoseExporter
+  {
+    /// \brief Cache of the result of matching names against the filter.
+    public: typedef std::unordered_map<std::string, bool> MatchCache;
+
+    /// \brief Constructor
+    /// \param[in] _filter Models and links to export, in the form
+    /// model[/link]. Both names accept '*' as a wildcard. An empty filter
+    /// exports all models, and no links.
+    public: explicit PoseExporter(const std::string &_filter);
+
+    /// \brief Write the CSV header and the rows of all frames of a log.
+    /// \param[in] _play The open log.
+    /// \param[in] _out Output stream.
+    /// \return Number of rows written.
+    public: size_t Export(const gazebo::util::LogPlay &_play,
+                std::ostream &_out) const;
+
+    /// \brief Convert the state frames of a decoded chunk to CSV rows.
+    /// \param[in] _chunk Data of the chunk.
+    /// \param[in,out] _cache Names already matched against the filter.
+    /// \param[out] _rows Number of rows.
+    /// \return The rows.
+    public: std::string ExportChunk(const std::string &_chunk,
+                MatchCache &_cache, size_t &_rows) const;
+
+    /// \brief Regular expression for scoped model names.
+    private: boost::regex modelRegex;
+
+    /// \brief Regular expression for link names.
+    private: boost::regex linkRegex;
+
+    /// \brief True to export links, false to export models.
+    private: bool exportLinks = false;
+
+    /// \brief Text that every chunk with a matching model contains.
+    private: std::string modelLiteral;
+  };
+
   /// \brief Log command
   class LogCommand : public Command
   {
@@ -240,6 +286,12 @@ namespace gazebo
     private: void Step(const std::string &_filter, bool _raw,
                  const std::string &_stamp, double _hz);
 
+    /// \brief Export the poses of models and links to a CSV file.
+    /// \param[in] _outFilename Output filename
+    /// \param[in] _filter Filter string, in the form model[/link].
+    private: void Export(const std::string &_outFilename,
+                 const std::string &_filter);
+
     /// \brief Start or stop logging
     /// \param[in] _start True to start logging
     private: void Record(bool _start);
@@ -17,6 +17,7 @@
 #include <thread>
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <gazebo/common/CommonIface.hh>
 #include <gazebo/common/Time.hh>
@@ -24,7 +25,10 @@
 #include <sdf/sdf_config.h>
 
 #include <stdio.h>
+#include <algorithm>
+#include <fstream>
 #include <string>
+#include <vector>
 
 // This header file isn't needed if shasums are used
 // #include "test/data/pr2_state_log_expected.h"
@@ -474,6 +478,83 @@ TEST(gz_log, Output)
 #endif
 }
 
+/////////////////////////////////////////////////
+/// Check to make sure that 'gz log -x' exports poses to CSV
+TEST(gz_log, Export)
+{
+#ifndef _WIN32
+  std::ostringstream csvStream;
+  csvStream << "/tmp/__gz_log_export_test" << std::this_thread::get_id()
+    << ".csv";
+  const std::string csvFile = csvStream.str();
+
+  // Model poses
+  custom_exec(GZ_LOG_PATH + " -f " + PROJECT_SOURCE_PATH +
+      "/test/data/pr2_state.log --filter pr2 -x " + csvFile);
+
+  std::vector<std::string> lines;
+  {
+    std::ifstream in(csvFile);
+    std::string line;
+    while (std::getline(in, line))
+      lines.push_back(line);
+  }
+  ASSERT_GT(lines.size(), 1u);
+  EXPECT_EQ(lines[0], "sim_time,model,link,x,y,z,roll,pitch,yaw");
+
+  for (size_t i = 1; i < lines.size(); ++i)
+  {
+    std::vector<std::string> fields;
+    boost::split(fields, lines[i], boost::is_any_of(","));
+    ASSERT_EQ(fields.size(), 9u) << lines[i];
+    EXPECT_EQ(fields[1], "pr2");
+    EXPECT_TRUE(fields[2].empty());
+  }
+
+  // One row per frame in which the pose of the model was recorded
+  std::string echo = custom_exec(GZ_LOG_PATH + " -e -r --filter pr2.pose -f " +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+  EXPECT_EQ(static_cast<size_t>(std::count(echo.begin(), echo.end(), '\n')),
+      lines.size() - 1);
+
+  // Link poses
+  custom_exec(GZ_LOG_PATH + " -f " + PROJECT_SOURCE_PATH +
+      "/test/data/pr2_state.log --filter pr2/r_upper* -x " + csvFile);
+
+  lines.clear();
+  {
+    std::ifstream in(csvFile);
+    std::string line;
+    while (std::getline(in, line))
+      lines.push_back(line);
+  }
+  ASSERT_GT(lines.size(), 1u);
+
+  for (size_t i = 1; i < lines.size(); ++i)
+  {
+    std::vector<std::string> fields;
+    boost::split(fields, lines[i], boost::is_any_of(","));
+    ASSERT_EQ(fields.size(), 9u) << lines[i];
+    EXPECT_EQ(fields[1], "pr2");
+    EXPECT_EQ(fields[2].find("r_upper"), 0u) << lines[i];
+  }
+
+  // No match
+  custom_exec(GZ_LOG_PATH + " -f " + PROJECT_SOURCE_PATH +
+      "/test/data/pr2_state.log --filter no_such_model -x " + csvFile);
+  lines.clear();
+  {
+    std::ifstream in(csvFile);
+    std::string line;
+    while (std::getline(in, line))
+      lines.push_back(line);
+  }
+  EXPECT_EQ(lines.size(), 1u);
+
+  std::remove(csvFile.c_str());
+#endif
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
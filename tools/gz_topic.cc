@@ -16,11 +16,15 @@
 */
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include <gazebo/gui/qt.h>
 #include <gazebo/gui/TopicSelector.hh>
 #include <gazebo/gui/viewers/TopicView.hh>
 #include <gazebo/gui/viewers/ViewFactory.hh>
 #include <gazebo/gazebo_client.hh>
+#include <gazebo/transport/ConnectionManager.hh>
 
 #include "gz_topic.hh"
 
@@ -38,6 +42,26 @@ static std::string &EraseTrailingWhitespaces(std::string &_str)
   return _str;
 }
 
+/// \brief Format a number of bytes with a unit.
+/// \param[in] _bytes Number of bytes.
+/// \return Formatted string, in B, KB or MB.
+static std::string FormatBytes(const double _bytes)
+{
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(2);
+  if (_bytes < 1000)
+    stream << _bytes << " B";
+  else if (_bytes < 1000000)
+    stream << _bytes / 1024.0 << " KB";
+  else
+    stream << _bytes / 1.049e6 << " MB";
+  return stream.str();
+}
+
+/// \brief Upper bounds of the buckets of the transfer time histogram of
+/// Stats(), in milliseconds.
+static const double transferBuckets[] = {0.1, 0.25, 0.5, 1, 2, 5, 10, 20, 50};
+
 /////////////////////////////////////////////////
 TopicCommand::TopicCommand()
   : Command("topic", "Lists information about topics on a Gazebo master")
@@ -52,11 +76,14 @@ TopicCommand::TopicCommand()
      "View topic data using a QT widget.")
     ("hz,z", po::value<std::string>(), "Get publish frequency.")
     ("bw,b", po::value<std::string>(), "Get topic bandwidth.")
+    ("stats,s", po::value<std::vector<std::string>>()->multitoken(),
+     "Get rate, bandwidth, inter-arrival jitter and transfer time histogram "
+     "of topics, without parsing their messages.")
     ("publish,p", po::value<std::string>(), "Publish message on a topic.")
     ("request,r", po::value<std::string>(), "Send a request.")
     ("unformatted,u", "Output data from echo without formatting.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run. "
-     "Applicable with echo, hz, and bw")
+     "Applicable with echo, hz, bw and stats")
     ("msg,m", po::value<std::string>(), "Message to send on topic. "
      "Applicable with publish and request")
     ("file,f", po::value<std::string>(), "Path to a file containing the "
@@ -96,6 +123,8 @@ bool TopicCommand::RunImpl()
     this->Hz(this->vm["hz"].as<std::string>());
   else if (this->vm.count("bw"))
     this->Bw(this->vm["bw"].as<std::string>());
+  else if (this->vm.count("stats"))
+    this->Stats(this->vm["stats"].as<std::vector<std::string>>());
   else if (this->vm.count("view"))
     this->View(this->vm["view"].as<std::string>());
   else if (this->vm.count("publish"))
@@ -231,40 +260,111 @@ void TopicCommand::Echo(const std::string &_topic)
 }
 
 /////////////////////////////////////////////////
-void TopicCommand::HzCB(const std::string &/*_data*/)
+void TopicCommand::Sample(const std::vector<std::string> &_topics,
+    const SampleCallback &_cb, const boost::function<void()> &_report)
 {
-  common::Time curTime = common::Time::GetWallTime();
+  std::vector<std::string> topics;
+  for (auto const &topic : _topics)
+    topics.push_back(this->node->DecodeTopicName(topic));
 
-  if (this->prevMsgTime != common::Time(0, 0))
-    printf("Hz: %6.2f\n", 1.0 / (curTime - this->prevMsgTime).Double());
+  common::Time end = common::Time::Maximum();
+  if (this->vm.count("duration"))
+  {
+    end = common::Time::GetWallTime() +
+        common::Time(this->vm["duration"].as<uint64_t>(), 0);
+  }
 
-  this->prevMsgTime = curTime;
+  boost::mutex::scoped_lock lock(this->sigMutex);
+  bool interrupted = false;
+  while (!interrupted && common::Time::GetWallTime() < end)
+  {
+    // Publishers may come and go
+    for (auto const &topic : topics)
+      this->ConnectPublishers(topic, _cb);
+
+    interrupted = this->sigCondition.timed_wait(lock,
+        boost::posix_time::seconds(1));
+
+    if (_report)
+      _report();
+  }
+
+  for (auto &conn : this->sampleConnections)
+  {
+    conn.second->Shutdown();
+    transport::ConnectionManager::Instance()->RemoveConnection(conn.second);
+  }
+  this->sampleConnections.clear();
 }
 
 /////////////////////////////////////////////////
-void TopicCommand::Hz(const std::string &_topic)
+void TopicCommand::ConnectPublishers(const std::string &_topic,
+    const SampleCallback &_cb)
 {
-  transport::SubscriberPtr sub = this->node->Subscribe(_topic,
-      &TopicCommand::HzCB, this);
+  msgs::TopicInfo info = this->GetInfo(_topic);
+  for (int i = 0; i < info.publisher_size(); ++i)
+  {
+    const msgs::Publish &pub = info.publisher(i);
+    const std::string key = _topic + " " + pub.host() + ":" +
+        std::to_string(pub.port());
 
-  boost::mutex::scoped_lock lock(this->sigMutex);
-  if (this->vm.count("duration"))
-    this->sigCondition.timed_wait(lock,
-        boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
-  else
-    this->sigCondition.wait(lock);
+    auto iter = this->sampleConnections.find(key);
+    if (iter != this->sampleConnections.end())
+    {
+      if (iter->second->IsOpen())
+        continue;
+      transport::ConnectionManager::Instance()->RemoveConnection(
+          iter->second);
+      this->sampleConnections.erase(iter);
+    }
+
+    transport::ConnectionPtr conn =
+      transport::ConnectionManager::Instance()->ConnectToRemoteHost(
+          pub.host(), pub.port());
+    if (!conn)
+      continue;
+
+    // Subscribe like a node would, but read only the framing
+    msgs::Subscribe sub;
+    sub.set_topic(_topic);
+    sub.set_msg_type(info.msg_type());
+    sub.set_host(conn->GetLocalAddress());
+    sub.set_port(conn->GetLocalPort());
+    sub.set_latching(false);
+    conn->EnqueueMsg(msgs::Package("sub", sub));
+    conn->AsyncSample(boost::bind(_cb, _topic, _1, _2, _3));
+
+    this->sampleConnections[key] = conn;
+  }
 }
 
 /////////////////////////////////////////////////
-void TopicCommand::BwCB(const std::string &_data)
+void TopicCommand::HzCB(const common::Time &_time)
 {
-  common::Time curTime = common::Time::GetWallTime();
+  if (this->prevMsgTime != common::Time(0, 0))
+    printf("Hz: %6.2f\n", 1.0 / (_time - this->prevMsgTime).Double());
+
+  this->prevMsgTime = _time;
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::Hz(const std::string &_topic)
+{
+  this->Sample({_topic}, [this](const std::string &, std::size_t,
+        const common::Time &, const common::Time &_end)
+      {
+        this->HzCB(_end);
+      }, boost::function<void()>());
+}
 
-  this->bwBytes.push_back(_data.size());
-  this->bwTime.push_back(common::Time::GetWallTime());
+/////////////////////////////////////////////////
+void TopicCommand::BwCB(std::size_t _size, const common::Time &_time)
+{
+  this->bwBytes.push_back(_size);
+  this->bwTime.push_back(_time);
 
   // One second time window
-  if (curTime - this->prevMsgTime > common::Time(1, 0))
+  if (_time - this->prevMsgTime > common::Time(1, 0))
   {
     // Make sure we have received at least 10 bytes of data.
     if (this->bwBytes.size() >= 10)
@@ -283,52 +383,17 @@ void TopicCommand::BwCB(const std::string &_data)
       float meanBytes = sumSize / count;
       float totalBps = sumSize / dt.Double();
 
-      // Create the output streams
-      std::ostringstream bandwidth, mean, min, max;
-      bandwidth << std::fixed << std::setprecision(2);
-      mean << std::fixed << std::setprecision(2);
-      min << std::fixed << std::setprecision(2);
-      max << std::fixed << std::setprecision(2);
-
-      // Format the bandwidth output
-      if (totalBps < 1000)
-        bandwidth << totalBps << " B/s";
-      else if (totalBps < 1000000)
-        bandwidth << totalBps / 1024.0f << " KB/s";
-      else
-        bandwidth << totalBps/1.049e6 << " MB/s";
-
-      // Format message size  output
-      if (meanBytes < 1000)
-      {
-        mean << meanBytes << " B";
-        min << this->bwBytes[0] << " B";
-        max << this->bwBytes[count-1] << " B";
-      }
-      else if (meanBytes < 1000000)
-      {
-        mean << meanBytes / 1024.0f << " KB";
-        min << this->bwBytes[0] / 1024.0f << " KB";
-        max << this->bwBytes[count-1] / 1024.0f << " KB";
-      }
-      else
-      {
-        mean << meanBytes / 1.049e6 << " MB";
-        min << this->bwBytes[0] / 1.049e6 << " MB";
-        max << this->bwBytes[count-1] / 1.049e6 << " MB";
-      }
-
-      std::cout << "Total[" << bandwidth.str() << "] "
-        << "Mean[" << mean.str() << "] "
-        << "Min[" << min.str() << "] "
-        << "Max[" << max.str() << "] "
+      std::cout << "Total[" << FormatBytes(totalBps) << "/s] "
+        << "Mean[" << FormatBytes(meanBytes) << "] "
+        << "Min[" << FormatBytes(this->bwBytes[0]) << "] "
+        << "Max[" << FormatBytes(this->bwBytes[count-1]) << "] "
         << "Messages[" << count << "]\n";
 
       this->bwBytes.clear();
       this->bwTime.clear();
     }
 
-    this->prevMsgTime = curTime;
+    this->prevMsgTime = _time;
   }
 }
 
@@ -336,15 +401,93 @@ void TopicCommand::BwCB(const std::string &_data)
 void TopicCommand::Bw(const std::string &_topic)
 {
   this->prevMsgTime = common::Time::GetWallTime();
-  transport::SubscriberPtr sub = node->Subscribe(_topic,
-      &TopicCommand::BwCB, this);
+  this->Sample({_topic}, [this](const std::string &, std::size_t _size,
+        const common::Time &, const common::Time &_end)
+      {
+        this->BwCB(_size, _end);
+      }, boost::function<void()>());
+}
 
-  boost::mutex::scoped_lock lock(this->sigMutex);
-  if (this->vm.count("duration"))
-    this->sigCondition.timed_wait(lock,
-        boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
-  else
-    this->sigCondition.wait(lock);
+/////////////////////////////////////////////////
+void TopicCommand::StatsCB(const std::string &_topic, std::size_t _size,
+    const common::Time &_start, const common::Time &_end)
+{
+  boost::mutex::scoped_lock lock(this->statsMutex);
+  TopicSamples &samples = this->stats[_topic];
+  samples.sizes.push_back(_size);
+  samples.arrivals.push_back(_end);
+  samples.transfers.push_back((_end - _start).Double() * 1e3);
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::PrintStats()
+{
+  std::map<std::string, TopicSamples> samples;
+  {
+    boost::mutex::scoped_lock lock(this->statsMutex);
+    std::swap(samples, this->stats);
+  }
+
+  for (auto const &topic : samples)
+  {
+    const TopicSamples &s = topic.second;
+    std::cout << topic.first << "\n";
+    if (s.arrivals.size() < 2)
+    {
+      std::cout << "  Messages[" << s.arrivals.size() << "]\n";
+      continue;
+    }
+
+    const double elapsed = (s.arrivals.back() - s.arrivals.front()).Double();
+    double bytes = 0;
+    for (auto size : s.sizes)
+      bytes += size;
+
+    // Standard deviation of the intervals between messages
+    std::vector<double> intervals;
+    double meanInterval = 0;
+    for (size_t i = 1; i < s.arrivals.size(); ++i)
+    {
+      intervals.push_back((s.arrivals[i] - s.arrivals[i-1]).Double() * 1e3);
+      meanInterval += intervals.back();
+    }
+    meanInterval /= intervals.size();
+    double variance = 0;
+    for (auto interval : intervals)
+      variance += (interval - meanInterval) * (interval - meanInterval);
+    const double jitter = std::sqrt(variance / intervals.size());
+
+    std::cout << std::fixed << std::setprecision(2)
+      << "  Rate[" << (elapsed > 0 ? intervals.size() / elapsed : 0)
+      << " Hz] Bandwidth[" << FormatBytes(elapsed > 0 ? bytes / elapsed : 0)
+      << "/s] Mean[" << FormatBytes(bytes / s.sizes.size())
+      << "] Jitter[" << jitter << " ms] Messages[" << s.sizes.size()
+      << "]\n";
+
+    // Histogram of the transfer times
+    const size_t bucketCount =
+      sizeof(transferBuckets) / sizeof(transferBuckets[0]);
+    std::vector<unsigned int> counts(bucketCount + 1, 0);
+    for (auto transfer : s.transfers)
+    {
+      counts[std::upper_bound(transferBuckets, transferBuckets + bucketCount,
+          transfer) - transferBuckets]++;
+    }
+    std::cout << "  Transfer[ms]";
+    std::cout.unsetf(std::ios_base::floatfield);
+    for (size_t i = 0; i < bucketCount; ++i)
+      std::cout << " <" << transferBuckets[i] << ":" << counts[i];
+    std::cout << " >=" << transferBuckets[bucketCount - 1] << ":"
+      << counts[bucketCount] << "\n";
+  }
+  std::cout << std::flush;
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::Stats(const std::vector<std::string> &_topics)
+{
+  this->Sample(_topics, boost::bind(&TopicCommand::StatsCB, this,
+        _1, _2, _3, _4), boost::bind(&TopicCommand::PrintStats, this));
 }
 
 /////////////////////////////////////////////////
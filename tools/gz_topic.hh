@@ -17,6 +17,7 @@
 #ifndef _GZ_TOPIC_HH_
 #define _GZ_TOPIC_HH_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -24,6 +25,20 @@
 
 namespace gazebo
 {
+  /// \brief Framing of the messages received on a topic, used by Stats().
+  class TopicSamples
+  {
+    /// \brief Sizes of the messages, in bytes.
+    public: std::vector<std::size_t> sizes;
+
+    /// \brief Wall times at which the messages were received.
+    public: std::vector<common::Time> arrivals;
+
+    /// \brief Times taken to receive the messages, from their header to
+    /// their last byte, in milliseconds.
+    public: std::vector<double> transfers;
+  };
+
   /// \brief Topic command
   class TopicCommand : public Command
   {
@@ -56,22 +71,68 @@ namespace gazebo
     /// \param[in] _data Data message from a topic.
     private: void EchoCB(const std::string &_data);
 
+    /// \brief The signature of the callback of Sample().
+    /// \param[in] _topic Topic of the message.
+    /// \param[in] _size Size of the message in bytes.
+    /// \param[in] _start Wall time at which the message started arriving.
+    /// \param[in] _end Wall time at which the message was received.
+    private: typedef boost::function<void(const std::string &_topic,
+        std::size_t _size, const common::Time &_start,
+        const common::Time &_end)> SampleCallback;
+
+    /// \brief Receive the framing of the messages published on topics,
+    /// without copying or parsing the messages, until the duration
+    /// elapses or the command is interrupted. Publishers are connected to
+    /// directly, without a node.
+    /// \param[in] _topics Topic names.
+    /// \param[in] _cb Callback invoked on the transport thread for each
+    /// message.
+    /// \param[in] _report Callback invoked every second, may be empty.
+    private: void Sample(const std::vector<std::string> &_topics,
+                 const SampleCallback &_cb,
+                 const boost::function<void()> &_report);
+
+    /// \brief Connect to the publishers of a topic that aren't sampled
+    /// yet.
+    /// \param[in] _topic Decoded topic name.
+    /// \param[in] _cb Callback invoked for each message.
+    private: void ConnectPublishers(const std::string &_topic,
+                 const SampleCallback &_cb);
+
     /// \brief Callback used by Hz() to receive topic messages.
-    /// \param[in] _data Data message from a topic (unused).
-    private: void HzCB(const std::string &_data);
+    /// \param[in] _time Wall time at which the message was received.
+    private: void HzCB(const common::Time &_time);
 
     /// \brief Output Hz rate for a topic.
     /// \param[in] _topic Topic name.
     private: void Hz(const std::string &_topic);
 
     /// \brief Subscription callback used by Bw().
-    /// \param[in] _data Message data.
-    private: void BwCB(const std::string &_data);
+    /// \param[in] _size Size of the message in bytes.
+    /// \param[in] _time Wall time at which the message was received.
+    private: void BwCB(std::size_t _size, const common::Time &_time);
 
     /// \brief Output bandwidth data for a topic.
     /// \param[in] _topic Topic name.
     private: void Bw(const std::string &_topic);
 
+    /// \brief Sample callback used by Stats().
+    /// \param[in] _topic Topic of the message.
+    /// \param[in] _size Size of the message in bytes.
+    /// \param[in] _start Wall time at which the message started arriving.
+    /// \param[in] _end Wall time at which the message was received.
+    private: void StatsCB(const std::string &_topic, std::size_t _size,
+                 const common::Time &_start, const common::Time &_end);
+
+    /// \brief Output the rate, bandwidth, inter-arrival jitter and
+    /// transfer time histogram of each topic sampled since the last
+    /// report.
+    private: void PrintStats();
+
+    /// \brief Output rate, bandwidth, jitter and transfer times of topics.
+    /// \param[in] _topics Topic names.
+    private: void Stats(const std::vector<std::string> &_topics);
+
     /// \brief View topic information using QT.
     /// \param[in] _topic Name of the topic to view. Empty will bring up
     /// a topic selector.
@@ -103,6 +164,18 @@ namespace gazebo
 
     /// \brief Buffer of message publish times, used by Bw().
     private: std::vector<common::Time> bwTime;
+
+    /// \brief Connections to sampled publishers, by topic and publisher
+    /// address.
+    private: std::map<std::string, transport::ConnectionPtr>
+             sampleConnections;
+
+    /// \brief Samples of each topic since the last report, used by
+    /// Stats().
+    private: std::map<std::string, TopicSamples> stats;
+
+    /// \brief Protects stats.
+    private: boost::mutex statsMutex;
   };
 }
 #endif